@@ -59,6 +59,20 @@ U32 Usb::receive(U8* data, U32 offset, U32 length) const
 	return ecrobot_read_usb(data, offset, length);
 }
 
+//=============================================================================
+// send data stream
+U32 Usb::sendStream(U8* data, U32 offset, U32 length)
+{
+	return ecrobot_send_usb_stream(data, offset, length);
+}
+
+//=============================================================================
+// receive data stream
+U32 Usb::receiveStream(U8* data, U32 offset, U32 length) const
+{
+	return ecrobot_read_usb_stream(data, offset, length);
+}
+
 //=============================================================================
 // close connection
 bool Usb::close(void)
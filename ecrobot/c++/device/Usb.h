@@ -77,6 +77,24 @@ public:
 	 */
 	U32 receive(U8* data, U32 offset, U32 length) const;
 
+	/**
+	 * Send data to the host device as a byte stream, in packets of up to MAX_USB_DATA_LENGTH.
+	 * @param data Data to be sent
+	 * @param offset Offset of data to be sent
+	 * @param length Length of data to be sent (no limit)
+	 * @return Length of sent data (less than length when the send buffer is full)
+	 */
+	U32 sendStream(U8* data, U32 offset, U32 length);
+
+	/**
+	 * Receive data from the host device as a byte stream, regardless of packets.
+	 * @param data Data to be received
+	 * @param offset Offset of data to be received
+	 * @param length Length of data to be received (no limit)
+	 * @return Length of received data
+	 */
+	U32 receiveStream(U8* data, U32 offset, U32 length) const;
+
 	/**
 	 * Close the existing connection.
 	 * @param -
@@ -2,12 +2,81 @@
 // New.cpp
 //
 // Simple new/delete overload to reduce the memory consumption.
-// Note that there is NO exception handling and NOT thread safe.
+// Note that there is NO exception handling.
+//
+// The blocks are allocated from a TLSF pool (see tlsf.h), so new and delete
+// take a bounded time. The pool grows by areas of at least NEW_AREA_SIZE
+// bytes taken from the C heap with malloc, which are never given back.
+// The pool is accessed with the IRQ disabled, so new and delete may be
+// used from several tasks.
 //
 // Copyright 2009 by Takashi Chikamasa, Jon C. Martin and Robert W. Kramer
 //
 
 #include <stdlib.h>
+#include "tlsf.h"
+
+extern "C" {
+#include "interrupts.h"
+}
+
+#define NEW_AREA_SIZE 1024
+
+static TLSF_POOL heap;
+static int heap_initialized = 0;
+
+static void* heap_alloc(size_t size)
+{
+	void* ptr;
+	void* area;
+	size_t area_size;
+	int enabled;
+
+	enabled = interrupts_get_and_disable();
+	if (!heap_initialized)
+	{
+		tlsf_init(&heap);
+		heap_initialized = 1;
+	}
+	ptr = tlsf_malloc(&heap, size);
+	if (enabled) interrupts_enable();
+
+	if (ptr == 0)
+	{
+		// worst case: the request rounded up to the next free list plus
+		// the block header and the area overheads
+		area_size = size + (size >> TLSF_SL_LOG2) + 4 * TLSF_ALIGN
+			+ TLSF_OVERHEAD + TLSF_AREA_OVERHEAD;
+		if (area_size < NEW_AREA_SIZE)
+		{
+			area_size = NEW_AREA_SIZE;
+		}
+		area = malloc(area_size);
+		if (area == 0)
+		{
+			return 0;
+		}
+
+		enabled = interrupts_get_and_disable();
+		if (tlsf_add_area(&heap, area, area_size) == 0)
+		{
+			if (enabled) interrupts_enable();
+			return 0;
+		}
+		ptr = tlsf_malloc(&heap, size);
+		if (enabled) interrupts_enable();
+	}
+	return ptr;
+}
+
+static void heap_free(void* ptr)
+{
+	int enabled;
+
+	enabled = interrupts_get_and_disable();
+	tlsf_free(&heap, ptr);
+	if (enabled) interrupts_enable();
+}
 
 //=============================================================================
 // new operators overload
@@ -20,7 +89,7 @@ void* operator new(size_t size) throw()
 	{
 		size = 1; // size 0 is set as size 1
 	}
-	return malloc(size);
+	return heap_alloc(size);
 }
 
 // normal array new
@@ -30,7 +99,7 @@ void* operator new [](size_t size) throw()
 	{
 		size = 1; // size 0 is set as size 1
 	}
-	return malloc(size);
+	return heap_alloc(size);
 }
 
 // default placement version of single new
@@ -45,10 +114,10 @@ void* operator new [](size_t, void* ptr) throw() { return ptr; }
 //
 
 // normal single delete
-void operator delete(void* ptr) throw() { free(ptr); }
+void operator delete(void* ptr) throw() { heap_free(ptr); }
 
 // normal array delete
-void operator delete [](void* ptr) throw() { free(ptr); }
+void operator delete [](void* ptr) throw() { heap_free(ptr); }
 
 // default placement version of single delete
 void operator delete(void*, void*) throw() { /* do nothing */ }
@@ -0,0 +1,89 @@
+//
+// Telemetry.h
+//
+// Schema-described telemetry over Bluetooth or USB (see ecrobot_telemetry.h)
+//
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "Bluetooth.h"
+#include "Usb.h"
+
+extern "C"
+{
+	#include "ecrobot_interface.h"
+};
+
+namespace ecrobot
+{
+/**
+ * Telemetry class: streams records of registered variables.
+ *
+ * Unlike Daq, which sends a fixed 32 byte record for NXT GamePad, the
+ * signals are chosen by the application and sent packed, so that many
+ * more of them fit in the link. Decode the captured stream with
+ * ecrobot/utils/telemetry_decode.py. Only one object may exist, and its
+ * records must be taken from one task.
+ */
+class Telemetry
+{
+public:
+	/**
+	 * Constructor (telemetry over Bluetooth).
+	 * @param bt Reference of a Bluetooth object.
+	 * @param frameLen Largest frame in byte (0: Bluetooth::MAX_BT_DATA_LENGTH).
+	 * @return -
+	 */
+	Telemetry(Bluetooth& bt, U32 frameLen = 0)
+	{
+		ecrobot_init_telemetry(ecrobot_send_bt_packet, frameLen);
+	}
+
+	/**
+	 * Constructor (telemetry over USB).
+	 * @param usb Reference of a Usb object.
+	 * @return -
+	 */
+	Telemetry(Usb& usb)
+	{
+		ecrobot_init_telemetry(ecrobot_send_telemetry_usb, Usb::MAX_USB_DATA_LENGTH);
+	}
+
+	/**
+	 * Register a signal, read from var each time a record is taken.
+	 * @param name Signal name (column name in the decoded output).
+	 * @param var Variable holding the signal.
+	 * @return true:registered/false:no room for the signal
+	 */
+	bool add(const CHAR* name, const S8& var) { return ecrobot_add_telemetry_signal(name, TELEMETRY_S8, &var) >= 0; }
+	bool add(const CHAR* name, const U8& var) { return ecrobot_add_telemetry_signal(name, TELEMETRY_U8, &var) >= 0; }
+	bool add(const CHAR* name, const S16& var) { return ecrobot_add_telemetry_signal(name, TELEMETRY_S16, &var) >= 0; }
+	bool add(const CHAR* name, const U16& var) { return ecrobot_add_telemetry_signal(name, TELEMETRY_U16, &var) >= 0; }
+	bool add(const CHAR* name, const S32& var) { return ecrobot_add_telemetry_signal(name, TELEMETRY_S32, &var) >= 0; }
+	bool add(const CHAR* name, const U32& var) { return ecrobot_add_telemetry_signal(name, TELEMETRY_U32, &var) >= 0; }
+
+	/**
+	 * Take a record of all signals.
+	 * @param -
+	 * @return -
+	 */
+	void log(void) { ecrobot_log_telemetry(); }
+
+	/**
+	 * Send the records taken so far.
+	 * @param -
+	 * @return -
+	 */
+	void flush(void) { ecrobot_flush_telemetry(); }
+
+	/**
+	 * Get the number of frames the link refused.
+	 * @param -
+	 * @return Number of dropped frames
+	 */
+	U32 getDropped(void) const { return ecrobot_get_telemetry_dropped(); }
+};
+}
+
+#endif
@@ -515,32 +515,46 @@ void ecrobot_term_bt_connection(void)
 /**
  * send Bluetooth data packet
  *
+ * The packet is queued behind any packets still being sent and goes out
+ * from the Bluetooth Tx ring under interrupt, so the caller does not wait.
+ * If the ring is too full to take the whole packet, nothing is queued and
+ * the packet is counted as dropped.
+ *
  * @param buf: data buffer to send
  * @param bufLen: length of data to send
- * @return: length of data to be able to send
+ * @return: length of data queued (0: dropped or not connected)
  */
 U32 ecrobot_send_bt_packet(U8 *buf, U32 bufLen)
 {
 #ifndef XCP_ON_BLUETOOTH
-	SINT i;
-
 	if (bt_status == BT_STREAM && bufLen <= BT_BUF_SIZE)
-    {
-		sendBuf[0] = (U8) (bufLen & 0xFF);
-		sendBuf[1] = (U8) ((bufLen >> 8) & 0xFF);
-		for(i = 0; i < bufLen; i++)
-		{
-			sendBuf[i+2] = buf[i];
-		}
-		if (bt_pending() & 2)
-		{
-			return 0;
-		}
-		bt_write(&sendBuf[0], 0, bufLen+2);
-		return bufLen;
-    }
+	{
+		return bt_write_packet(buf, bufLen);
+	}
 #endif
-    return 0;
+	return 0;
+}
+
+/**
+ * get free space of Bluetooth Tx ring
+ *
+ * A packet of bufLen bytes needs bufLen+2 bytes of space.
+ *
+ * @return: free space in byte
+ */
+U32 ecrobot_get_bt_tx_space(void)
+{
+	return bt_tx_space();
+}
+
+/**
+ * get number of Bluetooth writes dropped because the Tx ring was full
+ *
+ * @return: number of dropped packets since the Bluetooth device was initialized
+ */
+U32 ecrobot_get_bt_tx_dropped(void)
+{
+	return bt_tx_dropped();
 }
 
 /**
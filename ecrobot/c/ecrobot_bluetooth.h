@@ -14,5 +14,7 @@ extern   U8 ecrobot_set_bt_device_name(const CHAR* bd_name);
 extern   U8 ecrobot_set_bt_factory_settings(void);
 extern  U32 ecrobot_send_bt_packet(U8 *buf, U32 bufLen);
 extern  U32 ecrobot_read_bt_packet(U8 *buf, U32 bufLen);
+extern  U32 ecrobot_get_bt_tx_space(void);
+extern  U32 ecrobot_get_bt_tx_dropped(void);
 
 #endif
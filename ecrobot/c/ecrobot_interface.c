@@ -266,7 +266,10 @@ void ecrobot_term_i2c(U8 port_id)
 /*==============================================================================
  * NXT Ultrasonic Sensor API
  *=============================================================================*/
+#define SONAR_POLL_PERIOD 30 /* msec between measurement data reads */
+
 static S32 distance_state[4] = {-1,-1,-1,-1}; /* -1: sensor is not connected */
+static SINT sonar_poll[4] = {-1,-1,-1,-1}; /* I2C poll reading measurement data */
 
 static S32 getDistance(void)
 {
@@ -295,6 +298,11 @@ static S32 getDistance(void)
 void ecrobot_init_sonar_sensor(U8 port_id)
 {
 	ecrobot_init_i2c(port_id, LOWSPEED);
+	if (sonar_poll[port_id] < 0)
+	{
+		/* measurement data is read by the I2C ISR from now on */
+		sonar_poll[port_id] = i2c_add_poll(port_id, 1, 0x42, 1, SONAR_POLL_PERIOD);
+	}
 }
 
 /**
@@ -302,22 +310,20 @@ void ecrobot_init_sonar_sensor(U8 port_id)
  *
  * @param port_id: NXT_PORT_S1/NXT_PORT_S2/NXT_PORT_S3/NXT_PORT_S4
  * @return: distance in cm (0 to 255), -1 (failure)
- *  NOTE that this API has one cycle delay between data acquisition request
- *  and actual data acquisition. 
+ *  The measurement data is read every SONAR_POLL_PERIOD msec by the I2C
+ *  ISR, so this API returns at once with data at most that old.
  */
 S32 ecrobot_get_sonar_sensor(U8 port_id)
 {
-	static U8 data[4] = {0};
+	U8 data;
 
-	if (i2c_busy(port_id) == 0)
+	if (sonar_poll[port_id] < 0)
 	{
-		distance_state[port_id] = (S32)data[port_id];
-	   /* i2c_start_transaction just triggers an I2C transaction,
-		* actual data transaction between ARM7 and a Ultrasonic
-		* Sensor is done by an ISR after this, so there is one cycle
-		* delay for consistent data acquistion
-		*/
-		i2c_start_transaction(port_id,1,0x42,1,&data[port_id],1,0);
+		sonar_poll[port_id] = i2c_add_poll(port_id, 1, 0x42, 1, SONAR_POLL_PERIOD);
+	}
+	if (i2c_get_poll(sonar_poll[port_id], &data, 1) == 1)
+	{
+		distance_state[port_id] = (S32)data;
 	}
 
 	return distance_state[port_id];
@@ -334,7 +340,8 @@ void ecrobot_term_sonar_sensor(U8 port_id)
 	distance_state[1] = -1;
 	distance_state[2] = -1;
 	distance_state[3] = -1;
-	i2c_disable(port_id);
+	sonar_poll[port_id] = -1;
+	i2c_disable(port_id); /* also stops the poll */
 }
 
 
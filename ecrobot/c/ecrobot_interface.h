@@ -24,6 +24,7 @@
 #include "ecrobot_types.h"
 #include "ecrobot_bluetooth.h"
 #include "ecrobot_usb.h"
+#include "ecrobot_telemetry.h"
 
 typedef enum {
 	NXT_PORT_A,
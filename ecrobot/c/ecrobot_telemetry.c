@@ -0,0 +1,294 @@
+/*****************************************************************************
+ * FILE: ecrobot_telemetry.c
+ *
+ * Schema-described telemetry channel
+ *
+ * Records are packed as they are taken into the frame being built. A
+ * value is sent as the change from the previous record of the frame,
+ * which for most signals fits in one or two bytes, instead of the full
+ * width of its type. The frame goes out when the next record would not
+ * fit, or when its first record is TELEMETRY_FLUSH_MS old. A frame the
+ * link refuses is dropped and counted; its sequence number is not
+ * reused, so the decoder sees the gap.
+ *
+ * See ecrobot_telemetry.h for the frame layout.
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "ecrobot_interface.h"
+#include "ecrobot_telemetry.h"
+
+#define DATA_HEADER_LEN		9u	/* type, length, seq, time, count */
+#define SCHEMA_HEADER_LEN	6u	/* type, length, seq, first, total */
+#define MAX_VARINT_LEN		5u
+#define MAX_NAME_LEN		31u
+
+static TELEMETRY_SEND tlmSend = NULL;
+static U32 tlmFrameLen;
+
+static const CHAR *sigName[TELEMETRY_MAX_SIGNALS];
+static const void *sigAddr[TELEMETRY_MAX_SIGNALS];
+static U8 sigType[TELEMETRY_MAX_SIGNALS];
+static U8 sigCount;
+
+static S32 prevValue[TELEMETRY_MAX_SIGNALS];
+static U32 prevTime;
+
+static U8 frame[TELEMETRY_MAX_FRAME];
+static U32 framePos;
+static U32 frameTime;
+static U8 frameRecords;
+
+static U16 seq;
+static U32 framesSinceSchema;
+static U8 schemaDue;
+static U32 dropped;
+
+/* write v as a varint (7 bits per byte, low bits first) */
+static U32 put_varint(U8 *buf, U32 v)
+{
+	U32 len = 0;
+
+	while (v >= 0x80)
+	{
+		buf[len++] = (U8)(v | 0x80);
+		v >>= 7;
+	}
+	buf[len++] = (U8)v;
+	return len;
+}
+
+/* the value of signal i, widened to 32 bits */
+static S32 read_signal(U8 i)
+{
+	const void *addr = sigAddr[i];
+
+	switch (sigType[i])
+	{
+	case TELEMETRY_S8:  return *(const S8 *)addr;
+	case TELEMETRY_U8:  return *(const U8 *)addr;
+	case TELEMETRY_S16: return *(const S16 *)addr;
+	case TELEMETRY_U16: return *(const U16 *)addr;
+	default:            return *(const S32 *)addr;
+	}
+}
+
+/* send a frame of len bytes, counting it as dropped if refused */
+static U8 send_frame(U8 *buf, U32 len)
+{
+	U8 sent;
+
+	buf[1] = (U8)(len - 2);
+	buf[2] = (U8)(seq & 0xFF);
+	buf[3] = (U8)(seq >> 8);
+	seq++;
+	sent = (*tlmSend)(buf, len) != 0;
+	if (!sent)
+	{
+		dropped++;
+	}
+	return sent;
+}
+
+/*
+ * send the schema, in as many frames as needed; it is sent again with
+ * the next data frame if any part is refused
+ */
+static void send_schema(void)
+{
+	static U8 buf[TELEMETRY_MAX_FRAME];
+	U32 len, nameLen;
+	U8 i, first;
+
+	schemaDue = 0;
+	framesSinceSchema = 0;
+	i = 0;
+	do
+	{
+		first = i;
+		len = SCHEMA_HEADER_LEN;
+		for (; i < sigCount; i++)
+		{
+			for (nameLen = 0; nameLen < MAX_NAME_LEN && sigName[i][nameLen] != '\0'; nameLen++);
+			if (len + 2 + nameLen > tlmFrameLen)
+			{
+				break;
+			}
+			buf[len++] = sigType[i];
+			buf[len++] = (U8)nameLen;
+			memcpy(&buf[len], sigName[i], nameLen);
+			len += nameLen;
+		}
+		buf[0] = TELEMETRY_FRAME_SCHEMA;
+		buf[4] = first;
+		buf[5] = sigCount;
+		if (!send_frame(buf, len))
+		{
+			schemaDue = 1;
+		}
+	} while (i < sigCount);
+}
+
+/**
+ * initialize the telemetry channel and forget all signals
+ *
+ * @param send: output function, e.g. ecrobot_send_bt_packet or
+ *              ecrobot_send_telemetry_usb
+ * @param frameLen: largest frame in bytes (at most TELEMETRY_MAX_FRAME,
+ *                  MAX_USB_DATA_LEN for USB), 0 for the largest
+ */
+void ecrobot_init_telemetry(TELEMETRY_SEND send, U32 frameLen)
+{
+	if (frameLen == 0 || frameLen > TELEMETRY_MAX_FRAME)
+	{
+		frameLen = TELEMETRY_MAX_FRAME;
+	}
+	tlmSend = send;
+	tlmFrameLen = frameLen;
+	sigCount = 0;
+	framePos = DATA_HEADER_LEN;
+	frameRecords = 0;
+	seq = 0;
+	schemaDue = 1;
+	dropped = 0;
+}
+
+/**
+ * register a signal, read from addr each time a record is taken
+ *
+ * @param name: signal name (column name), up to 31 characters are sent
+ * @param type: TELEMETRY_S8 ... TELEMETRY_U32
+ * @param addr: address of the variable holding the signal
+ * @return: index of the signal, -1 if there is no room for it
+ */
+SINT ecrobot_add_telemetry_signal(const CHAR *name, U8 type, const void *addr)
+{
+	/* a record of all signals must fit in one frame */
+	if (tlmSend == NULL || sigCount >= TELEMETRY_MAX_SIGNALS || type > TELEMETRY_U32 ||
+		DATA_HEADER_LEN + MAX_VARINT_LEN * (sigCount + 2) > tlmFrameLen ||
+		SCHEMA_HEADER_LEN + 2 + MAX_NAME_LEN > tlmFrameLen)
+	{
+		return -1;
+	}
+
+	/* the records of the frame being built have the old layout */
+	ecrobot_flush_telemetry();
+	sigName[sigCount] = name;
+	sigType[sigCount] = type;
+	sigAddr[sigCount] = addr;
+	schemaDue = 1;
+	return sigCount++;
+}
+
+/**
+ * take a record of all signals
+ */
+void ecrobot_log_telemetry(void)
+{
+	U8 rec[MAX_VARINT_LEN * (TELEMETRY_MAX_SIGNALS + 1)];
+	S32 value[TELEMETRY_MAX_SIGNALS];
+	U32 now, len, diff;
+	U8 i;
+
+	if (tlmSend == NULL || sigCount == 0)
+	{
+		return;
+	}
+
+	now = systick_get_ms();
+	if (frameRecords != 0 && (now - frameTime >= TELEMETRY_FLUSH_MS || frameRecords == 0xFF))
+	{
+		ecrobot_flush_telemetry();
+	}
+	for (i = 0; i < sigCount; i++)
+	{
+		value[i] = read_signal(i);
+	}
+
+	for (;;)
+	{
+		if (frameRecords == 0)
+		{
+			frameTime = prevTime = now;
+			for (i = 0; i < sigCount; i++)
+			{
+				prevValue[i] = 0;
+			}
+		}
+		len = put_varint(rec, now - prevTime);
+		for (i = 0; i < sigCount; i++)
+		{
+			/* zigzag: small changes of either sign give small numbers */
+			diff = (U32)value[i] - (U32)prevValue[i];
+			len += put_varint(&rec[len], (diff << 1) ^ (U32)((S32)diff >> 31));
+		}
+		if (framePos + len <= tlmFrameLen || frameRecords == 0)
+		{
+			break;
+		}
+		/* start a new frame, where the record is coded again from zero */
+		ecrobot_flush_telemetry();
+	}
+
+	for (i = 0; i < len; i++)
+	{
+		frame[framePos + i] = rec[i];
+	}
+	framePos += len;
+	frameRecords++;
+	prevTime = now;
+	for (i = 0; i < sigCount; i++)
+	{
+		prevValue[i] = value[i];
+	}
+}
+
+/**
+ * send the records taken so far, without waiting for the frame to fill
+ */
+void ecrobot_flush_telemetry(void)
+{
+	if (tlmSend == NULL || frameRecords == 0)
+	{
+		return;
+	}
+
+	if (schemaDue || framesSinceSchema >= TELEMETRY_SCHEMA_INTERVAL)
+	{
+		send_schema();
+	}
+	frame[0] = TELEMETRY_FRAME_DATA;
+	frame[4] = (U8)(frameTime & 0xFF);
+	frame[5] = (U8)((frameTime >> 8) & 0xFF);
+	frame[6] = (U8)((frameTime >> 16) & 0xFF);
+	frame[7] = (U8)(frameTime >> 24);
+	frame[8] = frameRecords;
+	send_frame(frame, framePos);
+	framesSinceSchema++;
+	framePos = DATA_HEADER_LEN;
+	frameRecords = 0;
+}
+
+/**
+ * get number of frames the link refused
+ *
+ * @return: number of dropped frames since ecrobot_init_telemetry
+ */
+U32 ecrobot_get_telemetry_dropped(void)
+{
+	return dropped;
+}
+
+/**
+ * output function for telemetry over USB (frameLen up to MAX_USB_DATA_LEN)
+ *
+ * @param buf: frame to send
+ * @param len: length of the frame
+ * @return: len if sent, 0 otherwise
+ */
+U32 ecrobot_send_telemetry_usb(U8 *buf, U32 len)
+{
+	return (ecrobot_send_usb(buf, 0, len) > 0) ? len : 0;
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * FILE: ecrobot_telemetry.h
+ *
+ * Schema-described telemetry channel
+ *
+ * The application registers its signals once, by name, type and the
+ * address of the variable that holds each, then calls
+ * ecrobot_log_telemetry() whenever a record is to be taken. Records are
+ * packed into frames that are sent through a function such as
+ * ecrobot_send_bt_packet(). ecrobot/utils/telemetry_decode.py turns the
+ * stream back into columns (CSV).
+ *
+ * Frame (all multi-byte fields little endian):
+ *   U8  type      TELEMETRY_FRAME_DATA or TELEMETRY_FRAME_SCHEMA
+ *   U8  length    number of bytes after this field
+ *   U16 seq       frame sequence number, counts dropped frames too
+ *   data frame:
+ *     U32 time    systick_get_ms() of the first record
+ *     U8  count   number of records
+ *     records:    varint time step [ms] from the previous record (the
+ *                 first from time), then one zigzag varint per signal:
+ *                 the value in the first record, the change from the
+ *                 previous record in the others
+ *   schema frame:
+ *     U8  first   index of the first signal described
+ *     U8  total   number of signals
+ *     per signal: U8 type, U8 name length, name
+ *
+ * Each frame can be decoded on its own, so a dropped frame loses only
+ * its own records. The schema is sent again every
+ * TELEMETRY_SCHEMA_INTERVAL data frames for a decoder that starts late.
+ *
+ * Not reentrant: records must be taken from one task.
+ *****************************************************************************/
+
+#ifndef _ECROBOT_TELEMETRY_H_
+#define _ECROBOT_TELEMETRY_H_
+
+#include "ecrobot_types.h"
+
+/*
+ * Signal types
+ */
+#define TELEMETRY_S8	0
+#define TELEMETRY_U8	1
+#define TELEMETRY_S16	2
+#define TELEMETRY_U16	3
+#define TELEMETRY_S32	4
+#define TELEMETRY_U32	5
+
+/*
+ * Frame types
+ */
+#define TELEMETRY_FRAME_DATA	0xD1
+#define TELEMETRY_FRAME_SCHEMA	0xD0
+
+/*
+ * Number of signals, largest frame (a Bluetooth packet), longest time
+ * a record waits in a frame [ms] and data frames between schemas
+ */
+#ifndef TELEMETRY_MAX_SIGNALS
+#define TELEMETRY_MAX_SIGNALS		32
+#endif
+#define TELEMETRY_MAX_FRAME			254
+#ifndef TELEMETRY_FLUSH_MS
+#define TELEMETRY_FLUSH_MS			100
+#endif
+#ifndef TELEMETRY_SCHEMA_INTERVAL
+#define TELEMETRY_SCHEMA_INTERVAL	64
+#endif
+
+/*
+ * Output function: sends len bytes, returns the number sent (0 when
+ * the link is busy or down), like ecrobot_send_bt_packet()
+ */
+typedef U32 (*TELEMETRY_SEND)(U8 *buf, U32 len);
+
+extern void ecrobot_init_telemetry(TELEMETRY_SEND send, U32 frameLen);
+extern SINT ecrobot_add_telemetry_signal(const CHAR *name, U8 type, const void *addr);
+extern void ecrobot_log_telemetry(void);
+extern void ecrobot_flush_telemetry(void);
+extern  U32 ecrobot_get_telemetry_dropped(void);
+extern  U32 ecrobot_send_telemetry_usb(U8 *buf, U32 len);
+
+#endif
@@ -51,6 +51,10 @@
 
 #include "ecrobot_usb.h"
 
+#if !UDP_BUFFERED
+#error "ecrobot_usb.c needs the buffered mode of udp.c: define UDP_RX_PACKETS"
+#endif
+
 /*==============================================================================
  * NXT USB API for LEGO fantom driver
  *=============================================================================*/
@@ -75,7 +79,6 @@ static U8 dev_name[MAX_DEV_NAME_LEN] = NAME;
 /* unique signature to connect with only NXTCommFantom API */
 static const U8 ecrobot_sig[] = {'E', 'C', 'R', 'O', 'B', 'O', 'T'};
 
-static volatile SINT read_data_len;
 static volatile U8 usb_status = USB_NO_INIT;
 static U8 usb_buf[MAX_USB_DATA_LEN];
 
@@ -95,6 +98,7 @@ void ecrobot_init_usb(void)
 		udp_set_name((U8 *)NAME, sizeof(NAME));
 		udp_set_serialno((U8 *)SERIAL_NO, sizeof(SERIAL_NO));
 		udp_enable(0); /* no reset */
+		udp_set_buffered(1); /* packets are moved by the USB ISR */
 		memset(usb_buf,0,sizeof(usb_buf)); /* flush buffer */
 		usb_status = USB_INIT;
 	}
@@ -130,6 +134,9 @@ SINT ecrobot_set_name_usb(U8* name)
  * USB process handler to establish a connection with PC.
  * This function must be invoked every 1msec
  * (i.e. in a loop with 1msec wait, OSEK/JSP 1msec peiodical Task)
+ * Once connected, data is moved by the USB ISR and buffered in the
+ * driver (UDP_RX_PACKETS/UDP_TX_PACKETS packets), so this function
+ * does not limit the throughput.
  *
  * @return: usb_status(USB_NO_INIT/USB_INIT/USB_CONNECTED)
  */ 
@@ -172,7 +179,6 @@ U8 ecrobot_process1ms_usb(void)
 						usb_buf[i+1] = ecrobot_sig[i];
 					}
 					len = sizeof(ecrobot_sig) + 1;
-					read_data_len = 0;
 					usb_status = USB_CONNECTED; /* a connection is established */
 				}
 				usb_buf[0] = REPLY_COMMAND;
@@ -180,14 +186,6 @@ U8 ecrobot_process1ms_usb(void)
 			}
 		}
 	}
-	else if (usb_status == USB_CONNECTED)
-	{
-		/* keep un-read data until ecrobot_read_usb is called */
-		if (read_data_len == 0)
-		{
-			read_data_len = udp_read(usb_buf, 0, MAX_USB_DATA_LEN);
-		}
-	}
 	return usb_status;
 }
 
@@ -222,30 +220,42 @@ SINT ecrobot_disconnect_usb(void)
 }
 
 /**
- * read USB data from host
+ * read a USB packet from host
  *
  * @param buf: buffer for read data
  * @param off: buffer offset
- * @param len: length of data to be read
+ * @param len: length of data to be read (the rest of the packet is lost)
  * @return: length of read data
  */
 SINT ecrobot_read_usb(U8* buf, U32 off, U32 len)
 {
+	SINT ret;
+
 	if (usb_status != USB_CONNECTED) return 0;
 	if (len > MAX_USB_DATA_LEN) len = MAX_USB_DATA_LEN;
 	
-	if (read_data_len > 0)
-	{
-		if (read_data_len > len) read_data_len = len;
-		memcpy(&buf[off], usb_buf, read_data_len);
-		len = read_data_len;
-		read_data_len = 0; /* data is read by application */
-	}
-	else
-	{
-		len = 0;
-	}
-	return len;
+	ret = udp_read(buf, off, len);
+	if (ret < 0) ret = 0; /* not configured or zero length packet */
+	return ret;
+}
+
+/**
+ * read USB data from host as a byte stream, regardless of packets
+ *
+ * @param buf: buffer for read data
+ * @param off: buffer offset
+ * @param len: length of data to be read (no limit)
+ * @return: length of read data
+ */
+SINT ecrobot_read_usb_stream(U8* buf, U32 off, U32 len)
+{
+	SINT ret;
+
+	if (usb_status != USB_CONNECTED) return 0;
+
+	ret = udp_stream_read(buf, off, len);
+	if (ret < 0) ret = 0;
+	return ret;
 }
 
 /**
@@ -264,6 +274,26 @@ SINT ecrobot_send_usb(U8* buf, U32 off, U32 len)
 	return udp_write(buf, off, len);
 }
 
+/**
+ * send USB data to host as a byte stream, in packets of up to
+ * MAX_USB_DATA_LEN bytes
+ *
+ * @param buf: buffer for data to be sent
+ * @param off: buffer offset
+ * @param len: length of the data to be sent (no limit)
+ * @return: length of sent data (less than len when the buffer is full)
+ */
+SINT ecrobot_send_usb_stream(U8* buf, U32 off, U32 len)
+{
+	SINT ret;
+
+	if (usb_status != USB_CONNECTED) return 0;
+
+	ret = udp_stream_write(buf, off, len);
+	if (ret < 0) ret = 0;
+	return ret;
+}
+
 /**
  * close a USB connection.
  */
@@ -18,6 +18,8 @@ extern   U8 ecrobot_process1ms_usb(void);
 extern   U8 ecrobot_is_usb_connected(void);
 extern SINT ecrobot_read_usb(U8* buf, U32 off, U32 len);
 extern SINT ecrobot_send_usb(U8* buf, U32 off, U32 len);
+extern SINT ecrobot_read_usb_stream(U8* buf, U32 off, U32 len);
+extern SINT ecrobot_send_usb_stream(U8* buf, U32 off, U32 len);
 extern SINT ecrobot_disconnect_usb(void);
 extern void ecrobot_term_usb(void);
 
@@ -10,6 +10,8 @@
  * Copyright 2007, 2008 by Takashi Chikamasa and Robert W. Kramer
  */
 
+#include <stddef.h>
+
 #include "rtoscalls.h"
 
 #include "ecrobot_base.h"
@@ -20,16 +22,46 @@
 DeclareEvent(EventSleepI2C);
 DeclareEvent(EventSleep);
 
+/*
+ * a Task sleeping in Sleep, linked in the wake up queue in order of wake
+ * up time. Note that each node is on the stack of its sleeping Task, so
+ * Sleep must not return before SleeperMonitor has taken it off the queue
+ */
+typedef struct sleeper
+{
+	struct sleeper *next;
+	TaskType id;
+	U32 wakeTick;
+	volatile U8 queued; /* cleared by SleeperMonitor */
+} SLEEPER;
+
 static TaskType sleeperI2C_ID[MAX_N_SENSORS];
-static TaskType sleeperTask_ID[N_TASKS];
 static  U8 isI2cSleeping[MAX_N_SENSORS] = {0};
-static  U8 isTaskSleeping[N_TASKS] = {0};
-static U32 sleepTaskCounter[N_TASKS] = {0};
+static SLEEPER *sleepQueue = NULL; /* sleeping Tasks, earliest wake up first */
+static U32 sleepTick = 0; /* number of SleeperMonitor calls */
 #endif
 
 
+#ifdef NXT_JSP /* TOPPERS/JSP(uITRON) */
+#else /* TOPPERS/ATK(OSEK) */
+/*
+ * wake up the Task sleeping on an I2C port
+ * Note that this function is called from the I2C ISR when the port has
+ * finished all its queued transactions
+ */
+static void I2cIdle(int port)
+{
+	if (port < MAX_N_SENSORS && isI2cSleeping[port])
+	{
+		isI2cSleeping[port] = 0; /* reset a sleep flag */
+
+		SetEvent(sleeperI2C_ID[port], EventSleepI2C); /* kick out the sleeping Task */
+	}
+}
+#endif
+
 /* 
- * check sleeping I2C devices and Tasks
+ * check sleeping Tasks
  * Note that this function must be executed from 1msec ISR hook
  */
 void SleeperMonitor(void)
@@ -44,31 +76,18 @@ void SleeperMonitor(void)
 	 */
 
 #else /* TOPPERS/ATK(OSEK) */
-	SINT i;
-
-	/* check on sleeping I2C devices */
-	for (i = 0; i<MAX_N_SENSORS; i++)
-	{
-		if (isI2cSleeping[i] && i2c_busy(i) == 0)
-		{
-			isI2cSleeping[i] = 0; /* reset a sleep flag */
+	SLEEPER *s;
 
-			SetEvent(sleeperI2C_ID[i], EventSleepI2C); /* kick out the sleeping Task */
-		}
-	}
+	sleepTick++;
 
-	/* check on sleeping Tasks */
-	for (i = 0; i<N_TASKS; i++)
+	/* the queue is sorted, so only Tasks at its head can be due */
+	while (sleepQueue != NULL && (S32)(sleepQueue->wakeTick - sleepTick) <= 0)
 	{
-		if (isTaskSleeping[i])
-		{
-			if (!--sleepTaskCounter[i])
-			{
-				isTaskSleeping[i] = 0; /* reset a sleep flag */
+		s = sleepQueue;
+		sleepQueue = s->next;
+		s->queued = 0; /* the node is not used after this */
 
-				SetEvent(sleeperTask_ID[i], EventSleep); /* kick out the sleeping Task */
-			}
-		}
+		SetEvent(s->id, EventSleep); /* kick out the sleeping Task */
 	}
 #endif
 }
@@ -90,10 +109,21 @@ void SleepI2C(U8 port)
 		GetTaskID(&id); /* get running Task ID */
 		if (id != INVALID_TASK)
 		{
+			i2c_set_idle_callback(I2cIdle);
+			ClearEvent(EventSleepI2C);
 			sleeperI2C_ID[port] = id; /* save the runninng Task ID */
 			isI2cSleeping[port] = 1; /* set sleep flag */
 			
-			WaitEvent(EventSleepI2C); /* sleep until kicked up by the SleeperMonitor */
+			/*
+			 * the port may have become idle before the flag was set, and
+			 * EventSleepI2C may be set by others while it is still busy
+			 */
+			while (i2c_busy(port) == 1)
+			{
+				WaitEvent(EventSleepI2C); /* sleep until kicked up by I2cIdle */
+				ClearEvent(EventSleepI2C);
+			}
+			isI2cSleeping[port] = 0;
 			ClearEvent(EventSleepI2C);
 		}
 	}
@@ -107,25 +137,41 @@ void Sleep(U32 duration)
 	dly_tsk((RELTIM) duration);
 
 #else /* TOPPERS/ATK(OSEK) */
-	for (SINT i = 0;i < N_TASKS; i++)
+	SLEEPER node;
+	SLEEPER **pos;
+
+	GetTaskID(&node.id); /* get running Task ID */
+	if (node.id != INVALID_TASK)
 	{
-		if (!isTaskSleeping[i])
-		{
-			TaskType id;
+		SuspendOSInterrupts(); /* SleeperMonitor also changes the queue */
 
-			GetTaskID(&id); /* get running Task ID */
-			if (id != INVALID_TASK)
+		/* 0 wakes up at the next SleeperMonitor call like 1 */
+		node.wakeTick = sleepTick + duration;
+
+		/* insert behind the Tasks which wake up earlier or at the same time */
+		for (pos = &sleepQueue; *pos != NULL; pos = &(*pos)->next)
+		{
+			if ((S32)((*pos)->wakeTick - node.wakeTick) > 0)
 			{
-				sleeperTask_ID[i] = id; /* save the runninng Task ID */
-				isTaskSleeping[i] = 1; /* set sleep flag */
-				sleepTaskCounter[i] = duration; /* set sleep time in msec */
-				
-				WaitEvent(EventSleep); /* sleep until kicked up by the SleeperMonitor */
-				ClearEvent(EventSleep);
+				break;
 			}
-			break;
 		}
-    }
+		node.next = *pos;
+		node.queued = 1;
+		*pos = &node;
+
+		ResumeOSInterrupts();
+
+		/*
+		 * EventSleep is public and may be set by others: sleep until
+		 * kicked up by the SleeperMonitor, which has then dequeued the node
+		 */
+		do
+		{
+			WaitEvent(EventSleep);
+			ClearEvent(EventSleep);
+		} while (node.queued);
+	}
 #endif
 }
 
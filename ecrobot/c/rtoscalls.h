@@ -4,13 +4,6 @@
 #include "kernel.h"
 #include "ecrobot_interface.h"
 
-/*
- * N_TASKS: max number of Tasks to be slept
- * Note that it needs to modify N_TASKS when Sleep APIs were used in more than 8 Tasks
- */
-#define N_TASKS 8
-
-
 #define MAX_N_SENSORS 4 /* I2C sensors can be used per a NXT is fixed as 4 (number of sensor ports) */
 
 
@@ -20,7 +13,7 @@ DeclareEvent(EventSleepI2C);
 DeclareEvent(EventSleep);
 #endif
 
-extern void SleeperMonitor(void); /* SleeperMonitor must be invoked from 1msec periodical ISR hook */
+extern void SleeperMonitor(void); /* SleeperMonitor must be invoked from 1msec periodical ISR hook (for Sleep) */
 /* Below functions must be used in Tasks */
 extern void SleepI2C(U8 port);
 extern void Sleep(U32 duration);
@@ -0,0 +1,325 @@
+/*****************************************************************************
+ * FILE: tlsf.c
+ *
+ * Two-Level Segregated Fit (TLSF) memory allocator
+ *
+ * A free block of size s is kept in list [fl][sl]: fl is the position of
+ * the highest bit of s, and sl the next TLSF_SL_LOG2 bits below it, so
+ * that each power of two is divided into TLSF_SL_COUNT lists.  Blocks
+ * smaller than (1 << TLSF_FL_SHIFT) all go to fl 0, one list per
+ * TLSF_ALIGN bytes.
+ *
+ * tlsf_malloc() rounds the request up to the next list boundary so that
+ * any block of the first non-empty list at or above it is large enough
+ * (good fit), and tlsf_free() merges the block with its free neighbours
+ * in memory.  Neither of them loops over the blocks of the pool.
+ *****************************************************************************/
+
+#include "tlsf.h"
+
+#define TLSF_FREE         ((size_t) 1)
+#define TLSF_SIZE(b)      ((b)->size & ~TLSF_FREE)
+#define TLSF_IS_FREE(b)   (((b)->size & TLSF_FREE) != 0)
+
+#define TLSF_ROUND(x)     (((x) + TLSF_ALIGN - 1) & ~((size_t) TLSF_ALIGN - 1))
+#define TLSF_MIN_BLOCK    TLSF_ROUND(sizeof(TLSF_BLOCK))
+#define TLSF_MAX_BLOCK    (((size_t) 1 << TLSF_FL_MAX) - TLSF_ALIGN)
+
+#define TLSF_PAYLOAD(b)   ((void *)((char *)(b) + TLSF_OVERHEAD))
+#define TLSF_HEADER(p)    ((TLSF_BLOCK *)((char *)(p) - TLSF_OVERHEAD))
+#define TLSF_NEXT_PHYS(b) ((TLSF_BLOCK *)((char *)(b) + TLSF_SIZE(b)))
+
+/* position of the highest/lowest bit set (x must not be 0) */
+static unsigned int tlsf_fls(unsigned int x)
+{
+	return 31 - __builtin_clz(x);
+}
+
+static unsigned int tlsf_ffs(unsigned int x)
+{
+	return __builtin_ctz(x);
+}
+
+/* list a free block of size bytes belongs to */
+static void tlsf_mapping(size_t size, unsigned int *fl, unsigned int *sl)
+{
+	unsigned int f;
+
+	if (size < (1u << TLSF_FL_SHIFT))
+	{
+		*fl = 0;
+		*sl = (unsigned int)size >> TLSF_ALIGN_LOG2;
+	}
+	else
+	{
+		f = tlsf_fls((unsigned int)size);
+		*fl = f - TLSF_FL_SHIFT + 1;
+		*sl = ((unsigned int)size >> (f - TLSF_SL_LOG2)) - TLSF_SL_COUNT;
+	}
+}
+
+static void tlsf_insert(TLSF_POOL *pool, TLSF_BLOCK *b)
+{
+	unsigned int fl, sl;
+	TLSF_BLOCK *head;
+
+	tlsf_mapping(TLSF_SIZE(b), &fl, &sl);
+	head = pool->blocks[fl][sl];
+	b->prev_free = NULL;
+	b->next_free = head;
+	if (head != NULL)
+	{
+		head->prev_free = b;
+	}
+	pool->blocks[fl][sl] = b;
+	pool->fl_bitmap |= 1u << fl;
+	pool->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void tlsf_remove(TLSF_POOL *pool, TLSF_BLOCK *b)
+{
+	unsigned int fl, sl;
+
+	tlsf_mapping(TLSF_SIZE(b), &fl, &sl);
+	if (b->next_free != NULL)
+	{
+		b->next_free->prev_free = b->prev_free;
+	}
+	if (b->prev_free != NULL)
+	{
+		b->prev_free->next_free = b->next_free;
+	}
+	else
+	{
+		pool->blocks[fl][sl] = b->next_free;
+		if (b->next_free == NULL)
+		{
+			pool->sl_bitmap[fl] &= ~(1u << sl);
+			if (pool->sl_bitmap[fl] == 0)
+			{
+				pool->fl_bitmap &= ~(1u << fl);
+			}
+		}
+	}
+}
+
+/* first free block at or above list [fl][sl], or NULL */
+static TLSF_BLOCK *tlsf_search(TLSF_POOL *pool, unsigned int fl, unsigned int sl)
+{
+	unsigned int map;
+
+	map = pool->sl_bitmap[fl] & (~0u << sl);
+	if (map == 0)
+	{
+		map = pool->fl_bitmap & (~0u << (fl + 1));
+		if (map == 0)
+		{
+			return NULL;
+		}
+		fl = tlsf_ffs(map);
+		map = pool->sl_bitmap[fl];
+	}
+	return pool->blocks[fl][tlsf_ffs(map)];
+}
+
+void tlsf_init(TLSF_POOL *pool)
+{
+	unsigned int fl, sl;
+
+	pool->fl_bitmap = 0;
+	for (fl = 0; fl < TLSF_FL_COUNT; fl++)
+	{
+		pool->sl_bitmap[fl] = 0;
+		for (sl = 0; sl < TLSF_SL_COUNT; sl++)
+		{
+			pool->blocks[fl][sl] = NULL;
+		}
+	}
+	pool->total = 0;
+	pool->used = 0;
+	pool->max_used = 0;
+}
+
+/*
+ * Add the memory area [mem, mem + size) to the pool; returns the number
+ * of bytes it added (0 when the area is too small).  Areas are never
+ * merged with each other.
+ */
+size_t tlsf_add_area(TLSF_POOL *pool, void *mem, size_t size)
+{
+	char *start, *end;
+	size_t bsize, added;
+	TLSF_BLOCK *b, *prev;
+
+	start = (char *)TLSF_ROUND((size_t)mem);
+	end = (char *)(((size_t)mem + size) & ~((size_t) TLSF_ALIGN - 1));
+	if (end < start || (size_t)(end - start) < TLSF_MIN_BLOCK + TLSF_OVERHEAD)
+	{
+		return 0;
+	}
+
+	added = 0;
+	prev = NULL;
+	while ((size_t)(end - start) >= TLSF_MIN_BLOCK + TLSF_OVERHEAD)
+	{
+		bsize = (size_t)(end - start) - TLSF_OVERHEAD;
+		if (bsize > TLSF_MAX_BLOCK)
+		{
+			bsize = TLSF_MAX_BLOCK;
+		}
+		b = (TLSF_BLOCK *)start;
+		b->prev_phys = prev;
+		b->size = bsize | TLSF_FREE;
+		tlsf_insert(pool, b);
+		added += bsize;
+		prev = b;
+		start += bsize;
+	}
+
+	/* zero-sized block in use closing the area */
+	b = (TLSF_BLOCK *)start;
+	b->prev_phys = prev;
+	b->size = 0;
+
+	pool->total += added;
+	return added;
+}
+
+/*
+ * Allocate size bytes aligned on TLSF_ALIGN; returns NULL when no free
+ * block is large enough.
+ */
+void *tlsf_malloc(TLSF_POOL *pool, size_t size)
+{
+	size_t bsize, rest;
+	unsigned int fl, sl;
+	TLSF_BLOCK *b, *r;
+
+	if (size > TLSF_MAX_BLOCK - TLSF_OVERHEAD)
+	{
+		return NULL;
+	}
+	bsize = TLSF_ROUND(size + TLSF_OVERHEAD);
+	if (bsize < TLSF_MIN_BLOCK)
+	{
+		bsize = TLSF_MIN_BLOCK;
+	}
+
+	rest = bsize;
+	if (rest >= (1u << TLSF_FL_SHIFT))
+	{
+		rest += (1u << (tlsf_fls((unsigned int)rest) - TLSF_SL_LOG2)) - 1;
+	}
+	tlsf_mapping(rest, &fl, &sl);
+	if (fl >= TLSF_FL_COUNT)
+	{
+		return NULL;
+	}
+	b = tlsf_search(pool, fl, sl);
+	if (b == NULL)
+	{
+		return NULL;
+	}
+	tlsf_remove(pool, b);
+
+	rest = TLSF_SIZE(b) - bsize;
+	if (rest >= TLSF_MIN_BLOCK)
+	{
+		/* split off the tail of the block */
+		r = (TLSF_BLOCK *)((char *)b + bsize);
+		r->prev_phys = b;
+		r->size = rest | TLSF_FREE;
+		TLSF_NEXT_PHYS(r)->prev_phys = r;
+		tlsf_insert(pool, r);
+		b->size = bsize;
+	}
+	else
+	{
+		b->size = TLSF_SIZE(b);
+	}
+
+	pool->used += TLSF_SIZE(b);
+	if (pool->used > pool->max_used)
+	{
+		pool->max_used = pool->used;
+	}
+	return TLSF_PAYLOAD(b);
+}
+
+/*
+ * Release a block allocated by tlsf_malloc(); returns -1 when the header
+ * of the block says it is free, 0 otherwise.  A block released twice is
+ * not detected once it has been merged with a neighbour.
+ */
+int tlsf_free(TLSF_POOL *pool, void *ptr)
+{
+	TLSF_BLOCK *b, *n;
+
+	if (ptr == NULL)
+	{
+		return 0;
+	}
+	b = TLSF_HEADER(ptr);
+	if (TLSF_IS_FREE(b))
+	{
+		return -1;
+	}
+	pool->used -= TLSF_SIZE(b);
+
+	n = TLSF_NEXT_PHYS(b);
+	if (TLSF_IS_FREE(n) && TLSF_SIZE(b) + TLSF_SIZE(n) <= TLSF_MAX_BLOCK)
+	{
+		tlsf_remove(pool, n);
+		b->size = TLSF_SIZE(b) + TLSF_SIZE(n);
+	}
+	n = b->prev_phys;
+	if (n != NULL && TLSF_IS_FREE(n)
+		&& TLSF_SIZE(n) + TLSF_SIZE(b) <= TLSF_MAX_BLOCK)
+	{
+		tlsf_remove(pool, n);
+		n->size = TLSF_SIZE(n) + TLSF_SIZE(b);
+		b = n;
+	}
+	TLSF_NEXT_PHYS(b)->prev_phys = b;
+	b->size |= TLSF_FREE;
+	tlsf_insert(pool, b);
+	return 0;
+}
+
+/* usable size of an allocated block */
+size_t tlsf_block_size(const void *ptr)
+{
+	return TLSF_SIZE(TLSF_HEADER(ptr)) - TLSF_OVERHEAD;
+}
+
+/*
+ * Statistics; only the list holding the largest free blocks is walked.
+ */
+void tlsf_stat(const TLSF_POOL *pool, TLSF_STAT *stat)
+{
+	unsigned int fl;
+	size_t largest;
+	const TLSF_BLOCK *b;
+
+	stat->total = pool->total;
+	stat->used = pool->used;
+	stat->max_used = pool->max_used;
+	stat->free = pool->total - pool->used;
+
+	largest = 0;
+	if (pool->fl_bitmap != 0)
+	{
+		fl = tlsf_fls(pool->fl_bitmap);
+		b = pool->blocks[fl][tlsf_fls(pool->sl_bitmap[fl])];
+		for (; b != NULL; b = b->next_free)
+		{
+			if (TLSF_SIZE(b) > largest)
+			{
+				largest = TLSF_SIZE(b);
+			}
+		}
+	}
+	stat->largest = (largest != 0) ? largest - TLSF_OVERHEAD : 0;
+	stat->frag = (stat->free != 0)
+		? 100 - (unsigned int)((largest * 100) / stat->free) : 0;
+}
@@ -0,0 +1,104 @@
+/*****************************************************************************
+ * FILE: tlsf.h
+ *
+ * Two-Level Segregated Fit (TLSF) memory allocator
+ *
+ * Allocation and release take a bounded number of steps whatever the
+ * state of the pool, which makes the allocator usable from real-time
+ * code: the free blocks are kept in TLSF_FL_COUNT x TLSF_SL_COUNT
+ * segregated lists, and two levels of bitmaps find a non-empty list
+ * with a single count-leading-zeros each.
+ *
+ * The allocator has no locking of its own; the caller serializes the
+ * accesses to a pool (the JSP kernel under t_lock_cpu, the C++ new
+ * operators with the interrupts disabled).
+ *****************************************************************************/
+
+#ifndef _TLSF_H_
+#define _TLSF_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Block alignment (8 bytes, as required by double and long long under
+ * the ARM EABI) and number of second level lists per power of two
+ */
+#define TLSF_ALIGN_LOG2   3
+#define TLSF_ALIGN        (1u << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2      3
+#define TLSF_SL_COUNT     (1u << TLSF_SL_LOG2)
+
+/*
+ * Blocks are smaller than (1 << TLSF_FL_MAX) bytes; larger areas are
+ * cut into several blocks by tlsf_add_area().  The default covers the
+ * whole RAM of the NXT with one block.
+ */
+#ifndef TLSF_FL_MAX
+#define TLSF_FL_MAX       17
+#endif
+#define TLSF_FL_SHIFT     (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT     (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+
+/*
+ * Block header
+ *
+ * prev_phys and size are present in every block, the list links only
+ * in free blocks: they are the first bytes of the payload of a block
+ * in use.  size includes the header; its lowest bit is set while the
+ * block is free.
+ */
+typedef struct tlsf_block {
+	struct tlsf_block *prev_phys;	/* block just before in memory */
+	size_t size;			/* size of the block and free flag */
+	struct tlsf_block *next_free;	/* next block in the free list */
+	struct tlsf_block *prev_free;	/* previous block in the free list */
+} TLSF_BLOCK;
+
+#define TLSF_OVERHEAD     (offsetof(TLSF_BLOCK, next_free))
+
+/*
+ * Extra bytes an area needs besides the blocks carved out of it: the
+ * alignment of its start and the zero-sized block closing it
+ */
+#define TLSF_AREA_OVERHEAD (TLSF_ALIGN + TLSF_OVERHEAD)
+
+/*
+ * Pool
+ */
+typedef struct tlsf_pool {
+	unsigned int fl_bitmap;			/* non-empty first levels */
+	unsigned int sl_bitmap[TLSF_FL_COUNT];	/* non-empty lists */
+	TLSF_BLOCK *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+	size_t total;		/* bytes in blocks, headers included */
+	size_t used;		/* bytes in blocks in use */
+	size_t max_used;	/* high-water mark of used */
+} TLSF_POOL;
+
+/*
+ * Statistics
+ */
+typedef struct tlsf_stat {
+	size_t total;		/* bytes in blocks, headers included */
+	size_t used;		/* bytes in blocks in use */
+	size_t max_used;	/* high-water mark of used */
+	size_t free;		/* bytes in free blocks */
+	size_t largest;		/* payload of the largest free block */
+	unsigned int frag;	/* 100 - 100 * largest free block / free */
+} TLSF_STAT;
+
+extern void tlsf_init(TLSF_POOL *pool);
+extern size_t tlsf_add_area(TLSF_POOL *pool, void *mem, size_t size);
+extern void *tlsf_malloc(TLSF_POOL *pool, size_t size);
+extern int tlsf_free(TLSF_POOL *pool, void *ptr);
+extern size_t tlsf_block_size(const void *ptr);
+extern void tlsf_stat(const TLSF_POOL *pool, TLSF_STAT *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
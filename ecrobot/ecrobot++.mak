@@ -47,6 +47,9 @@ ifeq ($(TOPPERS_KERNEL), NXT_JSP)
 		interrupt.c \
 		mailbox.c \
 		mempfix.c \
+		mempvar.c \
+		messagebuf.c \
+		mutex.c \
 		semaphore.c \
 		startup.c \
 		sys_manage.c \
@@ -97,8 +100,10 @@ else
 		interrupt.c \
 		osctl.c	\
 		resource.c \
+		stack.c \
 		task.c \
-		task_manage.c )
+		task_manage.c \
+		trace.c )
 
 	TOPPERS_CONFIG_SOURCES = $(addprefix config/at91sam7s-gnu/, \
 		cpu_config.c )
@@ -129,11 +134,22 @@ ifndef ECROBOT_SOURCES
 ECROBOT_SOURCES = \
 	rtoscalls.c \
 	syscalls.c \
+	tlsf.c \
 	ecrobot_bluetooth.c \
+	ecrobot_telemetry.c \
 	ecrobot_base.c \
 	ecrobot.c
 endif
 
+# C++ library sources built with the application. Their objects come
+# before libecrobot++.a on the link line, so they replace the prebuilt
+# ones, which are older (the prebuilt Usb.o has no stream calls).
+ifndef ECROBOT_CPP_SOURCES
+ECROBOT_CPP_SOURCES = \
+	New.cpp \
+	Usb.cpp
+endif
+
 ################################################################################
 # leJOS NXJ specific settings
 #
@@ -167,7 +183,8 @@ S_RAMSOURCES = \
 	$(TOPPERS_SRAM_SOURCES)
 
 CPP_SOURCES = \
-	$(TARGET_CPP_SOURCES)
+	$(TARGET_CPP_SOURCES) \
+	$(ECROBOT_CPP_SOURCES)
 
 # using the new linker script
 LDSCRIPT_SOURCE = $(ECROBOT_C_ROOT)/sam7_ecrobot.lds
@@ -45,6 +45,9 @@ ifeq ($(TOPPERS_KERNEL), NXT_JSP)
 		interrupt.c \
 		mailbox.c \
 		mempfix.c \
+		mempvar.c \
+		messagebuf.c \
+		mutex.c \
 		semaphore.c \
 		startup.c \
 		sys_manage.c \
@@ -95,8 +98,10 @@ else
 		interrupt.c \
 		osctl.c	\
 		resource.c \
+		stack.c \
 		task.c \
-		task_manage.c )
+		task_manage.c \
+		trace.c )
 
 	TOPPERS_CONFIG_SOURCES = $(addprefix config/at91sam7s-gnu/, \
 		cpu_config.c )
@@ -126,7 +131,9 @@ TOPPERS_CFG_HEADER = ./kernel_id.h
 ifndef ECROBOT_SOURCES
 ECROBOT_SOURCES = \
 	syscalls.c \
+	tlsf.c \
 	ecrobot_bluetooth.c \
+	ecrobot_telemetry.c \
 	ecrobot_base.c \
 	ecrobot.c
 endif
@@ -0,0 +1,28 @@
+/* Host stand-in for the NXT headers that ecrobot_telemetry.c includes,
+ * for testing it on a Linux host.
+ *
+ * It is included first (see Makefile). The U32 and S32 of mytypes.h are
+ * longs, 64 bits wide on the host, so the types are defined here with
+ * the widths they have on the ARM. mytypes.h and ecrobot_interface.h,
+ * which pulls in the drivers, are kept out by their include guards.
+ */
+
+#ifndef TELEMETRY_HOST_H_
+#define TELEMETRY_HOST_H_
+
+#define __MTYPES_H__
+typedef unsigned char U8;
+typedef signed char S8;
+typedef unsigned short U16;
+typedef signed short S16;
+typedef unsigned int U32;
+typedef signed int S32;
+
+#define _ECROBOT_INTERFACE_H_
+#include "ecrobot_types.h"
+#include "ecrobot_telemetry.h"
+
+extern U32 systick_get_ms(void);
+extern SINT ecrobot_send_usb(U8 *buf, U32 off, U32 len);
+
+#endif
@@ -0,0 +1,217 @@
+/* telemetrytest.c - host round trip of the telemetry channel
+ *
+ * Takes NRECORDS records of one signal of each type with
+ * ecrobot_log_telemetry(), at steps of a few ms and with an occasional
+ * pause longer than TELEMETRY_FLUSH_MS, from a time just before
+ * systick_get_ms() wraps. The values jump over the whole range of
+ * their types. The output function refuses about one frame in twelve,
+ * and writes the others to STREAM.bin with the 2 byte length header of
+ * ecrobot_send_bt_packet().
+ *
+ * The records of each data frame the link takes are written to
+ * EXPECTED.csv as ../utils/telemetry_decode.py should decode them, and
+ * the line it should print on stderr to EXPECTED.txt (see Makefile). A
+ * failed check here exits with 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ecrobot_telemetry.h"
+
+#define NRECORDS	2000
+#define NSIGNALS	6
+#define START_MS	(0xFFFFFFFFu - 1500u)
+
+static S8 s8;
+static U8 u8;
+static S16 s16;
+static U16 u16;
+static S32 s32;
+static U32 u32;
+
+static U32 now = START_MS;
+
+/* records taken and not yet sent, oldest first */
+static U32 pendingTime[NRECORDS];
+static S32 pendingValue[NRECORDS][NSIGNALS];
+static U32 pendingFirst, pendingCount;
+
+static FILE *streamFile, *expectedFile;
+static U32 accepted, refused, lost, refusedSinceAccepted;
+static U32 skipped, records;
+static int schemaSeen, errors;
+
+static U32 random_state = 12345;
+
+static U32 random_u32(void)
+{
+	random_state = random_state * 1103515245u + 12345u;
+	return (random_state >> 16) | (random_state << 16);
+}
+
+U32 systick_get_ms(void)
+{
+	return now;
+}
+
+SINT ecrobot_send_usb(U8 *buf, U32 off, U32 len)
+{
+	return 0;
+}
+
+/* write the first n records taken */
+static void expect(U32 n)
+{
+	U32 i, j;
+
+	for (i = pendingFirst; i < pendingFirst + n; i++)
+	{
+		fprintf(expectedFile, "%u", pendingTime[i]);
+		for (j = 0; j < NSIGNALS - 1; j++)
+		{
+			fprintf(expectedFile, ",%d", pendingValue[i][j]);
+		}
+		fprintf(expectedFile, ",%u\n", (U32)pendingValue[i][j]);
+	}
+}
+
+/* output function: refuses some frames, writes the others */
+static U32 send(U8 *buf, U32 len)
+{
+	U8 header[2];
+	U32 n, sent;
+
+	n = 0;
+	if (buf[0] == TELEMETRY_FRAME_DATA)
+	{
+		n = buf[8];
+		if (n == 0 || n > pendingCount)
+		{
+			printf("telemetrytest: data frame of %u records, %u taken\n",
+				n, pendingCount);
+			errors++;
+			n = pendingCount;
+		}
+	}
+
+	if (random_u32() % 12 == 0)
+	{
+		refused++;
+		refusedSinceAccepted++;
+		sent = 0;
+	}
+	else
+	{
+		/* the decoder counts the gaps between the frames it sees */
+		if (accepted != 0)
+		{
+			lost += refusedSinceAccepted;
+		}
+		refusedSinceAccepted = 0;
+		accepted++;
+		if (buf[0] == TELEMETRY_FRAME_SCHEMA)
+		{
+			schemaSeen = 1;
+		}
+		else if (!schemaSeen)
+		{
+			skipped++;
+		}
+		else
+		{
+			expect(n);
+			records += n;
+		}
+		header[0] = (U8)len;
+		header[1] = (U8)(len >> 8);
+		fwrite(header, 1, 2, streamFile);
+		fwrite(buf, 1, len, streamFile);
+		sent = len;
+	}
+	pendingFirst += n;
+	pendingCount -= n;
+	return sent;
+}
+
+/* the values of the next record */
+static void step(U32 k)
+{
+	U32 r = random_u32();
+
+	s8 = (S8)(s8 + 37);
+	u8 = (U8)(k % 7 == 0 ? r : u8 + 1u);
+	s16 = (S16)(k % 100 < 50 ? s16 + 700 : s16 - 700);
+	u16 = (U16)r;
+	s32 = k % 97 == 0 ? (S32)0x80000000u : k % 89 == 0 ? 0x7FFFFFFF : s32 + (S32)(r % 2001) - 1000;
+	u32 = k % 5 == 0 ? r : u32 + k;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *summary;
+	U32 k, i;
+
+	if (argc != 4 || (streamFile = fopen(argv[1], "wb")) == NULL ||
+		(expectedFile = fopen(argv[2], "w")) == NULL ||
+		(summary = fopen(argv[3], "w")) == NULL)
+	{
+		fprintf(stderr, "usage: telemetrytest STREAM.bin EXPECTED.csv EXPECTED.txt\n");
+		return 2;
+	}
+	fprintf(expectedFile, "time,s8,u8,s16,u16,s32,u32\n");
+
+	ecrobot_init_telemetry(send, 0);
+	if (ecrobot_add_telemetry_signal("s8", TELEMETRY_S8, &s8) != 0 ||
+		ecrobot_add_telemetry_signal("u8", TELEMETRY_U8, &u8) != 1 ||
+		ecrobot_add_telemetry_signal("s16", TELEMETRY_S16, &s16) != 2 ||
+		ecrobot_add_telemetry_signal("u16", TELEMETRY_U16, &u16) != 3 ||
+		ecrobot_add_telemetry_signal("s32", TELEMETRY_S32, &s32) != 4 ||
+		ecrobot_add_telemetry_signal("u32", TELEMETRY_U32, &u32) != 5)
+	{
+		printf("telemetrytest: signals not added\n");
+		return 1;
+	}
+
+	for (k = 0; k < NRECORDS; k++)
+	{
+		now += k % 50 == 49 ? TELEMETRY_FLUSH_MS + 50 : 1 + random_u32() % 4;
+		step(k);
+		i = pendingFirst + pendingCount++;
+		pendingTime[i] = now;
+		pendingValue[i][0] = s8;
+		pendingValue[i][1] = u8;
+		pendingValue[i][2] = s16;
+		pendingValue[i][3] = u16;
+		pendingValue[i][4] = s32;
+		pendingValue[i][5] = (S32)u32;
+		ecrobot_log_telemetry();
+	}
+	ecrobot_flush_telemetry();
+
+	if (pendingCount != 0)
+	{
+		printf("telemetrytest: %u records not sent\n", pendingCount);
+		errors++;
+	}
+	if (ecrobot_get_telemetry_dropped() != refused)
+	{
+		printf("telemetrytest: %u frames dropped, %u refused\n",
+			ecrobot_get_telemetry_dropped(), refused);
+		errors++;
+	}
+	if (now >= START_MS)
+	{
+		printf("telemetrytest: the time did not wrap\n");
+		errors++;
+	}
+
+	fprintf(summary, "%u frames, %u lost, %u before the schema, %u records, %u signals\n",
+		accepted, lost, skipped, records, NSIGNALS);
+	fclose(streamFile);
+	fclose(expectedFile);
+	fclose(summary);
+	printf("telemetrytest: %u records sent in %u frames, %u frames refused\n",
+		records, accepted, refused);
+	return errors ? 1 : 0;
+}
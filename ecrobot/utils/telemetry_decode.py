@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+#
+# telemetry_decode.py - decoder for the ecrobot telemetry channel
+#
+# Reads the frames sent by ecrobot_log_telemetry() (ecrobot/c/
+# ecrobot_telemetry.c) and writes one column per signal, with the time
+# of each record in ms in the first column.
+#
+# usage: telemetry_decode.py [-b] [-f csv|parquet] [-o OUT] STREAM.bin
+#
+#   -b        input was captured from Bluetooth: every packet starts with
+#             the 2 byte length header of ecrobot_send_bt_packet()
+#   -f FMT    output format: csv (default) or parquet (needs pyarrow)
+#   -o OUT    output file (default: STREAM.csv or STREAM.parquet)
+#
+# Frames lost on the link show as gaps in the sequence numbers and are
+# counted on stderr; their records are simply missing from the output.
+
+import argparse
+import struct
+import sys
+
+FRAME_SCHEMA = 0xD0
+FRAME_DATA = 0xD1
+
+# type: (bits, signed)
+TYPES = {
+    0: (8, True),       # TELEMETRY_S8
+    1: (8, False),      # TELEMETRY_U8
+    2: (16, True),      # TELEMETRY_S16
+    3: (16, False),     # TELEMETRY_U16
+    4: (32, True),      # TELEMETRY_S32
+    5: (32, False),     # TELEMETRY_U32
+}
+
+
+def strip_bt_headers(data):
+    """Remove the 2 byte little endian length header of each BT packet."""
+    out = bytearray()
+    pos = 0
+    while pos + 2 <= len(data):
+        (length,) = struct.unpack_from("<H", data, pos)
+        pos += 2
+        out += data[pos:pos + length]
+        pos += length
+    return bytes(out)
+
+
+def frames(data):
+    """Yield (type, seq, body) for each frame, skipping unknown bytes."""
+    pos = 0
+    while pos + 4 <= len(data):
+        typ, length = data[pos], data[pos + 1]
+        if typ not in (FRAME_SCHEMA, FRAME_DATA) or pos + 2 + length > len(data):
+            pos += 1
+            continue
+        (seq,) = struct.unpack_from("<H", data, pos + 2)
+        yield typ, seq, data[pos + 4:pos + 2 + length]
+        pos += 2 + length
+
+
+def varint(body, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = body[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, pos
+
+
+def to_type(value, typ):
+    """Reduce an accumulated 32 bit value to the range of the signal type."""
+    bits, signed = TYPES.get(typ, (32, True))
+    value &= (1 << bits) - 1
+    if signed and value >= 1 << (bits - 1):
+        value -= 1 << bits
+    return value
+
+
+class Decoder:
+    def __init__(self):
+        self.signals = []       # [(name, type)]
+        self.pending = {}       # schema entries by index, until complete
+        self.columns = None     # {"time": [...], name: [...]}
+        self.last_seq = None
+        self.frames = 0
+        self.lost = 0
+        self.skipped = 0
+
+    def schema(self, body):
+        first, total = body[0], body[1]
+        pos = 2
+        index = first
+        while pos + 2 <= len(body):
+            typ, length = body[pos], body[pos + 1]
+            name = body[pos + 2:pos + 2 + length].decode("ascii", "replace")
+            self.pending[index] = (name, typ)
+            index += 1
+            pos += 2 + length
+        if all(i in self.pending for i in range(total)):
+            signals = [self.pending[i] for i in range(total)]
+            self.pending = {}
+            if signals != self.signals:
+                if self.columns is not None and self.columns["time"]:
+                    print("warning: schema changed, the %d records before "
+                          "are dropped" % len(self.columns["time"]),
+                          file=sys.stderr)
+                self.signals = signals
+                self.columns = {"time": []}
+                for name, _ in signals:
+                    self.columns[name] = []
+
+    def data(self, body):
+        if self.columns is None:
+            self.skipped += 1       # no schema yet
+            return
+        time, count = struct.unpack_from("<IB", body, 0)
+        pos = 5
+        values = [0] * len(self.signals)
+        names = [name for name, _ in self.signals]
+        for _ in range(count):
+            step, pos = varint(body, pos)
+            time = (time + step) & 0xFFFFFFFF
+            self.columns["time"].append(time)
+            for i, (name, typ) in enumerate(self.signals):
+                zz, pos = varint(body, pos)
+                values[i] = (values[i] + ((zz >> 1) ^ -(zz & 1))) & 0xFFFFFFFF
+                self.columns[names[i]].append(to_type(values[i], typ))
+
+    def feed(self, typ, seq, body):
+        if self.last_seq is not None:
+            self.lost += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+        self.frames += 1
+        if typ == FRAME_SCHEMA:
+            self.schema(body)
+        else:
+            self.data(body)
+
+
+def write_csv(path, columns):
+    names = list(columns)
+    with open(path, "w") as out:
+        out.write(",".join(names) + "\n")
+        for row in zip(*(columns[n] for n in names)):
+            out.write(",".join(str(v) for v in row) + "\n")
+
+
+def write_parquet(path, columns):
+    try:
+        import pyarrow
+        import pyarrow.parquet
+    except ImportError:
+        sys.exit("parquet output needs pyarrow")
+    pyarrow.parquet.write_table(pyarrow.table(columns), path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="ecrobot telemetry decoder")
+    parser.add_argument("-b", action="store_true",
+                        help="input has Bluetooth packet headers")
+    parser.add_argument("-f", choices=("csv", "parquet"), default="csv",
+                        help="output format")
+    parser.add_argument("-o", help="output file")
+    parser.add_argument("stream", help="captured byte stream")
+    args = parser.parse_args()
+
+    with open(args.stream, "rb") as f:
+        data = f.read()
+    if args.b:
+        data = strip_bt_headers(data)
+
+    decoder = Decoder()
+    for typ, seq, body in frames(data):
+        decoder.feed(typ, seq, body)
+    if decoder.columns is None:
+        sys.exit("no schema found in %s" % args.stream)
+
+    out = args.o or args.stream.rsplit(".", 1)[0] + "." + args.f
+    if args.f == "csv":
+        write_csv(out, decoder.columns)
+    else:
+        write_parquet(out, decoder.columns)
+    print("%d frames, %d lost, %d before the schema, %d records, %d signals"
+          % (decoder.frames, decoder.lost, decoder.skipped,
+             len(decoder.columns["time"]), len(decoder.signals)),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
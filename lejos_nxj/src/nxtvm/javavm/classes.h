@@ -33,6 +33,9 @@
 #define is_allocated(OBJ_)       ((OBJ_)->flags.freeBlock.isAllocated)
 #define get_monitor_count(OBJ_)  ((OBJ_)->monitorCount)
 #define is_gc(OBJ_)              ((OBJ_)->flags.objects.mark)
+#define is_gc_marked(OBJ_)       (((OBJ_)->flags.all & GC_MASK) != 0)
+#define set_gc_marked(OBJ_)      ((OBJ_)->flags.all |= GC_MASK)
+#define clear_gc_marked(OBJ_)    ((OBJ_)->flags.all &= ~GC_MASK)
 
 // Double-check these data structures with the 
 // Java declaration of each corresponding class.
@@ -87,7 +90,9 @@ typedef struct S_Object
    } __attribute__((packed)) flags;
 
   /**
-   * Synchronization state.
+   * Synchronization state. Bits 0-6 of monitorCount are the number
+   * of times threadId has entered the monitor (at most 127). Bit 7
+   * is set while other threads wait to enter it.
    */
   byte monitorCount;
   byte threadId;
@@ -45,6 +45,17 @@
  */
 #define SEGMENTED_HEAP                 0
 
+/**
+ * If not 0, each heap region ends with a map of where allocated
+ * blocks start, one bit per MEMORY_ALIGNMENT words (1/33 of the
+ * region), which the garbage collector rebuilds to check words of
+ * thread stacks in constant time. If 0, each such word is checked
+ * by walking its region.
+ */
+#ifndef GC_BLOCK_MAP
+#define GC_BLOCK_MAP                     1
+#endif
+
 /**
  * Iff not 0, threads in the DEAD state are
  * removed from the circular list. Recommended.
@@ -62,4 +73,71 @@
  */
 #define PI_AVOIDANCE                     1
 
+/**
+ * Number of contended monitors that get a queue of their own.
+ * Waiters of any others share one queue, which is searched
+ * when their monitor is released.
+ */
+#define MAX_MONITOR_RECORDS              4
+
+/**
+ * If not 0, the interpreter jumps from instruction to instruction
+ * through a table of label addresses (a GCC extension) instead of a
+ * switch, and thread switch and tick requests are only checked on
+ * backward branches, method calls and returns and instructions that
+ * may throw, block or allocate.
+ */
+#ifndef COMPUTED_GOTO
+#define COMPUTED_GOTO                    0
+#endif
+
+/**
+ * Number of entries in the cache of methods found by virtual
+ * calls. Must be a power of two. If 0, every call searches the
+ * method tables of the receiver's class and its superclasses.
+ */
+#ifndef METHOD_CACHE_SIZE
+#define METHOD_CACHE_SIZE                32
+#endif
+
+/**
+ * Number of Strings made for string constants that are kept, so
+ * that loading the same constant again returns the String already
+ * built instead of a new one. Must be a power of two. If 0, every ldc
+ * of a string builds a new String. Only loads of the same constant
+ * record share a String, and only until another constant takes its
+ * entry; equal literals are not guaranteed to be the same object.
+ */
+#ifndef STRING_CACHE_SIZE
+#define STRING_CACHE_SIZE                16
+#endif
+
+/**
+ * Number of (method, pc) pairs the sampling profiler can count
+ * (see profiler.c). Must be a power of two. Each takes 8 bytes
+ * of RAM. If 0, nothing is profiled.
+ */
+#ifndef PROFILER_ENTRIES
+#define PROFILER_ENTRIES                 0
+#endif
+
+/**
+ * Bytes of RAM for copies of frequently run methods (see quicken.c).
+ * If 0, methods always run from the binary.
+ */
+#ifndef QUICKEN_BUFFER_SIZE
+#define QUICKEN_BUFFER_SIZE              1024
+#endif
+
+/**
+ * Number of methods that can be copied. Must be a power of two.
+ */
+#define QUICKEN_MAX_METHODS              16
+
+/**
+ * Number of calls and backward branches after which a method is
+ * copied. Must be less than 255.
+ */
+#define QUICKEN_THRESHOLD                16
+
 #endif
@@ -17,6 +17,7 @@
 #include "stack.h"
 
 #include "platform_hooks.h"
+#include "quicken.h"
 
 Object *outOfMemoryError;
 Object *noSuchMethodError;
@@ -36,6 +37,7 @@ Object *error;
 static TWOBYTES tempCurrentOffset;
 static MethodRecord *tempMethodRecord = null;
 static StackFrame *tempStackFrame;
+static byte *tempCodeBase;
 static ExceptionRecord *gExceptionRecord;
 static byte gNumExceptionHandlers;
 static MethodRecord *gExcepMethodRec = null;
@@ -104,7 +106,8 @@ void throw_exception (Object *exception)
   if (gExcepMethodRec == null)
     gExcepMethodRec = tempMethodRecord;
   gExceptionRecord = (ExceptionRecord *) (get_binary_base() + tempMethodRecord->exceptionTable);
-  tempCurrentOffset = ptr2word(pc) - ptr2word(get_binary_base() + tempMethodRecord->codeOffset);
+  tempCodeBase = get_code_base (tempMethodRecord, pc);
+  tempCurrentOffset = ptr2word(pc) - ptr2word(tempCodeBase);
 
   #if 0
   trace (-1, tempCurrentOffset, 5);
@@ -127,8 +130,7 @@ void throw_exception (Object *exception)
         // Push the exception object
         push_ref (ptr2word (exception));
         // Jump to handler:
-        pc = get_binary_base() + tempMethodRecord->codeOffset + 
-             gExceptionRecord->handler;
+        pc = tempCodeBase + gExceptionRecord->handler;
 #if DEBUG_EXCEPTIONS
   printf("Found exception handler\n");
 #endif
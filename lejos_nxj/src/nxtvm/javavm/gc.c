@@ -1,24 +1,73 @@
 /**
  * gc.c
  * Garbage collection routines
+ *
+ * Stop-the-world mark and sweep collector, run by memcheck_allocate()
+ * when the heap has no block large enough for a request.
+ *
+ * The roots are the static fields, the preallocated exceptions, the
+ * poller, the objects passed to gc_protect() and the threads. Thread
+ * stacks do not record which words are references, so every word of
+ * the used part of a stack that is the address of an allocated block
+ * is taken as one.
+ *
+ * Marked objects are scanned from a small fixed stack. When it
+ * overflows, the objects that could not be pushed stay marked and the
+ * heap is walked again to scan every marked object, until a walk ends
+ * without overflow.
  */
- 
+
+#include <stddef.h>
+
+#include "types.h"
 #include "trace.h"
+#include "constants.h"
+#include "specialclasses.h"
 #include "classes.h"
 #include "language.h"
+#include "threads.h"
+#include "exceptions.h"
+#include "memory.h"
+#include "poll.h"
+#include "interpreter.h"
+#include "gc.h"
 
-byte gCurrentMark = 0;
+/**
+ * Number of objects waiting to be scanned.
+ */
+#define MARK_STACK_SIZE 32
 
+static Object *markStack[MARK_STACK_SIZE];
+static byte markStackTop;
+static boolean markOverflow;
 
+static Object *protectedObjects[MAX_PROTECTED_OBJECTS];
+static byte numProtected;
 
-void mark_and_sweep()
+/**
+ * Keeps obj alive while it is only referenced from C code.
+ * Calls must be paired with gc_unprotect.
+ */
+void gc_protect (Object *obj)
 {
+  #ifdef VERIFY
+  assert (numProtected < MAX_PROTECTED_OBJECTS, GC1);
+  #endif
+  protectedObjects[numProtected++] = obj;
+}
 
-$TBD
-	
+void gc_unprotect ()
+{
+  #ifdef VERIFY
+  assert (numProtected > 0, GC2);
+  #endif
+  numProtected--;
 }
 
-void mark (Object *obj)
+/**
+ * Marks obj and queues it for scanning if it may hold references.
+ */
+static void mark (Object *obj)
 {
   if (obj == JNULL)
     return;
@@ -30,32 +79,281 @@ void mark (Object *obj)
   if (is_gc_marked (obj))
     return;
   set_gc_marked (obj);
+  if (is_array (obj) && get_element_type (obj) != T_REFERENCE)
+    return;
+  if (markStackTop < MARK_STACK_SIZE)
+    markStack[markStackTop++] = obj;
+  else
+    markOverflow = true;
+}
+
+/**
+ * Marks a word read from a stack if it is a reference.
+ */
+static void mark_conservative (STACKWORD word)
+{
+  if (word != JNULL && is_allocated_block (word2ptr (word)))
+    mark (word2obj (word));
+}
+
+/**
+ * @return Number of words at the bottom of a thread's stack that may
+ *         be in use: up to the end of the operand stack of its top
+ *         frame. The arguments of a native method, which are popped
+ *         before it is called, lie below that end, but above the
+ *         stack top, which is also out of date in the frame of the
+ *         running thread.
+ */
+static TWOBYTES used_stack_words (Thread *thread, Object *arr)
+{
+  STACKWORD *words = word_array (arr);
+  TWOBYTES length = get_array_length (arr);
+  StackFrame *frame;
+  int used;
+
+  if (thread->stackFrameArraySize == 0)
+  {
+    // A thread being started holds the argument of its entry method
+    if (thread != currentThread)
+      return 0;
+    used = stackTop - words + 1;
+  }
+  else
+  {
+    frame = (StackFrame *) array_start (word2obj (thread->stackFrameArray)) +
+            (thread->stackFrameArraySize - 1);
+    used = frame->localsBase - words + frame->methodRecord->numLocals +
+           frame->methodRecord->maxOperands;
+  }
+  if (used < 0)
+    return 0;
+  return used < length ? used : length;
+}
+
+/**
+ * Marks what a thread refers to natively: its stacks, the
+ * monitors of its frames and the monitor it waits for.
+ */
+static void mark_thread_state (Thread *thread)
+{
+  Object *arr;
+  STACKWORD *words;
+  StackFrame *frames;
+  TWOBYTES i;
+
+  if (thread->waitingOn != JNULL)
+    mark (word2obj (thread->waitingOn));
+
+  if (thread->stackFrameArray != JNULL)
+  {
+    arr = word2obj (thread->stackFrameArray);
+    mark (arr);
+    frames = (StackFrame *) array_start (arr);
+    for (i = 0; i < thread->stackFrameArraySize; i++)
+      mark (frames[i].monitor);
+  }
+
+  if (thread->stackArray != JNULL)
+  {
+    arr = word2obj (thread->stackArray);
+    mark (arr);
+    words = word_array (arr);
+    for (i = used_stack_words (thread, arr); i-- > 0; )
+      mark_conservative (words[i]);
+  }
+}
+
+/**
+ * Marks the objects obj refers to.
+ */
+static void scan (Object *obj)
+{
   if (is_array (obj))
   {
     if (get_element_type (obj) == T_REFERENCE)
     {
-      unsigned short i;
-      unsigned short length = get_array_length (obj);
+      TWOBYTES i;
       REFERENCE *refarr = ref_array (obj);
-      
-      for (i = 0; i < length; i++)
-	mark (refarr[i]);
+
+      for (i = get_array_length (obj); i-- > 0; )
+        mark (ref2obj (refarr[i]));
     }
   }
   else
   {
     ClassRecord *classRecord;
     byte classIndex;
-    
+    byte i;
+    TWOBYTES offset;
+    TWOBYTES fieldOffset;
+    TWOBYTES fieldsSize;
+    STACKWORD word;
+
+    // Fields are laid out from the root class down,
+    // so they are scanned backwards from the end.
+    offset = HEADER_SIZE;
+    classIndex = get_na_class_index (obj);
+    for (;;)
+    {
+      classRecord = get_class_record (classIndex);
+      for (i = 0; i < classRecord->numInstanceFields; i++)
+        offset += typeSize[get_field_type (classRecord, i)];
+      if (classIndex == JAVA_LANG_OBJECT)
+        break;
+      classIndex = classRecord->parentClass;
+    }
+
     classIndex = get_na_class_index (obj);
     for (;;)
     {
       classRecord = get_class_record (classIndex);
-      // Mark fields of type REFERENCE.
-      mark_reference_fields (obj, classRecord);
+      fieldsSize = 0;
+      for (i = 0; i < classRecord->numInstanceFields; i++)
+        fieldsSize += typeSize[get_field_type (classRecord, i)];
+      offset -= fieldsSize;
+
+      fieldOffset = offset;
+      for (i = 0; i < classRecord->numInstanceFields; i++)
+      {
+        byte fieldType = get_field_type (classRecord, i);
+
+        // The fields of Thread that the VM keeps (struct S_Thread)
+        // are native words, not in the byte order of the Java fields
+        // that make_word reads, so mark_thread_state covers them.
+        if (fieldType == T_REFERENCE &&
+            (classIndex != JAVA_LANG_THREAD || fieldOffset > offsetof (Thread, daemon)))
+        {
+          make_word ((byte *) obj + fieldOffset, 4, &word);
+          mark (word2obj (word));
+        }
+        fieldOffset += typeSize[fieldType];
+      }
+      if (classIndex == JAVA_LANG_THREAD)
+        mark_thread_state ((Thread *) obj);
       if (classIndex == JAVA_LANG_OBJECT)
-	break;
-      classIndex = classRecord -> parentClass;
-    } 
+        break;
+      classIndex = classRecord->parentClass;
+    }
+  }
+}
+
+/**
+ * Scans the queued objects until there are none left.
+ */
+static void drain_mark_stack ()
+{
+  while (markStackTop > 0)
+    scan (markStack[--markStackTop]);
+}
+
+/**
+ * Marks the threads in a queue that ends with null.
+ */
+static void mark_thread_list (Thread *thread)
+{
+  while (thread != null)
+  {
+    mark ((Object *) thread);
+    drain_mark_stack ();
+    thread = (Thread *) word2ptr (thread->nextThread);
+  }
+}
+
+/**
+ * Scans a marked object found by walking the heap.
+ */
+static void rescan (Object *obj)
+{
+  scan (obj);
+  drain_mark_stack ();
+}
+
+static void mark_roots ()
+{
+  MasterRecord *mrec;
+  STATICFIELD *fields;
+  STATICFIELD fieldRecord;
+  STACKWORD word;
+  Thread *thread;
+  TWOBYTES i;
+
+  // Static fields
+  mrec = get_master_record();
+  fields = (STATICFIELD *) get_static_fields_base();
+  for (i = 0; i < mrec->numStaticFields; i++)
+  {
+    fieldRecord = fields[i];
+    if (((fieldRecord >> 12) & 0x0F) == T_REFERENCE)
+    {
+      make_word (get_static_state_base() + get_static_field_offset (fieldRecord), 4, &word);
+      mark (word2obj (word));
+      drain_mark_stack ();
+    }
   }
+
+  // Preallocated exceptions
+  mark (outOfMemoryError);
+  mark (noSuchMethodError);
+  mark (stackOverflowError);
+  mark (nullPointerException);
+  mark (classCastException);
+  mark (arithmeticException);
+  mark (arrayIndexOutOfBoundsException);
+  mark (illegalArgumentException);
+  mark (interruptedException);
+  mark (illegalStateException);
+  mark (illegalMonitorStateException);
+  mark (error);
+  drain_mark_stack ();
+
+  mark ((Object *) poller);
+  #if STRING_CACHE_SIZE
+  for (i = 0; i < STRING_CACHE_SIZE; i++)
+    mark (stringCache[i]);
+  #endif
+  for (i = 0; i < numProtected; i++)
+    mark (protectedObjects[i]);
+  drain_mark_stack ();
+
+  // Threads
+  mark ((Object *) bootThread);
+  mark ((Object *) currentThread);
+  drain_mark_stack ();
+  for (i = 0; i < 10; i++)
+  {
+    thread = threadQ[i];
+    if (thread == null)
+      continue;
+    do
+    {
+      mark ((Object *) thread);
+      drain_mark_stack ();
+      thread = (Thread *) word2ptr (thread->nextThread);
+    } while (thread != threadQ[i]);
+  }
+  mark_thread_list (sleepQ);
+  mark_thread_list (waitQ);
+  mark_thread_list (monitorQ);
+  #if MAX_MONITOR_RECORDS
+  for (i = 0; i < MAX_MONITOR_RECORDS; i++)
+    mark_thread_list (monitorRecords[i].waiters);
+  #endif
+}
+
+void mark_and_sweep ()
+{
+  markStackTop = 0;
+  markOverflow = false;
+
+  #if GC_BLOCK_MAP
+  map_allocated_blocks();
+  #endif
+  mark_roots();
+  while (markOverflow)
+  {
+    markOverflow = false;
+    scan_marked_blocks (rescan);
+  }
+
+  sweep_heap();
 }
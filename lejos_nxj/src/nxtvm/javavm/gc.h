@@ -0,0 +1,18 @@
+
+#include "types.h"
+#include "classes.h"
+
+#ifndef _GC_H
+#define _GC_H
+
+/**
+ * Maximum number of objects held only by C code
+ * (see gc_protect).
+ */
+#define MAX_PROTECTED_OBJECTS 4
+
+extern void mark_and_sweep ();
+extern void gc_protect (Object *obj);
+extern void gc_unprotect ();
+
+#endif // _GC_H
@@ -15,10 +15,32 @@
 #include "fields.h"
 #include "stack.h"
 #include "poll.h"
+#include "gc.h"
+#include "quicken.h"
+#include "profiler.h"
 
 
 #define F_OFFSET_MASK  0x0F
 
+/**
+ * OPCODE(OP_) starts the code of an instruction in the op_*.hc files.
+ * Instructions that cannot throw, block or branch backwards end with
+ * NEXT_INSTRUCTION, which with COMPUTED_GOTO jumps straight to the
+ * next one without checking for requests. The others go through
+ * LABEL_ENGINELOOP.
+ */
+#if COMPUTED_GOTO
+#define OPCODE(OP_)       LABEL_##OP_
+#else
+#define OPCODE(OP_)       case OP_
+#endif
+
+#if COMPUTED_GOTO && !DEBUG_BYTECODE
+#define NEXT_INSTRUCTION  goto *dispatchTable[*pc++]
+#else
+#define NEXT_INSTRUCTION  goto LABEL_ENGINELOOP
+#endif
+
 #if DEBUG_BYTECODE
 extern char *OPCODE_NAME[];
 #endif
@@ -44,17 +66,26 @@ JSHORT tempInt;
   
 /**
  * Assumes pc points to 2-byte offset, and jumps.
+ * @return true iff the jump was taken backwards.
  */
-void do_goto (boolean aCond)
+boolean do_goto (boolean aCond)
 {
   if (aCond)
   {
-    pc += (JSHORT) (((TWOBYTES) *pc << 8) | *(pc+1));
+    JSHORT offset = (JSHORT) (((TWOBYTES) *pc << 8) | *(pc+1));
+
+    pc += offset;
     pc--;
+    #if QUICKEN_BUFFER_SIZE
+    if (offset <= 0 && !is_quick_code (pc))
+      pc = get_quick_pc (pc);
+    #endif
+    return offset <= 0;
   }
   else
   {
     pc += 2;
+    return false;
   }
 }
 
@@ -82,9 +113,44 @@ void do_fcmp (JFLOAT f1, JFLOAT f2, STACKWORD def)
 
 #endif
 
+#if STRING_CACHE_SIZE
+
+/**
+ * Strings made for string constants, indexed by a hash of the
+ * constant record, which is kept in stringCacheKeys.
+ */
+Object *stringCache[STRING_CACHE_SIZE];
+static ConstantRecord *stringCacheKeys[STRING_CACHE_SIZE];
+
+#define get_string_cache_index(CR_) \
+  ((ptr2word (CR_) >> 2) & (STRING_CACHE_SIZE - 1))
+
+#endif
+
+/**
+ * Empties the string cache. Must be called when the heap is reset.
+ */
+void clear_string_cache ()
+{
+  #if STRING_CACHE_SIZE
+  TWOBYTES i;
+
+  for (i = 0; i < STRING_CACHE_SIZE; i++)
+  {
+    stringCache[i] = JNULL;
+    stringCacheKeys[i] = null;
+  }
+  #endif
+}
+
 /**
  * @return A String instance, or JNULL if an exception was thrown
  *         or the static initializer of String had to be executed.
+ *         Strings are immutable, so one found in the cache is
+ *         returned as it is. The cache is keyed by constant record
+ *         and an entry is replaced by the next constant that hashes
+ *         to it, so two loads only give the same String if they are
+ *         of the same record and it stayed cached in between.
  */
 static inline Object *create_string (ConstantRecord *constantRecord, 
                                      byte *btAddr)
@@ -93,10 +159,19 @@ static inline Object *create_string (ConstantRecord *constantRecord,
   Object *arr;
   TWOBYTES i;
 
+  #if STRING_CACHE_SIZE
+  TWOBYTES cacheIndex = get_string_cache_index (constantRecord);
+
+  if (stringCacheKeys[cacheIndex] == constantRecord)
+    return stringCache[cacheIndex];
+  #endif
+
   ref = new_object_checked (JAVA_LANG_STRING, btAddr);
   if (ref == JNULL)
     return JNULL;
+  gc_protect (ref);
   arr = new_primitive_array (T_CHAR, constantRecord->constantSize);
+  gc_unprotect ();
   if (arr == JNULL)
   {
     deallocate (obj2ptr(ref), class_size (JAVA_LANG_STRING));    
@@ -113,6 +188,11 @@ static inline Object *create_string (ConstantRecord *constantRecord,
 
     //printf ("char %d: %c\n", i, (char) (jchar_array(arr)[i])); 
   }
+
+  #if STRING_CACHE_SIZE
+  stringCache[cacheIndex] = ref;
+  stringCacheKeys[cacheIndex] = constantRecord;
+  #endif
   return ref;
 }
 
@@ -173,6 +253,13 @@ void engine()
 
   int lgginst = 0;
 
+  #if COMPUTED_GOTO
+  static const void * const dispatchTable[256] =
+  {
+    #include "op_table.hc"
+  };
+  #endif
+
   assert( currentThread != null, INTERPRETER0);
 
   schedule_request( REQUEST_SWITCH_THREAD);
@@ -197,7 +284,10 @@ void engine()
     }
 
     if( requestCode == REQUEST_TICK)
+    {
+      profile_tick();
       ticks_until_switch--;
+    }
 
     if( requestCode == REQUEST_SWITCH_THREAD
         || ticks_until_switch == 0){
@@ -230,10 +320,15 @@ void engine()
   printf ("OPCODE (0x%X) %s\n", (int) *pc, OPCODE_NAME[*pc]);
   #endif
 
+  #if COMPUTED_GOTO
+  goto *dispatchTable[*pc++];
+  {
+  #else
   switch (*pc++)
   {
-    case OP_NOP:
-        goto LABEL_ENGINELOOP;
+  #endif
+    OPCODE(OP_NOP):
+        NEXT_INSTRUCTION;
 
     #include "op_stack.hc"
     #include "op_locals.hc"
@@ -245,6 +340,9 @@ void engine()
     #include "op_logical.hc"
     #include "op_arithmetic.hc"
     #include "op_methods.hc"
+    #if QUICKEN_BUFFER_SIZE
+    #include "op_quick.hc"
+    #endif
 
 /*
 #ifdef VERIFY
@@ -259,6 +357,10 @@ void engine()
   // SWITCH ENDS HERE
   //-----------------------------------------------
 
+  #if COMPUTED_GOTO
+ LABEL_UNIMPLEMENTED:
+  #endif
+
    #if !FP_ARITHMETIC
 
    throw_exception (noSuchMethodError);
@@ -2,6 +2,7 @@
 #include "types.h"
 #include "constants.h"
 #include "classes.h"
+#include "configure.h"
 
 #ifndef _INTERPRETER_H
 #define _INTERPRETER_H
@@ -24,6 +25,10 @@ extern STACKWORD tempStackWord;
 
 extern void engine();
 
+#if STRING_CACHE_SIZE
+extern Object *stringCache[];
+#endif
+
 static inline void schedule_request (const byte aCode)
 {
   gMakeRequest = true;
@@ -16,6 +16,8 @@
 #include "exceptions.h"
 #include "stack.h"
 #include "platform_hooks.h"
+#include "quicken.h"
+#include "profiler.h"
 
 #if 0
 #define get_stack_object(MREC_)  ((Object *) get_ref_at ((MREC_)->numParameters - 1))
@@ -33,6 +35,27 @@ void *installedBinary;
 static ClassRecord *tempClassRecord;
 static MethodRecord *tempMethodRecord;
 
+#if METHOD_CACHE_SIZE
+
+/**
+ * Methods found by dispatch_virtual, indexed by a hash of
+ * the receiver class and the signature. The binary cannot be
+ * changed while it runs, so entries never go stale.
+ */
+typedef struct S_MethodCacheEntry
+{
+  MethodRecord *methodRecord;
+  TWOBYTES signature;
+  byte classIndex;
+} MethodCacheEntry;
+
+static MethodCacheEntry methodCache[METHOD_CACHE_SIZE];
+
+#define get_method_cache_entry(CLASSIDX_,SIG_) \
+  (&methodCache[((SIG_) ^ ((TWOBYTES) (CLASSIDX_) << 3)) & (METHOD_CACHE_SIZE - 1)])
+
+#endif
+
 // Methods:
 
 byte get_class_index (Object *obj)
@@ -60,6 +83,16 @@ MethodRecord *find_method (ClassRecord *classRecord, TWOBYTES methodSignature)
   return null;
 }
 
+/**
+ * Empties the method cache. Must be called when a binary is installed.
+ */
+void clear_method_cache ()
+{
+  #if METHOD_CACHE_SIZE
+  zero_mem ((TWOBYTES *) methodCache, sizeof (methodCache) / 2);
+  #endif
+}
+
 boolean dispatch_static_initializer (ClassRecord *aRec, byte *retAddr)
 {
   if (is_initialized (aRec))
@@ -79,6 +112,9 @@ void dispatch_virtual (Object *ref, TWOBYTES signature, byte *retAddr)
 {
   MethodRecord *auxMethodRecord;
   byte auxByte;
+  #if METHOD_CACHE_SIZE
+  MethodCacheEntry *cacheEntry;
+  #endif
 
 #if DEBUG_METHODS
   printf("dispatch_virtual %d\n", signature);
@@ -90,6 +126,15 @@ void dispatch_virtual (Object *ref, TWOBYTES signature, byte *retAddr)
   }
 
   auxByte = get_class_index(ref);
+  #if METHOD_CACHE_SIZE
+  cacheEntry = get_method_cache_entry (auxByte, signature);
+  if (cacheEntry->methodRecord != null &&
+      cacheEntry->signature == signature && cacheEntry->classIndex == auxByte)
+  {
+    auxMethodRecord = cacheEntry->methodRecord;
+    goto LABEL_DISPATCH;
+  }
+  #endif
  LABEL_METHODLOOKUP:
   tempClassRecord = get_class_record (auxByte);
   auxMethodRecord = find_method (tempClassRecord, signature);
@@ -105,7 +150,17 @@ void dispatch_virtual (Object *ref, TWOBYTES signature, byte *retAddr)
     auxByte = tempClassRecord->parentClass;
     goto LABEL_METHODLOOKUP;
   }
+  #if METHOD_CACHE_SIZE
+  cacheEntry->methodRecord = auxMethodRecord;
+  cacheEntry->signature = signature;
+  cacheEntry->classIndex = get_class_index(ref);
 
+ LABEL_DISPATCH:
+  #endif
+  // Checked before the frame is pushed, because its return would
+  // exit the monitor
+  if (is_synchronized(auxMethodRecord) && !check_monitor_depth (currentThread, ref))
+    return;
   if (dispatch_special (auxMethodRecord, retAddr))
   {
     if (is_synchronized(auxMethodRecord))
@@ -170,6 +225,7 @@ boolean dispatch_special (MethodRecord *methodRecord, byte *retAddr)
   printf ("-- max stack ptr= %d\n", (int) (currentThread->stackArray + (get_array_size(currentThread->stackArray))*2));
   #endif
 
+  profile_call (methodRecord);
   pop_words (methodRecord->numParameters);
   pc = retAddr;
 
@@ -238,7 +294,7 @@ boolean dispatch_special (MethodRecord *methodRecord, byte *retAddr)
   stackFrame->monitor = null;
   stackFrame->localsBase = get_stack_ptr() + 1;
   // Initialize auxiliary global variables (registers)
-  pc = get_code_ptr(methodRecord);
+  pc = get_method_code (methodRecord);
 
   #if DEBUG_METHODS
   printf ("pc set to 0x%X\n", (int) pc);
@@ -120,6 +120,10 @@ extern void *installedBinary;
 extern byte get_class_index (Object *obj);
 extern void dispatch_virtual (Object *obj, TWOBYTES signature, byte *rAddr);
 extern MethodRecord *find_method (ClassRecord *classRec, TWOBYTES signature);
+extern void clear_method_cache ();
+extern void clear_quickened_methods ();
+extern void clear_string_cache ();
+extern void clear_profile ();
 extern STACKWORD instance_of (Object *obj, byte classIndex);
 extern void do_return (byte numWords);
 extern boolean dispatch_static_initializer (ClassRecord *aRec, byte *rAddr);
@@ -189,6 +193,10 @@ static inline void initialize_binary()
   {
     set_uninitialized (get_class_record (i)); 	  
   }
+  clear_method_cache();
+  clear_quickened_methods();
+  clear_string_cache();
+  clear_profile();
 }  
 
 #endif // _LANGUAGE_H
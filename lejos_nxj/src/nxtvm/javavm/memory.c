@@ -11,6 +11,7 @@
 #include "configure.h"
 #include "interpreter.h"
 #include "exceptions.h"
+#include "gc.h"
 #include "stdlib.h"
 
 #include <string.h>
@@ -48,6 +49,9 @@ typedef struct MemoryRegion_S {
   struct MemoryRegion_S *next;  /* pointer to next region */
 #endif
   TWOBYTES *end;                /* pointer to end of region */
+#if GC_BLOCK_MAP
+  TWOBYTES *blockMap;           /* after end, see map_allocated_blocks */
+#endif
   TWOBYTES contents;            /* start of contents, even length */
 } MemoryRegion;
 
@@ -63,6 +67,31 @@ static MemoryRegion *region; /* list of regions */
 static TWOBYTES memory_size;    /* total number of words in heap */
 static TWOBYTES memory_free;    /* total number of free words in heap */
 
+/**
+ * Free blocks are kept in three places, so that allocate() never walks
+ * over allocated blocks:
+ *  -- one list per size for blocks of up to MAX_SMALL_BLOCK words, so
+ *     that most objects are found or freed in constant time;
+ *  -- a list of larger blocks, searched best fit;
+ *  -- the nursery, the largest free block after a collection, which
+ *     objects the lists cannot hold are carved from, top down.
+ * The lists are linked through the second word of each free block, which
+ * holds the offset in words of the next block from heapBase, or NULL_OFFSET.
+ * The header of a free block is unchanged, so the heap can still be walked.
+ */
+#define NUM_FREE_LISTS 16
+#define MAX_SMALL_BLOCK (NUM_FREE_LISTS * MEMORY_ALIGNMENT)
+
+#define free_list_index(SIZE_)  ((SIZE_) / MEMORY_ALIGNMENT - 1)
+#define next_free(BLOCK_)       ((BLOCK_)[1])
+#define offset_to_block(OFF_)   (heapBase + (OFF_))
+#define block_to_offset(BLOCK_) ((TWOBYTES) ((BLOCK_) - heapBase))
+
+static TWOBYTES *heapBase;      /* base of free list offsets */
+static TWOBYTES *nursery;       /* free block allocated from, or null */
+static TWOBYTES smallFree[NUM_FREE_LISTS];
+static TWOBYTES largeFree;
+
 extern void deallocate (TWOBYTES *ptr, TWOBYTES size);
 extern TWOBYTES *allocate (TWOBYTES size);
 
@@ -100,6 +129,12 @@ Object *memcheck_allocate (const TWOBYTES size)
   Object *ref;
   ref = (Object *) allocate (size);
   if (ref == JNULL)
+  {
+    // Collect the garbage and retry once
+    mark_and_sweep();
+    ref = (Object *) allocate (size);
+  }
+  if (ref == JNULL)
   {
     #ifdef VERIFY
     assert (outOfMemoryError != null, MEMORY5);
@@ -254,6 +289,36 @@ Object *reallocate_array(Object *obj, STACKWORD newlen)
 }
 #endif
 
+/**
+ * Fills the reference array arr with new arrays of the next dimension.
+ * Each sub-array is stored in arr before its own sub-arrays are
+ * allocated, so that the garbage collector finds all of them as long
+ * as arr itself is reachable.
+ */
+static void fill_multi_array (Object *arr, byte elemType, byte totalDimensions,
+                              byte reqDimensions, STACKWORD *numElemPtr)
+{
+  Object *aux;
+  STACKWORD i;
+
+  if (reqDimensions <= 1)
+    return;
+
+  for (i = *numElemPtr; i-- > 0; )
+  {
+    if (totalDimensions == 2)
+      aux = new_primitive_array (elemType, numElemPtr[1]);
+    else
+      aux = new_primitive_array (T_REFERENCE, numElemPtr[1]);
+    if (aux == JNULL)
+      return;
+    ref_array(arr)[i] = ptr2word (aux);
+    if (totalDimensions > 2)
+      fill_multi_array (aux, elemType, totalDimensions - 1, reqDimensions - 1,
+                        numElemPtr + 1);
+  }
+}
+
 /**
  * @param elemType Type of primitive element of multi-dimensional array.
  * @param totalDimensions Same as number of brackets in array class descriptor.
@@ -265,11 +330,6 @@ Object *new_multi_array (byte elemType, byte totalDimensions,
 {
   Object *ref;
 
-  #ifdef WIMPY_MATH
-  Object *aux;
-  TWOBYTES ne;
-  #endif
-
   #ifdef VERIFY
   assert (totalDimensions >= 1, MEMORY6);
   assert (reqDimensions <= totalDimensions, MEMORY8);
@@ -289,27 +349,14 @@ Object *new_multi_array (byte elemType, byte totalDimensions,
   if (totalDimensions == 1)
     return new_primitive_array (elemType, *numElemPtr);
 
-
   ref = new_primitive_array (T_REFERENCE, *numElemPtr);
   if (ref == JNULL)
     return JNULL;
 
-  while ((*numElemPtr)--)
-  {
-    #ifdef WIMPY_MATH
-
-    aux = new_multi_array (elemType, totalDimensions - 1, reqDimensions - 1,
-      numElemPtr + 1);
-    ne = *numElemPtr;
-    ref_array(ref)[ne] = ptr2word (aux);
-
-    #else
-
-    ref_array(ref)[*numElemPtr] = ptr2word (new_multi_array (elemType, totalDimensions - 1, reqDimensions - 1, numElemPtr + 1));
-
-    #endif // WIMPY_MATH
-  }
-
+  // Only held here until it is pushed on the stack
+  gc_protect (ref);
+  fill_multi_array (ref, elemType, totalDimensions, reqDimensions, numElemPtr);
+  gc_unprotect ();
 
   return ref;
 }
@@ -411,6 +458,58 @@ void scan_memory (TWOBYTES *numNodes, TWOBYTES *biggest, TWOBYTES *freeMem)
 
 #endif // DEBUG_RCX_MEMORY
 
+static void clear_free_lists ()
+{
+  byte i;
+
+  for (i = 0; i < NUM_FREE_LISTS; i++)
+    smallFree[i] = NULL_OFFSET;
+  largeFree = NULL_OFFSET;
+}
+
+/**
+ * Makes the size words at p a free block and files it.
+ * @param size Multiple of MEMORY_ALIGNMENT.
+ */
+static void add_free_block (TWOBYTES *p, TWOBYTES size)
+{
+  TWOBYTES *list;
+
+  *p = size;
+  list = (size <= MAX_SMALL_BLOCK) ? &smallFree[free_list_index (size)]
+                                   : &largeFree;
+  next_free (p) = *list;
+  *list = block_to_offset (p);
+}
+
+/**
+ * Gives a free block to the allocator: the largest block seen
+ * becomes the nursery, the others go to the free lists.
+ */
+static void release_free_block (TWOBYTES *p, TWOBYTES size)
+{
+  if (nursery == null || size > *nursery)
+  {
+    if (nursery != null)
+      add_free_block (nursery, *nursery);
+    *p = size;
+    nursery = p;
+  }
+  else
+    add_free_block (p, size);
+}
+
+
+#if GC_BLOCK_MAP
+/**
+ * @return Number of 2-byte words of the block map of a region with
+ *         size words of contents.
+ */
+static inline TWOBYTES block_map_size (TWOBYTES size)
+{
+  return (size / MEMORY_ALIGNMENT + 15) / 16;
+}
+#endif
 
 void memory_init ()
 {
@@ -423,6 +522,9 @@ void memory_init ()
 #endif
   memory_size = 0;
   memory_free = 0;
+  heapBase = null;
+  nursery = null;
+  clear_free_lists();
 }
 
 /**
@@ -450,8 +552,20 @@ void memory_add_region (byte *start, byte *end)
  downwards */
 
   /* create free block in region */
-  contents_size = region->end - &(region->contents);
-  ((Object*)&(region->contents))->flags.all = contents_size;
+  contents_size = (region->end - &(region->contents)) & ~(MEMORY_ALIGNMENT-1);
+#if GC_BLOCK_MAP
+  /* the block map takes the end of the region */
+  contents_size = (contents_size - block_map_size (contents_size)) & ~(MEMORY_ALIGNMENT-1);
+  region->blockMap = &(region->contents) + contents_size;
+#endif
+  region->end = &(region->contents) + contents_size;
+  if (heapBase == null)
+    heapBase = &(region->contents);
+  #ifdef VERIFY
+  assert (&(region->contents) >= heapBase &&
+          region->end - heapBase < NULL_OFFSET, MEMORY2);
+  #endif
+  release_free_block (&(region->contents), contents_size);
 
   /* memory accounting */
   memory_size += contents_size;
@@ -472,94 +586,95 @@ void memory_add_region (byte *start, byte *end)
 }
 
 
+/**
+ * @return Size in 2-byte words of the allocated block at ptr,
+ *         rounded up to the heap alignment.
+ */
+static inline TWOBYTES get_allocated_size (TWOBYTES *ptr)
+{
+  TWOBYTES s = (*ptr & IS_ARRAY_MASK) 
+    ? get_array_size ((Object *) ptr)
+    : get_object_size ((Object *) ptr);
+
+  return (s + (MEMORY_ALIGNMENT-1)) & ~(MEMORY_ALIGNMENT-1);
+}
+
+/**
+ * Takes size words from the top of the free block p, or all of it.
+ * @param link Where the offset of p is stored if p is in a free list,
+ *             null if p is the nursery.
+ * @return The allocated block.
+ */
+static TWOBYTES *split_free_block (TWOBYTES *p, TWOBYTES *link, TWOBYTES size)
+{
+  TWOBYTES rest = *p - size;
+
+  if (link != null)
+  {
+    /* unlink, and file the rest again if it stays a free block */
+    *link = next_free (p);
+    if (rest != 0)
+      add_free_block (p, rest);
+  }
+  else if (rest != 0)
+    *p = rest;
+  else
+    nursery = null;
+
+  memory_free -= size;
+  return p + rest;
+}
+
 /**
  * @param size Size of block including header in 2-byte words.
+ * @return The block, or JNULL when no free block is large enough;
+ *         only the garbage collector merges free blocks again.
  */
 TWOBYTES *allocate (TWOBYTES size)
 {
+  TWOBYTES *link;
+  TWOBYTES *best;
+  TWOBYTES *ptr;
+  TWOBYTES i;
+
   // Align memory to boundary appropriate for system	
   size = (size + (MEMORY_ALIGNMENT-1)) & ~(MEMORY_ALIGNMENT-1);
 
-#if SEGMENTED_HEAP
-  MemoryRegion *region;
-
-#endif
-
 #if DEBUG_MEMORY
   printf("Allocate %d - free %d\n", size, memory_free-size);
 #endif
 
-#if SEGMENTED_HEAP
-  for (region = memory_regions; region != null; region = region->next)
-#endif
+  /* exact fit from the list of the size */
+  if (size <= MAX_SMALL_BLOCK)
   {
-    TWOBYTES *ptr = &(region->contents);
-    TWOBYTES *regionTop = region->end;
+    link = &smallFree[free_list_index (size)];
+    if (*link != NULL_OFFSET)
+      return split_free_block (offset_to_block (*link), link, size);
+  }
 
-    while (ptr < regionTop) {
-      TWOBYTES blockHeader = *ptr;
+  /* split a larger small block */
+  for (i = size + MEMORY_ALIGNMENT; i <= MAX_SMALL_BLOCK; i += MEMORY_ALIGNMENT)
+  {
+    link = &smallFree[free_list_index (i)];
+    if (*link != NULL_OFFSET)
+      return split_free_block (offset_to_block (*link), link, size);
+  }
 
+  /* best fit in the large blocks */
+  best = null;
+  for (link = &largeFree; *link != NULL_OFFSET; link = &next_free (ptr))
+  {
+    ptr = offset_to_block (*link);
+    if (size <= *ptr && (best == null || *ptr < *offset_to_block (*best)))
+      best = link;
+  }
+  if (best != null)
+    return split_free_block (offset_to_block (*best), best, size);
 
-      if (blockHeader & IS_ALLOCATED_MASK) {
-        /* jump over allocated block */
-        TWOBYTES s = (blockHeader & IS_ARRAY_MASK) 
-          ? get_array_size ((Object *) ptr)
-          : get_object_size ((Object *) ptr);
-          
-        // Round up according to alignment
-        s = (s + (MEMORY_ALIGNMENT-1)) & ~(MEMORY_ALIGNMENT-1);
-        ptr += s;
-      }
-      else
-      {
-        if (size <= blockHeader) {
-          /* allocate from this block */
+  /* bump allocation from the nursery */
+  if (nursery != null && size <= *nursery)
+    return split_free_block (nursery, null, size);
 
-#if COALESCE
-          {
-            TWOBYTES nextBlockHeader;
-
-            /* NOTE: Theoretically there could be adjacent blocks
-               that are too small, so we never arrive here and fail.
-               However, in practice this should suffice as it keeps
-               the big block at the beginning in one piece.
-               Putting it here saves code space as we only have to
-               search through the heap once, and deallocat remains
-               simple.
-            */
-            
-            while (true) {
-              TWOBYTES *next_ptr = ptr + blockHeader;
-              nextBlockHeader = *next_ptr;
-              if (next_ptr >= regionTop ||
-                  (nextBlockHeader & IS_ALLOCATED_MASK) != 0)
-                break;
-              blockHeader += nextBlockHeader;
-              *ptr = blockHeader;
-            }
-          }
-#endif
-          if (size < blockHeader) {
-            /* cut into two blocks */
-            blockHeader -= size; /* first block gets remaining free space */
-            *ptr = blockHeader;
-            ptr += blockHeader; /* second block gets allocated */
-#if SAFE
-            *ptr = size;
-#endif
-            /* NOTE: allocating from the top downwards avoids most
-                     searching through already allocated blocks */
-          }
-          memory_free -= size;
-
-          return ptr;
-        } else {
-          /* continue searching */
-          ptr += blockHeader;
-        }
-      }
-    }
-  }
   /* couldn't allocate block */
   return JNULL;
 }
@@ -582,9 +697,190 @@ void deallocate (TWOBYTES *p, TWOBYTES size)
   printf("Deallocate %d at %d - free %d\n", size, (int)p, memory_free);
 #endif
 
-  ((Object*)p)->flags.all = size;
+  add_free_block (p, size);
+}
+
+#if GC_BLOCK_MAP
+/**
+ * Sets the bit of the block map for the first MEMORY_ALIGNMENT words
+ * of each allocated block and clears the others. Called by the garbage
+ * collector before marking; the maps are only valid until the next
+ * allocation or deallocation.
+ */
+void map_allocated_blocks ()
+{
+#if SEGMENTED_HEAP
+  MemoryRegion *region;
+
+  for (region = memory_regions; region != null; region = region->next)
+#endif
+  {
+    TWOBYTES *contents = &(region->contents);
+    TWOBYTES *ptr = contents;
+    TWOBYTES *regionTop = region->end;
+    TWOBYTES *map = region->blockMap;
+    TWOBYTES granule;
+
+    zero_mem (map, block_map_size (regionTop - contents));
+    while (ptr < regionTop)
+    {
+      if (*ptr & IS_ALLOCATED_MASK)
+      {
+        granule = (ptr - contents) / MEMORY_ALIGNMENT;
+        map[granule >> 4] |= 1 << (granule & 15);
+        ptr += get_allocated_size (ptr);
+      }
+      else
+        ptr += *ptr;
+    }
+  }
+}
+#endif
+
+/**
+ * @return true iff ptr is the start of an allocated block. Used by the
+ *         garbage collector, after map_allocated_blocks, to check words
+ *         of thread stacks that may or may not be references.
+ */
+boolean is_allocated_block (void *ptr)
+{
+#if SEGMENTED_HEAP
+  MemoryRegion *region;
+
+  for (region = memory_regions; region != null; region = region->next)
+#endif
+  {
+    TWOBYTES *p = &(region->contents);
+    TWOBYTES *regionTop = region->end;
+
+    // Blocks start at multiples of MEMORY_ALIGNMENT words from the
+    // start of the contents
+    if ((TWOBYTES *) ptr >= p && (TWOBYTES *) ptr < regionTop &&
+        ((unsigned int) ptr & 1) == 0 &&
+        (((TWOBYTES *) ptr - p) & (MEMORY_ALIGNMENT-1)) == 0)
+    {
+#if GC_BLOCK_MAP
+      TWOBYTES granule = ((TWOBYTES *) ptr - p) / MEMORY_ALIGNMENT;
+
+      return (region->blockMap[granule >> 4] >> (granule & 15)) & 1;
+#else
+      if ((*(TWOBYTES *) ptr & IS_ALLOCATED_MASK) == 0)
+        return false;
+      while (p < (TWOBYTES *) ptr)
+      {
+        if (*p & IS_ALLOCATED_MASK)
+          p += get_allocated_size (p);
+        else
+          p += *p;
+      }
+      return p == (TWOBYTES *) ptr;
+#endif
+    }
+  }
+  return false;
 }
 
+/**
+ * Calls aScan for every allocated block with the garbage
+ * collection mark set.
+ */
+void scan_marked_blocks (void (*aScan)(Object *))
+{
+#if SEGMENTED_HEAP
+  MemoryRegion *region;
+
+  for (region = memory_regions; region != null; region = region->next)
+#endif
+  {
+    TWOBYTES *ptr = &(region->contents);
+    TWOBYTES *regionTop = region->end;
+
+    while (ptr < regionTop)
+    {
+      if (*ptr & IS_ALLOCATED_MASK)
+      {
+        if (*ptr & GC_MASK)
+          aScan ((Object *) ptr);
+        ptr += get_allocated_size (ptr);
+      }
+      else
+        ptr += *ptr;
+    }
+  }
+}
+
+/**
+ * Frees every allocated block without the garbage collection mark,
+ * clears the mark of the others and rebuilds the free lists, merging
+ * adjacent free blocks.
+ */
+void sweep_heap ()
+{
+#if SEGMENTED_HEAP
+  MemoryRegion *region;
+#endif
+
+  memory_free = 0;
+  nursery = null;
+  clear_free_lists();
+
+#if SEGMENTED_HEAP
+  for (region = memory_regions; region != null; region = region->next)
+#endif
+  {
+    TWOBYTES *ptr = &(region->contents);
+    TWOBYTES *regionTop = region->end;
+    TWOBYTES *freeBlock = null;
+    TWOBYTES freeSize = 0;
+
+    while (ptr < regionTop)
+    {
+      TWOBYTES blockHeader = *ptr;
+      TWOBYTES s;
+
+      if (blockHeader & IS_ALLOCATED_MASK)
+      {
+        s = get_allocated_size (ptr);
+        if (blockHeader & GC_MASK)
+        {
+          /* live block */
+          *ptr = blockHeader & ~GC_MASK;
+          if (freeBlock != null)
+            release_free_block (freeBlock, freeSize);
+          freeBlock = null;
+          ptr += s;
+          continue;
+        }
+      }
+      else
+        s = blockHeader;
+
+      memory_free += s;
+#if COALESCE
+      if (freeBlock != null &&
+          (FOURBYTES) freeSize + s <= (FREE_BLOCK_SIZE_MASK >> FREE_BLOCK_SIZE_SHIFT))
+      {
+        /* merge with the free block before */
+        freeSize += s;
+      }
+      else
+#endif
+      {
+        if (freeBlock != null)
+          release_free_block (freeBlock, freeSize);
+        freeBlock = ptr;
+        freeSize = s;
+      }
+      ptr += s;
+    }
+    if (freeBlock != null)
+      release_free_block (freeBlock, freeSize);
+  }
+
+#if DEBUG_MEMORY
+  printf("Sweep - free %d\n", memory_free);
+#endif
+}
 
 int getHeapSize() {
   return ((int)memory_size) << 1;
@@ -1,6 +1,7 @@
 
 #include "types.h"
 #include "classes.h"
+#include "configure.h"
 
 #ifndef _MEMORY_H
 #define _MEMORY_H
@@ -26,6 +27,12 @@ extern void zero_mem (TWOBYTES *ptr, TWOBYTES numWords);
 extern int getHeapSize();
 extern int getHeapFree();
 extern int getRegionAddress();
+#if GC_BLOCK_MAP
+extern void map_allocated_blocks ();
+#endif
+extern boolean is_allocated_block (void *ptr);
+extern void scan_marked_blocks (void (*aScan)(Object *));
+extern void sweep_heap ();
 
 #if DEBUG_RCX_MEMORY
 extern void scan_memory (TWOBYTES *numNodes, TWOBYTES *biggest, TWOBYTES *freeMem);
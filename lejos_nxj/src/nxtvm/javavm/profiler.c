@@ -0,0 +1,162 @@
+/**
+ * profiler.c
+ * Sampling profiler
+ *
+ * On each tick of the millisecond timer, the method the running thread
+ * is in and the offset of pc in its code are counted in a table. Calls
+ * of each method are counted in the same table, with PROFILE_CALLS as
+ * their pc. A method is named by the offset of its method record in
+ * the binary, so that the host can look it up in the class and method
+ * tables of the linked program.
+ *
+ * Ticks with no thread to run, and counts that find no free entry,
+ * are kept apart.
+ */
+
+#include "types.h"
+#include "constants.h"
+#include "classes.h"
+#include "language.h"
+#include "threads.h"
+#include "interpreter.h"
+#include "memory.h"
+#include "configure.h"
+#include "quicken.h"
+#include "profiler.h"
+
+#if PROFILER_ENTRIES
+
+typedef struct S_ProfileEntry
+{
+  // Offset of the method record in the binary, 0 if the entry is free
+  TWOBYTES method;
+  TWOBYTES pc;
+  FOURBYTES count;
+} ProfileEntry;
+
+/**
+ * Number of entries looked at before a count is lost.
+ */
+#define MAX_PROBES 8
+
+static ProfileEntry profile[PROFILER_ENTRIES];
+static FOURBYTES idleTicks;
+static FOURBYTES lostCounts;
+
+#define get_method_offset(MREC_) \
+  ((TWOBYTES) ((byte *) (MREC_) - get_binary_base()))
+
+/**
+ * Adds one to the entry of method and pc, which is made if needed.
+ */
+static void count (TWOBYTES method, TWOBYTES pc)
+{
+  ProfileEntry *entry;
+  TWOBYTES hash;
+  byte i;
+
+  hash = (method >> 2) * 31 + pc;
+  for (i = 0; i < MAX_PROBES; i++)
+  {
+    entry = &profile[(hash + i) & (PROFILER_ENTRIES - 1)];
+    if (entry->method == method && entry->pc == pc)
+    {
+      entry->count++;
+      return;
+    }
+    if (entry->method == 0)
+    {
+      entry->method = method;
+      entry->pc = pc;
+      entry->count = 1;
+      return;
+    }
+  }
+  lostCounts++;
+}
+
+/**
+ * Called on every call of a method, native or not.
+ */
+void profile_call (MethodRecord *methodRecord)
+{
+  count (get_method_offset (methodRecord), PROFILE_CALLS);
+}
+
+/**
+ * Called by the engine on every tick of the timer, before
+ * any thread switch.
+ */
+void profile_tick ()
+{
+  MethodRecord *methodRecord;
+
+  if (currentThread == null || currentThread->stackFrameArraySize == 0)
+  {
+    idleTicks++;
+    return;
+  }
+  methodRecord = current_stackframe()->methodRecord;
+  count (get_method_offset (methodRecord),
+         pc - get_code_base (methodRecord, pc));
+}
+
+#endif // PROFILER_ENTRIES
+
+/**
+ * Forgets all counts. Must be called when a binary is installed.
+ */
+void clear_profile ()
+{
+  #if PROFILER_ENTRIES
+  zero_mem ((TWOBYTES *) profile, sizeof (profile) / 2);
+  idleTicks = 0;
+  lostCounts = 0;
+  #endif
+}
+
+/**
+ * Copies used entries of the profile, starting with the first'th,
+ * into buffer. Each takes two words: the method offset in the high
+ * half of the first and pc in the low half, then the count. Entries
+ * 0 and 1 have method 0 and count idle ticks and lost counts.
+ * @return Number of entries copied.
+ */
+TWOBYTES read_profile (JINT *buffer, TWOBYTES length, TWOBYTES first)
+{
+  TWOBYTES copied;
+
+  copied = 0;
+  #if PROFILER_ENTRIES
+  {
+    ProfileEntry *entry;
+    JINT key;
+    JINT value;
+    TWOBYTES index;
+    TWOBYTES i;
+
+    index = 0;
+    for (i = 0; i < PROFILER_ENTRIES + 2 && copied + 2 <= length; i++)
+    {
+      if (i < 2)
+      {
+        key = i;
+        value = (i == 0) ? idleTicks : lostCounts;
+      }
+      else
+      {
+        entry = &profile[i - 2];
+        if (entry->method == 0)
+          continue;
+        key = ((JINT) entry->method << 16) | entry->pc;
+        value = entry->count;
+      }
+      if (index++ < first)
+        continue;
+      buffer[copied++] = key;
+      buffer[copied++] = value;
+    }
+  }
+  #endif
+  return copied / 2;
+}
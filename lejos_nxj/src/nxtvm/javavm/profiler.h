@@ -0,0 +1,28 @@
+#include "types.h"
+#include "configure.h"
+#include "language.h"
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+/**
+ * pc of the entries that count the calls of a method.
+ */
+#define PROFILE_CALLS  0xFFFF
+
+#if PROFILER_ENTRIES
+
+extern void profile_call (MethodRecord *methodRecord);
+extern void profile_tick ();
+
+#else
+
+#define profile_call(MREC_)
+#define profile_tick()
+
+#endif
+
+extern void clear_profile ();
+extern TWOBYTES read_profile (JINT *buffer, TWOBYTES length, TWOBYTES first);
+
+#endif // _PROFILER_H
@@ -0,0 +1,350 @@
+/**
+ * quicken.c
+ * Copies of frequently run methods in RAM
+ *
+ * Each call of a method and each backward branch taken in it makes
+ * it hotter. Once it has been used QUICKEN_THRESHOLD times, its code
+ * is copied into quickCode. Later calls run the copy, and so does the
+ * running call from its next backward branch. Instructions keep their
+ * offsets in the copy, so return addresses, branches and exception
+ * tables work unchanged.
+ *
+ * While copying, some common instruction sequences are replaced with
+ * superinstructions. Instructions that check that a class is
+ * initialized replace themselves with quick forms the first time they
+ * run in a copy and find it initialized.
+ */
+
+#include "types.h"
+#include "constants.h"
+#include "opcodes.h"
+#include "classes.h"
+#include "language.h"
+#include "threads.h"
+#include "interpreter.h"
+#include "memory.h"
+#include "configure.h"
+#include "quicken.h"
+
+#include <string.h>
+
+#if QUICKEN_BUFFER_SIZE
+
+typedef struct S_QuickMethod
+{
+  MethodRecord *methodRecord;
+  byte *code;
+  byte hotness;
+} QuickMethod;
+
+/**
+ * Hotness of a method that could not be copied.
+ */
+#define NOT_QUICKENED 0xFF
+
+byte quickCode[QUICKEN_BUFFER_SIZE];
+static TWOBYTES quickCodeSize;
+
+/**
+ * Copied methods, indexed by a hash of their method record.
+ * Until a method is copied, its entry counts how hot it is.
+ */
+static QuickMethod quickMethods[QUICKEN_MAX_METHODS];
+
+#define get_quick_method(MREC_) \
+  (&quickMethods[(ptr2word (MREC_) >> 2) & (QUICKEN_MAX_METHODS - 1)])
+
+#define get_exception_table(MREC_) \
+  ((ExceptionRecord *) (get_binary_base() + (MREC_)->exceptionTable))
+
+#define is_branch(OP_) \
+  (((OP_) >= OP_IFEQ && (OP_) <= OP_JSR) || (OP_) == OP_IFNULL || (OP_) == OP_IFNONNULL)
+
+#define get_branch_target(CODE_,OFFSET_) \
+  ((OFFSET_) + (JSHORT) (((TWOBYTES) (CODE_)[(OFFSET_) + 1] << 8) | (CODE_)[(OFFSET_) + 2]))
+
+/**
+ * @return Length of the instruction starting with op,
+ *         or 0 if the interpreter does not support it.
+ */
+static byte get_instruction_length (byte op)
+{
+  switch (op)
+  {
+    case OP_BIPUSH:
+    case OP_LDC:
+    case OP_ILOAD:
+    case OP_LLOAD:
+    case OP_FLOAD:
+    case OP_DLOAD:
+    case OP_ALOAD:
+    case OP_ISTORE:
+    case OP_LSTORE:
+    case OP_FSTORE:
+    case OP_DSTORE:
+    case OP_ASTORE:
+    case OP_RET:
+    case OP_NEWARRAY:
+      return 2;
+    case OP_SIPUSH:
+    case OP_LDC_W:
+    case OP_LDC2_W:
+    case OP_IINC:
+    case OP_GETSTATIC:
+    case OP_PUTSTATIC:
+    case OP_GETFIELD:
+    case OP_PUTFIELD:
+    case OP_INVOKEVIRTUAL:
+    case OP_INVOKESPECIAL:
+    case OP_INVOKESTATIC:
+    case OP_NEW:
+    case OP_ANEWARRAY:
+    case OP_CHECKCAST:
+    case OP_INSTANCEOF:
+      return 3;
+    case OP_MULTIANEWARRAY:
+      return 4;
+    case OP_TABLESWITCH:
+    case OP_LOOKUPSWITCH:
+    case OP_INVOKEINTERFACE:
+    case OP_XXXUNUSEDXXX:
+    case OP_WIDE:
+    case OP_GOTO_W:
+    case OP_JSR_W:
+      return 0;
+  }
+  if (is_branch (op))
+    return 3;
+  if (op >= OP_BREAKPOINT)
+    return 0;
+  return 1;
+}
+
+/**
+ * Finds the end of a method's code: the first instruction that
+ * does not fall through, once every branch target and exception
+ * handler has been passed.
+ * @return Length in bytes, or 0 if the method cannot be copied.
+ */
+static TWOBYTES get_code_length (MethodRecord *methodRecord)
+{
+  ExceptionRecord *exceptionRecord;
+  byte *code;
+  TWOBYTES offset;
+  TWOBYTES lastTarget;
+  byte op;
+  byte length;
+  byte i;
+
+  lastTarget = 0;
+  exceptionRecord = get_exception_table (methodRecord);
+  for (i = 0; i < methodRecord->numExceptionHandlers; i++)
+  {
+    if (exceptionRecord[i].end > lastTarget)
+      lastTarget = exceptionRecord[i].end;
+    if (exceptionRecord[i].handler > lastTarget)
+      lastTarget = exceptionRecord[i].handler;
+  }
+
+  code = get_code_ptr (methodRecord);
+  offset = 0;
+  for (;;)
+  {
+    op = code[offset];
+    length = get_instruction_length (op);
+    if (length == 0)
+      return 0;
+    if (is_branch (op) && get_branch_target (code, offset) > (JINT) lastTarget)
+      lastTarget = get_branch_target (code, offset);
+    offset += length;
+    if (offset > QUICKEN_BUFFER_SIZE)
+      return 0;
+    if (offset > lastTarget &&
+        (op == OP_GOTO || op == OP_RET || op == OP_ATHROW ||
+         (op >= OP_IRETURN && op <= OP_RETURN)))
+      return offset;
+  }
+}
+
+/**
+ * @return true iff a branch or an exception handler jumps
+ *         between the instructions at start and end.
+ */
+static boolean is_jump_target (MethodRecord *methodRecord, TWOBYTES length,
+                               TWOBYTES start, TWOBYTES end)
+{
+  ExceptionRecord *exceptionRecord;
+  byte *code;
+  TWOBYTES offset;
+  JINT target;
+  byte i;
+
+  exceptionRecord = get_exception_table (methodRecord);
+  for (i = 0; i < methodRecord->numExceptionHandlers; i++)
+  {
+    if (exceptionRecord[i].handler > start && exceptionRecord[i].handler < end)
+      return true;
+  }
+
+  code = get_code_ptr (methodRecord);
+  for (offset = 0; offset < length; offset += get_instruction_length (code[offset]))
+  {
+    if (is_branch (code[offset]))
+    {
+      target = get_branch_target (code, offset);
+      if (target > start && target < end)
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Decodes a load or store of a local, in its long form longOp
+ * or its short forms starting at shortOp, and skips it.
+ * @return false if the instruction is something else.
+ */
+static boolean decode_local (byte *code, TWOBYTES *offset, byte longOp,
+                             byte shortOp, byte *index)
+{
+  byte op = code[*offset];
+
+  if (op == longOp)
+  {
+    *index = code[*offset + 1];
+    *offset += 2;
+    return true;
+  }
+  if (op >= shortOp && op <= shortOp + 3)
+  {
+    *index = op - shortOp;
+    *offset += 1;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Replaces common sequences in the copy of a method with
+ * superinstructions. The original code is read to find them.
+ */
+static void add_superinstructions (MethodRecord *methodRecord, byte *copy,
+                                   TWOBYTES length)
+{
+  byte *code;
+  TWOBYTES offset;
+  TWOBYTES next;
+  byte locals[3];
+
+  code = get_code_ptr (methodRecord);
+  for (offset = 0; offset < length; offset = next)
+  {
+    next = offset;
+    if (decode_local (code, &next, OP_ILOAD, OP_ILOAD_0, &locals[0]) &&
+        decode_local (code, &next, OP_ILOAD, OP_ILOAD_0, &locals[1]) &&
+        code[next++] == OP_IADD &&
+        decode_local (code, &next, OP_ISTORE, OP_ISTORE_0, &locals[2]) &&
+        next <= length && !is_jump_target (methodRecord, length, offset, next))
+    {
+      // The bytes left over are filled with OP_NOP.
+      copy[offset] = OP_IADD_LOCALS;
+      memcpy (copy + offset + 1, locals, 3);
+      memset (copy + offset + 4, OP_NOP, next - offset - 4);
+      continue;
+    }
+
+    next = offset + get_instruction_length (code[offset]);
+    if (code[offset] == OP_ALOAD_0 && next < length && code[next] == OP_GETFIELD)
+    {
+      // OP_GETFIELD is kept, so branching to it still works.
+      copy[offset] = OP_ALOAD_0_GETFIELD;
+    }
+  }
+}
+
+/**
+ * Counts a use of a method, and copies it when it becomes hot.
+ * @return The entry of the copy, or null if the method runs
+ *         from the binary.
+ */
+static QuickMethod *use_method (MethodRecord *methodRecord)
+{
+  QuickMethod *quickMethod;
+  TWOBYTES length;
+
+  quickMethod = get_quick_method (methodRecord);
+  if (quickMethod->methodRecord == methodRecord)
+    return quickMethod;
+  if (quickMethod->methodRecord != null || quickMethod->hotness == NOT_QUICKENED)
+    return null;
+  if (++quickMethod->hotness < QUICKEN_THRESHOLD)
+    return null;
+
+  length = get_code_length (methodRecord);
+  if (length == 0 || quickCodeSize + length > QUICKEN_BUFFER_SIZE)
+  {
+    quickMethod->hotness = NOT_QUICKENED;
+    return null;
+  }
+
+  quickMethod->code = quickCode + quickCodeSize;
+  quickCodeSize += length;
+  memcpy (quickMethod->code, get_code_ptr (methodRecord), length);
+  add_superinstructions (methodRecord, quickMethod->code, length);
+  quickMethod->methodRecord = methodRecord;
+  return quickMethod;
+}
+
+/**
+ * Called on a call of a method.
+ * @return Code the call should run.
+ */
+byte *get_method_code (MethodRecord *methodRecord)
+{
+  QuickMethod *quickMethod;
+
+  quickMethod = use_method (methodRecord);
+  if (quickMethod == null)
+    return get_code_ptr (methodRecord);
+  return quickMethod->code;
+}
+
+/**
+ * Called on a backward branch to pc outside quickCode.
+ * @return pc, moved to the copy of the running method if it has one.
+ */
+byte *get_quick_pc (byte *pc)
+{
+  MethodRecord *methodRecord;
+  QuickMethod *quickMethod;
+
+  methodRecord = current_stackframe()->methodRecord;
+  quickMethod = use_method (methodRecord);
+  if (quickMethod == null)
+    return pc;
+  return quickMethod->code + (pc - get_code_ptr (methodRecord));
+}
+
+/**
+ * @return Start of the code of a method that pc is in,
+ *         the copy or the original.
+ */
+byte *get_code_base (MethodRecord *methodRecord, byte *pc)
+{
+  if (is_quick_code (pc))
+    return get_quick_method (methodRecord)->code;
+  return get_code_ptr (methodRecord);
+}
+
+#endif // QUICKEN_BUFFER_SIZE
+
+/**
+ * Forgets all copies. Must be called when a binary is installed.
+ */
+void clear_quickened_methods ()
+{
+  #if QUICKEN_BUFFER_SIZE
+  zero_mem ((TWOBYTES *) quickMethods, sizeof (quickMethods) / 2);
+  quickCodeSize = 0;
+  #endif
+}
@@ -0,0 +1,36 @@
+#include "types.h"
+#include "configure.h"
+#include "language.h"
+
+#ifndef _QUICKEN_H
+#define _QUICKEN_H
+
+// Opcodes only found in the copies made by quicken.c.
+// They use numbers the JVM leaves unassigned.
+
+#define OP_INVOKESTATIC_QUICK  203
+#define OP_GETSTATIC_QUICK     204
+#define OP_PUTSTATIC_QUICK     205
+#define OP_ALOAD_0_GETFIELD    206
+#define OP_IADD_LOCALS         207
+
+#if QUICKEN_BUFFER_SIZE
+
+extern byte quickCode[];
+
+#define is_quick_code(PC_)  ((PC_) >= quickCode && (PC_) < quickCode + QUICKEN_BUFFER_SIZE)
+
+extern byte *get_method_code (MethodRecord *methodRecord);
+extern byte *get_quick_pc (byte *pc);
+extern byte *get_code_base (MethodRecord *methodRecord, byte *pc);
+
+#else
+
+#define get_method_code(MREC_)     get_code_ptr(MREC_)
+#define get_code_base(MREC_,PC_)   get_code_ptr(MREC_)
+
+#endif
+
+extern void clear_quickened_methods ();
+
+#endif // _QUICKEN_H
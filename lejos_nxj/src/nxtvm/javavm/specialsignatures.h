@@ -60,4 +60,11 @@
 #define btGetCmdMode_4_5I 53
 #define btSetCmdMode_4I_5V 54
 #define btStartADConverter_4_5V 55
+#define usbRead_4_1BII_5I 56
+#define usbWrite_4_1BII_5I 57
+#define usbStatus_4_5I 58
+#define usbEnable_4I_5V 59
+#define usbDisable_4_5V 60
+#define readProfile_4_1II_5I 61
+#define resetProfile_4_5V 62
 #endif // _SPECIALSIGNATURES_H
@@ -16,19 +16,66 @@
 
 #define NO_OWNER 0x00
 
+/**
+ * Bit of an object's monitor count that is set while threads
+ * wait to enter its monitor. The rest is the depth.
+ */
+#define MONITOR_INFLATED 0x80
+
+#define get_monitor_depth(obj) (get_monitor_count(obj) & (MONITOR_INFLATED - 1))
+
 #define get_stack_frame() ((StackFrame *) (currentThread->currentStackFrame))
+#define get_next_thread(T_) ((Thread *) word2ptr ((T_)->nextThread))
+#define is_waiting_on(T_,OBJ_) ((T_)->state == CONDVAR_WAITING && (T_)->waitingOn == ptr2word (OBJ_))
 
 /**
- * Thread currently being executed by engine(). Threads exist in an
- * intrinsic circular list.
+ * Thread currently being executed by engine(). Every other live
+ * thread is in exactly one of the queues below, linked through
+ * nextThread.
  */
 Thread* currentThread;
 
 /**
- * Priority queue of threads. Entry points at the last thread in the queue.
+ * Priority queue of threads that can run (RUNNING or STARTED),
+ * including currentThread. Each is a circular list. Entry points
+ * at the last thread in the queue.
  */
 Thread *threadQ[10];
 
+/**
+ * SLEEPING threads, and CONDVAR_WAITING threads with a time out,
+ * in the order they wake up. Ends with null.
+ */
+Thread *sleepQ;
+
+/**
+ * CONDVAR_WAITING threads without a time out. Ends with null.
+ */
+Thread *waitQ;
+
+/**
+ * MON_WAITING threads of monitors that have no monitor record,
+ * most recently blocked first. Ends with null.
+ */
+Thread *monitorQ;
+
+#if MAX_MONITOR_RECORDS
+/**
+ * Queues of the threads waiting to enter a contended monitor.
+ */
+MonitorRecord monitorRecords[MAX_MONITOR_RECORDS];
+#endif
+
+/**
+ * Number of MON_WAITING threads, by priority.
+ */
+static byte monitorWaiters[MAX_PRIORITY];
+
+/**
+ * False once no thread that is not a daemon is alive.
+ */
+static boolean gNonDaemonAlive;
+
 /**
  * Thread id generator, always increasing.
  */
@@ -138,22 +185,401 @@ boolean init_thread (Thread *thread)
   thread->state = STARTED;
   if (currentThread == null)
     currentThread = thread;
+  if (!thread->daemon)
+    gNonDaemonAlive = true;
     
   enqueue_thread(thread);
 
   return true;
 }
 
+/**
+ * Finds the record of a monitor, or takes a free one if allocate is true.
+ * @return The record, or null if there is none. The threads waiting
+ *         to enter a monitor without a record are in monitorQ.
+ */
+static MonitorRecord *get_monitor_record (Object *obj, boolean allocate)
+{
+  #if MAX_MONITOR_RECORDS
+  MonitorRecord *record;
+  MonitorRecord *freeRecord = null;
+
+  for (record = monitorRecords; record < monitorRecords + MAX_MONITOR_RECORDS; record++)
+  {
+    if (record->object == obj)
+      return record;
+    if (record->object == null && freeRecord == null)
+      freeRecord = record;
+  }
+  if (allocate && freeRecord != null)
+  {
+    freeRecord->object = obj;
+    freeRecord->waiters = null;
+    return freeRecord;
+  }
+  #endif
+  return null;
+}
+
+/**
+ * Takes the thread of highest priority waiting to enter a monitor
+ * out of its queue. There must be one.
+ */
+static Thread *take_waiter (Thread **pList, Object *obj)
+{
+  Thread *thread, *previous, *best, *bestPrevious;
+
+  best = bestPrevious = null;
+  previous = null;
+  for (thread = *pList; thread != null; thread = get_next_thread (thread))
+  {
+    // Queues are newest first, so among equals the last found
+    // has waited longest.
+    if (thread->waitingOn == ptr2word (obj) &&
+        (best == null || thread->priority >= best->priority))
+    {
+      best = thread;
+      bestPrevious = previous;
+    }
+    previous = thread;
+  }
+
+  if (bestPrevious == null)
+    *pList = get_next_thread (best);
+  else
+    bestPrevious->nextThread = best->nextThread;
+  monitorWaiters[best->priority - 1]--;
+  return best;
+}
+
+/**
+ * @return true iff a thread in the queue waits to enter obj's monitor.
+ */
+static boolean has_waiter (Thread *thread, Object *obj)
+{
+  for (; thread != null; thread = get_next_thread (thread))
+  {
+    if (thread->waitingOn == ptr2word (obj))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Adds a thread that has stopped running to sleepQ, waitQ or
+ * the waiters of a monitor, according to its state.
+ */
+static void block_thread (Thread *thread)
+{
+  Thread *previous, *next;
+  Thread **pList;
+  Object *pObj;
+  MonitorRecord *record;
+
+  if (thread->state == MON_WAITING)
+  {
+    // Inflate the monitor. If it already was, but has no record,
+    // its waiters are in monitorQ and the new one joins them.
+    pObj = word2obj (thread->waitingOn);
+    record = get_monitor_record (pObj, !(get_monitor_count (pObj) & MONITOR_INFLATED));
+    pList = (record != null) ? &record->waiters : &monitorQ;
+    thread->nextThread = ptr2word (*pList);
+    *pList = thread;
+    set_monitor_count (pObj, get_monitor_count (pObj) | MONITOR_INFLATED);
+    monitorWaiters[thread->priority - 1]++;
+    return;
+  }
+  if (thread->state == CONDVAR_WAITING && thread->sleepUntil == 0)
+  {
+    thread->nextThread = ptr2word (waitQ);
+    waitQ = thread;
+    return;
+  }
+
+  // Sleeping, or waiting with a time out: after the threads
+  // that wake up no later.
+  previous = null;
+  next = sleepQ;
+  while (next != null && (FOURBYTES) next->sleepUntil <= (FOURBYTES) thread->sleepUntil)
+  {
+    previous = next;
+    next = get_next_thread (next);
+  }
+  thread->nextThread = ptr2word (next);
+  if (previous == null)
+    sleepQ = thread;
+  else
+    previous->nextThread = ptr2word (thread);
+}
+
+/**
+ * Takes a thread out of the sleepQ or waitQ it is in.
+ */
+static void unblock_thread (Thread *thread)
+{
+  Thread **pList;
+  Thread *previous;
+
+  if (thread->state == CONDVAR_WAITING && thread->sleepUntil == 0)
+    pList = &waitQ;
+  else
+    pList = &sleepQ;
+
+  if (*pList == thread)
+  {
+    *pList = get_next_thread (thread);
+    return;
+  }
+  previous = *pList;
+  while (get_next_thread (previous) != thread)
+    previous = get_next_thread (previous);
+  previous->nextThread = thread->nextThread;
+}
+
+/**
+ * Makes a thread that is not in any queue enter the monitor
+ * it is waiting for, or wait for it if it is taken.
+ */
+static void wait_for_monitor (Thread *thread)
+{
+  Object *pObj = word2obj (thread->waitingOn);
+
+  #ifdef VERIFY
+  assert (pObj != JNULL, THREADS6);
+  #endif
+
+  if (get_monitor_count (pObj) != NO_OWNER)
+  {
+    block_thread (thread);
+    return;
+  }
+
+  // Set the monitor depth to whatever was saved.
+  set_thread_id (pObj, thread->threadId);
+  set_monitor_count (pObj, thread->monitorCount);
+  thread->state = RUNNING;
+  #ifdef SAFE
+  thread->waitingOn = JNULL;
+  #endif
+  enqueue_thread (thread);
+}
+
+/**
+ * Ends the wait of a thread that called wait(). It still
+ * has to get the monitor back.
+ */
+static void notify_thread (Thread *thread)
+{
+  // might have been interrupted while waiting
+  if (thread->interruptState != INTERRUPT_CLEARED)
+    thread->interruptState = INTERRUPT_GRANTED;
+  thread->sleepUntil = 0;
+  thread->state = MON_WAITING;
+}
+
+/**
+ * Wakes up a sleeping or waiting thread that is not in any queue,
+ * because its time is up or it was interrupted.
+ */
+static void wake_thread (Thread *thread)
+{
+  #if DEBUG_THREADS
+  printf ("Waking up thread %d: %d\n", (int) thread, thread->threadId);
+  #endif
+  if (thread->state == CONDVAR_WAITING)
+  {
+    notify_thread (thread);
+    wait_for_monitor (thread);
+    return;
+  }
+
+  if (thread->interruptState != INTERRUPT_CLEARED)
+    thread->interruptState = INTERRUPT_GRANTED;
+  #ifdef SAFE
+  thread->sleepUntil = JNULL;
+  #endif
+  thread->state = RUNNING;
+  enqueue_thread (thread);
+}
+
+/**
+ * Frees a monitor. If it is inflated, it is handed to the thread
+ * of highest priority that waits to enter it instead, and deflated
+ * if no others wait.
+ */
+static void release_monitor (Object *obj)
+{
+  MonitorRecord *record;
+  Thread **pList;
+  Thread *thread;
+
+  if (!(get_monitor_count (obj) & MONITOR_INFLATED))
+  {
+    set_thread_id (obj, NO_OWNER);
+    set_monitor_count (obj, 0);
+    return;
+  }
+
+  record = get_monitor_record (obj, false);
+  pList = (record != null) ? &record->waiters : &monitorQ;
+  thread = take_waiter (pList, obj);
+
+  // Set the monitor depth to whatever was saved.
+  set_thread_id (obj, thread->threadId);
+  if (has_waiter (*pList, obj))
+    set_monitor_count (obj, thread->monitorCount | MONITOR_INFLATED);
+  else
+  {
+    set_monitor_count (obj, thread->monitorCount);
+    if (record != null)
+      record->object = null;
+  }
+  thread->state = RUNNING;
+  #ifdef SAFE
+  thread->waitingOn = JNULL;
+  #endif
+  enqueue_thread (thread);
+}
+
+/**
+ * @return true iff a thread that is not dead and not a daemon
+ *         is in one of the queues.
+ */
+static boolean has_non_daemon_thread()
+{
+  Thread *thread;
+  Thread *lists[3];
+  short i;
+  #if MAX_MONITOR_RECORDS
+  MonitorRecord *record;
+  #endif
+
+  for (i = MAX_PRIORITY-1; i >= 0; i--)
+  {
+    thread = threadQ[i];
+    if (thread == null)
+      continue;
+    do
+    {
+      thread = get_next_thread (thread);
+      if (!thread->daemon)
+        return true;
+    } while (thread != threadQ[i]);
+  }
+
+  lists[0] = sleepQ;
+  lists[1] = waitQ;
+  lists[2] = monitorQ;
+  for (i = 0; i < 3; i++)
+  {
+    for (thread = lists[i]; thread != null; thread = get_next_thread (thread))
+    {
+      if (!thread->daemon)
+        return true;
+    }
+  }
+
+  #if MAX_MONITOR_RECORDS
+  for (record = monitorRecords; record < monitorRecords + MAX_MONITOR_RECORDS; record++)
+  {
+    for (thread = record->waiters; thread != null; thread = get_next_thread (thread))
+    {
+      if (!thread->daemon)
+        return true;
+    }
+  }
+  #endif
+  return false;
+}
+
+#if PI_AVOIDANCE
+
+/**
+ * Finds a thread waiting to enter a monitor, by priority,
+ * or by id if priority is 0.
+ * @return The thread, or null if there is none.
+ */
+static Thread *find_monitor_waiter (byte priority, byte threadId)
+{
+  Thread *thread;
+  short i;
+
+  // -1 stands for monitorQ
+  for (i = -1; i < MAX_MONITOR_RECORDS; i++)
+  {
+    #if MAX_MONITOR_RECORDS
+    thread = (i < 0) ? monitorQ : monitorRecords[i].waiters;
+    #else
+    thread = monitorQ;
+    #endif
+    for (; thread != null; thread = get_next_thread (thread))
+    {
+      if (priority != 0 ? thread->priority == priority : thread->threadId == threadId)
+        return thread;
+    }
+  }
+  return null;
+}
+
+/**
+ * Finds the owner of the monitor that a thread in monitorQ with
+ * the given priority is waiting for. If the owner is waiting for
+ * a monitor too, goes on to that monitor's owner.
+ * @return The owner, or null if it cannot run.
+ */
+static Thread *find_runnable_owner (byte priority)
+{
+  Thread *thread;
+  Thread *owner;
+  byte threadId;
+  byte steps;
+  short j;
+
+  thread = find_monitor_waiter (priority, 0);
+
+  // A cycle of owners is a deadlock; give up on it.
+  for (steps = 0; steps < 255; steps++)
+  {
+    threadId = get_thread_id (word2obj (thread->waitingOn));
+    owner = null;
+    for (j = MAX_PRIORITY-1; owner == null && j >= 0; j--)
+    {
+      // Remember threadQ[j] is the last thread on the queue
+      thread = threadQ[j];
+      if (thread == null)
+        continue;
+      do
+      {
+        thread = get_next_thread (thread);
+        if (thread->threadId == threadId)
+          owner = thread;
+      } while (owner == null && thread != threadQ[j]);
+    }
+    if (owner != null)
+      return owner;
+
+    thread = find_monitor_waiter (0, threadId);
+    if (thread == null)
+      return null;
+  }
+  return null;
+}
+
+#endif // PI_AVOIDANCE
+
 /**
  * Switches to next thread:
  *
- * do
- *   get next thread
- *   if waiting, grab monitor and run
- *   if sleeping and timer expired, run
- *   if DEAD, clean up and use current thread
- *   if started, initialize and run
- * until selected thread can run
+ * if the current thread has died, clean up
+ * else if it has started to sleep or wait, move it to its queue
+ * else put it behind the other threads of its priority
+ * wake the sleeping threads whose time is up
+ * run the first thread of the highest priority that can run
+ *   (or the owner of a monitor a higher priority thread wants)
+ * if it is STARTED, initialize it
+ *
+ * Threads are only moved between queues when something happens
+ * to them, so this does not depend on the number of threads.
  *  
  * @return false iff there are no live threads
  *         to switch to.
@@ -161,11 +587,14 @@ boolean init_thread (Thread *thread)
  
 boolean switch_thread()
 {
-  Thread *anchorThread, *previousThread, *candidate;
+  Thread *candidate;
   Thread **pThreadQ;
-  boolean nonDaemonRunnable = false;
   StackFrame *stackFrame = null;
+  FOURBYTES now;
   short i;
+  #if PI_AVOIDANCE
+  short j;
+  #endif
 
   #if DEBUG_THREADS || DEBUG_BYTECODE
   printf ("------ switch_thread: currentThread at %d\n", (int) currentThread);
@@ -193,6 +622,7 @@ boolean switch_thread()
     
       // Remove thread from queue.
       dequeue_thread(currentThread);
+      gNonDaemonAlive = has_non_daemon_thread();
     }
     else { // Save context information
       stackFrame = current_stackframe();
@@ -204,230 +634,111 @@ boolean switch_thread()
       if (stackFrame != null) {
         update_stack_frame (stackFrame);
       }
+
+      if (currentThread->state == RUNNING)
+      {
+        // Move thread to end of queue, if it is at the front
+        pThreadQ = &threadQ[currentThread->priority - 1];
+        if (get_next_thread (*pThreadQ) == currentThread)
+          *pThreadQ = currentThread;
+      }
+      else if (currentThread->state != STARTED)
+      {
+        // It has just started to sleep or wait.
+        dequeue_thread (currentThread);
+        if (currentThread->state == MON_WAITING)
+          wait_for_monitor (currentThread);
+        else if (currentThread->interruptState != INTERRUPT_CLEARED)
+          wake_thread (currentThread);
+        else
+          block_thread (currentThread);
+      }
     }
   }
 
-  currentThread = null;
-  
-  // Loop until a frame is found that can be made to run.
-  for (i=MAX_PRIORITY-1; i >= 0; i--) {
-    pThreadQ = &threadQ[i];
-
-    previousThread = anchorThread = *pThreadQ;
-    if (!previousThread)
-      continue;
+  if (sleepQ != null)
+  {
+    now = get_sys_time();
+    while (sleepQ != null && now >= (FOURBYTES) sleepQ->sleepUntil)
+    {
+      candidate = sleepQ;
+      sleepQ = get_next_thread (candidate);
+      wake_thread (candidate);
+    }
+  }
 
-    do
+  currentThread = null;
+  for (i=MAX_PRIORITY-1; i >= 0; i--)
+  {
+    // Remember threadQ[i] is the last thread on the queue
+    if (threadQ[i] != null)
     {
-      candidate = word2ptr(previousThread->nextThread);
+      currentThread = get_next_thread (threadQ[i]);
+      break;
+    }
+  }
 
-      #if DEBUG_THREADS
-      printf ("Checking state of thread %d(%d)(s=%d,p=%d,i=%d,d=%d)\n",
-      	(int)candidate,
-      	(int)candidate->threadId,
-      	(int)candidate->state,
-      	(int)candidate->priority,
-      	(int)candidate->interruptState,
-      	(int)candidate->daemon
-             );
-      #endif
-      
-      // See if we can move a thread to the running state. Used to not do this if we
-      // had already found one, but turns out to be easiest if we are avoiding
-      // priority inversion.
-      switch (candidate->state)
-      {
-        case CONDVAR_WAITING:
-          // We are waiting to be notified
-          if ((candidate->sleepUntil > 0) && (get_sys_time() >= (FOURBYTES) candidate->sleepUntil))
-          {
-#if DEBUG_MONITOR
-      printf ("Waking up waiting thread %d: %d\n", (int) candidate, candidate->threadId);
-#endif
-            // We will drop through to mon waiting.
-          }
-          else if (candidate->interruptState == INTERRUPT_CLEARED)
-            break;
-          else
-            candidate->interruptState = INTERRUPT_GRANTED;
-
-          // candidate->state = MON_WAITING;
-          // drop through
-        case MON_WAITING:
-          {
-            Object *pObj = word2obj(candidate->waitingOn);
-            byte threadId = get_thread_id(pObj);
-
-            // We are waiting to enter a synchronized block
-            #ifdef VERIFY
-            assert (pObj != JNULL, THREADS6);
-            #endif
-             
-            if (threadId == NO_OWNER)
-            {
-              // NOW enter the monitor (guaranteed to succeed)
-              enter_monitor(candidate, pObj);
-              
-              // Set the monitor depth to whatever was saved.
-              set_monitor_count(pObj, candidate->monitorCount);
-              
-              // Let the thread run.
-              candidate->state = RUNNING;
-  
-              #ifdef SAFE
-              candidate->waitingOn = JNULL;
-              #endif
-            }
 #if PI_AVOIDANCE
-            // Only avoid priority inversion if we don't already have a thread to run.
-            else if (currentThread == null)
-            {
-            	Thread *pOwner;
-            	int j;
-            	
-            	// Track down who owns this monitor and run them instead.            	
-            	// Could be 'waiting' in a native method, or we could be deadlocked!
-find_next:
-            	if (candidate->threadId != threadId)
-            	{
-                    for (j=MAX_PRIORITY-1; j >= 0; j--)
-                    {
-                      pOwner = threadQ[j];
-                      if (!pOwner)
-                        continue;
-                        
-                      do {
-                        // Remember threadQ[j] is the last thread on the queue
-                        pOwner = word2ptr(pOwner->nextThread);
-                        if (pOwner->threadId == threadId)
-                        {
-            		      if (pOwner->state == RUNNING)
-            		      {
-            			    currentThread = pOwner;
-            			    goto done_pi;
-            			  }
-            			  
-            		      // if owner is waiting too, iterate down.
-            		      if (pOwner->state == MON_WAITING)
-            		      {
-            			    threadId = get_thread_id(word2obj(pOwner->waitingOn));
-            			    if (threadId != NO_OWNER)
-            				  goto find_next;
-            		      }
-                        }
-                      } while (pOwner != threadQ[j]);
-                    }                   
-                    // If we got here, we're in trouble, just drop through.
-            	}
-            }
-done_pi:
-		break;
-	    ;
-#endif // PI_AVOIDANCE
-          
-          }
-          break;
-        case SLEEPING:
-          if (candidate->interruptState != INTERRUPT_CLEARED
-              || (get_sys_time() >= (FOURBYTES) candidate->sleepUntil))
-          {
-      #if DEBUG_THREADS
-      printf ("Waking up sleeping thread %d: %d\n", (int) candidate, candidate->threadId);
-      #endif
-            candidate->state = RUNNING;
-            if (candidate->interruptState != INTERRUPT_CLEARED)
-          	candidate->interruptState = INTERRUPT_GRANTED;
-            #ifdef SAFE
-  	    candidate->sleepUntil = JNULL;
-            #endif // SAFE
-          }
-          break;
-        case STARTED:
-          if (currentThread == null)
-          {      
-            // Put stack ptr at the beginning of the stack so we can push arguments
-            // to entry methods. This assumes set_top_word or set_top_ref will
-            // be called immediately below.
-        #if DEBUG_THREADS
-        printf ("Starting thread %d: %d\n", (int) candidate, candidate->threadId);
-        #endif
-            currentThread = candidate;	// Its just easier this way.
-            init_sp_pv();
-            candidate->state = RUNNING;
-            if (candidate == bootThread)
-            {
-              MethodRecord *mRec;
-              ClassRecord *classRecord;
-              classRecord = get_class_record (get_entry_class (gProgramNumber));
-              // Initialize top word with fake parameter for main():
-              set_top_ref (JNULL);
-              // Push stack frame for main method:
-              mRec= find_method (classRecord, main_4_1Ljava_3lang_3String_2_5V);
-              dispatch_special (mRec, null);
-              // Push another if necessary for the static initializer:
-              dispatch_static_initializer (classRecord, pc);
-            }
-            else
-            {
-              set_top_ref (ptr2word (candidate));
-              dispatch_virtual ((Object *) candidate, run_4_5V, null);
-            }
-            // The following is needed because the current stack frame
-            // was just created
-            stackFrame = current_stackframe();
-            update_stack_frame (stackFrame);
-          }
-          break;
-        case RUNNING:
-          // Its running already
-        case DEAD:
-          // Dead threads should be handled earlier
-        default:
-          // ???
-          break;
-      }
-
-      // Do we now have a thread we want to run?
-      // Note we may later decide not to if all non-daemon threads have died        
-      if (currentThread == null && candidate->state == RUNNING)
-      {
+  // If a thread of higher priority is waiting for a monitor,
+  // run the monitor's owner instead, so that it releases it.
+  for (j=MAX_PRIORITY-1; j > i; j--)
+  {
+    if (monitorWaiters[j] != 0)
+    {
+      candidate = find_runnable_owner (j + 1);
+      if (candidate != null)
         currentThread = candidate;
-        // Move thread to end of queue
-        *pThreadQ = candidate;
-      }
-      
-      if (!candidate->daemon)
-      {
-      	// May or may not be running but it could do at some point
-#if DEBUG_THREADS
-printf ("Found a non-daemon thread %d: %d(%d)\n", (int) candidate, (int)candidate->threadId, (int) candidate->state);
-#endif
-           nonDaemonRunnable = true;
-      }
-      
-      #if DEBUG_THREADS
-      printf ("switch_thread: done processing thread %d: %d\n", (int) candidate,
-              (int) (candidate->state == RUNNING));
-      #endif
+      break;
+    }
+  }
+#endif // PI_AVOIDANCE
 
-      // Always use the first running thread as the thread
-      // Keep looping: cull dead threads, check there's at least one non-daemon thread
-      previousThread = candidate;
-    } while (candidate != anchorThread);
-  } // end for
-  
 #if DEBUG_THREADS
-printf ("currentThread=%d, ndr=%d\n", (int) currentThread, (int)nonDaemonRunnable);
+printf ("currentThread=%d, ndr=%d\n", (int) currentThread, (int)gNonDaemonAlive);
 #endif
 
 #if DEBUG_THREADS
   printf ("Leaving switch_thread()\n");
 #endif
-  if (nonDaemonRunnable)
+  if (gNonDaemonAlive)
   {
     // There is at least one non-daemon thread left alive
     if (currentThread != null)
     {
+      if (currentThread->state == STARTED)
+      {
+        // Put stack ptr at the beginning of the stack so we can push arguments
+        // to entry methods. This assumes set_top_word or set_top_ref will
+        // be called immediately below.
+        #if DEBUG_THREADS
+        printf ("Starting thread %d: %d\n", (int) currentThread, currentThread->threadId);
+        #endif
+        init_sp_pv();
+        currentThread->state = RUNNING;
+        if (currentThread == bootThread)
+        {
+          MethodRecord *mRec;
+          ClassRecord *classRecord;
+          classRecord = get_class_record (get_entry_class (gProgramNumber));
+          // Initialize top word with fake parameter for main():
+          set_top_ref (JNULL);
+          // Push stack frame for main method:
+          mRec= find_method (classRecord, main_4_1Ljava_3lang_3String_2_5V);
+          dispatch_special (mRec, null);
+          // Push another if necessary for the static initializer:
+          dispatch_static_initializer (classRecord, pc);
+        }
+        else
+        {
+          set_top_ref (ptr2word (currentThread));
+          dispatch_virtual ((Object *) currentThread, run_4_5V, null);
+        }
+        // The following is needed because the current stack frame
+        // was just created
+        stackFrame = current_stackframe();
+        update_stack_frame (stackFrame);
+      }
+
       // If we found a running thread and there is at least one
       // non-daemon thread left somewhere in the queue...
       #if DEBUG_THREADS
@@ -480,7 +791,7 @@ void monitor_wait(Object *obj, const FOURBYTES time)
   currentThread->state = CONDVAR_WAITING;
   
   // Save monitor depth
-  currentThread->monitorCount = get_monitor_count(obj);
+  currentThread->monitorCount = get_monitor_depth(obj);
   
   // Save the object who's monitor we will want back
   currentThread->waitingOn = ptr2word (obj);
@@ -496,8 +807,7 @@ void monitor_wait(Object *obj, const FOURBYTES time)
 #endif
 
   // Indicate that the object's monitor is now free.
-  set_thread_id (obj, NO_OWNER);
-  set_monitor_count(obj, 0);
+  release_monitor (obj);
   
   // Gotta yield
   schedule_request( REQUEST_SWITCH_THREAD);
@@ -526,34 +836,86 @@ void monitor_notify(Object *obj, const boolean all)
  */
 void monitor_notify_unchecked(Object *obj, const boolean all)
 {
+  Thread **lists[2] = { &waitQ, &sleepQ };
+  Thread *pThread, *previous, *next, *best, *notified;
   short i;
-  Thread *pThread;
   
 #if DEBUG_MONITOR
   printf("monitor_notify_unchecked of %d, thread %d(%d)\n",(int)obj, (int)currentThread, currentThread->threadId);
 #endif
-  // Find a thread waiting on us and move to WAIT state.
-  for (i=MAX_PRIORITY-1; i >= 0; i--)
+  // The current thread may have called wait() and not
+  // been moved to waitQ yet.
+  if (currentThread != null && is_waiting_on (currentThread, obj))
   {
-    pThread = threadQ[i];
-    if (!pThread)
-      continue;
-      
-    do {
-      // Remember threadQ[i] is the last thread on the queue
-      pThread = word2ptr(pThread->nextThread);
-      if (pThread->state == CONDVAR_WAITING && pThread->waitingOn == ptr2word (obj))
-      {
-        // might have been interrupted while waiting
-        if (pThread->interruptState != INTERRUPT_CLEARED)
-          pThread->interruptState = INTERRUPT_GRANTED;
+    notify_thread (currentThread);
+    if (!all)
+      return;
+  }
 
-        pThread->state = MON_WAITING;
+  // Find a thread waiting on us in waitQ or, if it has a time
+  // out, sleepQ. For notifyAll, take them all out before any
+  // of them goes to monitorQ.
+  best = notified = null;
+  for (i = 0; i < 2; i++)
+  {
+    previous = null;
+    for (pThread = *lists[i]; pThread != null; pThread = next)
+    {
+      next = get_next_thread (pThread);
+      if (is_waiting_on (pThread, obj))
+      {
         if (!all)
-          return;
+        {
+          if (best == null || pThread->priority > best->priority)
+            best = pThread;
+        }
+        else
+        {
+          if (previous == null)
+            *lists[i] = next;
+          else
+            previous->nextThread = ptr2word (next);
+          pThread->nextThread = ptr2word (notified);
+          notified = pThread;
+          continue;
+        }
       }
-    } while (pThread != threadQ[i]);
+      previous = pThread;
+    }
+  }
+
+  if (best != null)
+  {
+    unblock_thread (best);
+    notify_thread (best);
+    wait_for_monitor (best);
+    return;
+  }
+  while (notified != null)
+  {
+    pThread = notified;
+    notified = get_next_thread (pThread);
+    notify_thread (pThread);
+    wait_for_monitor (pThread);
+  }
+}
+
+/**
+ * Checks that pThread can enter obj's monitor once more. The depth
+ * shares the monitor count with MONITOR_INFLATED, so a thread can
+ * hold a monitor at most MONITOR_INFLATED - 1 times.
+ *
+ * @return false if it cannot; IllegalMonitorStateException is thrown.
+ */
+boolean check_monitor_depth (Thread *pThread, Object* obj)
+{
+  if (get_monitor_count (obj) != NO_OWNER && pThread->threadId == get_thread_id (obj) &&
+      get_monitor_depth (obj) == MONITOR_INFLATED - 1)
+  {
+    throw_exception (illegalMonitorStateException);
+    return false;
   }
+  return true;
 }
 
 /**
@@ -576,6 +938,9 @@ void enter_monitor (Thread *pThread, Object* obj)
     return;
   }
 
+  if (!check_monitor_depth (pThread, obj))
+    return;
+
   if (get_monitor_count (obj) != NO_OWNER && pThread->threadId != get_thread_id (obj))
   {
     // There is an owner, but its not us.
@@ -615,9 +980,10 @@ void exit_monitor (Thread *pThread, Object* obj)
   #endif
 
   newMonitorCount = get_monitor_count(obj)-1;
-  if (newMonitorCount == 0)
-    set_thread_id (obj, NO_OWNER);
-  set_monitor_count (obj, newMonitorCount);
+  if ((newMonitorCount & (MONITOR_INFLATED - 1)) == 0)
+    release_monitor (obj);
+  else
+    set_monitor_count (obj, newMonitorCount);
 }
 
 /**
@@ -697,8 +1063,54 @@ void set_thread_priority(Thread *thread, const FOURBYTES priority)
   	return;
   }
 
-  dequeue_thread(thread);
-  thread->priority = priority;
-  enqueue_thread(thread);      
+  if (thread->state == RUNNING || thread->state == STARTED)
+  {
+    dequeue_thread(thread);
+    thread->priority = priority;
+    enqueue_thread(thread);
+  }
+  else if (thread->state == MON_WAITING && thread != currentThread)
+  {
+    monitorWaiters[thread->priority - 1]--;
+    thread->priority = priority;
+    monitorWaiters[thread->priority - 1]++;
+  }
+  else
+    thread->priority = priority;
+}
+
+/**
+ * Mark thread as interrupted. If it is sleeping or waiting
+ * to be notified, it wakes up.
+ */
+void interrupt_thread(Thread *thread)
+{
+  thread->interruptState = INTERRUPT_REQUESTED;
+  if (thread != currentThread &&
+      (thread->state == SLEEPING || thread->state == CONDVAR_WAITING))
+  {
+    unblock_thread (thread);
+    wake_thread (thread);
+  }
+}
+
+void init_threads()
+{
+  int i;
+  Thread **pQ = threadQ;
+  gThreadCounter = 0;
+  currentThread = JNULL;
+  for (i = 0; i<10; i++)
+  {
+    *pQ++ = null;
+  }
+  sleepQ = waitQ = monitorQ = null;
+  #if MAX_MONITOR_RECORDS
+  for (i = 0; i < MAX_MONITOR_RECORDS; i++)
+    monitorRecords[i].object = null;
+  #endif
+  for (i = 0; i < MAX_PRIORITY; i++)
+    monitorWaiters[i] = 0;
+  gNonDaemonAlive = false;
 }
 
@@ -3,6 +3,7 @@
 #include "language.h"
 #include "constants.h"
 #include "trace.h"
+#include "configure.h"
 
 #ifndef _THREADS_H
 #define _THREADS_H
@@ -30,9 +31,28 @@ extern Thread *currentThread;
 extern Thread *bootThread;
 extern byte gThreadCounter;
 extern Thread *threadQ[];
+extern Thread *sleepQ;
+extern Thread *waitQ;
+extern Thread *monitorQ;
 extern byte gProgramNumber;
 extern boolean gRequestSuicide;
 
+/**
+ * A contended monitor
+ */
+typedef struct S_MonitorRecord
+{
+  // null if the record is free
+  Object *object;
+  // Threads waiting to enter the monitor, newest first,
+  // linked through nextThread.
+  Thread *waiters;
+} MonitorRecord;
+
+#if MAX_MONITOR_RECORDS
+extern MonitorRecord monitorRecords[];
+#endif
+
 /**
  * A stack frame record
  */
@@ -48,8 +68,10 @@ typedef struct S_StackFrame
   STACKWORD *stackTop;
 } StackFrame;
 
+extern void init_threads();
 extern boolean init_thread (Thread *thread);
 extern StackFrame *current_stackframe();
+extern boolean check_monitor_depth (Thread *pThread, Object* obj);
 extern void enter_monitor (Thread *pThread, Object* obj);
 extern void exit_monitor (Thread *pThread, Object* obj);
 extern boolean switch_thread();
@@ -70,20 +92,8 @@ extern void monitor_notify_unchecked(Object *obj, const boolean all);
 #define inc_program_number()     {if (++gProgramNumber >= get_num_entry_classes()) gProgramNumber = 0;}
 #define get_program_number()     gProgramNumber 
 
-static inline void init_threads()
-{
-  int i;
-  Thread **pQ = threadQ;
-  gThreadCounter = 0;
-  currentThread = JNULL;
-  for (i = 0; i<10; i++)
-  {
-    *pQ++ = null;
-  }
-}
-
 /**
- * Sets thread state to SLEEPING.
+ * Sets thread state to SLEEPING. switch_thread() moves it to sleepQ.
  * Thread should be switched immediately after calling this method.
  */
 static inline void sleep_thread (const FOURBYTES time)
@@ -105,15 +115,8 @@ static inline int get_thread_priority(Thread *thread)
   return thread->priority;
 }
 
-/**
- * Mark thread as interrupted.
- */
-static inline void interrupt_thread(Thread *thread)
-{
-  thread->interruptState = INTERRUPT_REQUESTED;
-}
-
 extern void set_thread_priority(Thread *thread, const FOURBYTES priority);
+extern void interrupt_thread(Thread *thread);
 
 #endif
 
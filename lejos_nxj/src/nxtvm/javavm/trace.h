@@ -46,6 +46,10 @@
 
 #define BAD_MAGIC	 54
 
+#define GC0          60
+#define GC1          61
+#define GC2          62
+
 #define ASSERT_TOP	100
 
 #define assert( cond, code)  assert_hook( cond, code);
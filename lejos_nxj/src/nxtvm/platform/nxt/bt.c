@@ -8,8 +8,25 @@
 #include "systick.h"
 
 static U8 in_buf[2][128];
-static U8 in_buf_in_ptr, out_buf_ptr;
-static U8 out_buf[2][256];
+static U8 in_buf_in_ptr;
+
+/*
+ * Output is queued in a ring that the PDC sends straight from, so
+ * each byte is copied once. The indices run freely and are masked
+ * when used: bytes from tx_tail to tx_head are waiting or being sent,
+ * and those from tx_tail to tx_queued have been given to the PDC, as
+ * its current buffer and then its next one. The US1 interrupt moves
+ * the PDC on through the ring.
+ */
+#define TX_RING_SIZE 512
+#define TX_MAX_WRITE 256
+
+static U8 tx_ring[TX_RING_SIZE];
+static volatile U32 tx_head;
+static volatile U32 tx_tail;
+static volatile U32 tx_queued;
+static volatile U32 tx_pdc_len[2];
+static U32 tx_dropped;
 
 static U8* buf_ptr;
 
@@ -18,13 +35,17 @@ static int in_buf_idx = 0;
 #define BAUD_RATE 460800
 #define CLOCK_RATE 48054850
 
+extern void bt_isr_entry(void);
 	
 void bt_init(void)
 {
   U8 trash;
   U32 trash2;
-  in_buf_in_ptr = out_buf_ptr = 0; 
+  in_buf_in_ptr = 0; 
   in_buf_idx = 0;
+  tx_head = tx_tail = tx_queued = 0;
+  tx_pdc_len[0] = tx_pdc_len[1] = 0;
+  tx_dropped = 0;
   
   *AT91C_PMC_PCER = (1 << AT91C_PERIPHERAL_ID_US1); 
   
@@ -34,7 +55,7 @@ void bt_init(void)
   *AT91C_US1_CR   = AT91C_US_RSTSTA;
   *AT91C_US1_CR   = AT91C_US_STTTO;
   *AT91C_US1_RTOR = 10000; 
-  *AT91C_US1_IDR  = AT91C_US_TIMEOUT;
+  *AT91C_US1_IDR  = AT91C_US_TIMEOUT | AT91C_US_ENDTX | AT91C_US_TXBUFE;
   *AT91C_US1_MR = (AT91C_US_USMODE_HWHSH & ~AT91C_US_SYNC) | AT91C_US_CLKS_CLOCK | AT91C_US_CHRL_8_BITS | AT91C_US_PAR_NONE | AT91C_US_NBSTOP_1_BIT | AT91C_US_OVER;
   *AT91C_US1_BRGR = ((CLOCK_RATE/8/BAUD_RATE) | (((CLOCK_RATE/8) - ((CLOCK_RATE/8/BAUD_RATE) * BAUD_RATE)) / ((BAUD_RATE + 4)/8)) << 16);
   *AT91C_US1_PTCR = (AT91C_PDC_RXTDIS | AT91C_PDC_TXTDIS); 
@@ -42,9 +63,13 @@ void bt_init(void)
   *AT91C_US1_TCR  = 0; 
   *AT91C_US1_RNPR = 0;
   *AT91C_US1_TNPR = 0;
+  *AT91C_US1_TNCR = 0;
   
   aic_mask_off(AT91C_PERIPHERAL_ID_US1);
   aic_clear(AT91C_PERIPHERAL_ID_US1);
+  aic_set_vector(AT91C_PERIPHERAL_ID_US1, AIC_INT_LEVEL_NORMAL,
+                 (U32) bt_isr_entry);
+  aic_mask_on(AT91C_PERIPHERAL_ID_US1);
 
   trash = *AT91C_US1_RHR;
   trash = *AT91C_US1_CSR;
@@ -99,30 +124,142 @@ U32 bt_get_mode()
   return (U32) *AT91C_ADC_CDR6;
 }
 
-void bt_send(U8 *buf, U32 len)
+/*
+ * Retires the PDC buffers that have been sent. This is read from the
+ * counters, not from ENDTX, which stays set from the end of one buffer
+ * while the next one is sent: the next buffer has become current once
+ * TNCR is 0, and the current one is done once TCR is 0 with no next
+ * buffer.
+ */
+static void tx_retire(void)
 {
-  if (*AT91C_US1_TNCR == 0)
+  if (tx_pdc_len[1] != 0 && *AT91C_US1_TNCR == 0)
   {
-    memcpy(&(out_buf[out_buf_ptr][0]), buf, len);
-    *AT91C_US1_TNPR = (unsigned int) &(out_buf[out_buf_ptr][0]);
-    *AT91C_US1_TNCR = len;
-    out_buf_ptr = (out_buf_ptr+1) % 2;
+    tx_tail += tx_pdc_len[0];
+    tx_pdc_len[0] = tx_pdc_len[1];
+    tx_pdc_len[1] = 0;
+  }
+  if (tx_pdc_len[1] == 0 && tx_pdc_len[0] != 0 && *AT91C_US1_TCR == 0)
+  {
+    tx_tail += tx_pdc_len[0];
+    tx_pdc_len[0] = 0;
   }
 }
 
-U32 bt_write(U8 *buf, U32 off, U32 len)
+/*
+ * Retires the buffers sent, then gives the PDC the queued bytes it
+ * does not have yet, for as many of its two buffers as are free. A
+ * buffer cannot run past the end of the ring, so a wrapped run of bytes
+ * takes both.
+ *
+ * ENDTX is enabled only while both buffers are in use: TNCR has then
+ * been written since the current buffer started, which cleared ENDTX,
+ * so it is raised by the end of the current buffer. With a single
+ * buffer, TXBUFE is enabled instead, and is raised when it ends.
+ * Called by the interrupt handler, or with both interrupts disabled.
+ */
+static void tx_start(void)
 {
-  if (*AT91C_US1_TNCR == 0)
-  {	
-    if (len > 256) len = 256;	
-    memcpy(&(out_buf[out_buf_ptr][0]), buf+off, len);
-    *AT91C_US1_TNPR = (unsigned int) &(out_buf[out_buf_ptr][0]);
-    *AT91C_US1_TNCR = len;
-    out_buf_ptr = (out_buf_ptr+1) % 2;
-    return len;
+  U32 start, len;
+
+  tx_retire();
+  while (tx_pdc_len[1] == 0 && tx_queued != tx_head)
+  {
+    start = tx_queued & (TX_RING_SIZE - 1);
+    len = tx_head - tx_queued;
+    if (len > TX_RING_SIZE - start) len = TX_RING_SIZE - start;
+    if (tx_pdc_len[0] == 0)
+    {
+      *AT91C_US1_TPR = (unsigned int) &(tx_ring[start]);
+      *AT91C_US1_TCR = len;
+      tx_pdc_len[0] = len;
+    }
+    else
+    {
+      // If the current buffer has just run out, this one starts at once
+      // and tx_retire finds both done when it ends.
+      *AT91C_US1_TNPR = (unsigned int) &(tx_ring[start]);
+      *AT91C_US1_TNCR = len;
+      tx_pdc_len[1] = len;
+    }
+    tx_queued += len;
+  }
+  if (tx_pdc_len[1] != 0)
+  {
+    *AT91C_US1_IDR = AT91C_US_TXBUFE;
+    *AT91C_US1_IER = AT91C_US_ENDTX;
+  }
+  else if (tx_pdc_len[0] != 0)
+  {
+    *AT91C_US1_IDR = AT91C_US_ENDTX;
+    *AT91C_US1_IER = AT91C_US_TXBUFE;
   }
   else
+    *AT91C_US1_IDR = AT91C_US_ENDTX | AT91C_US_TXBUFE;
+}
+
+/*
+ * ENDTX or TXBUFE: the current buffer has been sent.
+ */
+void bt_isr_C(void)
+{
+  tx_start();
+}
+
+/*
+ * Copies the parts of a message into the ring and starts them,
+ * all or nothing. Not reentrant: only one task may write at a time.
+ * @return 1 if queued, 0 if there was no room (counted as a drop).
+ */
+static int tx_queue(U8 *head, U32 head_len, U8 *buf, U32 len)
+{
+  U32 i;
+
+  if (head_len + len > bt_tx_space())
+  {
+    tx_dropped++;
     return 0;
+  }
+  for (i = 0; i < head_len; i++)
+    tx_ring[(tx_head + i) & (TX_RING_SIZE - 1)] = head[i];
+  for (i = 0; i < len; i++)
+    tx_ring[(tx_head + head_len + i) & (TX_RING_SIZE - 1)] = buf[i];
+  // Keep the interrupt handler out while the PDC state is changed
+  *AT91C_US1_IDR = AT91C_US_ENDTX | AT91C_US_TXBUFE;
+  tx_head += head_len + len;
+  tx_start();
+  return 1;
+}
+
+void bt_send(U8 *buf, U32 len)
+{
+  tx_queue(0, 0, buf, len);
+}
+
+U32 bt_write(U8 *buf, U32 off, U32 len)
+{
+  if (len > TX_MAX_WRITE) len = TX_MAX_WRITE;
+  return tx_queue(0, 0, buf+off, len) ? len : 0;
+}
+
+U32 bt_write_packet(U8 *buf, U32 len)
+{
+  U8 header[2];
+
+  // Stream mode packets start with their length, low byte first
+  header[0] = (U8) (len & 0xFF);
+  header[1] = (U8) ((len >> 8) & 0xFF);
+  return tx_queue(header, 2, buf, len) ? len : 0;
+}
+
+U32 bt_tx_space(void)
+{
+  return TX_RING_SIZE - (tx_head - tx_tail);
+}
+
+U32 bt_tx_dropped(void)
+{
+  return tx_dropped;
 }
 
 U32 bt_pending()
@@ -137,7 +274,7 @@ U32 bt_pending()
   else 
     bytes_ready = 128 - *AT91C_US1_RCR;
   if (bytes_ready  > in_buf_idx) ret |= 1;
-  if ((*AT91C_US1_TCR != 0) || (*AT91C_US1_TNCR != 0)) ret |= 2;
+  if (tx_head != tx_tail) ret |= 2;
   return ret;
 }
 
@@ -294,9 +431,16 @@ void bt_reset(void)
   bt_clear_arm7_cmd();
   // BC4 reset sequence. First take the reset line low for 100ms
   bt_set_reset_low();
+  // Drop any output still queued, so that the ring can be used as
+  // a scratch area below.
+  *AT91C_US1_IDR = AT91C_US_ENDTX | AT91C_US_TXBUFE;
+  *AT91C_US1_TNCR = 0;
+  *AT91C_US1_TCR = 0;
+  tx_head = tx_tail = tx_queued = 0;
+  tx_pdc_len[0] = tx_pdc_len[1] = 0;
   // Wait and discard any packets that may be around
   int cnt = 100;
-  U8 *buf = out_buf[0];
+  U8 *buf = tx_ring;
   while (cnt-- > 0)
   {
     bt_receive(buf);
@@ -304,8 +448,8 @@ void bt_reset(void)
   }
   bt_set_reset_high();
   // Now wait either for 5000ms or for the BC4 chip to signal reset
-  // complete. Note we use the out buffer as a scratch area here
-  // this id safe since we are forcing a reset.
+  // complete. Note we use the output ring as a scratch area here
+  // this is safe since we are forcing a reset.
   cnt = 5000;
   while (cnt-- > 0)
   {
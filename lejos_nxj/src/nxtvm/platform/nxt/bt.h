@@ -86,7 +86,11 @@ void bt_receive(U8 * buf);
 U32 bt_get_mode(void);
 void bt_reset(void);
 U32 bt_write(U8 *buf, U32 off, U32 len);
+U32 bt_write_packet(U8 *buf, U32 len);
+U32 bt_tx_space(void);
+U32 bt_tx_dropped(void);
 U32 bt_read(U8 * buf, U32 off, U32 len);
 U32 bt_pending(void);
+void bt_isr_C(void);
 
 #endif /*BT_H_*/
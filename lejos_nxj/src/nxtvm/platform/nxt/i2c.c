@@ -103,6 +103,33 @@ typedef enum {
   I2C_STOP3,
 } i2c_port_state;
 
+// Transactions wait in a ring on each port and are started by the
+// interrupt, one after the other, as the port becomes idle.
+struct i2c_txn {
+  U32 address;
+  int internal_address;
+  int n_internal_address_bytes;
+  U8 *data;
+  U32 nbytes;
+  int write;
+  i2c_callback callback;
+  void *arg;
+};
+
+// A poll reads a device register every period ms into rx, from where
+// it is copied to data once the read is known to be good.
+struct i2c_poll {
+  U32 period;	/* 0 if the slot is free */
+  U32 due;
+  U8  address;
+  U8  internal_address;
+  U8  nbytes;
+  U8  queued;
+  U8  valid;
+  U8  rx[I2C_POLL_MAX_BYTES];
+  U8  data[I2C_POLL_MAX_BYTES];
+};
+
 struct i2c_port_struct {
   U32 scl_pin;
   U32 sda_pin;
@@ -125,6 +152,12 @@ struct i2c_port_struct {
   U32 ack_good;
   U32 pt_num;
   U32 pt_begun;
+  U32 txn_fault;
+
+  struct i2c_txn queue[I2C_QUEUE_LEN];
+  U32 q_head;
+  U32 q_count;
+  struct i2c_poll poll[I2C_MAX_POLLS];
 };
 
 static struct i2c_port_struct i2c_port[I2C_N_PORTS];
@@ -159,8 +192,93 @@ static void i2c_log(int port, int state, int inpin)
 
 static U32 i2c_int_count;
 
+static void (*i2c_idle_callback)(int port);
+
 extern void i2c_timer_isr_entry(void);
 
+static void i2c_setup(struct i2c_port_struct *p, struct i2c_txn *t);
+
+// Add a transaction to the queue of a port. Also called from the
+// interrupt, so the queue is only changed with interrupts off.
+static int
+i2c_enqueue(struct i2c_port_struct *p, struct i2c_txn *t)
+{
+  int istate = interrupts_get_and_disable();
+  int ret = -1;
+
+  if (p->q_count < I2C_QUEUE_LEN) {
+    p->queue[(p->q_head + p->q_count) % I2C_QUEUE_LEN] = *t;
+    p->q_count++;
+    ret = 0;
+  }
+  if (istate)
+    interrupts_enable();
+  return ret;
+}
+
+// The transaction at the head of the queue has ended: report it and
+// leave the port idle, to start the next one on the following tick.
+static void
+i2c_complete(int port, struct i2c_port_struct *p)
+{
+  struct i2c_txn t;
+  int istate = interrupts_get_and_disable();
+
+  t = p->queue[p->q_head];
+  p->q_head = (p->q_head + 1) % I2C_QUEUE_LEN;
+  p->q_count--;
+  p->state = I2C_IDLE;
+  if (istate)
+    interrupts_enable();
+
+  if (t.callback)
+    t.callback(port, p->txn_fault ? -1 : 0, t.arg);
+  if (p->q_count == 0 && i2c_idle_callback)
+    i2c_idle_callback(port);
+}
+
+static void
+i2c_poll_done(int port, int status, void *arg)
+{
+  struct i2c_poll *poll = (struct i2c_poll *) arg;
+
+  poll->queued = 0;
+  if (poll->period == 0)
+    return;
+  poll->valid = (status == 0);
+  if (poll->valid)
+    memcpy(poll->data, poll->rx, poll->nbytes);
+}
+
+// Queue the reads of the polls that are due
+static void
+i2c_run_polls(struct i2c_port_struct *p, U32 now)
+{
+  struct i2c_poll *poll = p->poll;
+  struct i2c_txn t;
+  int i;
+
+  for (i = 0; i < I2C_MAX_POLLS; i++, poll++) {
+    if (poll->period == 0 || poll->queued || (int) (now - poll->due) < 0)
+      continue;
+    t.address = poll->address;
+    t.internal_address = poll->internal_address;
+    t.n_internal_address_bytes = 1;
+    t.data = poll->rx;
+    t.nbytes = poll->nbytes;
+    t.write = 0;
+    t.callback = i2c_poll_done;
+    t.arg = poll;
+    if (i2c_enqueue(p, &t) < 0)
+      break;
+    poll->queued = 1;
+    // Keep to the schedule, unless it has fallen a whole period behind
+    poll->due += poll->period;
+    if ((int) (now - poll->due) >= 0)
+      poll->due = now + poll->period;
+  }
+}
+
 void
 i2c_timer_isr_C(void)
 {
@@ -176,6 +294,7 @@ i2c_timer_isr_C(void)
   struct i2c_port_struct *p = i2c_port;
 
   U32 dummy = *AT91C_TC0_SR;
+  U32 now = systick_get_ms();
 
   i2c_int_count++;
   
@@ -188,6 +307,11 @@ i2c_timer_isr_C(void)
     case I2C_UNINITIALISED:	// Uninitialised
       break;
     case I2C_IDLE:		// Not in a transaction
+      i2c_run_polls(p, now);
+      if (p->q_count) {
+        i2c_setup(p, &p->queue[p->q_head]);
+        p->state = I2C_BEGIN;
+      }
       break;
     case I2C_BEGIN:		
       // Start the current partial transaction
@@ -221,7 +345,7 @@ i2c_timer_isr_C(void)
         }
       }
       else {
-        p->state = I2C_IDLE;
+        i2c_complete(i, p);
       }
       break;
     case I2C_RESTART1:
@@ -321,6 +445,7 @@ i2c_timer_isr_C(void)
           p->n_fault++;
           p->ack_fail++;
           p->fault=1;
+          p->txn_fault=1;
           codr |= p->scl_pin;
           p->state = I2C_STOP0;
         }
@@ -371,8 +496,9 @@ i2c_timer_isr_C(void)
       p->state = I2C_STOP3;
       break;
     case I2C_STOP3:
-      if(p->current_pt->last_pt){
-        p->state = I2C_IDLE;
+      // A transaction that was not acknowledged ends here
+      if(p->current_pt->last_pt || p->txn_fault){
+        i2c_complete(i, p);
       } else {
         p->current_pt++;
         p->pt_num++;
@@ -395,14 +521,18 @@ i2c_timer_isr_C(void)
 }
 
 
-// Disable an I2C port
+// Disable an I2C port and stop its polls. Transactions already
+// queued still run.
 void
 i2c_disable(int port)
 {
   if (port >= 0 && port < I2C_N_PORTS) {
     struct i2c_port_struct *p = &i2c_port[port];
     U32 pinmask = p->scl_pin | p->sda_pin;
+    int i;
 
+    for (i = 0; i < I2C_MAX_POLLS; i++)
+      p->poll[i].period = 0;
     *AT91C_PIOA_ODR = pinmask;
   }
 }
@@ -470,16 +600,17 @@ i2c_init(void)
 }
 
 
-// Is the port busy?
+// Is the port busy, or are transactions waiting?
 int
 i2c_busy(int port)
 {
   if(port >= 0 && port < I2C_N_PORTS)
-    return (i2c_port[port].state > I2C_IDLE);
+    return (i2c_port[port].state > I2C_IDLE || i2c_port[port].q_count != 0);
   return 0;
 }
 
-/* Start a transaction. 
+/* Start a transaction. Fails if the port is busy: use
+ * i2c_queue_transaction to queue several.
  */
 int
 i2c_start_transaction(int port, 
@@ -490,16 +621,137 @@ i2c_start_transaction(int port,
                       U32 nbytes,
                       int write)
 { 
-  struct i2c_port_struct *p;
-  struct i2c_partial_transaction *pt;
+  if(i2c_busy(port))
+    return -1;
+
+  return i2c_queue_transaction(port, address, internal_address,
+                               n_internal_address_bytes, data, nbytes,
+                               write, 0, 0);
+}
+
+/* Queue a transaction behind those already waiting on the port.
+ * callback, if not null, is called from the interrupt when it ends.
+ * Returns -1 if the queue is full.
+ */
+int
+i2c_queue_transaction(int port,
+                      U32 address,
+                      int internal_address,
+                      int n_internal_address_bytes,
+                      U8 *data,
+                      U32 nbytes,
+                      int write,
+                      i2c_callback callback,
+                      void *arg)
+{
+  struct i2c_txn t;
+
   if(port < 0 || port >= I2C_N_PORTS)
     return -1;
-    
-  if(i2c_busy(port))
+
+  t.address = address;
+  t.internal_address = internal_address;
+  t.n_internal_address_bytes = n_internal_address_bytes;
+  t.data = data;
+  t.nbytes = nbytes;
+  t.write = write;
+  t.callback = callback;
+  t.arg = arg;
+  return i2c_enqueue(&i2c_port[port], &t);
+}
+
+/* Read nbytes from internal_address of a device every period_ms,
+ * without a task having to ask. Returns a handle for i2c_get_poll,
+ * or -1 if the port has no free poll.
+ */
+int
+i2c_add_poll(int port, U32 address, int internal_address, U32 nbytes,
+             U32 period_ms)
+{
+  struct i2c_poll *poll;
+  int istate;
+  int i;
+  int ret = -1;
+
+  if(port < 0 || port >= I2C_N_PORTS || nbytes == 0 ||
+     nbytes > I2C_POLL_MAX_BYTES || period_ms == 0)
     return -1;
-    
-  p = &i2c_port[port];
+
+  // The interrupt takes the poll up as soon as period is set
+  istate = interrupts_get_and_disable();
+  for (i = 0; i < I2C_MAX_POLLS; i++) {
+    poll = &i2c_port[port].poll[i];
+    if (poll->period == 0 && !poll->queued) {
+      poll->address = address;
+      poll->internal_address = internal_address;
+      poll->nbytes = nbytes;
+      poll->valid = 0;
+      poll->due = systick_get_ms();
+      poll->period = period_ms;
+      ret = port * I2C_MAX_POLLS + i;
+      break;
+    }
+  }
+  if (istate)
+    interrupts_enable();
+  return ret;
+}
+
+void
+i2c_remove_poll(int poll)
+{
+  if (poll >= 0 && poll < I2C_N_PORTS * I2C_MAX_POLLS)
+    i2c_port[poll / I2C_MAX_POLLS].poll[poll % I2C_MAX_POLLS].period = 0;
+}
+
+/* Copy the latest good read of a poll. Returns the number of bytes
+ * copied, or -1 if there is none (yet, or the last read failed).
+ */
+int
+i2c_get_poll(int poll, U8 *data, U32 nbytes)
+{
+  struct i2c_poll *p;
+  int istate;
+  int ret = -1;
+
+  if (poll < 0 || poll >= I2C_N_PORTS * I2C_MAX_POLLS)
+    return -1;
+  p = &i2c_port[poll / I2C_MAX_POLLS].poll[poll % I2C_MAX_POLLS];
+  if (nbytes > p->nbytes)
+    nbytes = p->nbytes;
+
+  istate = interrupts_get_and_disable();
+  if (p->period && p->valid) {
+    memcpy(data, p->data, nbytes);
+    ret = nbytes;
+  }
+  if (istate)
+    interrupts_enable();
+  return ret;
+}
+
+/* Set a function called from the interrupt each time a port has
+ * finished all its queued transactions.
+ */
+void
+i2c_set_idle_callback(void (*callback)(int port))
+{
+  i2c_idle_callback = callback;
+}
+
+/* Build the partial transactions of t.
+ */
+static void
+i2c_setup(struct i2c_port_struct *p, struct i2c_txn *t)
+{
+  struct i2c_partial_transaction *pt;
+  U32 address = t->address;
+  int internal_address = t->internal_address;
+  int n_internal_address_bytes = t->n_internal_address_bytes;
+  int write = t->write;
+
   p->pt_num = 0;
+  p->txn_fault = 0;
   p->pt_begun = 0;
   pt = p->partial_transaction;
   p->current_pt = pt;
@@ -541,14 +793,9 @@ i2c_start_transaction(int port,
   pt->start = 0;
   pt->stop = 1;
   pt->tx = (write ? 1 : 0);
-  pt->data = data;
-  pt->nbytes = nbytes;
+  pt->data = t->data;
+  pt->nbytes = t->nbytes;
   pt->last_pt = 1;
-
-  // Start the transaction
-  p->state = I2C_BEGIN;
-  
-  return 0;
 }
 
 // Test
@@ -5,6 +5,16 @@
 
 #define I2C_N_PORTS 4
 
+// Transactions that can be queued on a port, polls per port and
+// largest polled read
+#define I2C_QUEUE_LEN 4
+#define I2C_MAX_POLLS 2
+#define I2C_POLL_MAX_BYTES 16
+
+// Called from the I2C interrupt when a queued transaction ends:
+// status is 0, or -1 if the device did not acknowledge
+typedef void (*i2c_callback)(int port, int status, void *arg);
+
 void i2c_disable(int port);
 void i2c_enable(int port);
 
@@ -18,6 +28,22 @@ int i2c_start_transaction(int port,
                       U8 *data, 
                       U32 nbytes,
                       int write);
+int i2c_queue_transaction(int port,
+                      U32 address,
+                      int internal_address,
+                      int n_internal_address_bytes,
+                      U8 *data,
+                      U32 nbytes,
+                      int write,
+                      i2c_callback callback,
+                      void *arg);
+
+int i2c_add_poll(int port, U32 address, int internal_address, U32 nbytes,
+                 U32 period_ms);
+void i2c_remove_poll(int poll);
+int i2c_get_poll(int poll, U8 *data, U32 nbytes);
+
+void i2c_set_idle_callback(void (*callback)(int port));
 
 
 void i2c_test(void);
@@ -138,6 +138,11 @@ uart_isr_entry_0:
 uart_isr_entry_1:
   irq_wrapper_nested uart_isr_C_1
 
+  .extern bt_isr_C
+  .global bt_isr_entry
+bt_isr_entry:
+  irq_wrapper_nested bt_isr_C
+
   .extern nxt_motor_isr_C
   .global nxt_motor_isr_entry
 nxt_motor_isr_entry:
@@ -36,6 +36,7 @@
 #include "display.h"
 #include "sound.h"
 #include "bt.h"
+#include "udp.h"
 
 extern U32 __free_ram_start__;
 extern U32 __free_ram_end__;
@@ -141,6 +142,10 @@ run(int jsize)
     //  memory_add_region(ram_start, ram_end);
   }
 
+  // The thread queues are garbage collection roots, so they
+  // must be cleared before the first allocation
+  init_threads();
+
   //printf("Initializing exceptions\n");
 
   // Initialize exceptions
@@ -149,7 +154,6 @@ run(int jsize)
   // Create the boot thread (bootThread is a special global)
   bootThread = (Thread *) new_object_for_class(JAVA_LANG_THREAD);
 
-  init_threads();
   if (!init_thread(bootThread)) {
     return;
   }
@@ -374,6 +378,7 @@ main(void)
   nxt_motor_init();
   i2c_init();
   bt_init();
+  udp_init();
     
   //xx_show();
 
@@ -19,12 +19,24 @@
 #include "platform_config.h"
 #include "sensors.h"
 #include "poll.h"
+#include "profiler.h"
 #include "display.h"
 #include "nxt_avr.h"
 #include "nxt_motors.h"
 #include "i2c.h"
 #include "sound.h"
 #include "bt.h"
+#include "udp.h"
+
+/**
+ * True if off and len, as passed from Java, select bytes of the array.
+ */
+static boolean
+usb_range_ok(Object *p, STACKWORD off, STACKWORD len)
+{
+  return word2jint(off) >= 0 && word2jint(len) >= 0 &&
+         word2jint(off) <= (JINT) get_array_length(p) - word2jint(len);
+}
 
 /**
  * NOTE: The technique is not the same as that used in TinyVM.
@@ -260,6 +272,59 @@ dispatch_native(TWOBYTES signature, STACKWORD * paramBase)
   case btStartADConverter_4_5V:
     bt_start_ad_converter();
     break;
+  case usbRead_4_1BII_5I:
+    {
+      Object *p = word2ptr(paramBase[0]);
+      byte *byteArray = (((byte *) p) + HEADER_SIZE);
+      if (p == JNULL)
+      {
+        throw_exception(nullPointerException);
+        return;
+      }
+      if (!usb_range_ok(p, paramBase[1], paramBase[2]))
+      {
+        throw_exception(arrayIndexOutOfBoundsException);
+        return;
+      }
+      push_word(udp_read(byteArray, paramBase[1], paramBase[2]));
+    }
+    return;
+  case usbWrite_4_1BII_5I:
+    {
+      Object *p = word2ptr(paramBase[0]);
+      byte *byteArray = (((byte *) p) + HEADER_SIZE);
+      if (p == JNULL)
+      {
+        throw_exception(nullPointerException);
+        return;
+      }
+      if (!usb_range_ok(p, paramBase[1], paramBase[2]))
+      {
+        throw_exception(arrayIndexOutOfBoundsException);
+        return;
+      }
+      push_word(udp_write(byteArray, paramBase[1], paramBase[2]));
+    }
+    return;
+  case usbStatus_4_5I:
+    push_word(udp_status());
+    return;
+  case usbEnable_4I_5V:
+    udp_enable(paramBase[0]);
+    return;
+  case usbDisable_4_5V:
+    udp_disable();
+    return;
+  case readProfile_4_1II_5I:
+    {
+      Object *p = word2ptr(paramBase[0]);
+      push_word(read_profile(jint_array(p), get_array_length(p),
+                             paramBase[1]));
+    }
+    return;
+  case resetProfile_4_5V:
+    clear_profile();
+    return;
   default:
     throw_exception(noSuchMethodError);
   }
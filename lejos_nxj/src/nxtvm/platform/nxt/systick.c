@@ -16,6 +16,8 @@
 #include "nxt_motors.h"
 #include "nxt_avr.h"
 
+#include "configure.h"
+
 extern volatile unsigned char gMakeRequest;
 
 #define PIT_FREQ 1000		/* Hz */
@@ -34,6 +36,10 @@ systick_low_priority_C(void)
   *AT91C_AIC_ICCR = (1 << LOW_PRIORITY_IRQ);
   nxt_avr_1kHz_update();
   nxt_motor_1kHz_process();
+#if PROFILER_ENTRIES
+  // Tick the interpreter for the profiler, which brings time slices
+  gMakeRequest = 1;
+#endif
 }
 
 // Called at 1000Hz
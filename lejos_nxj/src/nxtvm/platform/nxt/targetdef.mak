@@ -41,7 +41,10 @@ C_VM_SOURCES := \
 	$(VM_DIR)/threads.c \
 	$(VM_DIR)/exceptions.c \
 	$(VM_DIR)/memory.c \
+	$(VM_DIR)/gc.c \
 	$(VM_DIR)/language.c \
+	$(VM_DIR)/quicken.c \
+	$(VM_DIR)/profiler.c \
 	$(VM_DIR)/poll.c
 
 C_SOURCES := $(C_PLATFORM_SOURCES) $(C_VM_SOURCES) $(C_HOOK_SOURCES)
@@ -0,0 +1,595 @@
+/* Host stand-in for the AT91SAM7 peripherals (see at91sim.h), and for
+ * the AIC, interrupt and systick drivers.
+ *
+ * US1 transmitter model: the PDC sends its current buffer at one byte
+ * a step while the transmitter is enabled and CTS is on, and moves on
+ * to the next buffer when the current one ends, at once if TNCR is
+ * written while TCR is 0. ENDTX is set when TCR reaches 0 and cleared
+ * only by writing a non-zero value to TCR or TNCR, which is the
+ * strictest reading of the data sheet. TXBUFE is set while TCR and
+ * TNCR are both 0.
+ *
+ * TC0 reaches RC once a step while its clock is enabled, whatever RC
+ * is, and reading its status clears the compare flag. PIOA lines are
+ * high unless the PIO drives them low or a device pulls them low: a
+ * driven high loses to a device, as on an open drain line.
+ *
+ * UDP model: EP0 takes SETUP packets from sim_udp_setup and sends
+ * what the driver gives it at once. EP1 (bulk OUT) and EP2 (bulk IN)
+ * have two banks each, used in turn. The CSR status bits are cleared
+ * by writing 0 and unchanged by writing 1, and TXPKTRDY is set by
+ * writing 1. The host moves only between the steps of sim_run, not at
+ * register accesses, as the driver loops on the CSR until it reads
+ * back what it wrote.
+ *
+ * interrupts_get_and_disable() holds interrupts back until
+ * interrupts_enable(), and handlers run with interrupts off.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "at91sim.h"
+#include "aic.h"
+#include "interrupts.h"
+#include "systick.h"
+
+#define SIM_BASE 0xFFFA0000ul
+#define SIM_SIZE (0x100000000ul - SIM_BASE)
+
+#define REG(r) ((unsigned long) (r))
+
+unsigned int sim_progress;
+unsigned int sim_max_latency;
+unsigned long sim_irq_count[32];
+
+int sim_us1_cts;
+void (*sim_us1_tx_byte)(unsigned char b);
+unsigned long sim_us1_tx_buffers;
+
+unsigned int sim_pioa_low;
+void (*sim_pioa_changed)(void);
+
+unsigned int sim_udp_packets_per_ms;
+int (*sim_udp_out)(unsigned char *data);
+void (*sim_udp_in)(const unsigned char *data, unsigned int len);
+
+static int mapped;
+static unsigned int seed;
+static unsigned long now;
+static int in_isr;
+static int irqs_off;
+
+static unsigned int aic_imr;
+static sim_isr_t isr_table[32];
+static int (*irq_pending[32])(void);
+static int irq_delay[32];
+
+static struct
+{
+  unsigned int tpr, tcr, tnpr, tncr;
+  unsigned int imr;
+  int endtx;
+  int txen;
+} us1;
+
+static struct
+{
+  unsigned int imr;
+  int clken;
+  int cpcs;
+} tc0;
+
+static struct
+{
+  unsigned int osr, odsr;
+} pioa;
+
+/* udp.c has the CSR and FDR addresses, AT91SAM7.h does not */
+#define UDP_CSR(ep) (0xFFFB0030ul + 4 * (ep))
+#define UDP_FDR(ep) (0xFFFB0050ul + 4 * (ep))
+#define UDP_STATUS (AT91C_UDP_TXCOMP | AT91C_UDP_RX_DATA_BK0 | AT91C_UDP_RXSETUP \
+                    | AT91C_UDP_ISOERROR | AT91C_UDP_RX_DATA_BK1)
+
+struct udp_bank
+{
+  unsigned int len, pos;
+  int full;
+  unsigned char data[64];
+};
+
+static struct
+{
+  unsigned int imr;
+  unsigned int csr[4];		/* control bits, and status bits of EP0 */
+  unsigned char setup[8];
+  unsigned int setup_pos;
+  struct udp_bank out[2];	/* EP1 */
+  int out_wr, out_rd;
+  struct udp_bank in[2];	/* EP2, full when TXPKTRDY was set */
+  int in_wr, in_tx, in_txcomp;
+  unsigned long credit;
+} udp;
+
+unsigned int sim_random(unsigned int n)
+{
+  seed = seed * 1103515245u + 12345u;
+  return ((seed >> 16) & 0x7fff) % n;
+}
+
+unsigned long sim_time(void)
+{
+  return now;
+}
+
+static void us1_load(void)
+{
+  if (us1.tcr == 0 && us1.tncr != 0)
+  {
+    us1.tpr = us1.tnpr;
+    us1.tcr = us1.tncr;
+    us1.tncr = 0;
+  }
+}
+
+static unsigned int us1_csr(void)
+{
+  unsigned int csr = AT91C_US_TXRDY;
+
+  if (us1.endtx)
+    csr |= AT91C_US_ENDTX;
+  if (us1.tcr == 0 && us1.tncr == 0)
+    csr |= AT91C_US_TXBUFE;
+  return csr;
+}
+
+static int us1_irq(void)
+{
+  return (us1.imr & us1_csr()) != 0;
+}
+
+static void us1_step(void)
+{
+  unsigned char b;
+
+  if (!us1.txen || !sim_us1_cts || us1.tcr == 0)
+    return;
+  b = *(unsigned char *) (unsigned long) us1.tpr;
+  us1.tpr++;
+  if (--us1.tcr == 0)
+  {
+    us1.endtx = 1;
+    sim_us1_tx_buffers++;
+    us1_load();
+  }
+  if (sim_us1_tx_byte)
+    sim_us1_tx_byte(b);
+}
+
+static unsigned int tc0_sr(void)
+{
+  return tc0.cpcs ? AT91C_TC_CPCS : 0;
+}
+
+static int tc0_irq(void)
+{
+  return (tc0.imr & tc0_sr()) != 0;
+}
+
+unsigned int sim_pioa_lines(void)
+{
+  return ~(pioa.osr & ~pioa.odsr) & ~sim_pioa_low;
+}
+
+static unsigned int udp_csr(int ep)
+{
+  unsigned int csr = udp.csr[ep];
+
+  if (ep == 1)
+  {
+    if (udp.out[0].full)
+      csr |= AT91C_UDP_RX_DATA_BK0;
+    if (udp.out[1].full)
+      csr |= AT91C_UDP_RX_DATA_BK1;
+    if (udp.out[udp.out_rd].full)
+      csr |= udp.out[udp.out_rd].len << 16;
+  }
+  else if (ep == 2)
+  {
+    if (udp.in[udp.in_tx].full)
+      csr |= AT91C_UDP_TXPKTRDY;
+    if (udp.in_txcomp)
+      csr |= AT91C_UDP_TXCOMP;
+  }
+  return csr;
+}
+
+static void udp_csr_write(int ep, unsigned int value)
+{
+  unsigned int cleared = UDP_STATUS & ~value;
+
+  if (ep == 1)
+  {
+    if ((cleared & AT91C_UDP_RX_DATA_BK0) && udp.out[0].full)
+    {
+      udp.out[0].full = 0;
+      udp.out_rd = 1;
+    }
+    if ((cleared & AT91C_UDP_RX_DATA_BK1) && udp.out[1].full)
+    {
+      udp.out[1].full = 0;
+      udp.out_rd = 0;
+    }
+  }
+  else if (ep == 2)
+  {
+    if (cleared & AT91C_UDP_TXCOMP)
+      udp.in_txcomp = 0;
+    if ((value & AT91C_UDP_TXPKTRDY) && !udp.in[udp.in_tx].full)
+    {
+      udp.in[udp.in_wr].full = 1;
+      udp.in_wr ^= 1;
+    }
+  }
+  else
+  {
+    udp.csr[ep] &= ~cleared;
+    udp.csr[ep] |= value & AT91C_UDP_TXPKTRDY;
+  }
+  udp.csr[ep] = (udp.csr[ep] & (UDP_STATUS | AT91C_UDP_TXPKTRDY))
+    | (value & ~(UDP_STATUS | AT91C_UDP_TXPKTRDY | AT91C_UDP_RXBYTECNT));
+}
+
+static void udp_reset_ep(unsigned int eps)
+{
+  if (eps & AT91C_UDP_EP1)
+  {
+    memset(udp.out, 0, sizeof(udp.out));
+    udp.out_wr = udp.out_rd = 0;
+  }
+  if (eps & AT91C_UDP_EP2)
+  {
+    memset(udp.in, 0, sizeof(udp.in));
+    udp.in_wr = udp.in_tx = udp.in_txcomp = 0;
+  }
+}
+
+static unsigned int udp_isr(void)
+{
+  unsigned int isr = 0;
+
+  if (udp.csr[0] & (AT91C_UDP_RXSETUP | AT91C_UDP_TXCOMP))
+    isr |= AT91C_UDP_EPINT0;
+  if (udp.out[0].full || udp.out[1].full)
+    isr |= AT91C_UDP_EPINT1;
+  if (udp.in_txcomp)
+    isr |= AT91C_UDP_EPINT2;
+  return isr;
+}
+
+static int udp_irq(void)
+{
+  return (udp.imr & udp_isr()) != 0;
+}
+
+void sim_udp_setup(const unsigned char *setup)
+{
+  memcpy(udp.setup, setup, sizeof(udp.setup));
+  udp.setup_pos = 0;
+  udp.csr[0] |= AT91C_UDP_RXSETUP;
+}
+
+/* One transfer each way, if the endpoints are ready for it */
+static void udp_transfer(void)
+{
+  struct udp_bank *b;
+  int len;
+
+  if (udp.csr[0] & AT91C_UDP_TXPKTRDY)
+    udp.csr[0] = (udp.csr[0] & ~AT91C_UDP_TXPKTRDY) | AT91C_UDP_TXCOMP;
+
+  b = &udp.out[udp.out_wr];
+  if ((udp.csr[1] & AT91C_UDP_EPEDS) && !b->full && sim_udp_out
+      && (len = sim_udp_out(b->data)) >= 0)
+  {
+    b->len = len;
+    b->pos = 0;
+    b->full = 1;
+    udp.out_wr ^= 1;
+  }
+
+  b = &udp.in[udp.in_tx];
+  if (b->full)
+  {
+    if (sim_udp_in)
+      sim_udp_in(b->data, b->len);
+    b->len = 0;
+    b->full = 0;
+    udp.in_tx ^= 1;
+    udp.in_txcomp = 1;
+  }
+}
+
+static void udp_step(void)
+{
+  udp.credit += sim_udp_packets_per_ms * 1000;
+  while (udp.credit >= SIM_STEP_HZ)
+  {
+    udp.credit -= SIM_STEP_HZ;
+    udp_transfer();
+  }
+}
+
+static void step(void)
+{
+  now++;
+  us1_step();
+  if (tc0.clken)
+    tc0.cpcs = 1;
+}
+
+/* Delivers the interrupts that have been pending for their latency,
+ * if the AIC lets them through. Handlers do not nest. */
+static void check_irq(void)
+{
+  int pid;
+
+  if (in_isr || irqs_off)
+    return;
+  for (pid = 0; pid < 32; pid++)
+  {
+    if (isr_table[pid] == 0 || (aic_imr & (1u << pid)) == 0
+        || irq_pending[pid] == 0 || !irq_pending[pid]())
+    {
+      irq_delay[pid] = -1;
+      continue;
+    }
+    if (irq_delay[pid] < 0)
+      irq_delay[pid] = sim_random(sim_max_latency + 1);
+    if (irq_delay[pid]-- == 0)
+    {
+      in_isr = 1;
+      irqs_off = 1;
+      sim_irq_count[pid]++;
+      isr_table[pid]();
+      irqs_off = 0;
+      in_isr = 0;
+      irq_delay[pid] = -1;
+    }
+  }
+}
+
+static void accessed(void)
+{
+  if (sim_random(256) < sim_progress)
+    step();
+  check_irq();
+}
+
+unsigned int sim_read(unsigned long addr)
+{
+  unsigned int value;
+
+  if (addr == REG(AT91C_US1_TPR))
+    value = us1.tpr;
+  else if (addr == REG(AT91C_US1_TCR))
+    value = us1.tcr;
+  else if (addr == REG(AT91C_US1_TNPR))
+    value = us1.tnpr;
+  else if (addr == REG(AT91C_US1_TNCR))
+    value = us1.tncr;
+  else if (addr == REG(AT91C_US1_IMR))
+    value = us1.imr;
+  else if (addr == REG(AT91C_US1_CSR))
+    value = us1_csr();
+  else if (addr == REG(AT91C_TC0_SR))
+  {
+    value = tc0_sr();
+    tc0.cpcs = 0;
+  }
+  else if (addr == REG(AT91C_TC0_IMR))
+    value = tc0.imr;
+  else if (addr == REG(AT91C_UDP_ISR))
+    value = udp_isr();
+  else if (addr == REG(AT91C_UDP_IMR))
+    value = udp.imr;
+  else if (addr >= UDP_CSR(0) && addr <= UDP_CSR(3))
+    value = udp_csr((addr - UDP_CSR(0)) / 4);
+  else if (addr == UDP_FDR(0))
+    value = udp.setup_pos < 8 ? udp.setup[udp.setup_pos++] : 0;
+  else if (addr == UDP_FDR(1))
+  {
+    struct udp_bank *b = &udp.out[udp.out_rd];
+
+    value = b->pos < b->len ? b->data[b->pos++] : 0;
+  }
+  else if (addr == REG(AT91C_PIOA_PDSR))
+    value = sim_pioa_lines();
+  else if (addr == REG(AT91C_PIOA_OSR))
+    value = pioa.osr;
+  else if (addr == REG(AT91C_PIOA_ODSR))
+    value = pioa.odsr;
+  else
+    value = ((SimReg *) addr)->value;
+  accessed();
+  return value;
+}
+
+void sim_write(unsigned long addr, unsigned int value)
+{
+  if (addr == REG(AT91C_US1_TPR))
+    us1.tpr = value;
+  else if (addr == REG(AT91C_US1_TCR))
+  {
+    us1.tcr = value;
+    if (value != 0)
+      us1.endtx = 0;
+    us1_load();
+  }
+  else if (addr == REG(AT91C_US1_TNPR))
+    us1.tnpr = value;
+  else if (addr == REG(AT91C_US1_TNCR))
+  {
+    us1.tncr = value;
+    if (value != 0)
+      us1.endtx = 0;
+    us1_load();
+  }
+  else if (addr == REG(AT91C_US1_IER))
+    us1.imr |= value;
+  else if (addr == REG(AT91C_US1_IDR))
+    us1.imr &= ~value;
+  else if (addr == REG(AT91C_US1_PTCR))
+  {
+    if (value & AT91C_PDC_TXTEN)
+      us1.txen = 1;
+    if (value & AT91C_PDC_TXTDIS)
+      us1.txen = 0;
+  }
+  else if (addr == REG(AT91C_TC0_CCR))
+  {
+    if (value & AT91C_TC_CLKEN)
+      tc0.clken = 1;
+    if (value & AT91C_TC_CLKDIS)
+      tc0.clken = 0;
+  }
+  else if (addr == REG(AT91C_TC0_IER))
+    tc0.imr |= value;
+  else if (addr == REG(AT91C_TC0_IDR))
+    tc0.imr &= ~value;
+  else if (addr == REG(AT91C_UDP_IER))
+    udp.imr |= value;
+  else if (addr == REG(AT91C_UDP_IDR))
+    udp.imr &= ~value;
+  else if (addr >= UDP_CSR(0) && addr <= UDP_CSR(3))
+    udp_csr_write((addr - UDP_CSR(0)) / 4, value);
+  else if (addr == UDP_FDR(2))
+  {
+    struct udp_bank *b = &udp.in[udp.in_wr];
+
+    if (!b->full && b->len < sizeof(b->data))
+      b->data[b->len++] = (unsigned char) value;
+  }
+  else if (addr == REG(AT91C_UDP_RSTEP))
+  {
+    udp_reset_ep(value);
+    ((SimReg *) addr)->value = value;
+  }
+  else if (addr == REG(AT91C_PIOA_SODR) || addr == REG(AT91C_PIOA_CODR)
+           || addr == REG(AT91C_PIOA_OER) || addr == REG(AT91C_PIOA_ODR))
+  {
+    if (addr == REG(AT91C_PIOA_SODR))
+      pioa.odsr |= value;
+    else if (addr == REG(AT91C_PIOA_CODR))
+      pioa.odsr &= ~value;
+    else if (addr == REG(AT91C_PIOA_OER))
+      pioa.osr |= value;
+    else
+      pioa.osr &= ~value;
+    if (sim_pioa_changed)
+      sim_pioa_changed();
+  }
+  else
+    ((SimReg *) addr)->value = value;
+  accessed();
+}
+
+void sim_init(unsigned int s)
+{
+  int pid;
+
+  if (!mapped)
+  {
+    if (mmap((void *) SIM_BASE, SIM_SIZE, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+        != (void *) SIM_BASE)
+    {
+      perror("mapping the peripherals");
+      exit(2);
+    }
+    mapped = 1;
+  }
+  memset((void *) SIM_BASE, 0, SIM_SIZE);
+  seed = s;
+  now = 0;
+  in_isr = 0;
+  irqs_off = 0;
+  aic_imr = 0;
+  sim_progress = 0;
+  sim_max_latency = 0;
+  for (pid = 0; pid < 32; pid++)
+  {
+    isr_table[pid] = 0;
+    irq_pending[pid] = 0;
+    irq_delay[pid] = -1;
+    sim_irq_count[pid] = 0;
+  }
+  irq_pending[AT91C_PERIPHERAL_ID_US1] = us1_irq;
+  irq_pending[AT91C_ID_TC0] = tc0_irq;
+  irq_pending[AT91C_ID_UDP] = udp_irq;
+
+  memset(&us1, 0, sizeof(us1));
+  us1.endtx = 1;
+  sim_us1_cts = 1;
+  sim_us1_tx_byte = 0;
+  sim_us1_tx_buffers = 0;
+
+  memset(&tc0, 0, sizeof(tc0));
+  memset(&pioa, 0, sizeof(pioa));
+  sim_pioa_low = 0;
+  sim_pioa_changed = 0;
+
+  memset(&udp, 0, sizeof(udp));
+  sim_udp_packets_per_ms = 19;
+  sim_udp_out = 0;
+  sim_udp_in = 0;
+}
+
+void sim_set_isr(int pid, sim_isr_t isr)
+{
+  isr_table[pid] = isr;
+}
+
+void sim_run(unsigned long steps)
+{
+  while (steps-- > 0)
+  {
+    step();
+    udp_step();
+    check_irq();
+  }
+}
+
+/* interrupts.c */
+int interrupts_get_and_disable(void)
+{
+  int was_on = !irqs_off;
+
+  irqs_off = 1;
+  return was_on;
+}
+
+void interrupts_enable(void)
+{
+  irqs_off = 0;
+  check_irq();
+}
+
+/* aic.c */
+void aic_initialise(void) {}
+void aic_set_vector(U32 vector, U32 mode, U32 isr) { sim_set_isr(vector, (sim_isr_t) isr); }
+void aic_mask_on(U32 vector) { aic_imr |= 1u << vector; }
+void aic_mask_off(U32 vector) { aic_imr &= ~(1u << vector); }
+void aic_clear(U32 mask) {}
+
+/* systick.c */
+U32 systick_get_ms(void)
+{
+  return now * 1000 / SIM_STEP_HZ;
+}
+
+void systick_wait_ms(U32 ms)
+{
+  sim_run(ms * SIM_STEP_HZ / 1000);
+}
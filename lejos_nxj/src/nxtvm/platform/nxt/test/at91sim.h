@@ -0,0 +1,84 @@
+/* Host stand-in for the AT91SAM7 peripherals, for testing the NXT
+ * drivers on a Linux host.
+ *
+ * The drivers are compiled as C++ with this file included first (see
+ * Makefile). It includes the real AT91SAM7.h with AT91_REG made a class
+ * whose assignments and reads call the simulator, and maps memory at
+ * the peripheral addresses, so that "*AT91C_US1_TCR = len" reaches
+ * sim_write() with the register address. Registers without a model
+ * read back what was last written to them.
+ *
+ * Time runs in steps (one byte time of the simulated USART). Drivers
+ * may be interrupted after any register access: the hardware may move
+ * on by a step there, as it would while the CPU runs, and a pending
+ * interrupt is delivered after a random latency.
+ */
+
+#ifndef AT91SIM_H_
+#define AT91SIM_H_
+
+#define AT91_REG AT91_REG_HW
+#include "AT91SAM7.h"
+#undef AT91_REG
+
+extern unsigned int sim_read(unsigned long addr);
+extern void sim_write(unsigned long addr, unsigned int value);
+
+class SimReg
+{
+public:
+  operator unsigned int() const { return sim_read((unsigned long) this); }
+  SimReg &operator=(unsigned int v) { sim_write((unsigned long) this, v); return *this; }
+  SimReg &operator|=(unsigned int v) { return *this = *this | v; }
+  SimReg &operator&=(unsigned int v) { return *this = *this & v; }
+  unsigned int value;		/* last value written */
+};
+
+#define AT91_REG SimReg
+
+/* A step is one byte time at 460800 baud, 8N1 */
+#define SIM_STEP_HZ 46080
+
+/* Interrupt handler of a peripheral, called by the simulator */
+typedef void (*sim_isr_t)(void);
+
+extern void sim_init(unsigned int seed);
+extern void sim_set_isr(int pid, sim_isr_t isr);
+extern void sim_run(unsigned long steps);
+extern unsigned long sim_time(void);
+extern unsigned int sim_random(unsigned int n);
+
+/* Chance in 256 that the hardware moves on by a step at a register
+ * access, and the largest interrupt latency in register accesses or
+ * steps */
+extern unsigned int sim_progress;
+extern unsigned int sim_max_latency;
+
+/* Interrupts delivered so far, for each peripheral */
+extern unsigned long sim_irq_count[32];
+
+/* US1 (Bluetooth) transmitter: a transmitter whose PDC buffers are
+ * read at one byte a step while CTS is on. sim_us1_tx_byte is called
+ * with each byte sent. */
+extern int sim_us1_cts;
+extern void (*sim_us1_tx_byte)(unsigned char b);
+extern unsigned long sim_us1_tx_buffers;
+
+/* PIOA lines: wired-AND of the PIO outputs and of the devices, which
+ * pull low the lines set in sim_pioa_low. sim_pioa_changed is called
+ * after each write to the PIO outputs. */
+extern unsigned int sim_pioa_low;
+extern void (*sim_pioa_changed)(void);
+extern unsigned int sim_pioa_lines(void);
+
+/* UDP (USB): a host that does up to sim_udp_packets_per_ms bulk
+ * transfers each way per millisecond. sim_udp_out is called for the
+ * next OUT packet to EP1 when a bank is free and returns its length
+ * (-1 for none); sim_udp_in is called with each IN packet taken from
+ * EP2. sim_udp_setup puts a SETUP packet on EP0. */
+extern unsigned int sim_udp_packets_per_ms;
+extern int (*sim_udp_out)(unsigned char *data);
+extern void (*sim_udp_in)(const unsigned char *data, unsigned int len);
+extern void sim_udp_setup(const unsigned char *setup);
+
+#endif
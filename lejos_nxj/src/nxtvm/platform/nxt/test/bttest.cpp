@@ -0,0 +1,222 @@
+/* Host test of the Bluetooth output ring (bt.c) on a simulated US1
+ *
+ *   bttest check   random writes of the three kinds, with CTS going
+ *                  off and on, while the hardware moves on at random
+ *                  register accesses and interrupts come late. The
+ *                  bytes sent must be those of the accepted writes, in
+ *                  order; writes must be refused only for lack of room;
+ *                  the ring must drain; and every interrupt must follow
+ *                  the end of a PDC buffer.
+ *   bttest bench   packets written at a fixed rate for 10 s, with
+ *                  bt_write_packet as ecrobot_send_bt_packet does
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "at91sim.h"
+#include "bt.h"
+
+#define TX_RING_SIZE 512	/* as in bt.c */
+
+#define CHECK_RUNS 100
+#define CHECK_MS 500
+#define BENCH_MS 10000
+
+#define STREAM_SIZE (1 << 20)
+
+/* The bytes of the accepted writes, and those sent. The ones sent are
+ * checked after each write, as they may be sent before it returns. */
+static U8 stream[STREAM_SIZE];
+static U8 sent[STREAM_SIZE];
+static unsigned long stream_in, sent_in, stream_out;
+static unsigned long writes, refused;
+static int errors;
+
+static U8 data[TX_RING_SIZE];
+
+void bt_isr_entry(void)
+{
+  bt_isr_C();
+}
+
+static void error(const char *what)
+{
+  if (errors++ == 0)
+    printf("at %lu: %s\n", sim_time(), what);
+}
+
+static void received(unsigned char b)
+{
+  sent[sent_in++ % STREAM_SIZE] = b;
+}
+
+static void compare(void)
+{
+  for (; stream_out < sent_in; stream_out++)
+  {
+    if (stream_out == stream_in)
+    {
+      error("byte sent that was not written");
+      break;
+    }
+    if (stream[stream_out % STREAM_SIZE] != sent[stream_out % STREAM_SIZE])
+      error("byte sent differs from the one written");
+  }
+}
+
+static void accepted(const U8 *buf, U32 len)
+{
+  U32 i;
+
+  for (i = 0; i < len; i++)
+    stream[stream_in++ % STREAM_SIZE] = buf[i];
+}
+
+/* Writes len bytes with bt_send (kind 0), bt_write (1) or
+ * bt_write_packet (2) */
+static void write(int kind, U32 len)
+{
+  U32 space = bt_tx_space();
+  U32 dropped = bt_tx_dropped();
+  U32 need = kind == 2 ? len + 2 : len;
+  U32 ret = 0;
+  U8 header[2];
+  U32 i;
+  int ok;
+
+  for (i = 0; i < len; i++)
+    data[i] = (U8) sim_random(256);
+  switch (kind)
+  {
+  case 0:
+    bt_send(data, len);
+    break;
+  case 1:
+    ret = bt_write(data, 0, len);
+    break;
+  default:
+    ret = bt_write_packet(data, len);
+    break;
+  }
+  writes++;
+  ok = bt_tx_dropped() == dropped;
+  if (!ok)
+  {
+    refused++;
+    if (bt_tx_dropped() != dropped + 1)
+      error("drop not counted once");
+    if (need <= space)
+      error("write refused with room for it");
+  }
+  if (kind != 0 && ret != (ok ? len : 0))
+    error("wrong length returned");
+  if (ok && kind == 2)
+  {
+    header[0] = (U8) (len & 0xFF);
+    header[1] = (U8) ((len >> 8) & 0xFF);
+    accepted(header, 2);
+  }
+  if (ok)
+    accepted(data, len);
+  compare();
+}
+
+static void start(unsigned int seed)
+{
+  sim_init(seed);
+  stream_in = sent_in = stream_out = 0;
+  writes = refused = 0;
+  errors = 0;
+  sim_us1_tx_byte = received;
+  bt_init();
+}
+
+/* Runs the steps of millisecond ms */
+static void run_ms(unsigned long ms)
+{
+  sim_run((ms + 1) * SIM_STEP_HZ / 1000 - ms * SIM_STEP_HZ / 1000);
+  compare();
+}
+
+static int check(unsigned int seed)
+{
+  unsigned long ms;
+  unsigned int n;
+
+  start(seed);
+  sim_progress = 64;
+  sim_max_latency = 2;
+  for (ms = 0; ms < CHECK_MS; ms++)
+  {
+    if (sim_random(20) == 0)
+      sim_us1_cts = !sim_us1_cts;
+    for (n = sim_random(4); n > 0; n--)
+      write(sim_random(3), sim_random(5) == 0 ? sim_random(257) : sim_random(40));
+    run_ms(ms);
+  }
+  sim_us1_cts = 1;
+  for (; ms < CHECK_MS + 100 && (bt_pending() & 2); ms++)
+    run_ms(ms);
+
+  if (bt_pending() & 2)
+    error("ring not drained");
+  if (stream_out != stream_in)
+    error("bytes written but not sent");
+  if (bt_tx_space() != TX_RING_SIZE)
+    error("ring space not given back");
+  if (*AT91C_US1_IMR & (AT91C_US_ENDTX | AT91C_US_TXBUFE))
+    error("interrupt left enabled");
+  if (sim_irq_count[AT91C_PERIPHERAL_ID_US1] > sim_us1_tx_buffers)
+    error("more interrupts than PDC buffers sent");
+  if (errors)
+    printf("bttest: seed %u failed\n", seed);
+  return errors == 0;
+}
+
+static void bench(const char *name, U32 len, U32 period, U32 cts_off)
+{
+  unsigned long ms;
+
+  start(1);
+  sim_max_latency = 2;
+  for (ms = 0; ms < BENCH_MS; ms++)
+  {
+    sim_us1_cts = ms % 50 >= cts_off;
+    if (ms % period == 0)
+      write(2, len);
+    run_ms(ms);
+  }
+  printf("%-30s %10.1f %10.1f %9.1f%%\n", name,
+         (double) (len + 2) / period, (double) stream_out / BENCH_MS,
+         100.0 * refused / writes);
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int seed, passed = 0;
+  unsigned long bytes = 0, drops = 0;
+
+  if (argc == 2 && strcmp(argv[1], "check") == 0)
+  {
+    for (seed = 1; seed <= CHECK_RUNS; seed++)
+    {
+      passed += check(seed);
+      bytes += stream_out;
+      drops += refused;
+    }
+    printf("bttest: %u of %u runs passed, %lu bytes sent, %lu writes refused\n",
+           passed, CHECK_RUNS, bytes, drops);
+    return passed == CHECK_RUNS ? 0 : 1;
+  }
+  if (argc == 2 && strcmp(argv[1], "bench") == 0)
+  {
+    printf("%-30s %10s %10s %10s\n", "bttest (KB/s)", "offered", "sent",
+           "dropped");
+    bench("32 B / 4 ms, CTS off 15 in 50", 32, 4, 15);
+    bench("100 B / 1 ms", 100, 1, 0);
+    return 0;
+  }
+  fprintf(stderr, "usage: bttest check|bench\n");
+  return 2;
+}
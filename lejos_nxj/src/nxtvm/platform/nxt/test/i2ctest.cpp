@@ -0,0 +1,476 @@
+/* Host test of the I2C transaction queue and polls (i2c.c) against
+ * simulated I2C devices on the PIOA lines of the sensor ports
+ *
+ *   i2ctest check   on a port, a queued write, a read of it back, a
+ *                   read of a missing device and another read must
+ *                   end with statuses 0, 0, -1, 0 and the data written;
+ *                   then polls on two ports, one of whose device goes
+ *                   away for a while, must keep to their periods and
+ *                   never return a read older than the last two the
+ *                   device answered. The hardware moves on at random
+ *                   register accesses and interrupts come late.
+ *   i2ctest bench   a counter polled on each port for 3 s: reads
+ *                   done and mean age of the data returned
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "at91sim.h"
+#include "i2c.h"
+#include "systick.h"
+
+#define CHECK_RUNS 100
+#define CHECK_MS 1000
+#define BENCH_MS 3000
+
+#define DEVICE 1		/* 7-bit address of the devices */
+#define COUNTER_REG 0x42	/* 4 bytes, set to the time in ms */
+#define FIXED_REG 0x50		/* 2 bytes that do not change */
+
+/* Slave: a device on the SCL and SDA lines of a port. It takes the
+ * first byte written after its address as the register pointer, and
+ * the following ones as data; reads are served from a copy of the
+ * registers taken when it is addressed for reading, as sensors do to
+ * keep multi-byte values whole. */
+enum { S_IDLE, S_ADDR, S_WRITE, S_READ };
+
+struct slave
+{
+  unsigned int scl_pin, sda_pin;
+  int present;
+  U8 reg[256];
+  U8 latch[256];
+
+  int scl, sda;			/* line levels last seen */
+  int state;
+  int bits;			/* bits of the byte so far */
+  int ack;			/* in the acknowledge clock */
+  int pointer_next;
+  U8 byte;
+  U8 ptr;
+  U8 read_ptr;
+  int pull_low;
+
+  unsigned long reads[256];	/* reads that ended, by register */
+  unsigned long writes;
+  U32 last_value, prev_value;	/* counter of the last two reads */
+};
+
+static const unsigned int scl_pins[I2C_N_PORTS] = { 1 << 23, 1 << 28, 1 << 29, 1 << 30 };
+static const unsigned int sda_pins[I2C_N_PORTS] = { 1 << 18, 1 << 19, 1 << 20, 1 << 2 };
+
+static struct slave slaves[I2C_N_PORTS];
+static int errors;
+
+static int statuses[I2C_QUEUE_LEN];
+static int n_statuses;
+static unsigned long idle_calls[I2C_N_PORTS];
+
+/* Called by the assembler entry on the NXT */
+extern void i2c_timer_isr_C(void);
+
+void i2c_timer_isr_entry(void)
+{
+  i2c_timer_isr_C();
+}
+
+static void error(const char *what)
+{
+  if (errors++ == 0)
+    printf("at %lu: %s\n", sim_time(), what);
+}
+
+static U32 get32(const U8 *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((U32) p[3] << 24);
+}
+
+static void put32(U8 *p, U32 v)
+{
+  p[0] = (U8) v;
+  p[1] = (U8) (v >> 8);
+  p[2] = (U8) (v >> 16);
+  p[3] = (U8) (v >> 24);
+}
+
+static void slave_send_bit(struct slave *s)
+{
+  s->pull_low = !((s->byte >> (7 - s->bits)) & 1);
+}
+
+/* A byte has been clocked in: acknowledge it if it is for us */
+static void slave_byte(struct slave *s)
+{
+  if (s->state == S_ADDR)
+  {
+    if (!s->present || (s->byte >> 1) != DEVICE)
+    {
+      s->state = S_IDLE;
+      return;
+    }
+    if (s->byte & 1)
+    {
+      s->state = S_READ;
+      s->read_ptr = s->ptr;
+      memcpy(s->latch, s->reg, sizeof(s->reg));
+    }
+    else
+    {
+      s->state = S_WRITE;
+      s->pointer_next = 1;
+    }
+  }
+  else if (s->pointer_next)
+  {
+    s->ptr = s->byte;
+    s->pointer_next = 0;
+  }
+  else
+  {
+    s->reg[s->ptr++] = s->byte;
+    s->writes++;
+  }
+  s->ack = 1;
+  s->pull_low = 1;
+}
+
+static void slave_lines(struct slave *s, int scl, int sda)
+{
+  if (scl && s->scl && sda != s->sda)
+  {
+    /* START or STOP */
+    if (s->state == S_READ && s->ptr != s->read_ptr)
+    {
+      s->reads[s->read_ptr]++;
+      if (s->read_ptr == COUNTER_REG)
+      {
+        s->prev_value = s->last_value;
+        s->last_value = get32(s->latch + COUNTER_REG);
+      }
+    }
+    s->state = sda ? S_IDLE : S_ADDR;
+    s->bits = 0;
+    s->ack = 0;
+    s->byte = 0;
+    s->pull_low = 0;
+  }
+  else if (scl && !s->scl)
+  {
+    /* Rising clock: take a bit or the master's acknowledge */
+    if (s->ack)
+    {
+      if (s->state == S_READ && sda)
+        s->state = S_IDLE;
+    }
+    else if ((s->state == S_ADDR || s->state == S_WRITE) && s->bits < 8)
+    {
+      s->byte = (s->byte << 1) | sda;
+      s->bits++;
+    }
+  }
+  else if (!scl && s->scl)
+  {
+    /* Falling clock: move on to the next bit */
+    if (s->ack)
+    {
+      s->ack = 0;
+      s->pull_low = 0;
+      s->bits = 0;
+      s->byte = 0;
+      if (s->state == S_READ)
+      {
+        s->byte = s->latch[s->ptr++];
+        slave_send_bit(s);
+      }
+    }
+    else if (s->state == S_READ)
+    {
+      if (++s->bits == 8)
+      {
+        s->ack = 1;
+        s->pull_low = 0;
+      }
+      else
+        slave_send_bit(s);
+    }
+    else if ((s->state == S_ADDR || s->state == S_WRITE) && s->bits == 8)
+      slave_byte(s);
+  }
+}
+
+static void pioa_changed(void)
+{
+  int i;
+
+  for (i = 0; i < I2C_N_PORTS; i++)
+  {
+    struct slave *s = &slaves[i];
+    unsigned int lines = sim_pioa_lines();
+
+    slave_lines(s, (lines & s->scl_pin) != 0, (lines & s->sda_pin) != 0);
+    if (s->pull_low)
+      sim_pioa_low |= s->sda_pin;
+    else
+      sim_pioa_low &= ~s->sda_pin;
+    lines = sim_pioa_lines();
+    s->scl = (lines & s->scl_pin) != 0;
+    s->sda = (lines & s->sda_pin) != 0;
+  }
+}
+
+static void done(int port, int status, void *arg)
+{
+  if (n_statuses < I2C_QUEUE_LEN)
+    statuses[n_statuses] = status;
+  n_statuses++;
+}
+
+static void idle(int port)
+{
+  idle_calls[port]++;
+}
+
+static void start(unsigned int seed)
+{
+  int i;
+
+  sim_init(seed);
+  errors = 0;
+  n_statuses = 0;
+  memset(slaves, 0, sizeof(slaves));
+  for (i = 0; i < I2C_N_PORTS; i++)
+  {
+    slaves[i].scl_pin = scl_pins[i];
+    slaves[i].sda_pin = sda_pins[i];
+    slaves[i].scl = slaves[i].sda = 1;
+    slaves[i].present = 1;
+    idle_calls[i] = 0;
+  }
+  sim_pioa_changed = pioa_changed;
+  i2c_init();
+  i2c_set_idle_callback(idle);
+}
+
+/* Runs to the next millisecond. The hardware also moves on while the
+ * drivers run, so time is taken from systick rather than counted. */
+static U32 run_ms(void)
+{
+  U32 ms = systick_get_ms();
+
+  while (systick_get_ms() == ms)
+    sim_run(1);
+  return systick_get_ms();
+}
+
+/* Queued transactions on one port */
+static void check_queue(int port)
+{
+  static const int expected[I2C_QUEUE_LEN] = { 0, 0, -1, 0 };
+  struct slave *s = &slaves[port];
+  U8 wr[4], rd[4], missing[1], again[2];
+  U8 reg = (U8) sim_random(252);
+  unsigned long ms;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    wr[i] = (U8) sim_random(256);
+  memset(rd, 0, sizeof(rd));
+  memset(again, 0, sizeof(again));
+  i2c_enable(port);
+
+  if (i2c_queue_transaction(port, DEVICE, reg, 1, wr, 4, 1, done, 0) < 0
+      || i2c_queue_transaction(port, DEVICE, reg, 1, rd, 4, 0, done, 0) < 0
+      || i2c_queue_transaction(port, DEVICE + 1, reg, 1, missing, 1, 0, done, 0) < 0
+      || i2c_queue_transaction(port, DEVICE, reg + 1, 1, again, 2, 0, done, 0) < 0)
+    error("transaction not queued");
+  if (i2c_queue_transaction(port, DEVICE, reg, 1, rd, 4, 0, done, 0) == 0)
+    error("transaction queued on a full queue");
+  if (i2c_start_transaction(port, DEVICE, reg, 1, rd, 4, 0) == 0)
+    error("transaction started on a busy port");
+
+  for (ms = systick_get_ms(); ms < 100 && i2c_busy(port); ms = run_ms())
+    ;
+  if (i2c_busy(port))
+    error("queue not done");
+  if (n_statuses != I2C_QUEUE_LEN)
+    error("wrong number of transactions ended");
+  for (i = 0; i < n_statuses && i < I2C_QUEUE_LEN; i++)
+    if (statuses[i] != expected[i])
+      error("wrong transaction status");
+  if (memcmp(s->reg + reg, wr, 4) != 0)
+    error("device registers differ from the bytes written");
+  if (memcmp(rd, wr, 4) != 0 || memcmp(again, wr + 1, 2) != 0)
+    error("bytes read differ from the bytes written");
+  if (idle_calls[port] != 1)
+    error("idle callback not called once");
+  i2c_disable(port);
+}
+
+/* Checks the counter poll h of the device on port: it must be the
+ * last or next to last read the device answered, and there must be
+ * one after the device has been there for 100 ms, none after it has
+ * been gone for 100 ms */
+static void check_counter(int h, int port, unsigned long ms, unsigned long since)
+{
+  struct slave *s = &slaves[port];
+  U8 buf[4];
+  int n = i2c_get_poll(h, buf, 4);
+
+  if (n == 4)
+  {
+    U32 v = get32(buf);
+
+    if (v != s->last_value && v != s->prev_value)
+      error("poll returned a stale read");
+    if (!s->present && ms - since >= 100)
+      error("poll returned a read of a missing device");
+  }
+  else if (n != -1)
+    error("poll returned a wrong length");
+  else if (s->present && ms - since >= 100)
+    error("poll returned no read of a device that is there");
+}
+
+static int expected_reads(unsigned long ms, unsigned long period)
+{
+  return (ms + period - 1) / period;
+}
+
+static int check(unsigned int seed)
+{
+  static const U8 fixed[2] = { 0x5a, 0xa5 };
+  unsigned long ms, since[2] = { 0, 0 };
+  int h0, h1, h2;
+  U8 buf[2];
+  int i;
+
+  start(seed);
+  sim_progress = 64;
+  sim_max_latency = 2;
+  check_queue(seed % I2C_N_PORTS);
+
+  start(seed);
+  sim_progress = 64;
+  sim_max_latency = 2;
+  for (i = 0; i < 2; i++)
+  {
+    memcpy(slaves[i].reg + FIXED_REG, fixed, 2);
+    i2c_enable(i);
+  }
+  h0 = i2c_add_poll(0, DEVICE, COUNTER_REG, 4, 30);
+  h1 = i2c_add_poll(0, DEVICE, FIXED_REG, 2, 45);
+  h2 = i2c_add_poll(1, DEVICE, COUNTER_REG, 4, 30);
+  if (h0 < 0 || h1 < 0 || h2 < 0 || i2c_add_poll(0, DEVICE, 0, 1, 10) >= 0)
+    error("wrong poll handle");
+
+  for (ms = systick_get_ms(); ms < CHECK_MS;)
+  {
+    int want = ms < 400 || ms >= 600;
+
+    /* The device comes and goes between transactions */
+    if (slaves[1].present != want && slaves[1].state == S_IDLE)
+    {
+      slaves[1].present = want;
+      since[1] = ms;
+    }
+    for (i = 0; i < 2; i++)
+      put32(slaves[i].reg + COUNTER_REG, ms);
+    ms = run_ms();
+    check_counter(h0, 0, ms, since[0]);
+    check_counter(h2, 1, ms, since[1]);
+    if (i2c_get_poll(h1, buf, 2) == 2 && memcmp(buf, fixed, 2) != 0)
+      error("poll returned wrong bytes");
+  }
+
+  if (abs((int) slaves[0].reads[COUNTER_REG] - expected_reads(CHECK_MS, 30)) > 1
+      || abs((int) slaves[0].reads[FIXED_REG] - expected_reads(CHECK_MS, 45)) > 1)
+    error("polls not kept to their period");
+  if (slaves[1].reads[COUNTER_REG] > (unsigned long) expected_reads(CHECK_MS, 30))
+    error("more reads than polls");
+  if (slaves[0].writes != 0 || slaves[1].writes != 0)
+    error("device written by a poll");
+
+  i2c_remove_poll(h0);
+  i2c_remove_poll(h1);
+  i2c_remove_poll(h2);
+  for (; ms < CHECK_MS + 50; ms = run_ms())
+    ;
+  {
+    unsigned long reads = slaves[0].reads[COUNTER_REG] + slaves[1].reads[COUNTER_REG];
+
+    for (; ms < CHECK_MS + 150; ms = run_ms())
+      ;
+    if (slaves[0].reads[COUNTER_REG] + slaves[1].reads[COUNTER_REG] != reads)
+      error("removed poll still read");
+  }
+  if (i2c_get_poll(h0, buf, 2) != -1)
+    error("removed poll returned a read");
+  if (i2c_busy(0) || i2c_busy(1))
+    error("port left busy");
+
+  if (errors)
+    printf("i2ctest: seed %u failed\n", seed);
+  return errors == 0;
+}
+
+static void bench(void)
+{
+  int h[I2C_N_PORTS];
+  double age[I2C_N_PORTS];
+  unsigned long got[I2C_N_PORTS];
+  unsigned long ms;
+  U8 buf[4];
+  int i;
+
+  start(1);
+  sim_max_latency = 2;
+  for (i = 0; i < I2C_N_PORTS; i++)
+  {
+    i2c_enable(i);
+    h[i] = i2c_add_poll(i, DEVICE, COUNTER_REG, 4, 30);
+    age[i] = 0;
+    got[i] = 0;
+  }
+  for (ms = systick_get_ms(); ms < BENCH_MS;)
+  {
+    for (i = 0; i < I2C_N_PORTS; i++)
+      put32(slaves[i].reg + COUNTER_REG, ms);
+    ms = run_ms();
+    for (i = 0; i < I2C_N_PORTS; i++)
+      if (i2c_get_poll(h[i], buf, 4) == 4)
+      {
+        age[i] += ms - get32(buf);
+        got[i]++;
+      }
+  }
+  for (i = 0; i < I2C_N_PORTS; i++)
+  {
+    char name[32];
+
+    sprintf(name, "port %d, 4 B / 30 ms", i + 1);
+    printf("%-30s %10lu %10.1f\n", name, slaves[i].reads[COUNTER_REG],
+           got[i] ? age[i] / got[i] : 0.0);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int seed, passed = 0;
+
+  if (argc == 2 && strcmp(argv[1], "check") == 0)
+  {
+    for (seed = 1; seed <= CHECK_RUNS; seed++)
+      passed += check(seed);
+    printf("i2ctest: %u of %u runs passed\n", passed, CHECK_RUNS);
+    return passed == CHECK_RUNS ? 0 : 1;
+  }
+  if (argc == 2 && strcmp(argv[1], "bench") == 0)
+  {
+    printf("%-30s %10s %10s\n", "i2ctest (3 s)", "reads", "age (ms)");
+    bench();
+    return 0;
+  }
+  fprintf(stderr, "usage: i2ctest check|bench\n");
+  return 2;
+}
@@ -0,0 +1,327 @@
+/* Host test of the buffered mode of the USB driver (udp.c) on a
+ * simulated UDP and host
+ *
+ *   udptest check   the host sends packets as fast as the banks take
+ *                   them, some short and some empty, while the NXT
+ *                   reads at a random pace and stops now and then;
+ *                   the NXT writes at a random pace while the host
+ *                   takes the packets. Half of the runs use udp_read
+ *                   and udp_write, which must keep packets whole, the
+ *                   others udp_stream_read and udp_stream_write. Every
+ *                   byte must arrive once and in order each way, and
+ *                   the rings must drain. The hardware moves on at
+ *                   random register accesses and interrupts come late.
+ *   udptest bench   bytes moved each way in 1 s of full packets by an
+ *                   application that calls the driver once a
+ *                   millisecond, as ecrobot_process1ms_usb did
+ *                   unbuffered, or with the stream calls in buffered
+ *                   mode, once a millisecond or in a loop (once a step)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "at91sim.h"
+#include "udp.h"
+#include "systick.h"
+
+#define MAX_BUF 64		/* as in udp.c */
+#define USB_CONFIGURED 1
+
+#define CHECK_RUNS 100
+#define CHECK_MS 500
+#define BENCH_MS 1000
+
+#define STREAM_SIZE (1 << 20)
+#define PACKETS (1 << 16)
+
+/* Host to NXT: the bytes and packet lengths sent, and how far the NXT
+ * has read them */
+static U8 out_stream[STREAM_SIZE];
+static unsigned int out_len[PACKETS];
+static unsigned long out_in, out_read, out_pkts, out_pkts_read;
+static int host_sending;
+static int host_short;		/* some packets short or empty */
+
+/* NXT to host: the bytes and packet lengths written, and those the
+ * host received. The ones received are checked after each write, as
+ * they may be sent before it returns. */
+static U8 in_stream[STREAM_SIZE];
+static U8 in_recv[STREAM_SIZE];
+static unsigned int in_len[PACKETS];
+static unsigned int in_recv_len[PACKETS];
+static unsigned long in_written, in_recv_bytes, in_checked;
+static unsigned long in_pkts, in_recv_pkts, in_pkts_checked;
+
+static int packets;		/* udp_read and udp_write, not the stream calls */
+static int errors;
+
+static U8 buf[4096];
+
+void udp_isr_entry(void)
+{
+  udp_isr_C();
+}
+
+static void error(const char *what)
+{
+  if (errors++ == 0)
+    printf("at %lu: %s\n", sim_time(), what);
+}
+
+static int host_out(unsigned char *data)
+{
+  unsigned int len, i;
+
+  if (!host_sending)
+    return -1;
+  len = host_short && sim_random(4) == 0 ? sim_random(MAX_BUF + 1) : MAX_BUF;
+  for (i = 0; i < len; i++)
+  {
+    data[i] = (unsigned char) sim_random(256);
+    out_stream[(out_in + i) % STREAM_SIZE] = data[i];
+  }
+  out_in += len;
+  out_len[out_pkts++ % PACKETS] = len;
+  return len;
+}
+
+static void host_in(const unsigned char *data, unsigned int len)
+{
+  unsigned int i;
+
+  for (i = 0; i < len; i++)
+    in_recv[(in_recv_bytes + i) % STREAM_SIZE] = data[i];
+  in_recv_bytes += len;
+  in_recv_len[in_recv_pkts++ % PACKETS] = len;
+}
+
+static void compare(void)
+{
+  for (; in_checked < in_recv_bytes; in_checked++)
+  {
+    if (in_checked == in_written)
+    {
+      error("byte sent that was not written");
+      break;
+    }
+    if (in_stream[in_checked % STREAM_SIZE] != in_recv[in_checked % STREAM_SIZE])
+      error("byte sent differs from the one written");
+  }
+  for (; packets && in_pkts_checked < in_recv_pkts && in_pkts_checked < in_pkts;
+       in_pkts_checked++)
+    if (in_len[in_pkts_checked % PACKETS] != in_recv_len[in_pkts_checked % PACKETS])
+      error("packet sent differs from the one written");
+}
+
+/* Checks n bytes read into buf against what the host sent */
+static void got(const U8 *data, unsigned long n)
+{
+  unsigned long i;
+
+  if (out_read + n > out_in)
+  {
+    error("byte read that was not sent");
+    return;
+  }
+  for (i = 0; i < n; i++)
+    if (data[i] != out_stream[(out_read + i) % STREAM_SIZE])
+      error("byte read differs from the one sent");
+  out_read += n;
+}
+
+/* Reads with udp_read (one packet) or udp_stream_read (len bytes) */
+static int read(U32 len)
+{
+  int n;
+
+  if (!packets)
+  {
+    n = udp_stream_read(buf, 0, len);
+    if (n < 0)
+      error("stream read failed");
+    else
+      got(buf, n);
+    return n;
+  }
+  n = udp_read(buf, 0, MAX_BUF);
+  if (n == 0 || n == -1)
+  {
+    if (n == -1)
+      error("read failed");
+    return 0;
+  }
+  if (out_pkts_read == out_pkts)
+  {
+    error("packet read that was not sent");
+    return 0;
+  }
+  if ((n == -2 ? 0 : n) != (int) out_len[out_pkts_read % PACKETS])
+    error("packet read differs from the one sent");
+  out_pkts_read++;
+  if (n > 0)
+    got(buf, n);
+  return n;
+}
+
+/* Writes with udp_write (one packet) or udp_stream_write (len bytes) */
+static int write(U32 len)
+{
+  U32 i;
+  int n;
+
+  for (i = 0; i < len; i++)
+    buf[i] = (U8) sim_random(256);
+  if (packets)
+  {
+    if (len > MAX_BUF)
+      len = MAX_BUF;
+    n = udp_write(buf, 0, len);
+    if (n != 0 && n != (int) len)
+      error("write returned a wrong length");
+  }
+  else
+  {
+    n = udp_stream_write(buf, 0, len);
+    if (n < 0 || n > (int) len || (n < (int) len && n % MAX_BUF != 0))
+      error("stream write returned a wrong length");
+  }
+  if (n > 0)
+  {
+    for (i = 0; i < (U32) n; i++)
+      in_stream[(in_written + i) % STREAM_SIZE] = buf[i];
+    in_written += n;
+    for (i = 0; i < (U32) n; i += MAX_BUF)
+      in_len[in_pkts++ % PACKETS] = n - i < MAX_BUF ? n - i : MAX_BUF;
+  }
+  compare();
+  return n;
+}
+
+static void start(unsigned int seed, int buffered)
+{
+  static const unsigned char set_configuration[8] = { 0x00, 0x09, 0x01, 0, 0, 0, 0, 0 };
+  int ms;
+
+  sim_init(seed);
+  out_in = out_read = out_pkts = out_pkts_read = 0;
+  in_written = in_recv_bytes = in_checked = 0;
+  in_pkts = in_recv_pkts = in_pkts_checked = 0;
+  host_sending = 0;
+  errors = 0;
+  sim_udp_out = host_out;
+  sim_udp_in = host_in;
+
+  udp_init();
+  udp_enable(0);
+  udp_set_buffered(buffered);
+  sim_udp_setup(set_configuration);
+  for (ms = 0; ms < 10 && ((unsigned int) udp_status() >> 28) != USB_CONFIGURED; ms++)
+    systick_wait_ms(1);
+  if (((unsigned int) udp_status() >> 28) != USB_CONFIGURED)
+    error("not configured");
+  host_sending = 1;
+}
+
+static int check(unsigned int seed)
+{
+  unsigned long ms;
+  unsigned int n, pause = 0;
+
+  packets = seed & 1;
+  start(seed, 1);
+  host_short = 1;
+  sim_progress = 64;
+  sim_max_latency = 2;
+  for (ms = 0; ms < CHECK_MS; ms++)
+  {
+    if (pause > 0)
+      pause--;
+    else if (sim_random(50) == 0)
+      pause = sim_random(30);
+    else
+      for (n = sim_random(4); n > 0; n--)
+        read(1 + sim_random(300));
+    for (n = sim_random(3); n > 0; n--)
+      write(1 + sim_random(300));
+    systick_wait_ms(1);
+    compare();
+  }
+
+  host_sending = 0;
+  for (; ms < CHECK_MS + 100; ms++)
+  {
+    read(sizeof(buf));
+    systick_wait_ms(1);
+    compare();
+  }
+  if (out_read != out_in || out_pkts == 0)
+    error("bytes sent but not read");
+  if (packets && out_pkts_read != out_pkts)
+    error("packets sent but not read");
+  if (in_checked != in_written || in_written == 0)
+    error("bytes written but not sent");
+  if ((udp_status() & 0x300000) != 0x100000)
+    error("rings not drained");
+  if (errors)
+    printf("udptest: seed %u failed\n", seed);
+  return errors == 0;
+}
+
+/* Bytes per ms (KB/s) moved each way by an application that calls the
+ * driver every steps steps */
+static void bench(const char *name, int buffered, int to_host, unsigned long steps)
+{
+  unsigned long t0;
+
+  packets = !buffered;
+  start(1, buffered);
+  host_short = 0;
+  host_sending = !to_host;
+  t0 = sim_time();
+  while (sim_time() - t0 < BENCH_MS * SIM_STEP_HZ / 1000)
+  {
+    if (to_host)
+      write(buffered ? sizeof(buf) : MAX_BUF);
+    else
+      read(sizeof(buf));
+    sim_run(steps);
+  }
+  compare();
+  printf("%-34s %10.1f\n", name,
+         (double) (to_host ? in_recv_bytes : out_read) / BENCH_MS);
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int seed, passed = 0;
+  unsigned long in = 0, out = 0;
+
+  if (argc == 2 && strcmp(argv[1], "check") == 0)
+  {
+    for (seed = 1; seed <= CHECK_RUNS; seed++)
+    {
+      passed += check(seed);
+      out += out_read;
+      in += in_written;
+    }
+    printf("udptest: %u of %u runs passed, %lu bytes read, %lu bytes written\n",
+           passed, CHECK_RUNS, out, in);
+    return passed == CHECK_RUNS ? 0 : 1;
+  }
+  if (argc == 2 && strcmp(argv[1], "bench") == 0)
+  {
+    unsigned long ms = SIM_STEP_HZ / 1000;
+
+    printf("%-34s %10s\n", "udptest (KB/s)", "moved");
+    bench("read, udp_read / 1 ms", 0, 0, ms);
+    bench("read, udp_stream_read / 1 ms", 1, 0, ms);
+    bench("read, udp_stream_read in a loop", 1, 0, 1);
+    bench("write, udp_write / 1 ms", 0, 1, ms);
+    bench("write, udp_stream_write / 1 ms", 1, 1, ms);
+    bench("write, udp_stream_write in a loop", 1, 1, 1);
+    return 0;
+  }
+  fprintf(stderr, "usage: udptest check|bench\n");
+  return 2;
+}
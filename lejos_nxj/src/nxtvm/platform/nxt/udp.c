@@ -11,6 +11,11 @@
  * The leJOS implementation uses the standard Lego identifiers (and so can
  * be used from the PC side applications that work with the standard Lego
  * firmware).
+ * In buffered mode (udp_set_buffered, if built with UDP_RX_PACKETS, see
+ * udp.h) the data end points are also interrupt driven. Received packets are moved from the two hardware banks
+ * to a ring as they arrive, and packets to send wait in a second ring
+ * until a bank is free, so several can be in flight each way without the
+ * caller polling the hardware.
  */
 #include "types.h"
 #include "mytypes.h"
@@ -102,6 +107,26 @@ static U8 *outPtr;
 static U32 outCnt;
 static U8 delayedEnable = 0;
 static U32 intCnt = 0;
+
+// Packet rings of buffered mode. The interrupt adds at the tail of
+// rxRing and takes from the head of txRing, the caller the other way.
+struct udp_packet {
+  U32 len;
+  U8 data[MAX_BUF];
+};
+#if UDP_BUFFERED
+static int buffered = 0;
+static struct udp_packet rxRing[UDP_RX_PACKETS];
+static volatile U32 rxHead;
+static volatile U32 rxCount;
+static U32 rxOff;             // Bytes of the head packet already streamed
+static struct udp_packet txRing[UDP_TX_PACKETS];
+static volatile U32 txHead;
+static volatile U32 txCount;
+static U32 txBanks;           // Packets in the hardware banks (0 to 2)
+#else
+#define buffered 0
+#endif
 #if REMOTE_CONSOLE
 static U8 rConsole = 0;
 #endif
@@ -223,6 +248,16 @@ hex4(int i)
   return x4;
 }
 
+static
+void
+buffers_reset()
+{
+#if UDP_BUFFERED
+  rxHead = rxCount = rxOff = 0;
+  txHead = txCount = txBanks = 0;
+#endif
+}
+
 static
 void
 reset()
@@ -235,6 +270,7 @@ reset()
   newAddress = -1;
   outCnt = 0;
   delayedEnable = 0;
+  buffers_reset();
 }
  
 
@@ -285,21 +321,21 @@ udp_reset()
     interrupts_enable(); 
 }
 
-int
-udp_read(U8* buf, int off, int len)
+static int
+rx_bank(U8* buf, int len)
 {
-  /* Perform a non-blocking read operation. We use double buffering (ping-pong)
+  /* Take the packet in the current receive bank, if there is one, and
+   * return its size (-1 if none). We use double buffering (ping-pong)
    * operation to provide better throughput.
    */
   int packetSize = 0, i;
   
-  if (len == 0) return 0;
   if ((*AT91C_UDP_CSR1) & currentRxBank) // data to read
   {
     packetSize = ((*AT91C_UDP_CSR1) & AT91C_UDP_RXBYTECNT) >> 16;
     if (packetSize > len) packetSize = len;
     // Transfer the data 
-    for(i=0;i<packetSize;i++) buf[off+i] = *AT91C_UDP_FDR1;
+    for(i=0;i<packetSize;i++) buf[i] = *AT91C_UDP_FDR1;
 
     // Flip bank
     ENTER();
@@ -319,7 +355,131 @@ udp_read(U8* buf, int off, int len)
       (*AT91C_UDP_RSTEP) &= ~AT91C_UDP_EP1;
     }
     LEAVE();
+    return packetSize;
+  }
+  return -1;
+}
+
+#if UDP_BUFFERED
+static int
+rx_take(U8* buf, int len, int whole)
+{
+  /* Copy up to len bytes of the packet at the head of the receive ring,
+   * and drop it once it has been read up (or at once if whole is set).
+   * Returns the number of bytes copied, or -1 if the ring is empty.
+   */
+  struct udp_packet *p;
+  int i_state;
+
+  if (rxCount == 0) return -1;
+  p = &rxRing[rxHead];
+  if (len > p->len - rxOff) len = p->len - rxOff;
+  memcpy(buf, p->data + rxOff, len);
+  rxOff += len;
+  if (whole || rxOff == p->len)
+  {
+    i_state = interrupts_get_and_disable();
+    rxHead = (rxHead + 1) % UDP_RX_PACKETS;
+    rxCount--;
+    rxOff = 0;
+    // There is room again for packets left in the banks
+    *AT91C_UDP_IER = AT91C_UDP_EPINT1;
+    if (i_state)
+      interrupts_enable();
+  }
+  return len;
+}
+
+static void
+rx_isr()
+{
+  /* Move the received packets to the ring. When it is full they are left
+   * in the banks, and the host is NAKed until udp_read makes room.
+   */
+  struct udp_packet *p;
+  int len;
+
+  while (rxCount < UDP_RX_PACKETS)
+  {
+    p = &rxRing[(rxHead + rxCount) % UDP_RX_PACKETS];
+    len = rx_bank(p->data, MAX_BUF);
+    if (len < 0) return;
+    p->len = len;
+    rxCount++;
+  }
+  *AT91C_UDP_IDR = AT91C_UDP_EPINT1;
+}
+
+static void
+tx_load()
+{
+  /* Copy queued packets to the free banks. The first is sent at once, a
+   * second one waits in the other bank until the first is complete.
+   * Called from the interrupt or with interrupts disabled.
+   */
+  struct udp_packet *p;
+  int i;
+
+  while (txBanks < 2 && txCount > 0)
+  {
+    p = &txRing[txHead];
+    for(i=0;i<p->len;i++) *AT91C_UDP_FDR2 = p->data[i];
+    txHead = (txHead + 1) % UDP_TX_PACKETS;
+    txCount--;
+    if (txBanks == 0)
+      UDP_SETEPFLAGS(*AT91C_UDP_CSR2, AT91C_UDP_TXPKTRDY);
+    txBanks++;
+  }
+}
+
+static void
+tx_isr()
+{
+  /* A bank has been sent. Release the one waiting behind it and refill. */
+  if (((*AT91C_UDP_CSR2) & AT91C_UDP_TXCOMP) == 0) return;
+  if (txBanks == 2)
+    UDP_SETEPFLAGS(*AT91C_UDP_CSR2, AT91C_UDP_TXPKTRDY);
+  UDP_CLEAREPFLAGS(*AT91C_UDP_CSR2, AT91C_UDP_TXCOMP);
+  if (txBanks > 0) txBanks--;
+  tx_load();
+}
+
+static int
+tx_put(U8* buf, int len)
+{
+  /* Queue a packet of len bytes, if there is room for it. */
+  struct udp_packet *p;
+  int i_state;
+
+  if (txCount == UDP_TX_PACKETS) return 0;
+  // The interrupt does not use the free slots
+  p = &txRing[(txHead + txCount) % UDP_TX_PACKETS];
+  memcpy(p->data, buf, len);
+  p->len = len;
+  i_state = interrupts_get_and_disable();
+  txCount++;
+  tx_load();
+  if (i_state)
+    interrupts_enable();
+  return len;
+}
+#endif
 
+int
+udp_read(U8* buf, int off, int len)
+{
+  /* Perform a non-blocking read operation of one packet. */
+  int packetSize;
+  
+  if (len == 0) return 0;
+#if UDP_BUFFERED
+  if (buffered)
+    packetSize = rx_take(buf + off, len, 1);
+  else
+#endif
+    packetSize = rx_bank(buf + off, len);
+  if (packetSize >= 0)
+  {
     // use special case for a real zero length packet so we can use it to
     // indicate EOF
     if (packetSize == 0) return -2;
@@ -329,6 +489,23 @@ udp_read(U8* buf, int off, int len)
   return 0;
 }
 
+int
+udp_stream_read(U8* buf, int off, int len)
+{
+  /* Perform a non-blocking read of up to len bytes, across packet
+   * boundaries (buffered mode only). Return the number of bytes read.
+   */
+  int total = 0;
+#if UDP_BUFFERED
+  int n;
+
+  while (total < len && (n = rx_take(buf + off + total, len - total, 0)) >= 0)
+    total += n;
+#endif
+  if (total == 0 && configured != USB_CONFIGURED) return -1;
+  return total;
+}
+
 int
 udp_write(U8* buf, int off, int len)
 {
@@ -338,10 +515,13 @@ udp_write(U8* buf, int off, int len)
   int i;
   
   if (configured != USB_CONFIGURED) return -1;
-  // Can we write ?
-  if ((*AT91C_UDP_CSR2 & AT91C_UDP_TXPKTRDY) != 0) return 0;
   // Limit to max transfer size
   if (len > MAX_BUF) len = MAX_BUF;
+#if UDP_BUFFERED
+  if (buffered) return tx_put(buf + off, len);
+#endif
+  // Can we write ?
+  if ((*AT91C_UDP_CSR2 & AT91C_UDP_TXPKTRDY) != 0) return 0;
   for(i=0;i<len;i++) *AT91C_UDP_FDR2 = buf[off+i];
   
   ENTER();
@@ -351,6 +531,27 @@ udp_write(U8* buf, int off, int len)
   return len;
 }
 
+int
+udp_stream_write(U8* buf, int off, int len)
+{
+  /* Perform a non-blocking write of up to len bytes, sent in full size
+   * packets and a short one for the rest (buffered mode only). Return the
+   * number of bytes actually written.
+   */
+  int total = 0;
+#if UDP_BUFFERED
+  int n;
+#endif
+
+  if (configured != USB_CONFIGURED) return -1;
+  if (!buffered) return 0;
+#if UDP_BUFFERED
+  while (total < len && (n = tx_put(buf + off + total, MIN(len - total, MAX_BUF))) > 0)
+    total += n;
+#endif
+  return total;
+}
+
 static
 void 
 udp_send_null()
@@ -523,6 +724,9 @@ udp_enumerate()
         // and reset them...
         (*AT91C_UDP_RSTEP) |= (AT91C_UDP_EP1|AT91C_UDP_EP2|AT91C_UDP_EP3);
         (*AT91C_UDP_RSTEP) &= ~(AT91C_UDP_EP1|AT91C_UDP_EP2|AT91C_UDP_EP3);
+        buffers_reset();
+        if (buffered)
+          *AT91C_UDP_IER = (AT91C_UDP_EPINT1 | AT91C_UDP_EPINT2);
       }
       else
       {
@@ -598,6 +802,14 @@ udp_enumerate()
         }
         (*AT91C_UDP_RSTEP) |= res;
         (*AT91C_UDP_RSTEP) &= ~res;
+        if (res == AT91C_UDP_EP2)
+        {
+#if UDP_BUFFERED
+          // The banks were emptied, carry on with the queued packets
+          txBanks = 0;
+          if (buffered) tx_load();
+#endif
+        }
         udp_send_null();
       }
       else udp_send_stall();
@@ -740,6 +952,13 @@ display_string(hex4(intCnt++));*/
     *AT91C_UDP_ICR = AT91C_UDP_EPINT0; 
     udp_enumerate();                    
   } 
+#if UDP_BUFFERED
+  // The data end point interrupts are cleared by emptying the banks
+  if (buffered && (*AT91C_UDP_ISR & AT91C_UDP_EPINT1))
+    rx_isr();
+  if (buffered && (*AT91C_UDP_ISR & AT91C_UDP_EPINT2))
+    tx_isr();
+#endif
     //display_goto_xy(12,2);
     //display_string("IE2");
 }
@@ -756,6 +975,14 @@ udp_status()
    */
   int ret = (configured << 28) | (currentConfig << 24) | (currentFeatures & 0xffff);
 
+#if UDP_BUFFERED
+  if (configured == USB_CONFIGURED && buffered)
+  {
+    if (rxCount > 0) ret |= USB_READABLE;
+    if (txCount < UDP_TX_PACKETS) ret |= USB_WRITEABLE;
+  }
+  else
+#endif
   if (configured == USB_CONFIGURED)
   {
     if ((*AT91C_UDP_CSR1) & currentRxBank) ret |= USB_READABLE;
@@ -799,6 +1026,7 @@ udp_disable()
 {
   /* Disable processing of USB requests */
   U8 buf[MAX_BUF];
+  udp_set_buffered(0);
   // Discard any input
   while (udp_read(buf, 0, sizeof(buf)) > 0)
     ;
@@ -812,6 +1040,33 @@ udp_disable()
 #endif
 }
 
+void
+udp_set_buffered(int on)
+{
+  /* Turn buffered mode on or off. Packets waiting in the rings are
+   * dropped. Without the rings (UDP_RX_PACKETS 0) the driver stays
+   * unbuffered.
+   */
+#if UDP_BUFFERED
+  int i_state = interrupts_get_and_disable();
+  buffers_reset();
+  if (on)
+  {
+    // Left over from an unbuffered write
+    if ((*AT91C_UDP_CSR2) & AT91C_UDP_TXCOMP)
+      UDP_CLEAREPFLAGS(*AT91C_UDP_CSR2, AT91C_UDP_TXCOMP);
+    txBanks = ((*AT91C_UDP_CSR2) & AT91C_UDP_TXPKTRDY) ? 1 : 0;
+  }
+  buffered = on;
+  if (on && configured == USB_CONFIGURED)
+    *AT91C_UDP_IER = (AT91C_UDP_EPINT1 | AT91C_UDP_EPINT2);
+  else
+    *AT91C_UDP_IDR = (AT91C_UDP_EPINT1 | AT91C_UDP_EPINT2);
+  if (i_state)
+    interrupts_enable(); 
+#endif
+}
+
 void
 udp_set_serialno(U8 *serNo, int len)
 {
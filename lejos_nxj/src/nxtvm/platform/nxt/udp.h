@@ -14,6 +14,22 @@ int udp_status();
 void udp_set_serialno(U8 *serNo, int len);
 void udp_set_name(U8 *name, int len);
 void udp_rconsole(U8* buf, int len);
+void udp_set_buffered(int on);
+int udp_stream_read(U8* buf, int off, int len);
+int udp_stream_write(U8* buf, int off, int len);
+
+/* Packets held by the driver in each direction in buffered mode. Each
+ * takes 68 bytes of RAM, so the rings are only built where buffered mode
+ * is used: the ecrobot library sets UDP_RX_PACKETS, the leJOS VM does
+ * not, and without the rings udp_set_buffered leaves the driver
+ * unbuffered. */
+#ifndef UDP_RX_PACKETS
+#define UDP_RX_PACKETS 0
+#endif
+#ifndef UDP_TX_PACKETS
+#define UDP_TX_PACKETS UDP_RX_PACKETS
+#endif
+#define UDP_BUFFERED (UDP_RX_PACKETS > 0 && UDP_TX_PACKETS > 0)
 
 #define   USB_TIMEOUT   0x0BB8 
 #define END_OF_BUS_RESET ((unsigned int) 0x1 << 12)
@@ -0,0 +1,238 @@
+/**
+ * main.c
+ * Runs a leJOS NXT binary on a Linux host.
+ *
+ * Usage: lejos_unix [-v] [-b buttons] [-s port=value]... [-p file] [binary]
+ *
+ * Without a binary file, the image in platform/nxt/java_binary.h
+ * is run. -v prints the display on every refresh, -b sets the
+ * buttons reported as pressed and -s sets the raw reading of a
+ * sensor port. -p writes the counts of the profiler to a file when
+ * the program ends. The exit status is the one given to System.exit,
+ * or 1 after an uncaught exception.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "constants.h"
+#include "classes.h"
+#include "threads.h"
+#include "stack.h"
+#include "specialclasses.h"
+#include "specialsignatures.h"
+#include "language.h"
+#include "memory.h"
+#include "interpreter.h"
+#include "exceptions.h"
+#include "trace.h"
+#include "poll.h"
+#include "sensors.h"
+#include "magic.h"
+#include "platform_hooks.h"
+#include "profiler.h"
+#include "sim.h"
+#include "../nxt/java_binary.h"
+
+/**
+ * Largest binary that can be loaded, in bytes.
+ */
+#define MAX_BINARY_SIZE 0x10000
+
+/**
+ * Size of the Java heap, in bytes. About what is left
+ * of the NXT's RAM once the firmware is loaded.
+ */
+#define HEAP_SIZE 0xC000
+
+extern void init_sys_time(void);
+extern int exit_status;
+
+static byte binary[MAX_BINARY_SIZE] __attribute__ ((aligned (4)));
+static byte region[HEAP_SIZE] __attribute__ ((aligned (4)));
+Thread *bootThread;
+
+void
+handle_uncaught_exception(Object * exception,
+			  const Thread * thread,
+			  const MethodRecord * methodRecord,
+			  const MethodRecord * rootMethod, byte * pc)
+{
+  fprintf(stderr, "Java Exception: class %d, method %d, thread %d\n",
+	  get_class_index(exception), methodRecord->signatureId,
+	  thread->threadId);
+  exit(1);
+}
+
+void
+switch_thread_hook()
+{
+}
+
+void
+assert_hook(boolean aCond, int aCode)
+{
+  if (!aCond) {
+    fprintf(stderr, "Assertion failed: %d\n", aCode);
+    abort();
+  }
+}
+
+/**
+ * Writes the profile, one entry per line, with the method of
+ * each entry found in the class and method tables of the binary.
+ */
+static void
+write_profile(const char *path)
+{
+  FILE *f;
+  JINT entry[2];
+  TWOBYTES offset;
+  TWOBYTES pc;
+  ClassRecord *classRecord;
+  MethodRecord *methodRecord;
+  int i, j, k;
+
+  f = fopen(path, "w");
+  if (f == NULL) {
+    perror(path);
+    return;
+  }
+  fprintf(f, "# class method signature pc count\n");
+  for (i = 0; read_profile(entry, 2, i) == 1; i++) {
+    offset = (TWOBYTES) (entry[0] >> 16);
+    pc = (TWOBYTES) entry[0];
+    if (offset == 0) {
+      fprintf(f, "# %s %ld\n", pc == 0 ? "idle" : "lost",
+	      (long) (FOURBYTES) entry[1]);
+      continue;
+    }
+    for (j = 0; j <= get_master_record()->lastClass; j++) {
+      classRecord = get_class_record(j);
+      for (k = 0; k < classRecord->numMethods; k++) {
+	methodRecord = get_method_record(classRecord, k);
+	if ((byte *) methodRecord - get_binary_base() != offset)
+	  continue;
+	fprintf(f, "%d %d %d ", j, k, methodRecord->signatureId);
+	if (pc == PROFILE_CALLS)
+	  fprintf(f, "calls");
+	else
+	  fprintf(f, "%d", pc);
+	fprintf(f, " %ld\n", (long) (FOURBYTES) entry[1]);
+      }
+    }
+  }
+  fclose(f);
+}
+
+static int
+load_binary(const char *path)
+{
+  FILE *f;
+  size_t size;
+
+  if (path == NULL) {
+    memcpy(binary, java_binary, sizeof(java_binary));
+    return 1;
+  }
+  f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return 0;
+  }
+  size = fread(binary, 1, sizeof(binary), f);
+  if (!feof(f)) {
+    fprintf(stderr, "%s: larger than %d bytes\n", path, MAX_BINARY_SIZE);
+    size = 0;
+  }
+  fclose(f);
+  return size > 0;
+}
+
+void
+run(void)
+{
+  init_poller();
+
+  // Initialize binary image state
+  initialize_binary();
+
+  // Initialize memory
+  memory_init();
+  memory_add_region(region, region + HEAP_SIZE);
+
+  // The thread queues are garbage collection roots, so they
+  // must be cleared before the first allocation
+  init_threads();
+
+  // Initialize exceptions
+  init_exceptions();
+
+  // Create the boot thread (bootThread is a special global)
+  bootThread = (Thread *) new_object_for_class(JAVA_LANG_THREAD);
+
+  if (!init_thread(bootThread)) {
+    return;
+  }
+
+  // Execute the bytecode interpreter
+  set_program_number(0);
+
+  engine();
+  // Engine returns when all non-daemon threads are dead
+}
+
+int
+main(int argc, char *argv[])
+{
+  const char *path = NULL;
+  const char *profilePath = NULL;
+  int port, value;
+  int i;
+
+  // Stack words hold pointers in 32 bits.
+  if ((unsigned long) (region + HEAP_SIZE) > 0xFFFFFFFFUL ||
+      (unsigned long) (binary + MAX_BINARY_SIZE) > 0xFFFFFFFFUL) {
+    fprintf(stderr, "%s: must be linked below 4 GB (-no-pie)\n", argv[0]);
+    return 2;
+  }
+
+  sim_init();
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0)
+      sim_verbose = 1;
+    else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+      sim_buttons = strtoul(argv[++i], NULL, 0);
+    else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc &&
+	     sscanf(argv[++i], "%d=%d", &port, &value) == 2 &&
+	     port >= 0 && port < N_SENSORS)
+      sim_sensor_adc[port] = value;
+    else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+      profilePath = argv[++i];
+    else if (argv[i][0] != '-' && path == NULL)
+      path = argv[i];
+    else {
+      fprintf(stderr,
+	      "Usage: %s [-v] [-b buttons] [-s port=value]... [-p file] [binary]\n",
+	      argv[0]);
+      return 2;
+    }
+  }
+
+  if (!load_binary(path))
+    return 2;
+  install_binary(binary);
+  if (get_magic_number() != MAGIC) {
+    fprintf(stderr, "%s: not a leJOS binary\n", path ? path : "java_binary.h");
+    return 2;
+  }
+
+  init_sys_time();
+  init_sensors();
+  run();
+  if (profilePath != NULL)
+    write_profile(profilePath);
+  return exit_status;
+}
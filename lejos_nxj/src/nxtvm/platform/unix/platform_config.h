@@ -0,0 +1,40 @@
+#ifndef _PLATFORM_CONFIG_H
+#  define _PLATFORM_CONFIG_H
+
+// Basic types
+
+typedef unsigned char byte;
+typedef signed char JBYTE;
+typedef signed short JSHORT;
+typedef signed int JINT;
+typedef unsigned short TWOBYTES;
+typedef unsigned int FOURBYTES;
+
+extern FOURBYTES get_sys_time_impl();
+
+// Converting words to pointers. Stack words are 32 bits wide, so
+// on a 64-bit host everything the VM points to must be below 4 GB
+// (see Makefile).
+
+#  define ptr2word(PTR_) ((STACKWORD) (unsigned long) (PTR_))
+#  define word2ptr(WRD_) ((void *) (unsigned long) (WRD_))
+
+// Macro to get 4-byte system time, used in sleep.
+
+#  define get_sys_time() get_sys_time_impl()
+
+// Byte order (<endian.h> may already define it as 1234):
+
+#  undef LITTLE_ENDIAN
+#  define LITTLE_ENDIAN 1
+
+// Floating point arithmetic supported?
+
+#  define FP_ARITHMETIC 1
+
+// Are we using the timer IRQ to switch threads? Not yet.
+
+#  define PLATFORM_HANDLES_SWITCH_THREAD 0
+#  define TICKS_PER_TIME_SLICE          2
+
+#endif // _PLATFORM_CONFIG_H
@@ -0,0 +1,66 @@
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "platform_hooks.h"
+
+
+int last_ad_time;
+
+static struct timespec start_time;
+
+#if PROFILER_ENTRIES
+/**
+ * Ticks the interpreter every millisecond for the profiler, as the NXT's
+ * timer does.
+ */
+static void
+tick(int signal)
+{
+  gMakeRequest = true;
+}
+#endif
+
+void
+init_sys_time(void)
+{
+#if PROFILER_ENTRIES
+  struct sigaction action;
+  struct itimerval interval;
+#endif
+
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+#if PROFILER_ENTRIES
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = tick;
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGALRM, &action, NULL);
+
+  interval.it_interval.tv_sec = 0;
+  interval.it_interval.tv_usec = 1000;
+  interval.it_value = interval.it_interval;
+  setitimer(ITIMER_REAL, &interval, NULL);
+#endif
+}
+
+/**
+ * Milliseconds since init_sys_time().
+ */
+FOURBYTES
+get_sys_time_impl(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (FOURBYTES) ((now.tv_sec - start_time.tv_sec) * 1000 +
+		      (now.tv_nsec - start_time.tv_nsec) / 1000000);
+}
+
+void
+idle_hook(void)
+{
+  usleep(1000);
+}
@@ -0,0 +1,70 @@
+#include "platform_config.h"
+
+#include "types.h"
+#include "sensors.h"
+#include "sim.h"
+
+sensor_t sensors[N_SENSORS] = {
+  {0, 0, 0, 0, 0},
+  {0, 0, 0, 0, 0},
+  {0, 0, 0, 0, 0},
+  {0, 0, 0, 0, 0}
+};
+
+void
+init_sensors(void)
+{
+  int i;
+
+  for (i = 0; i < N_SENSORS; i++) {
+    unset_digi0(i);
+    unset_digi1(i);
+    nxt_avr_set_input_power(i, 0);
+  }
+}
+
+/**
+ * Read sensor values
+ */
+void
+poll_sensors(void)
+{
+  byte i;
+  sensor_t *pSensor = sensors;
+
+  for (i = 0; i < N_SENSORS; i++, pSensor++) {
+    pSensor->value = sensor_adc(i);
+  }
+}
+
+void
+read_buttons(int dummy, short *output)
+{
+  *output = (short) buttons_get();
+}
+
+void
+check_for_data(char *valid, char **nextbyte)
+{
+  *valid = 0;
+}
+
+void
+set_digi0(int sensor)
+{
+}
+
+void
+unset_digi0(int sensor)
+{
+}
+
+void
+set_digi1(int sensor)
+{
+}
+
+void
+unset_digi1(int sensor)
+{
+}
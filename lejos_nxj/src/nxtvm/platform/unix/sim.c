@@ -0,0 +1,293 @@
+/**
+ * sim.c
+ * In-memory stand-ins for the NXT hardware.
+ *
+ * Sensors and buttons return the values set in sim_sensor_adc and
+ * sim_buttons. Motors turn at a speed proportional to their power,
+ * with no load. I2C transactions and Bluetooth sends complete at
+ * once, and nothing is ever received. USB is never connected.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "types.h"
+#include "sensors.h"
+#include "sim.h"
+
+/**
+ * Degrees turned per second by a motor at 100% power.
+ */
+#define MOTOR_DEGREES_PER_SECOND 900
+
+int sim_verbose;
+unsigned sim_sensor_adc[N_SENSORS];
+unsigned sim_buttons;
+
+static char display_text[SIM_DISPLAY_HEIGHT][SIM_DISPLAY_WIDTH];
+static unsigned char display_buffer[SIM_DISPLAY_HEIGHT][100];
+static int display_x;
+static int display_y;
+
+typedef struct {
+  int speed_percent;
+  // Position in thousandths of a degree
+  int millidegrees;
+  FOURBYTES last_update;
+} sim_motor_t;
+
+static sim_motor_t motor[N_MOTORS];
+
+void
+sim_init(void)
+{
+  int i;
+
+  // An open sensor port reads full scale.
+  for (i = 0; i < N_SENSORS; i++)
+    sim_sensor_adc[i] = 1023;
+  display_clear(0);
+}
+
+// Display
+
+void
+display_update(void)
+{
+  int x, y;
+
+  if (!sim_verbose)
+    return;
+  printf("+----------------+\n");
+  for (y = 0; y < SIM_DISPLAY_HEIGHT; y++) {
+    putchar('|');
+    for (x = 0; x < SIM_DISPLAY_WIDTH; x++)
+      putchar(display_text[y][x]);
+    printf("|\n");
+  }
+  printf("+----------------+\n");
+  fflush(stdout);
+}
+
+void
+display_clear(unsigned updateToo)
+{
+  memset(display_text, ' ', sizeof(display_text));
+  memset(display_buffer, 0, sizeof(display_buffer));
+  if (updateToo)
+    display_update();
+}
+
+void
+display_goto_xy(int x, int y)
+{
+  display_x = x;
+  display_y = y;
+}
+
+void
+display_string(const char *str)
+{
+  while (*str) {
+    if (*str != '\n') {
+      if (display_x >= 0 && display_x < SIM_DISPLAY_WIDTH &&
+	  display_y >= 0 && display_y < SIM_DISPLAY_HEIGHT)
+	display_text[display_y][display_x] = *str;
+      display_x++;
+    } else {
+      display_x = 0;
+      display_y++;
+    }
+    str++;
+  }
+}
+
+void
+display_int(int val, unsigned places)
+{
+  char x[12];
+
+  if (places > 11)
+    places = 11;
+  sprintf(x, "%*d", (int) places, val);
+  display_string(x);
+}
+
+unsigned char *
+display_get_buffer(void)
+{
+  return (unsigned char *) display_buffer;
+}
+
+// AVR link
+
+unsigned
+buttons_get(void)
+{
+  return sim_buttons;
+}
+
+unsigned
+battery_voltage(void)
+{
+  return 8000;
+}
+
+unsigned
+sensor_adc(unsigned n)
+{
+  if (n < N_SENSORS)
+    return sim_sensor_adc[n];
+  return 0;
+}
+
+void
+nxt_avr_set_input_power(unsigned n, unsigned power_type)
+{
+}
+
+// Motors
+
+static void
+motor_update(sim_motor_t *m)
+{
+  FOURBYTES now = get_sys_time_impl();
+
+  m->millidegrees += m->speed_percent * (int) (now - m->last_update) *
+    (MOTOR_DEGREES_PER_SECOND / 100);
+  m->last_update = now;
+}
+
+int
+nxt_motor_get_count(unsigned n)
+{
+  if (n >= N_MOTORS)
+    return 0;
+  motor_update(&motor[n]);
+  return motor[n].millidegrees / 1000;
+}
+
+void
+nxt_motor_set_count(unsigned n, int count)
+{
+  if (n < N_MOTORS) {
+    motor_update(&motor[n]);
+    motor[n].millidegrees = count * 1000;
+  }
+}
+
+void
+nxt_motor_set_speed(unsigned n, int speed_percent, int brake)
+{
+  if (n < N_MOTORS) {
+    if (speed_percent > 100)
+      speed_percent = 100;
+    if (speed_percent < -100)
+      speed_percent = -100;
+    motor_update(&motor[n]);
+    motor[n].speed_percent = speed_percent;
+  }
+}
+
+// I2C
+
+void
+i2c_enable(int port)
+{
+}
+
+void
+i2c_disable(int port)
+{
+}
+
+int
+i2c_busy(int port)
+{
+  return 0;
+}
+
+int
+i2c_start_transaction(int port, unsigned address, int internal_address,
+		      int n_internal_address_bytes, unsigned char *data,
+		      unsigned nbytes, int write)
+{
+  // No device answers: reads return zeros.
+  if (!write)
+    memset(data, 0, nbytes);
+  return 0;
+}
+
+// Sound
+
+void
+sound_freq(unsigned freq, unsigned ms)
+{
+  if (sim_verbose)
+    printf("tone %u Hz %u ms\n", freq, ms);
+}
+
+// Bluetooth
+
+void
+bt_send(unsigned char *buf, unsigned len)
+{
+}
+
+void
+bt_receive(unsigned char *buf)
+{
+  buf[0] = 0;
+  buf[1] = 0;
+}
+
+unsigned
+bt_get_mode(void)
+{
+  return 0;
+}
+
+void
+bt_set_arm7_cmd(void)
+{
+}
+
+void
+bt_clear_arm7_cmd(void)
+{
+}
+
+void
+bt_start_ad_converter(void)
+{
+}
+
+// USB
+
+int
+udp_read(unsigned char *buf, int off, int len)
+{
+  return -1;
+}
+
+int
+udp_write(unsigned char *buf, int off, int len)
+{
+  return -1;
+}
+
+int
+udp_status(void)
+{
+  return 0;
+}
+
+void
+udp_enable(int reset)
+{
+}
+
+void
+udp_disable(void)
+{
+}
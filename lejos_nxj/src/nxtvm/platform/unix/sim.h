@@ -0,0 +1,83 @@
+#ifndef _SIM_H
+#  define _SIM_H
+
+// In-memory stand-ins for the NXT hardware. The functions have
+// the names and meanings of their counterparts in platform/nxt.
+
+#  define SIM_DISPLAY_WIDTH  16
+#  define SIM_DISPLAY_HEIGHT 8
+#  define N_MOTORS           3
+
+/**
+ * If not 0, the display is printed on stdout on every refresh,
+ * and tones are reported.
+ */
+extern int sim_verbose;
+
+/**
+ * Raw A/D readings returned for the sensor ports.
+ */
+extern unsigned sim_sensor_adc[];
+
+/**
+ * Buttons reported as pressed.
+ */
+extern unsigned sim_buttons;
+
+extern void sim_init(void);
+
+// Display
+
+extern void display_update(void);
+extern void display_clear(unsigned updateToo);
+extern void display_goto_xy(int x, int y);
+extern void display_string(const char *str);
+extern void display_int(int val, unsigned places);
+extern unsigned char *display_get_buffer(void);
+
+// AVR link
+
+extern unsigned buttons_get(void);
+extern unsigned battery_voltage(void);
+extern unsigned sensor_adc(unsigned n);
+extern void nxt_avr_set_input_power(unsigned n, unsigned power_type);
+
+// Motors
+
+extern int nxt_motor_get_count(unsigned n);
+extern void nxt_motor_set_count(unsigned n, int count);
+extern void nxt_motor_set_speed(unsigned n, int speed_percent, int brake);
+
+// I2C
+
+extern void i2c_enable(int port);
+extern void i2c_disable(int port);
+extern int i2c_busy(int port);
+extern int i2c_start_transaction(int port, unsigned address,
+                                 int internal_address,
+                                 int n_internal_address_bytes,
+                                 unsigned char *data, unsigned nbytes,
+                                 int write);
+
+// Sound
+
+extern void sound_freq(unsigned freq, unsigned ms);
+
+// Bluetooth
+
+extern void bt_send(unsigned char *buf, unsigned len);
+extern void bt_receive(unsigned char *buf);
+extern unsigned bt_get_mode(void);
+extern void bt_set_arm7_cmd(void);
+extern void bt_clear_arm7_cmd(void);
+extern void bt_start_ad_converter(void);
+
+// USB
+
+extern int udp_read(unsigned char *buf, int off, int len);
+extern int udp_write(unsigned char *buf, int off, int len);
+extern int udp_status(void);
+extern void udp_enable(int reset);
+extern void udp_disable(void);
+
+#endif // _SIM_H
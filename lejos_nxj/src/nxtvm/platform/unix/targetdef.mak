@@ -0,0 +1,30 @@
+#
+# This file defines the source and target file names
+#
+
+# TARGET is the name of the executable.
+# C_SOURCES are the C files
+
+VM_DIR := ../../javavm
+
+TARGET := lejos_unix
+
+C_PLATFORM_SOURCES := \
+	main.c \
+	native.c \
+	platform_hooks.c \
+	sensors.c \
+	sim.c
+
+C_VM_SOURCES := \
+	$(VM_DIR)/interpreter.c \
+	$(VM_DIR)/threads.c \
+	$(VM_DIR)/exceptions.c \
+	$(VM_DIR)/memory.c \
+	$(VM_DIR)/gc.c \
+	$(VM_DIR)/language.c \
+	$(VM_DIR)/quicken.c \
+	$(VM_DIR)/profiler.c \
+	$(VM_DIR)/poll.c
+
+C_SOURCES := $(C_PLATFORM_SOURCES) $(C_VM_SOURCES)
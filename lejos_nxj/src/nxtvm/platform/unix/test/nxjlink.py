@@ -0,0 +1,400 @@
+"""
+nxjlink.py
+Builds leJOS binaries for lejos_unix without a Java compiler.
+
+Programs are described in Python: classes with their fields, and
+methods as lists of bytecode instructions and labels. link() lays
+them out the way the VM reads them (see javavm/language.h), with the
+special classes and signatures numbered as in specialclasses.h and
+specialsignatures.h. The layout assumes the host's structure sizes
+(a 12 byte MethodRecord and an 8 byte ExceptionRecord), which are
+also those of the NXT.
+
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, 'main([Ljava/lang/String;)V', [
+        'iconst_3',
+        ('invokestatic', img.native('exit(I)V')),
+        'return'])
+    open('exit3.bin', 'wb').write(img.link([main]))
+"""
+
+import os
+import re
+import struct
+
+VM_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      '..', '..', '..', 'javavm')
+
+MAGIC = 0xCAF6
+HEADER_SIZE = 4
+
+# Field and array element types (constants.h), by descriptor
+TYPES = {'L': 0, '[': 0, 'Z': 4, 'C': 5, 'F': 6, 'D': 7, 'B': 8, 'S': 9,
+         'I': 10, 'J': 11}
+TYPE_SIZE = {0: 4, 4: 1, 5: 2, 6: 4, 7: 8, 8: 1, 9: 2, 10: 4, 11: 8}
+
+M_NATIVE = 0x01
+M_SYNCHRONIZED = 0x02
+M_STATIC = 0x04
+C_HASCLINIT = 0x04
+
+OPCODES = {}
+for _line in open(os.path.join(VM_DIR, 'opcodes.h')):
+    _m = re.match(r'#define OP_(\w+)\s+(\d+)', _line)
+    if _m:
+        OPCODES[_m.group(1).lower()] = int(_m.group(2))
+
+# Operand bytes of the instructions that have them
+OPERAND_SIZE = {'bipush': 1, 'sipush': 2, 'ldc': 1, 'newarray': 1,
+                'iinc': 2, 'invokevirtual': 2, 'invokestatic': 2,
+                'invokespecial': 2, 'getfield': 2, 'putfield': 2,
+                'getstatic': 2, 'putstatic': 2, 'new': 2,
+                'checkcast': 2, 'instanceof': 2}
+for _op in ('iload', 'lload', 'fload', 'dload', 'aload', 'istore',
+            'lstore', 'fstore', 'dstore', 'astore'):
+    OPERAND_SIZE[_op] = 1
+for _op in ('ifeq', 'ifne', 'iflt', 'ifge', 'ifgt', 'ifle', 'if_icmpeq',
+            'if_icmpne', 'if_icmplt', 'if_icmpge', 'if_icmpgt', 'if_icmple',
+            'if_acmpeq', 'if_acmpne', 'goto', 'ifnull', 'ifnonnull'):
+    OPERAND_SIZE[_op] = 2
+BRANCHES = [op for op, n in OPERAND_SIZE.items()
+            if n == 2 and (op.startswith('if') or op == 'goto')]
+
+
+def _read_defines(name):
+    defines = {}
+    for line in open(os.path.join(VM_DIR, name)):
+        m = re.match(r'#define (\w+) (\d+)', line)
+        if m:
+            defines[m.group(1)] = int(m.group(2))
+    return defines
+
+
+def mangle(signature):
+    """
+    Name of a signature in specialsignatures.h,
+    e.g. wait(J)V -> wait_4J_5V.
+    """
+    for a, b in (('_', '_1'), ('/', '_3'), (';', '_2'), ('[', '_1'),
+                 ('(', '_4'), (')', '_5'), ('<', '_6'), ('>', '_7')):
+        signature = signature.replace(a, b)
+    return signature
+
+
+def param_words(signature, static):
+    """
+    Stack words taken by the parameters of a method, receiver included.
+    """
+    desc = signature[signature.index('(') + 1:signature.index(')')]
+    words = 0 if static else 1
+    i = 0
+    while i < len(desc):
+        start = i
+        while desc[i] == '[':
+            i += 1
+        if desc[i] == 'L':
+            i = desc.index(';', i)
+        words += 2 if desc[start] in 'JD' else 1
+        i += 1
+    return words
+
+
+class Class:
+    def __init__(self, index, name, parent, fields):
+        self.index = index
+        self.name = name
+        self.parent = parent
+        self.fields = fields
+        self.methods = []
+        self.flags = 0
+
+    def field_types(self):
+        return [TYPES[desc[0]] for name, desc in self.fields]
+
+    def size(self):
+        """Size of the fields of this class and its superclasses, header included."""
+        size = HEADER_SIZE if self.parent is None else self.parent.size()
+        return size + sum(TYPE_SIZE[t] for t in self.field_types())
+
+    def field(self, name):
+        """Operands of getfield/putfield for a field of this class or a superclass."""
+        offset = HEADER_SIZE if self.parent is None else self.parent.size()
+        for fname, desc in self.fields:
+            if fname == name:
+                return (TYPES[desc[0]] << 4) | (offset >> 8), offset & 0xFF
+            offset += TYPE_SIZE[TYPES[desc[0]]]
+        return self.parent.field(name)
+
+    def method(self, signature):
+        """Operands of invokestatic/invokespecial for a method of this class."""
+        for i, m in enumerate(self.methods):
+            if m.signature == signature:
+                return self.index, i
+        raise KeyError('%s.%s' % (self.name, signature))
+
+
+class Method:
+    def __init__(self, signature, sig_id, code, flags, locals_, max_stack,
+                 handlers):
+        self.signature = signature
+        self.sig_id = sig_id
+        self.code = code
+        self.flags = flags
+        self.locals = locals_
+        self.max_stack = max_stack
+        self.handlers = handlers
+
+
+class Image:
+    """
+    A program being built. Classes 0 to 16 are the special classes,
+    with the fields the VM expects of Thread and String. Thread also
+    has a name, a field the VM does not know of. Natives are
+    declared in class 17 (see native()).
+    """
+
+    def __init__(self):
+        self.special_classes = _read_defines('specialclasses.h')
+        self.special_signatures = _read_defines('specialsignatures.h')
+        self.signatures = {}
+        self.classes = []
+        self.statics = []
+        self.constants = []
+
+        names = sorted(self.special_classes, key=self.special_classes.get)
+        for name in names:
+            self.classes.append(None)
+        obj = self._make_class('JAVA_LANG_OBJECT', None, [])
+        thread = self._make_class('JAVA_LANG_THREAD', obj, [
+            ('nextThread', 'Ljava/lang/Thread;'), ('waitingOn', 'I'),
+            ('sleepUntil', 'I'), ('stackFrameArray', 'I'),
+            ('stackArray', 'I'), ('stackFrameArraySize', 'B'),
+            ('monitorCount', 'B'), ('threadId', 'B'), ('state', 'B'),
+            ('priority', 'B'), ('interruptState', 'B'), ('daemon', 'B'),
+            ('name', '[C')])
+        self._make_class('JAVA_LANG_STRING', obj, [('characters', '[C')])
+        throwable = self._make_class('JAVA_LANG_THROWABLE', obj, [])
+        for name in names:
+            if self.classes[self.special_classes[name]] is None:
+                self._make_class(name, throwable, [])
+        self.natives = self.add_class('Natives')
+        self.thread = thread
+
+    def _make_class(self, name, parent, fields):
+        c = Class(self.special_classes[name], name, parent, fields)
+        self.classes[c.index] = c
+        return c
+
+    def add_class(self, name, parent=None, fields=()):
+        """
+        Adds a class, a subclass of Object unless parent is given.
+        Fields are (name, descriptor) pairs.
+        """
+        c = Class(len(self.classes), name,
+                  parent if parent is not None else self.classes[0],
+                  list(fields))
+        self.classes.append(c)
+        return c
+
+    def signature(self, signature):
+        """
+        Id of a signature: the one in specialsignatures.h if it is
+        listed there, else one numbered after them.
+        """
+        name = mangle(signature)
+        if name in self.special_signatures:
+            return self.special_signatures[name]
+        if signature not in self.signatures:
+            self.signatures[signature] = \
+                len(self.special_signatures) + len(self.signatures)
+        return self.signatures[signature]
+
+    def add_method(self, cls, signature, code, static=True,
+                   synchronized=False, locals_=None, max_stack=8,
+                   handlers=()):
+        """
+        Adds a method. code is a list of instructions, each a
+        mnemonic or a tuple of a mnemonic and its operands, and of
+        labels ending with ':'. Branch operands are labels. handlers
+        are (start, end, handler, class) tuples of labels and a
+        Class. A static main(), run() or <clinit>() is what the VM
+        looks for in entry classes and threads.
+        """
+        words = param_words(signature, static)
+        flags = (M_STATIC if static else 0) | \
+            (M_SYNCHRONIZED if synchronized else 0)
+        if signature == '<clinit>()V':
+            cls.flags |= C_HASCLINIT
+        m = Method(signature, self.signature(signature), code, flags,
+                   max(words, locals_ or 0), max_stack, handlers)
+        m.params = words
+        cls.methods.append(m)
+        return m
+
+    def native(self, signature, static=True):
+        """
+        Operands of invokestatic for a native method of
+        specialsignatures.h. Instance natives (Thread.start() and the
+        like) are declared in Thread, and the operands of
+        invokevirtual are returned for them.
+        """
+        cls = self.natives if static else self.thread
+        if mangle(signature) not in self.special_signatures:
+            raise KeyError('no native ' + signature)
+        if all(m.signature != signature for m in cls.methods):
+            m = Method(signature, self.signature(signature), None,
+                       M_NATIVE | (M_STATIC if static else 0), 0, 0, ())
+            m.params = param_words(signature, static)
+            cls.methods.append(m)
+        if not static:
+            return self.virtual(signature)
+        return cls.method(signature)
+
+    def virtual(self, signature):
+        """Operands of invokevirtual for a method signature."""
+        sig = self.signature(signature)
+        words = param_words(signature, False) - 1
+        return (words << 4) | (sig >> 8), sig & 0xFF
+
+    def add_static(self, cls, name, desc):
+        """
+        Adds a static field of cls. Returns the operands of
+        getstatic/putstatic.
+        """
+        self.statics.append((cls, name, TYPES[desc[0]]))
+        return cls.index, len(self.statics) - 1
+
+    def string(self, text):
+        """Constant index of a string, for ldc."""
+        data = text.encode('latin-1')
+        self.constants.append((TYPES['L'], len(data), data))
+        return len(self.constants) - 1
+
+    def int(self, value):
+        """Constant index of an int, for ldc."""
+        self.constants.append((TYPES['I'], 4, struct.pack('>i', value)))
+        return len(self.constants) - 1
+
+    def link(self, entry_classes):
+        """Returns the binary, which runs main() of entry_classes[0]."""
+        out = bytearray(16 + 10 * len(self.classes))
+
+        def align(n):
+            while len(out) % n:
+                out.append(0)
+
+        # Method tables, then exception tables, code and field types
+        method_offsets = {}
+        for c in self.classes:
+            align(2)
+            method_offsets[c.index] = len(out)
+            out += bytes(12 * len(c.methods))
+        records = []
+        for c in self.classes:
+            for i, m in enumerate(c.methods):
+                records.append((method_offsets[c.index] + 12 * i, m))
+        for offset, m in records:
+            ex_offset = 0
+            code_offset = 0
+            handlers = []
+            if m.code is not None:
+                code, labels = assemble(m.code)
+                align(2)
+                code_offset = len(out)
+                out += code
+                for start, end, handler, cls in m.handlers:
+                    handlers.append(struct.pack('<HHHBx', labels[start],
+                                                labels[end], labels[handler],
+                                                cls.index))
+                align(2)
+                ex_offset = len(out)
+                for h in handlers:
+                    out += h
+            out[offset:offset + 12] = struct.pack(
+                '<HHHBBBBBx', m.sig_id, ex_offset, code_offset, m.locals,
+                m.max_stack, m.params, len(handlers), m.flags)
+        field_offsets = {}
+        for c in self.classes:
+            field_offsets[c.index] = len(out)
+            out += bytes(c.field_types())
+
+        # Constants for ldc; ints are big-endian, as make_word reads them
+        align(2)
+        constant_offset = len(out)
+        out += bytes(4 * len(self.constants))
+        for i, (t, size, data) in enumerate(self.constants):
+            out[constant_offset + 4 * i:constant_offset + 4 * i + 4] = \
+                struct.pack('<HBB', len(out), t, size)
+            out += data
+
+        # Entry classes, static fields and their state
+        entry_offset = len(out)
+        out += bytes(c.index for c in entry_classes)
+        align(2)
+        fields_offset = len(out)
+        state = 0
+        for cls, name, t in self.statics:
+            out += struct.pack('<H', (t << 12) | state)
+            state += TYPE_SIZE[t]
+        align(4)
+        state_offset = len(out)
+        state = (state + 3) & ~3
+        out += bytes(state)
+
+        out[0:16] = struct.pack('<HHHHHHHBB', MAGIC, constant_offset,
+                                fields_offset, state_offset, state // 2,
+                                len(self.statics), entry_offset,
+                                len(entry_classes), len(self.classes) - 1)
+        for c in self.classes:
+            parent = c.parent.index if c.parent is not None else 0
+            out[16 + 10 * c.index:26 + 10 * c.index] = struct.pack(
+                '<HHHBBBB', (c.size() + 1) // 2, method_offsets[c.index],
+                field_offsets[c.index], len(c.fields), len(c.methods),
+                parent, c.flags)
+        return bytes(out)
+
+
+def assemble(code):
+    """Returns the bytecode of a method and the offsets of its labels."""
+    labels = {}
+    items = []
+    pc = 0
+    for ins in code:
+        if isinstance(ins, str) and ins.endswith(':'):
+            labels[ins[:-1]] = pc
+            continue
+        if not isinstance(ins, tuple):
+            ins = (ins,)
+        items.append((pc, ins))
+        pc += 1 + OPERAND_SIZE.get(ins[0], 0)
+        if ins[0] == 'anewarray':
+            pc += 2
+    out = bytearray()
+    for pc, ins in items:
+        op = ins[0]
+        args = ins[1:]
+        if op == 'anewarray':
+            # The linker's form: newarray of references and a nop
+            out += bytes([OPCODES['newarray'], TYPES['L'], OPCODES['nop']])
+            continue
+        out.append(OPCODES[op])
+        if op in BRANCHES:
+            rel = (labels[args[0]] - pc) & 0xFFFF
+            out += bytes([rel >> 8, rel & 0xFF])
+        elif op == 'sipush':
+            out += struct.pack('>h', args[0])
+        elif op == 'bipush':
+            out += struct.pack('>b', args[0])
+        elif op == 'iinc':
+            out += struct.pack('>Bb', args[0], args[1])
+        elif op == 'new':
+            out += bytes([0, args[0].index])
+        elif op in ('checkcast', 'instanceof'):
+            out += bytes([0, args[0].index])
+        elif OPERAND_SIZE.get(op, 0) == 2:
+            a = args[0] if len(args) == 1 else args
+            out += bytes(a)
+        elif OPERAND_SIZE.get(op, 0) == 1:
+            out.append(args[0])
+    return bytes(out), labels
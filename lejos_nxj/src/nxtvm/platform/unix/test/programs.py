@@ -0,0 +1,510 @@
+"""
+programs.py
+Test programs for lejos_unix, built with nxjlink.
+
+Each function decorated with @check builds a program whose exit
+status (System.exit) must be the one given. Functions decorated with
+@bench build a program that runs the given number of operations, for
+run.py to time. If a result is named, the number the program shows
+(see show()), or else its exit status, is reported as that result;
+otherwise it must exit with 0. Functions decorated with @profile build
+a program that calls a hot method the given number of times, and
+return the binary and the class and method index of that method, for
+run.py to look up in the profile of a VM built with the profiler on.
+"""
+
+from nxjlink import Image
+
+MAIN = 'main([Ljava/lang/String;)V'
+
+CHECKS = []
+BENCHES = []
+PROFILES = []
+
+
+def check(status):
+    def register(f):
+        CHECKS.append((f.__name__, f, status))
+        return f
+    return register
+
+
+def bench(ops, unit, result=None):
+    def register(f):
+        BENCHES.append((f.__name__, f, ops, unit, result))
+        return f
+    return register
+
+
+def profile(calls):
+    def register(f):
+        PROFILES.append((f.__name__, f, calls))
+        return f
+    return register
+
+
+def exit_with(img):
+    """Code that exits with the int on the stack."""
+    return [('invokestatic', img.native('exit(I)V')), 'return']
+
+
+def new_thread(img, cls, local):
+    """
+    Code that creates a thread of class cls in a local variable, with
+    the normal priority that Thread() would give it.
+    """
+    return [('new', cls), ('astore', local), ('aload', local), 'iconst_5',
+            ('putfield', img.thread.field('priority'))]
+
+
+def join(img, local):
+    """
+    Code that waits for the thread in a local variable to die, as
+    Thread.join() does in Java (the native join() does nothing).
+    """
+    label = 'join%d' % local
+    return [label + ':',
+            ('invokestatic', img.native('yield()V')),
+            ('aload', local), ('getfield', img.thread.field('state')),
+            'iconst_1', ('if_icmpgt', label)]
+
+
+@check(42)
+def exit_status():
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, MAIN, [('bipush', 42)] + exit_with(img))
+    return img.link([main])
+
+
+@check(0)
+def arithmetic():
+    # Sum of the squares of 1..30 is 9455
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, MAIN, [
+        'iconst_0', 'istore_1', 'iconst_1', 'istore_2',
+        'loop:',
+        'iload_2', ('bipush', 30), ('if_icmpgt', 'done'),
+        'iload_1', 'iload_2', 'iload_2', 'imul', 'iadd', 'istore_1',
+        ('iinc', 2, 1), ('goto', 'loop'),
+        'done:',
+        'iload_1', ('sipush', 9455), 'isub'] + exit_with(img), locals_=3)
+    return img.link([main])
+
+
+@check(7)
+def virtual_calls():
+    # A.get() returns the field, B overrides it to add one
+    img = Image()
+    a = img.add_class('A', fields=[('x', 'I')])
+    b = img.add_class('B', parent=a)
+    main = img.add_class('Main')
+    img.add_method(a, 'get()I', [
+        'aload_0', ('getfield', a.field('x')), 'ireturn'], static=False)
+    img.add_method(b, 'get()I', [
+        'aload_0', ('getfield', a.field('x')), 'iconst_1', 'iadd',
+        'ireturn'], static=False)
+    img.add_method(main, MAIN, [
+        ('new', a), 'astore_1', 'aload_1', 'iconst_3',
+        ('putfield', a.field('x')),
+        ('new', b), 'astore_2', 'aload_2', 'iconst_2',
+        ('putfield', a.field('x')),
+        'aload_1', ('invokevirtual', img.virtual('get()I')),
+        'aload_2', ('invokevirtual', img.virtual('get()I')),
+        'iadd', 'iconst_1', 'iadd'] + exit_with(img), locals_=3)
+    return img.link([main])
+
+
+@check(3)
+def caught_exception():
+    # Index 5 of a 5 element array, caught as
+    # ArrayIndexOutOfBoundsException
+    img = Image()
+    main = img.add_class('Main')
+    aioobe = img.classes[img.special_classes[
+        'JAVA_LANG_ARRAYINDEXOUTOFBOUNDSEXCEPTION']]
+    img.add_method(main, MAIN, [
+        'iconst_5', ('newarray', 10), 'astore_1',
+        'try:',
+        'aload_1', 'iconst_5', 'iaload',
+        'end:',
+        'pop', 'iconst_1'] + exit_with(img) + [
+        'handler:',
+        'pop', 'iconst_3'] + exit_with(img),
+        locals_=2, handlers=[('try', 'end', 'handler', aioobe)])
+    return img.link([main])
+
+
+@check(1)
+def uncaught_exception():
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, MAIN, [
+        'aconst_null', 'arraylength', 'pop', 'iconst_0'] + exit_with(img))
+    return img.link([main])
+
+
+@check(5)
+def string_constant():
+    img = Image()
+    main = img.add_class('Main')
+    string = img.classes[img.special_classes['JAVA_LANG_STRING']]
+    img.add_method(main, MAIN, [
+        ('ldc', img.string('leJOS')),
+        ('getfield', string.field('characters')), 'arraylength'] +
+        exit_with(img))
+    return img.link([main])
+
+
+@check(20)
+def threads():
+    # Two threads add 1..4 to a static field; main joins them
+    img = Image()
+    worker = img.add_class('Worker', parent=img.thread)
+    main = img.add_class('Main')
+    total = img.add_static(main, 'total', 'I')
+    lock = img.add_static(main, 'lock', 'Ljava/lang/Object;')
+    img.add_method(worker, 'run()V', [
+        'iconst_1', 'istore_1',
+        'loop:',
+        'iload_1', 'iconst_4', ('if_icmpgt', 'done'),
+        ('getstatic', lock), 'monitorenter',
+        ('getstatic', total), 'iload_1', 'iadd', ('putstatic', total),
+        ('getstatic', lock), 'monitorexit',
+        ('invokestatic', img.native('yield()V')),
+        ('iinc', 1, 1), ('goto', 'loop'),
+        'done:', 'return'], static=False, locals_=2)
+    start = img.native('start()V', static=False)
+    img.add_method(main, MAIN, [
+        ('new', img.classes[0]), ('putstatic', lock),
+    ] + new_thread(img, worker, 1) + new_thread(img, worker, 2) + [
+        'aload_1', ('invokevirtual', start),
+        'aload_2', ('invokevirtual', start)] +
+        join(img, 1) + join(img, 2) +
+        [('getstatic', total)] + exit_with(img), locals_=3)
+    return img.link([main])
+
+
+@check(0)
+def gc_stress():
+    # A thread allocates 1000000 objects and as many int arrays, keeping
+    # every 64th in a ring of 32. Its name, which is only referenced
+    # from the Thread object, and the ring must survive the
+    # collections.
+    img = Image()
+    worker = img.add_class('Worker', parent=img.thread,
+                           fields=[('result', 'I')])
+    main = img.add_class('Main')
+    name = img.thread.field('name')
+    img.add_method(worker, 'run()V', [
+        ('bipush', 32), ('anewarray',), 'astore_3',
+        'iconst_0', 'istore_1',
+        'outer:',
+        'iload_1', ('sipush', 2000), ('if_icmpge', 'verify'),
+        'iconst_0', 'istore_2',
+        'inner:',
+        'iload_2', ('sipush', 500), ('if_icmpge', 'next'),
+        ('new', img.classes[0]), 'pop',
+        'iload_2', ('bipush', 15), 'iand', 'iconst_1', 'iadd',
+        ('newarray', 10), ('astore', 4),
+        'iload_2', ('bipush', 63), 'iand', ('ifne', 'drop'),
+        'aload_3', 'iload_2', ('bipush', 6), 'ishr', ('aload', 4), 'aastore',
+        'drop:',
+        ('iinc', 2, 1), ('goto', 'inner'),
+        'next:',
+        ('iinc', 1, 1), ('goto', 'outer'),
+        # The name holds 0..99: check that it adds up to 4950
+        'verify:',
+        'iconst_0', 'istore_1', 'iconst_0', 'istore_2',
+        'sum:',
+        'iload_2', ('bipush', 100), ('if_icmpge', 'ring'),
+        'iload_1', 'aload_0', ('getfield', name), 'iload_2', 'caload',
+        'iadd', 'istore_1', ('iinc', 2, 1), ('goto', 'sum'),
+        # Ring element k was allocated by inner iteration k * 64,
+        # so it is an int array of length 1
+        'ring:',
+        'iload_1', ('sipush', 4950), 'isub', 'istore_1',
+        'iconst_0', 'istore_2',
+        'elem:',
+        'iload_2', 'iconst_5', ('if_icmpge', 'store'),
+        'aload_3', 'iload_2', 'aaload', 'arraylength', 'iconst_1', 'isub',
+        'iload_1', 'ior', 'istore_1',
+        ('iinc', 2, 1), ('goto', 'elem'),
+        'store:',
+        'aload_0', 'iload_1', ('putfield', worker.field('result')),
+        'return'], static=False, locals_=5)
+    start = img.native('start()V', static=False)
+    img.add_method(main, MAIN, new_thread(img, worker, 1) + [
+        'aload_1', ('bipush', 100), ('newarray', 5), ('putfield', name),
+        'iconst_0', 'istore_2',
+        'fill:',
+        'iload_2', ('bipush', 100), ('if_icmpge', 'run'),
+        'aload_1', ('getfield', name), 'iload_2', 'iload_2', 'castore',
+        ('iinc', 2, 1), ('goto', 'fill'),
+        'run:',
+        'aload_1', ('invokevirtual', start)] + join(img, 1) + [
+        'aload_1', ('getfield', worker.field('result'))] + exit_with(img),
+        locals_=3)
+    return img.link([main])
+
+
+@bench(1000000, 'op', result='int[500]s')
+def alloc():
+    # Random objects of four sizes, char arrays of up to 31 elements
+    # and int arrays of up to 63 elements, each stored over a random
+    # one of 256 live slots. Then int[500] arrays (2 KB) are allocated
+    # until the heap is full; how many fit shows the fragmentation.
+    img = Image()
+    sizes = [img.add_class('S%d' % n, fields=[('f%d' % i, 'I')
+                                              for i in range(n)])
+             for n in (1, 3, 6, 12)]
+    main = img.add_class('Main')
+    oom = img.classes[img.special_classes['JAVA_LANG_OUTOFMEMORYERROR']]
+    img.add_method(main, MAIN, [
+        ('sipush', 256), ('anewarray',), 'astore_1',
+        ('bipush', 64), ('anewarray',), ('astore', 7),
+        ('ldc', img.int(12345)), ('istore', 4),
+        'iconst_0', 'istore_2',
+        'outer:',
+        'iload_2', ('sipush', 1000), ('if_icmpge', 'fill'),
+        'iconst_0', 'istore_3',
+        'inner:',
+        'iload_3', ('sipush', 1000), ('if_icmpge', 'next'),
+        ('iload', 4), ('ldc', img.int(1103515245)), 'imul',
+        ('ldc', img.int(12345)), 'iadd', ('istore', 4),
+        ('iload', 4), ('bipush', 7), 'iand', ('istore', 6),
+        ('iload', 6), ('ifeq', 's0'),
+        ('iload', 6), 'iconst_1', ('if_icmpeq', 's1'),
+        ('iload', 6), 'iconst_2', ('if_icmpeq', 's2'),
+        ('iload', 6), 'iconst_5', ('if_icmplt', 's3'),
+        ('iload', 6), ('bipush', 7), ('if_icmpeq', 'ints'),
+        ('iload', 4), ('bipush', 8), 'iushr', ('bipush', 31), 'iand',
+        ('newarray', 5), ('goto', 'store'),
+        'ints:',
+        ('iload', 4), ('bipush', 8), 'iushr', ('bipush', 63), 'iand',
+        ('newarray', 10), ('goto', 'store'),
+        's0:', ('new', sizes[0]), ('goto', 'store'),
+        's1:', ('new', sizes[1]), ('goto', 'store'),
+        's2:', ('new', sizes[2]), ('goto', 'store'),
+        's3:', ('new', sizes[3]),
+        'store:',
+        ('astore', 5), 'aload_1', ('iload', 4), ('bipush', 16), 'iushr',
+        ('sipush', 255), 'iand', ('aload', 5), 'aastore',
+        ('iinc', 3, 1), ('goto', 'inner'),
+        'next:',
+        ('iinc', 2, 1), ('goto', 'outer'),
+        'fill:',
+        'iconst_0', ('istore', 6),
+        'try:',
+        ('aload', 7), ('iload', 6), ('sipush', 500), ('newarray', 10),
+        'aastore', ('iinc', 6, 1), ('goto', 'try'),
+        'end:',
+        'full:',
+        'pop', ('iload', 6)] + exit_with(img),
+        locals_=8, handlers=[('try', 'end', 'full', oom)])
+    return img.link([main])
+
+
+# Instructions run by the inner loop of the dispatch benchmarks, each
+# 10000000 times. The loop test (iload, sipush, if_icmpge) and the
+# iinc and goto closing the loop are counted.
+ARITH_INSTRUCTIONS = 15
+ARRAY_INSTRUCTIONS = 11
+CALL_INSTRUCTIONS = 14
+
+
+def loop(img, body, inner=1000, outer=10000, locals_=(1, 2)):
+    """
+    body run outer x inner times, with the inner index in local
+    locals_[1].
+    """
+    i, j = locals_
+    return [
+        'iconst_0', ('istore', i),
+        'outer:',
+        ('iload', i), ('sipush', outer), ('if_icmpge', 'done'),
+        'iconst_0', ('istore', j),
+        'inner:',
+        ('iload', j), ('sipush', inner), ('if_icmpge', 'next')] + body + [
+        ('iinc', j, 1), ('goto', 'inner'),
+        'next:',
+        ('iinc', i, 1), ('goto', 'outer'),
+        'done:',
+        'iconst_0'] + exit_with(img)
+
+
+@bench(10000000 * ARITH_INSTRUCTIONS, 'instr')
+def arith():
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, MAIN, ['iconst_0', 'istore_3'] + loop(img, [
+        'iload_3', 'iload_2', 'iconst_3', 'imul', 'iload_3', 'iconst_1',
+        'ishr', 'ixor', 'iadd', 'istore_3']), locals_=4)
+    return img.link([main])
+
+
+@bench(10000000 * ARRAY_INSTRUCTIONS, 'instr')
+def array_copy():
+    # Copies an int[500] to another, 20000 times
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, MAIN, [
+        ('sipush', 500), ('newarray', 10), ('astore', 3),
+        ('sipush', 500), ('newarray', 10), ('astore', 4)] + loop(img, [
+            ('aload', 4), 'iload_2', ('aload', 3), 'iload_2', 'iaload',
+            'iastore'], inner=500, outer=20000), locals_=5)
+    return img.link([main])
+
+
+@bench(10000000 * CALL_INSTRUCTIONS, 'instr')
+def virtual_call():
+    # A one-line getter: 5 instructions in the callee
+    img = Image()
+    a = img.add_class('A', fields=[('x', 'I')])
+    main = img.add_class('Main')
+    img.add_method(a, 'add(I)I', [
+        'aload_0', ('getfield', a.field('x')), 'iload_1', 'iadd',
+        'ireturn'], static=False)
+    img.add_method(main, MAIN, [('new', a), ('astore', 3)] + loop(img, [
+        ('aload', 3), 'iload_2', ('invokevirtual', img.virtual('add(I)I')),
+        ('istore', 4)]), locals_=5)
+    return img.link([main])
+
+
+@bench(1000000, 'call')
+def deep_call():
+    # get() is defined in the root of a chain of 8 classes, each with 6
+    # other methods, and called on an instance of the last one
+    img = Image()
+    chain = [img.add_class('C0', fields=[('x', 'I')])]
+    for depth in range(1, 8):
+        chain.append(img.add_class('C%d' % depth, parent=chain[-1]))
+    for depth, c in enumerate(chain):
+        for n in range(6):
+            img.add_method(c, 'm%d_%d()I' % (depth, n), [
+                'iconst_0', 'ireturn'], static=False)
+    img.add_method(chain[0], 'get()I', [
+        'aload_0', ('getfield', chain[0].field('x')), 'ireturn'],
+        static=False)
+    main = img.add_class('Main')
+    img.add_method(main, MAIN, [('new', chain[-1]), ('astore', 3)] +
+                   loop(img, [('aload', 3),
+                              ('invokevirtual', img.virtual('get()I')),
+                              'pop'], outer=1000), locals_=4)
+    return img.link([main])
+
+
+# Instructions of the loop of the quick benchmark, as in the binary
+QUICK_INSTRUCTIONS = 18
+
+
+@bench(10000000 * QUICK_INSTRUCTIONS, 'instr')
+def quick():
+    # s += i, a static counter and a static call: the sequences
+    # quicken.c rewrites. Exits with 0 if the counter is right.
+    img = Image()
+    main = img.add_class('Main')
+    count = img.add_static(main, 'count', 'I')
+    img.add_method(main, 'id(I)I', ['iload_0', 'ireturn'])
+    code = loop(img, [
+        'iload_3', 'iload_2', 'iadd', 'istore_3',
+        ('getstatic', count), 'iconst_1', 'iadd', ('putstatic', count),
+        'iload_2', ('invokestatic', main.method('id(I)I')), 'pop'])
+    done = code.index('done:')
+    code[done + 1:] = [('getstatic', count), ('ldc', img.int(10000000)),
+                       'isub'] + exit_with(img)
+    img.add_method(main, MAIN, ['iconst_0', 'istore_3'] + code, locals_=4)
+    return img.link([main])
+
+
+SWITCH_YIELDS = 1000000
+
+
+def sleeping_threads(n):
+    # main and another thread yield to each other SWITCH_YIELDS times
+    # each while n threads sleep
+    img = Image()
+    sleeper = img.add_class('Sleeper', parent=img.thread)
+    yielder = img.add_class('Yielder', parent=img.thread)
+    main = img.add_class('Main')
+    yield_ = ('invokestatic', img.native('yield()V'))
+    img.add_method(sleeper, 'run()V', [
+        ('ldc', img.int(100000000)), 'i2l',
+        ('invokestatic', img.native('sleep(J)V')), 'return'],
+        static=False)
+    img.add_method(yielder, 'run()V', [
+        'loop:', yield_, ('goto', 'loop')], static=False)
+    start = ('invokevirtual', img.native('start()V', static=False))
+    img.add_method(main, MAIN, [
+        'iconst_0', 'istore_2',
+        'sleepers:',
+        'iload_2', ('bipush', n), ('if_icmpge', 'run')] +
+        new_thread(img, sleeper, 1) + ['aload_1', start,
+        ('iinc', 2, 1), ('goto', 'sleepers'),
+        'run:'] + new_thread(img, yielder, 1) + ['aload_1', start] +
+        loop(img, [yield_], inner=1000, outer=SWITCH_YIELDS // 1000),
+        locals_=3)
+    return img.link([main])
+
+
+for n in (0, 4, 16, 64):
+    BENCHES.append(('sleeping_%d' % n, lambda n=n: sleeping_threads(n),
+                    2 * SWITCH_YIELDS, 'switch', None))
+
+
+def show(img):
+    """Code that shows the int on the stack, for run.py to report."""
+    return ['iconst_0', 'iconst_0',
+            ('invokestatic', img.native('drawInt(III)V')),
+            ('invokestatic', img.native('refresh()V'))]
+
+
+@bench(2000000, 'ldc', result='bytes')
+def string_ldc():
+    # Shows the heap used by 100 runs of a loop loading two string
+    # constants, then times a million more
+    img = Image()
+    main = img.add_class('Main')
+    free = ('invokestatic', img.native('freeMemory()J'))
+    body = [('ldc', img.string('speed')), 'pop',
+            ('ldc', img.string('angle')), 'pop']
+    img.add_method(main, MAIN, [
+        free, 'l2i', 'istore_3',
+        'iconst_0', 'istore_1',
+        'warm:',
+        'iload_1', ('bipush', 100), ('if_icmpge', 'shown')] + body + [
+        ('iinc', 1, 1), ('goto', 'warm'),
+        'shown:',
+        'iload_3', free, 'l2i', 'isub'] + show(img) +
+        loop(img, body), locals_=4)
+    return img.link([main])
+
+
+HOT_CALLS = 1000
+
+
+@profile(HOT_CALLS)
+def hot_method():
+    # main() calls hot() HOT_CALLS times; hot() runs a loop of 20000
+    # iterations, so nearly all ticks fall in it
+    img = Image()
+    main = img.add_class('Main')
+    img.add_method(main, 'hot()I', [
+        'iconst_0', 'istore_0', 'iconst_0', 'istore_1',
+        'loop:',
+        'iload_1', ('sipush', 20000), ('if_icmpge', 'done'),
+        'iload_0', 'iload_1', 'iadd', 'istore_0',
+        ('iinc', 1, 1), ('goto', 'loop'),
+        'done:',
+        'iload_0', 'ireturn'], locals_=2)
+    hot = main.method('hot()I')
+    img.add_method(main, MAIN, [
+        'iconst_0', 'istore_1',
+        'calls:',
+        'iload_1', ('sipush', HOT_CALLS), ('if_icmpge', 'done'),
+        ('invokestatic', hot), 'pop',
+        ('iinc', 1, 1), ('goto', 'calls'),
+        'done:',
+        'iconst_0'] + exit_with(img), locals_=2)
+    return img.link([main]), hot
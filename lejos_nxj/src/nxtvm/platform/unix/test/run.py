@@ -0,0 +1,214 @@
+"""
+run.py
+Runs the programs of programs.py on lejos_unix.
+
+    python3 run.py check [name]...
+        runs the checks and compares their exit status
+    python3 run.py bench [-c name=DEFINES]... [name]...
+        times the benchmarks on lejos_unix, or on a VM built with each
+        set of -D options given by -c (see CONFIG in the Makefile)
+    python3 run.py profile [name]...
+        builds a VM with the profiler on and checks that the profile
+        it writes with -p counts the calls of the hot method of each
+        program and most ticks in it
+
+Run from platform/unix (make check and make bench do). Each program
+is written to test/out/<name>.bin, which lejos_unix can also run by
+hand.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import programs
+
+TEST_DIR = os.path.dirname(os.path.abspath(__file__))
+UNIX_DIR = os.path.dirname(TEST_DIR)
+OUT_DIR = os.path.join(TEST_DIR, 'out')
+VM = os.path.join(UNIX_DIR, 'lejos_unix')
+
+# Best of this many runs is reported
+BENCH_RUNS = 5
+
+# PROFILER_ENTRIES of the VM run.py profile builds
+PROFILER_ENTRIES = 32
+
+
+def build(name, f):
+    path = os.path.join(OUT_DIR, name + '.bin')
+    with open(path, 'wb') as out:
+        out.write(f())
+    return path
+
+
+def selected(table, names):
+    return [t for t in table if not names or t[0] in names]
+
+
+def check(names):
+    failed = 0
+    for name, f, status in selected(programs.CHECKS, names):
+        run = subprocess.run([VM, build(name, f)], stdout=subprocess.DEVNULL,
+                             stderr=subprocess.PIPE, timeout=60)
+        if run.returncode == status:
+            print('%-24s ok' % name)
+        else:
+            print('%-24s FAILED: exit status %d, expected %d %s' %
+                  (name, run.returncode, status, run.stderr.decode().strip()))
+            failed += 1
+    print('%d failed' % failed if failed else 'all passed')
+    return failed != 0
+
+
+def build_vm(name, defines, vm_dir):
+    """
+    Builds lejos_unix with -D options and keeps a copy of it in vm_dir
+    (make clean removes test/out).
+    """
+    make = ['make', '-s', '-C', UNIX_DIR]
+    subprocess.run(make + ['clean'], check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(make + ['CONFIG=' + defines], check=True,
+                   stdout=subprocess.DEVNULL)
+    path = os.path.join(vm_dir, 'lejos_unix.' + name)
+    shutil.copy(VM, path)
+    subprocess.run(make + ['clean'], check=True, stdout=subprocess.DEVNULL)
+    return path
+
+
+def bench(args):
+    vms = []
+    names = []
+    while args:
+        arg = args.pop(0)
+        if arg == '-c' and args:
+            name, _, defines = args.pop(0).partition('=')
+            vms.append((name, defines))
+        else:
+            names.append(arg)
+    if vms:
+        with tempfile.TemporaryDirectory() as vm_dir:
+            return run_benches([(name, build_vm(name, defines, vm_dir))
+                                for name, defines in vms], names)
+    return run_benches([('lejos_unix', VM)], names)
+
+
+def profile_error(path, method, calls):
+    """
+    What is wrong with the profile in path, None if method, a (class
+    index, method index) pair, has the given number of calls and more
+    than half of the ticks.
+    """
+    counted = 0
+    ticks = 0
+    hot_ticks = 0
+    with open(path) as f:
+        for line in f:
+            if line.startswith('#'):
+                continue
+            cls, index, sig, pc, count = line.split()
+            hot = (int(cls), int(index)) == method
+            if pc == 'calls':
+                counted += int(count) if hot else 0
+                continue
+            ticks += int(count)
+            hot_ticks += int(count) if hot else 0
+    if counted != calls:
+        return '%d calls counted, expected %d' % (counted, calls)
+    if hot_ticks * 2 <= ticks:
+        return 'only %d of %d ticks in the hot method' % (hot_ticks, ticks)
+    return None
+
+
+def profile(names):
+    failed = 0
+    with tempfile.TemporaryDirectory() as vm_dir:
+        vm = build_vm('profile', '-DPROFILER_ENTRIES=%d' % PROFILER_ENTRIES,
+                      vm_dir)
+        # build_vm leaves the tree clean; make check runs lejos_unix after
+        subprocess.run(['make', '-s', '-C', UNIX_DIR], check=True,
+                       stdout=subprocess.DEVNULL)
+        os.makedirs(OUT_DIR, exist_ok=True)
+        for name, f, calls in selected(programs.PROFILES, names):
+            binary, method = f()
+            path = build(name, lambda: binary)
+            prof = os.path.join(OUT_DIR, name + '.prof')
+            run = subprocess.run([vm, '-p', prof, path],
+                                 stdout=subprocess.DEVNULL,
+                                 stderr=subprocess.PIPE, timeout=60)
+            if run.returncode != 0:
+                error = 'exit status %d %s' % (run.returncode,
+                                               run.stderr.decode().strip())
+            else:
+                error = profile_error(prof, method, calls)
+            if error is None:
+                print('%-24s ok' % name)
+            else:
+                print('%-24s FAILED: %s' % (name, error))
+                failed += 1
+    print('%d failed' % failed if failed else 'all passed')
+    return failed != 0
+
+
+def shown(run):
+    """
+    The number a program showed on the top line of the display, or
+    its exit status if it showed none.
+    """
+    screens = run.stdout.decode().split('+----------------+\n')
+    for screen in reversed(screens):
+        if screen.startswith('|'):
+            return int(screen[1:].split('|')[0])
+    return run.returncode
+
+
+def run_benches(vms, names):
+    os.makedirs(OUT_DIR, exist_ok=True)
+
+    print('%-16s' % 'benchmark' +
+          ''.join('%16s' % name for name, vm in vms))
+    for name, f, ops, unit, result in selected(programs.BENCHES, names):
+        path = build(name, f)
+        line = '%-16s' % name
+        results = '%-16s' % ''
+        for vm_name, vm in vms:
+            best = None
+            for i in range(BENCH_RUNS):
+                start = time.perf_counter()
+                run = subprocess.run([vm, '-v', path],
+                                     stdout=subprocess.PIPE,
+                                     stderr=subprocess.PIPE, timeout=600)
+                elapsed = time.perf_counter() - start
+                if run.returncode < 0 or run.stderr or \
+                        (run.returncode != 0 and result is None):
+                    print('%s on %s: exit status %d %s' %
+                          (name, vm_name, run.returncode,
+                           run.stderr.decode().strip()))
+                    return True
+                best = elapsed if best is None else min(best, elapsed)
+            line += '%16s' % ('%.2f M%s/s' % (ops / best / 1e6, unit))
+            if result is not None:
+                results += '%16s' % ('%d %s' % (shown(run), result))
+        print(line)
+        if result is not None:
+            print(results)
+    return False
+
+
+def main(argv):
+    os.makedirs(OUT_DIR, exist_ok=True)
+    if len(argv) >= 1 and argv[0] == 'check':
+        return check(argv[1:])
+    if len(argv) >= 1 and argv[0] == 'bench':
+        return bench(argv[1:])
+    if len(argv) >= 1 and argv[0] == 'profile':
+        return profile(argv[1:])
+    print(__doc__.strip())
+    return True
+
+
+if __name__ == '__main__':
+    sys.exit(1 if main(sys.argv[1:]) else 0)
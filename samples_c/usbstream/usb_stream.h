@@ -0,0 +1,20 @@
+/* usb_stream.h */
+
+#ifndef _USB_STREAM_H
+#define _USB_STREAM_H
+
+/*
+ * Commands from the host, in a packet of BENCH_CMD_LEN bytes:
+ *   U8 command, U8 pad[3], U32 number of bytes (little endian)
+ */
+#define BENCH_SINK     0x01 /* host sends the bytes, NXT replies with the U32 count */
+#define BENCH_SOURCE   0x02 /* NXT sends the bytes */
+#define BENCH_ECHO     0x03 /* NXT sends back the bytes as they are received */
+#define DISCONNECT_REQ 0xFF
+
+#define BENCH_CMD_LEN  8
+
+/* byte i of a transfer (checked by the host for BENCH_SOURCE) */
+#define BENCH_PATTERN(i) ((unsigned char)((i) * 7 + 1))
+
+#endif
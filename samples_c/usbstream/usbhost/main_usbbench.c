@@ -0,0 +1,190 @@
+/*
+ * USB throughput benchmark, host side of the usbstream sample.
+ *
+ * usage: usbbench [-n bytes] [sink|source|echo]...
+ *
+ * Runs each test (all of them by default) with the NXT and prints the
+ * throughput seen by the host.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nxtcommusb.h"
+#include "usb_stream.h"
+
+#define BLOCK_LEN 4096 /* bytes per libusb transfer */
+#define ECHO_LEN  512  /* what the NXT can buffer while it is not read */
+
+static unsigned char out[BLOCK_LEN];
+static unsigned char in[BLOCK_LEN];
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int command(NXTCommUsb *nxt, int cmd, unsigned int n)
+{
+	unsigned char buf[BENCH_CMD_LEN] = {0};
+
+	buf[0] = cmd;
+	buf[4] = n;
+	buf[5] = n >> 8;
+	buf[6] = n >> 16;
+	buf[7] = n >> 24;
+	return NXTCommUsb_send(nxt, buf, 0, BENCH_CMD_LEN) == BENCH_CMD_LEN;
+}
+
+/* host to NXT: the NXT replies with the number of bytes it read */
+static int sink(NXTCommUsb *nxt, unsigned int n)
+{
+	unsigned int total = 0;
+	int len;
+
+	memset(out, 0x55, sizeof(out));
+	if (!command(nxt, BENCH_SINK, n))
+		return -1;
+	while (total < n)
+	{
+		len = NXTCommUsb_send(nxt, out, 0, (n - total < BLOCK_LEN) ? n - total : BLOCK_LEN);
+		if (len <= 0)
+			return -1;
+		total += len;
+	}
+	if (NXTCommUsb_receive(nxt, in, 0, MAX_DATA_LEN) != 4)
+		return -1;
+	return (in[0] | (in[1] << 8) | (in[2] << 16) | ((unsigned int)in[3] << 24)) == n ? 0 : -1;
+}
+
+/* NXT to host: the data is checked against BENCH_PATTERN */
+static int source(NXTCommUsb *nxt, unsigned int n)
+{
+	unsigned int total = 0;
+	int len, i;
+
+	if (!command(nxt, BENCH_SOURCE, n))
+		return -1;
+	while (total < n)
+	{
+		len = NXTCommUsb_receive(nxt, in, 0, (n - total < BLOCK_LEN) ? n - total : BLOCK_LEN);
+		if (len <= 0)
+			return -1;
+		for (i = 0; i < len; i++)
+		{
+			if (in[i] != BENCH_PATTERN(total + i))
+				return -1;
+		}
+		total += len;
+	}
+	return 0;
+}
+
+/*
+ * both ways: a block is sent, then read back
+ * The host does not read while it sends, so a block must fit in the NXT
+ * receive and send rings or both sides would wait for each other.
+ */
+static int echo(NXTCommUsb *nxt, unsigned int n)
+{
+	unsigned int total = 0;
+	int len, block, got, i;
+
+	if (!command(nxt, BENCH_ECHO, n))
+		return -1;
+	while (total < n)
+	{
+		block = (n - total < ECHO_LEN) ? n - total : ECHO_LEN;
+		for (i = 0; i < block; i++)
+			out[i] = BENCH_PATTERN(total + i);
+		if (NXTCommUsb_send(nxt, out, 0, block) != block)
+			return -1;
+		for (got = 0; got < block; got += len)
+		{
+			len = NXTCommUsb_receive(nxt, in, got, block - got);
+			if (len <= 0)
+				return -1;
+		}
+		if (memcmp(in, out, block) != 0)
+			return -1;
+		total += block;
+	}
+	return 0;
+}
+
+static const struct {
+	const char *name;
+	int (*run)(NXTCommUsb *nxt, unsigned int n);
+	int ways;
+} tests[] = {
+	{"sink", sink, 1},
+	{"source", source, 1},
+	{"echo", echo, 2},
+};
+#define N_TESTS (sizeof(tests) / sizeof(tests[0]))
+
+int main(int argc, char *argv[])
+{
+	NXTCommUsb *nxt;
+	unsigned char buf[BENCH_CMD_LEN] = {DISCONNECT_REQ};
+	unsigned int n = 1 << 20;
+	int selected[N_TESTS] = {0};
+	int any = 0, failed = 0;
+	int i;
+	unsigned int j;
+	double t;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			n = strtoul(argv[++i], NULL, 0);
+			continue;
+		}
+		for (j = 0; j < N_TESTS && strcmp(argv[i], tests[j].name) != 0; j++);
+		if (j == N_TESTS)
+		{
+			fprintf(stderr, "usage: %s [-n bytes] [sink|source|echo]...\n", argv[0]);
+			return 2;
+		}
+		selected[j] = any = 1;
+	}
+
+	nxt = NXTCommUsb_open();
+	if (nxt == NULL)
+	{
+		fprintf(stderr, "NXT not found.\n");
+		return 1;
+	}
+	if (!NXTCommUsb_connect(nxt))
+	{
+		fprintf(stderr, "Failed to connect with the NXT (is usbstream running?).\n");
+		NXTCommUsb_close(nxt);
+		return 1;
+	}
+
+	for (j = 0; j < N_TESTS; j++)
+	{
+		if (any && !selected[j])
+			continue;
+		t = now();
+		if (tests[j].run(nxt, n) != 0)
+		{
+			printf("%-6s failed\n", tests[j].name);
+			failed = 1;
+			break;
+		}
+		t = now() - t;
+		printf("%-6s %u bytes in %.3f s: %.1f KB/s\n", tests[j].name, n, t,
+			tests[j].ways * n / t / 1000.0);
+	}
+
+	NXTCommUsb_send(nxt, buf, 0, BENCH_CMD_LEN);
+	NXTCommUsb_close(nxt);
+	return failed;
+}
@@ -0,0 +1,91 @@
+/*
+ * nxtcommusb.c
+ *
+ * Connection with an NXT running the ECRobot USB API, over libusb-1.0.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <libusb.h>
+
+#include "nxtcommusb.h"
+
+#define TIMEOUT_MS 1000
+
+#define SYSTEM_COMMAND_REPLY 0x01
+#define REPLY_COMMAND        0x02
+#define USB_ECROBOT_MODE     0xFF
+
+struct nxtcommusb {
+	libusb_context *ctx;
+	libusb_device_handle *handle;
+};
+
+static const unsigned char ecrobot_sig[] = {'E', 'C', 'R', 'O', 'B', 'O', 'T'};
+
+/* open the first NXT found, NULL if there is none */
+NXTCommUsb *NXTCommUsb_open(void)
+{
+	NXTCommUsb *nxt = calloc(1, sizeof(NXTCommUsb));
+
+	if (nxt == NULL || libusb_init(&nxt->ctx) != 0)
+	{
+		free(nxt);
+		return NULL;
+	}
+	nxt->handle = libusb_open_device_with_vid_pid(nxt->ctx, NXT_VENDOR_ID, NXT_PRODUCT_ID);
+	if (nxt->handle == NULL || libusb_claim_interface(nxt->handle, 0) != 0)
+	{
+		NXTCommUsb_close(nxt);
+		return NULL;
+	}
+	return nxt;
+}
+
+/* ask the NXT for ECRobot mode: 1 if it accepted, 0 otherwise */
+int NXTCommUsb_connect(NXTCommUsb *nxt)
+{
+	unsigned char buf[MAX_DATA_LEN];
+
+	buf[0] = SYSTEM_COMMAND_REPLY;
+	buf[1] = USB_ECROBOT_MODE;
+	if (NXTCommUsb_send(nxt, buf, 0, 2) != 2 ||
+		NXTCommUsb_receive(nxt, buf, 0, MAX_DATA_LEN) != sizeof(ecrobot_sig) + 1)
+	{
+		return 0;
+	}
+	return buf[0] == REPLY_COMMAND && memcmp(&buf[1], ecrobot_sig, sizeof(ecrobot_sig)) == 0;
+}
+
+/* send len bytes (in packets of MAX_DATA_LEN), returns the number sent or -1 */
+int NXTCommUsb_send(NXTCommUsb *nxt, unsigned char *buf, int off, int len)
+{
+	int done = 0;
+	int ret = libusb_bulk_transfer(nxt->handle, NXT_EP_OUT, &buf[off], len, &done, TIMEOUT_MS);
+
+	return (ret == 0 || ret == LIBUSB_ERROR_TIMEOUT) ? done : -1;
+}
+
+/*
+ * receive up to len bytes, returns the number received or -1
+ * Note that a transfer ends with a packet shorter than MAX_DATA_LEN, so
+ * len should be a multiple of it
+ */
+int NXTCommUsb_receive(NXTCommUsb *nxt, unsigned char *buf, int off, int len)
+{
+	int done = 0;
+	int ret = libusb_bulk_transfer(nxt->handle, NXT_EP_IN, &buf[off], len, &done, TIMEOUT_MS);
+
+	return (ret == 0 || ret == LIBUSB_ERROR_TIMEOUT) ? done : -1;
+}
+
+void NXTCommUsb_close(NXTCommUsb *nxt)
+{
+	if (nxt->handle != NULL)
+	{
+		libusb_release_interface(nxt->handle, 0);
+		libusb_close(nxt->handle);
+	}
+	libusb_exit(nxt->ctx);
+	free(nxt);
+}
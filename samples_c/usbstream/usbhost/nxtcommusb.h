@@ -0,0 +1,27 @@
+/*
+ * nxtcommusb.h
+ *
+ * Connection with an NXT running the ECRobot USB API, over libusb-1.0.
+ * It stands in for nxtcommfantom (Fantom driver) on hosts without it,
+ * with the same calls: open the NXT, connect in ECRobot mode, then send
+ * and receive data.
+ */
+
+#ifndef _NXTCOMMUSB_H
+#define _NXTCOMMUSB_H
+
+#define NXT_VENDOR_ID  0x0694
+#define NXT_PRODUCT_ID 0x0002
+#define NXT_EP_OUT     0x01
+#define NXT_EP_IN      0x82
+#define MAX_DATA_LEN   64 /* bytes per packet */
+
+typedef struct nxtcommusb NXTCommUsb;
+
+extern NXTCommUsb *NXTCommUsb_open(void);
+extern int NXTCommUsb_connect(NXTCommUsb *nxt);
+extern int NXTCommUsb_send(NXTCommUsb *nxt, unsigned char *buf, int off, int len);
+extern int NXTCommUsb_receive(NXTCommUsb *nxt, unsigned char *buf, int off, int len);
+extern void NXTCommUsb_close(NXTCommUsb *nxt);
+
+#endif
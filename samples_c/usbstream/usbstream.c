@@ -0,0 +1,162 @@
+/* usbstream.c */
+#include "kernel.h"
+#include "kernel_id.h"
+
+#include "ecrobot_interface.h"
+#include "usb_stream.h"
+
+/* OSEK declarations */
+DeclareTask(Task_ts1);
+DeclareTask(Task_background);
+DeclareCounter(SysTimerCnt);
+
+#define CHUNK_LEN 256 /* bytes moved per stream call */
+
+static U8 chunk[CHUNK_LEN];
+
+static void showInitScreen(void)
+{
+	display_clear(0);
+	display_goto_xy(0, 0);
+	display_string("USB STREAM");
+	display_goto_xy(0, 1);
+	display_string("Run usbbench");
+	display_update();
+}
+
+static void showResult(const CHAR *name, U32 bytes, U32 ms)
+{
+	display_goto_xy(0, 3);
+	display_string(name);
+	display_string("        ");
+	display_goto_xy(0, 4);
+	display_unsigned(bytes, 8);
+	display_string(" B");
+	display_goto_xy(0, 5);
+	display_unsigned((ms > 0) ? bytes / ms : 0, 8);
+	display_string(" KB/s");
+	display_update();
+}
+
+/* host sends n bytes, reply with the number received */
+static void sink(U32 n)
+{
+	U32 total = 0;
+	U8 reply[4];
+
+	while (total < n)
+	{
+		total += ecrobot_read_usb_stream(chunk, 0, (n - total < CHUNK_LEN) ? n - total : CHUNK_LEN);
+	}
+	reply[0] = (U8)total;
+	reply[1] = (U8)(total >> 8);
+	reply[2] = (U8)(total >> 16);
+	reply[3] = (U8)(total >> 24);
+	while (ecrobot_send_usb(reply, 0, sizeof(reply)) == 0);
+}
+
+/* send n bytes of BENCH_PATTERN to the host */
+static void source(U32 n)
+{
+	U32 total = 0;
+	U32 len, sent, i;
+
+	while (total < n)
+	{
+		len = (n - total < CHUNK_LEN) ? n - total : CHUNK_LEN;
+		for (i = 0; i < len; i++)
+		{
+			chunk[i] = BENCH_PATTERN(total + i);
+		}
+		for (sent = 0; sent < len; )
+		{
+			sent += ecrobot_send_usb_stream(chunk, sent, len - sent);
+		}
+		total += len;
+	}
+}
+
+/* send back n bytes as they are received */
+static void echo(U32 n)
+{
+	U32 total = 0;
+	U32 len, sent;
+
+	while (total < n)
+	{
+		len = ecrobot_read_usb_stream(chunk, 0, (n - total < CHUNK_LEN) ? n - total : CHUNK_LEN);
+		for (sent = 0; sent < len; )
+		{
+			sent += ecrobot_send_usb_stream(chunk, sent, len - sent);
+		}
+		total += len;
+	}
+}
+
+/* ECRobot hooks */
+void ecrobot_device_initialize()
+{
+	ecrobot_init_usb(); /* init USB */
+}
+
+void ecrobot_device_terminate()
+{
+	ecrobot_term_usb(); /* terminate USB */
+}
+
+/* nxtOSEK hook to be invoked from an ISR in category 2 */
+void user_1ms_isr_type2(void)
+{
+	/* Increment System Timer Count to activate periodical Tasks */
+	(void)SignalCounter(SysTimerCnt);
+}
+
+/* 1msec periodical Task */
+TASK(Task_ts1)
+{
+	ecrobot_process1ms_usb(); /* USB process handler (must be invoked every 1msec) */
+
+	TerminateTask();
+}
+
+/* background Task */
+TASK(Task_background)
+{
+	U8 cmd[MAX_USB_DATA_LEN];
+	U32 n, start;
+
+	showInitScreen();
+
+	while(1)
+	{
+		if (ecrobot_read_usb(cmd, 0, MAX_USB_DATA_LEN) < BENCH_CMD_LEN)
+		{
+			continue;
+		}
+
+		n = cmd[4] | (cmd[5] << 8) | (cmd[6] << 16) | ((U32)cmd[7] << 24);
+		start = systick_get_ms();
+		switch (cmd[0])
+		{
+		case BENCH_SINK:
+			sink(n);
+			showResult("SINK", n, systick_get_ms() - start);
+			break;
+		case BENCH_SOURCE:
+			source(n);
+			showResult("SOURCE", n, systick_get_ms() - start);
+			break;
+		case BENCH_ECHO:
+			echo(n);
+			showResult("ECHO", n, systick_get_ms() - start);
+			break;
+		case DISCONNECT_REQ:
+			/* disconnect current connection */
+			ecrobot_disconnect_usb();
+			showInitScreen();
+			break;
+		default:
+			break;
+		}
+	}
+}
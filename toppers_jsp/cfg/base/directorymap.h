@@ -51,6 +51,7 @@
 
   //MSVC6.0 <cstdio> ƤstdƤʤΤ
 #include <stdio.h>
+#include <string.h>
 
 #include <string>
 #include <map>
@@ -48,6 +48,7 @@
 #endif
 
 #include "base/testsuite.h"
+#include <cstddef>
 #include <list>
 
 
@@ -164,6 +164,10 @@ inline int Parser::getChar(void)
   */
 inline void Parser::putBack(int ch)
 {
+        /* putback clears eofbit since C++11: keep the end of stream */
+    if(ch == EOF)
+        return;
+
         /* ֹΤν */
     if(ch == '\n')
         current->line --;
@@ -73,10 +73,13 @@ protected:
 
     bool check_taskblock(Directory &, FileContainer *);
     bool check_semaphoreblock(Directory &, FileContainer *);
+    bool check_mutexblock(Directory &, FileContainer *);
     bool check_eventflagblock(Directory &, FileContainer *);
     bool check_dataqueueblock(Directory &, FileContainer *);
     bool check_mailboxblock(Directory &, FileContainer *);
+    bool check_messagebufferblock(Directory &, FileContainer *);
     bool check_fixed_memorypoolblock(Directory &, FileContainer *);
+    bool check_variable_memorypoolblock(Directory &, FileContainer *);
     bool check_cyclic_handlerblock(Directory &, FileContainer *);
     bool check_interrupt_handlerblock(Directory &, FileContainer *);
     bool check_exception_handlerblock(Directory &, FileContainer *);
@@ -332,6 +335,50 @@ bool ConfigurationChecker::check_semaphoreblock(Directory & parameter, FileConta
 }
 
 
+bool ConfigurationChecker::check_mutexblock(Directory & parameter, FileContainer * container)
+{
+    unsigned int id;
+    unsigned int old_error_count = error_count;
+    int maxpri, minpri;
+
+    Message object("Mutex","ߥ塼ƥå");
+
+    TargetVariable<DT_UINT> _kernel_tmax_mtxid("_kernel_tmax_mtxid");
+    if(*_kernel_tmax_mtxid < 1)
+        return true;
+
+    TargetVariable<DT_UINT> mtxatr("_kernel_mtxinib_table","mutex_initialization_block::mtxatr");
+    TargetVariable<DT_INT>  ceilpri("_kernel_mtxinib_table","mutex_initialization_block::ceilpri");
+
+    maxpri = container->getVariableInfo("TMAX_TPRI").value;
+    minpri = container->getVariableInfo("TMIN_TPRI").value;
+
+    VerboseMessage("% object : % items\n","%֥ : % \n")
+        << object << *_kernel_tmax_mtxid;
+
+    for(id = 1; id <= *_kernel_tmax_mtxid; id++)
+    {
+        set_banner(parameter, object, MUTEX, id);
+
+            //attribute validation check
+        if((*mtxatr & ~0x3) != 0)
+            notify(STANDARD,
+                Message("Illegal attribute (It should be (TA_TFIFO||TA_TPRI||TA_INHERIT||TA_CEILING)).",
+                        "(TA_TFIFO||TA_TPRI||TA_INHERIT||TA_CEILING)ʳ°ꤵƤ"));
+
+            //ceiling priority is in [TMIN_TPRI, TMAX_TPRI]
+        if(*mtxatr == 0x3 && (*ceilpri < 0 || *ceilpri > (signed)(maxpri - minpri)))
+            notify(STANDARD,
+                Message("Ceiling priority is out of range [%, %].",
+                        "ͥ٤ϰ[%, %]ĶƤ") << minpri << maxpri);
+
+        ++ mtxatr, ++ ceilpri;
+    }
+
+    return old_error_count == error_count;
+}
+
+
 bool ConfigurationChecker::check_eventflagblock(Directory & parameter, FileContainer * container)
 {
     unsigned int id;
@@ -458,6 +505,50 @@ bool ConfigurationChecker::check_mailboxblock(Directory & parameter, FileContain
     return old_error_count == error_count;
 }
 
+
+bool ConfigurationChecker::check_messagebufferblock(Directory & parameter, FileContainer * container)
+{
+    unsigned int id;
+    unsigned int old_error_count = error_count;
+
+    Message object("Message buffer","åХåե");
+
+    TargetVariable<DT_UINT> _kernel_tmax_mbfid("_kernel_tmax_mbfid");
+    if(*_kernel_tmax_mbfid < 1)
+        return true;
+
+    TargetVariable<DT_UINT> mbfatr("_kernel_mbfinib_table", "message_buffer_initialization_block::mbfatr");
+    TargetVariable<DT_UINT> maxmsz("_kernel_mbfinib_table", "message_buffer_initialization_block::maxmsz");
+    TargetVariable<DT_UINT> mbfsz("_kernel_mbfinib_table", "message_buffer_initialization_block::mbfsz");
+    TargetVariable<DT_VP_INT> mbf("_kernel_mbfinib_table", "message_buffer_initialization_block::mbf");
+
+    VerboseMessage("% object : % items\n","%֥ : % \n")
+        << object << *_kernel_tmax_mbfid;
+
+    for(id = 1; id <= *_kernel_tmax_mbfid; id++)
+    {
+        set_banner(parameter, object, MESSAGEBUFFER, id);
+
+            //attribute validation check
+        if((*mbfatr & ~0x1) != 0)
+            notify(STANDARD,
+                Message("Illegal attribute value [0x%]",
+                        "° [0x%]") << setbase(16) << (*mbfatr & ~0x1));
+
+        if(*maxmsz == 0)
+            notify(STANDARD,
+                Message("Maximum message size should not be 0", "å0"));
+
+        if(*mbfsz != 0 && *mbf == 0)
+            notify(TOPPERS,
+                Message("Message buffer should not be NULL", "åХåեΰ褬NULL"));
+
+        ++ mbfatr, ++ maxmsz, ++ mbfsz, ++ mbf;
+    }
+
+    return old_error_count == error_count;
+}
+
 bool ConfigurationChecker::check_fixed_memorypoolblock(Directory & parameter, FileContainer * container)
 {
     unsigned int id;
@@ -505,6 +596,47 @@ bool ConfigurationChecker::check_fixed_memorypoolblock(Directory & parameter, Fi
     return old_error_count == error_count;
 }
 
+bool ConfigurationChecker::check_variable_memorypoolblock(Directory & parameter, FileContainer * container)
+{
+    unsigned int id;
+    unsigned int old_error_count = error_count;
+
+    Message object("Variable size memory pool","Ĺס");
+
+    TargetVariable<DT_UINT> _kernel_tmax_mplid("_kernel_tmax_mplid");
+    if(*_kernel_tmax_mplid < 1)
+        return true;
+
+    TargetVariable<DT_UINT> mplatr("_kernel_mplinib_table", "variable_memorypool_initialization_block::mplatr");
+    TargetVariable<DT_UINT> mplsz ("_kernel_mplinib_table", "variable_memorypool_initialization_block::mplsz");
+    TargetVariable<DT_VP>   mpl   ("_kernel_mplinib_table", "variable_memorypool_initialization_block::mpl");
+
+    VerboseMessage("% object : % items\n","%֥ : % \n") << object << *_kernel_tmax_mplid;
+    for(id = 1; id <= *_kernel_tmax_mplid; id++)
+    {
+        set_banner(parameter, object, VARIABLESIZEMEMORYPOOL, id);
+
+            //attribute validation check
+        if((*mplatr & ~0x1) != 0)
+            notify(STANDARD,
+                Message("Illegal attribute value [0x%]","° [0x%]") << (*mplatr & ~0x1));
+
+            //ΰΥ0
+        if(*mplsz == 0)
+            notify(STANDARD,
+                Message("mplsz should be a non-zero value.","סΰΥ0Ǥ"));
+
+            //ΰΥɥ쥹0
+        if(*mpl == 0)
+            notify(TOPPERS,
+                Message("buffer address is a NULL pointer.","Хåեɥ쥹NULLݥ󥿤ˤʤäƤޤ"));
+
+        ++ mplatr, ++ mplsz, ++ mpl;
+    }
+
+    return old_error_count == error_count;
+}
+
 
 bool ConfigurationChecker::check_cyclic_handlerblock(Directory & parameter, FileContainer * container)
 {
@@ -755,10 +887,13 @@ void ConfigurationChecker::body(Directory & parameter)
     error_count = 0;
     result &= check_taskblock(parameter,container);
     result &= check_semaphoreblock(parameter,container);
+    result &= check_mutexblock(parameter,container);
     result &= check_eventflagblock(parameter,container);
     result &= check_dataqueueblock(parameter,container);
     result &= check_mailboxblock(parameter,container);
+    result &= check_messagebufferblock(parameter,container);
     result &= check_fixed_memorypoolblock(parameter,container);
+    result &= check_variable_memorypoolblock(parameter,container);
     result &= check_cyclic_handlerblock(parameter,container);
     result &= check_interrupt_handlerblock(parameter,container);
     result &= check_exception_handlerblock(parameter,container);
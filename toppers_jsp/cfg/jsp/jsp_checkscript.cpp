@@ -195,10 +195,13 @@ void CheckScriptGenerator::body(Directory & container)
     (*out) <<	"#include \"queue.h\"\n\n"
 		        "#include \"task.h\"\n"
 		        "#include \"semaphore.h\"\n"
+		        "#include \"mutex.h\"\n"
 		        "#include \"eventflag.h\"\n"
 		        "#include \"dataqueue.h\"\n"
 		        "#include \"mailbox.h\"\n"
+		        "#include \"messagebuf.h\"\n"
 		        "#include \"mempfix.h\"\n"
+		        "#include \"mempvar.h\"\n"
 		        "#include \"cyclic.h\"\n"
 		        "#include \"../kernel/exception.h\"\n"
 		        "#include \"interrupt.h\"\n"
@@ -216,10 +219,13 @@ void CheckScriptGenerator::body(Directory & container)
 
     createScriptEntry(container[OBJECTTREE "/" TASK],      out, "tskatr,exinf,task,ipriority,stksz,stk,texatr,texrtn");
     createScriptEntry(container[OBJECTTREE "/" SEMAPHORE], out, "sematr,isemcnt,maxsem");
+    createScriptEntry(container[OBJECTTREE "/" MUTEX], out, "wobjatr,mtxatr,ceilpri");
     createScriptEntry(container[OBJECTTREE "/" EVENTFLAG], out, "flgatr,iflgptn");
     createScriptEntry(container[OBJECTTREE "/" DATAQUEUE], out, "dtqatr,dtqcnt,dtq");
     createScriptEntry(container[OBJECTTREE "/" MAILBOX], out, "mbxatr,maxmpri");
+    createScriptEntry(container[OBJECTTREE "/" MESSAGEBUFFER], out, "message_buffer", "mbfatr,maxmsz,mbfsz,mbf");
     createScriptEntry(container[OBJECTTREE "/" FIXEDSIZEMEMORYPOOL], out, "fixed_memorypool", "mpfatr,blksz,mpf,limit");
+    createScriptEntry(container[OBJECTTREE "/" VARIABLESIZEMEMORYPOOL], out, "variable_memorypool", "mplatr,mplsz,mpl");
     createScriptEntry(container[OBJECTTREE "/" CYCLICHANDLER], out, "cyclic_handler", "cycatr,exinf,cychdr,cyctim,cycphs");
     createScriptEntry(container[OBJECTTREE "/" INTERRUPTHANDLER], out, "interrupt_handler", "inhno,inhatr,inthdr", false);
     createScriptEntry(container[OBJECTTREE "/" EXCEPTIONHANDLER], out, "cpu_exception_handler", "excno,excatr,exchdr", false);
@@ -45,10 +45,13 @@
 
 #define TASK                "task"
 #define SEMAPHORE           "semaphore"
+#define MUTEX               "mutex"
 #define EVENTFLAG           "eventflag"
 #define DATAQUEUE           "dataqueue"
 #define MAILBOX             "mailbox"
+#define MESSAGEBUFFER       "messagebuf"
 #define FIXEDSIZEMEMORYPOOL "mempfix"
+#define VARIABLESIZEMEMORYPOOL "mempvar"
 #define CYCLICHANDLER       "cyclic"
 #define INTERRUPTHANDLER    "interrupt"
 #define EXCEPTIONHANDLER    "exception"
@@ -160,10 +160,13 @@ void CoreParser::assignID(Directory & container) throw()
 
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" TASK].size(), TASK));
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" SEMAPHORE].size(), SEMAPHORE));
+    sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" MUTEX].size(), MUTEX));
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" EVENTFLAG].size(), EVENTFLAG));
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" DATAQUEUE].size(), DATAQUEUE));
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" MAILBOX].size(), MAILBOX));
+    sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" MESSAGEBUFFER].size(), MESSAGEBUFFER));
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" FIXEDSIZEMEMORYPOOL].size(), FIXEDSIZEMEMORYPOOL));
+    sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" VARIABLESIZEMEMORYPOOL].size(), VARIABLESIZEMEMORYPOOL));
     sorter.insert(pair<int, const char *>(container[OBJECTTREE "/" CYCLICHANDLER].size(), CYCLICHANDLER));
 
     order = Common::parseOrder(getOption("ao", "assign-order"));
@@ -344,10 +347,13 @@ namespace {
             .createPart(IDENTIFIER_VARIABLE)
             .createPart(TASK)
             .createPart(SEMAPHORE)
+            .createPart(MUTEX)
             .createPart(EVENTFLAG)
             .createPart(DATAQUEUE)
             .createPart(MAILBOX)
+            .createPart(MESSAGEBUFFER)
             .createPart(FIXEDSIZEMEMORYPOOL)
+            .createPart(VARIABLESIZEMEMORYPOOL)
             .createPart(CYCLICHANDLER)
             .createPart(INTERRUPTHANDLER)
             .createPart(EXCEPTIONHANDLER)
@@ -924,6 +930,9 @@ void ConfigurationFileGenerator::body(Directory & container)
         /* SEMAPHORE */
     createObjectDefinition(out, container[OBJECTTREE "/" SEMAPHORE], HEADER|TNUM|DEFINITION|CONTROLBLOCK|INIT,"sem", "$(sematr), $(isemcnt), $(maxsem)");
 
+        /* MUTEX */
+    createObjectDefinition(out, container[OBJECTTREE "/" MUTEX], HEADER|TNUM|DEFINITION|CONTROLBLOCK|INIT,"mtx", "MTX_WOBJATR($(mtxatr)), $(mtxatr), INT_PRIORITY($(ceilpri))");
+
         /* EVENTFLAG */
     createObjectDefinition(out, container[OBJECTTREE "/" EVENTFLAG], HEADER|TNUM|DEFINITION|CONTROLBLOCK|INIT,"flg", "$(flgatr), $(iflgptn)");
 
@@ -933,9 +942,15 @@ void ConfigurationFileGenerator::body(Directory & container)
         /* MAILBOX */
     createObjectDefinition(out, container[OBJECTTREE "/" MAILBOX], HEADER|TNUM|DEFINITION|CONTROLBLOCK|INIT,"mbx","$(mbxatr), $(maxmpri)");
 
+        /* MESSAGEBUFFER */
+    createObjectDefinition(out, container[OBJECTTREE "/" MESSAGEBUFFER], HEADER|TNUM|BUFFER|DEFINITION|CONTROLBLOCK|INIT,"mbf", "#if ($(mbfsz)) > 0\n  static VP __messagebuf_$@[TCOUNT_VP($(mbfsz))];\n#else\n  #define __messagebuf_$@ NULL\n#endif","$(mbfatr), $(maxmsz), TROUND_VP($(mbfsz)), __messagebuf_$@");
+
         /* FIXEDSIZEMEMORYPOOL */
     createObjectDefinition(out, container[OBJECTTREE "/" FIXEDSIZEMEMORYPOOL], HEADER|TNUM|BUFFER|DEFINITION|CONTROLBLOCK|INIT,"mpf","static __MPF_UNIT __fixedsize_memorypool_$@[__TCOUNT_MPF_UNIT($(blksz)) * (($(blkcnt)))];","$(mpfatr), __TROUND_MPF_UNIT($(blksz)), __fixedsize_memorypool_$@, (VP)((VB *)__fixedsize_memorypool_$@ + sizeof(__fixedsize_memorypool_$@))");
 
+        /* VARIABLESIZEMEMORYPOOL */
+    createObjectDefinition(out, container[OBJECTTREE "/" VARIABLESIZEMEMORYPOOL], HEADER|TNUM|BUFFER|DEFINITION|CONTROLBLOCK|INIT,"mpl","static VP __variable_memorypool_$@[TCOUNT_VP($(mplsz))];","$(mplatr), sizeof(__variable_memorypool_$@), __variable_memorypool_$@");
+
         /* CYCLICHANDLER */
     createObjectDefinition(out, container[OBJECTTREE "/" CYCLICHANDLER], HEADER|TNUM|DEFINITION|CONTROLBLOCK|INIT|PROTOTYPE,"cyc","void $(cychdr)(VP_INT exinf);","$(cycatr),$(exinf),(FP)($(cychdr)),$(cyctim),$(cycphs)");
 
@@ -145,6 +145,20 @@ DECLARE_API(CRE_SEM,"CRE_SEM")
     p.getToken("}");
 }
 
+DECLARE_API(CRE_MTX,"CRE_MTX")
+{
+    Token token;
+    Directory * node;
+
+    p.getToken(token);
+    node = allocate(container[OBJECTTREE], token, MUTEX);
+    (*node)["position"] = p.getStreamLocation();
+
+    p.getToken(",","{",NULL);
+    parseParameters(p,node,"mtxatr,ceilpri");
+    p.getToken("}");
+}
+
 DECLARE_API(CRE_FLG,"CRE_FLG")
 {
     Token token;
@@ -187,6 +201,20 @@ DECLARE_API(CRE_MBX,"CRE_MBX")
     p.getToken(",","NULL","}",NULL);
 }
 
+DECLARE_API(CRE_MBF,"CRE_MBF")
+{
+    Token token;
+    Directory * node;
+
+    p.getToken(token);
+    node = allocate(container[OBJECTTREE], token, MESSAGEBUFFER);
+    (*node)["position"] = p.getStreamLocation();
+
+    p.getToken(",","{",NULL);
+    parseParameters(p,node,"mbfatr,maxmsz,mbfsz");
+    p.getToken(",","NULL","}",NULL);
+}
+
 DECLARE_API(CRE_MPF,"CRE_MPF")
 {
     Token token;
@@ -201,6 +229,20 @@ DECLARE_API(CRE_MPF,"CRE_MPF")
     p.getToken(",","NULL","}",NULL);
 }
 
+DECLARE_API(CRE_MPL,"CRE_MPL")
+{
+    Token token;
+    Directory * node;
+
+    p.getToken(token);
+    node = allocate(container[OBJECTTREE], token, VARIABLESIZEMEMORYPOOL);
+    (*node)["position"] = p.getStreamLocation();
+
+    p.getToken(",","{",NULL);
+    parseParameters(p,node,"mplatr,mplsz");
+    p.getToken(",","NULL","}",NULL);
+}
+
 DECLARE_API(CRE_CYC,"CRE_CYC")
 {
     Token token;
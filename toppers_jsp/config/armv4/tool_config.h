@@ -198,6 +198,38 @@ call_atexit()
 #define	LOG_PRCV_MBX_LEAVE(ercd, pk_msg)
 #define	LOG_TRCV_MBX_ENTER(mbxid, ppk_msg, tmout)
 #define	LOG_TRCV_MBX_LEAVE(ercd, pk_msg)
+#define	LOG_LOC_MTX_ENTER(mtxid)
+#define	LOG_LOC_MTX_LEAVE(ercd)
+#define	LOG_PLOC_MTX_ENTER(mtxid)
+#define	LOG_PLOC_MTX_LEAVE(ercd)
+#define	LOG_TLOC_MTX_ENTER(mtxid, tmout)
+#define	LOG_TLOC_MTX_LEAVE(ercd)
+#define	LOG_UNL_MTX_ENTER(mtxid)
+#define	LOG_UNL_MTX_LEAVE(ercd)
+#define	LOG_SND_MBF_ENTER(mbfid, msg, msgsz)
+#define	LOG_SND_MBF_LEAVE(ercd)
+#define	LOG_PSND_MBF_ENTER(mbfid, msg, msgsz)
+#define	LOG_PSND_MBF_LEAVE(ercd)
+#define	LOG_TSND_MBF_ENTER(mbfid, msg, msgsz, tmout)
+#define	LOG_TSND_MBF_LEAVE(ercd)
+#define	LOG_RCV_MBF_ENTER(mbfid, msg)
+#define	LOG_RCV_MBF_LEAVE(ercd, msg)
+#define	LOG_PRCV_MBF_ENTER(mbfid, msg)
+#define	LOG_PRCV_MBF_LEAVE(ercd, msg)
+#define	LOG_TRCV_MBF_ENTER(mbfid, msg, tmout)
+#define	LOG_TRCV_MBF_LEAVE(ercd, msg)
+#define	LOG_VRSV_MBF_ENTER(mbfid, p_msg, msgsz)
+#define	LOG_VRSV_MBF_LEAVE(ercd, msg)
+#define	LOG_VCMT_MBF_ENTER(mbfid, msgsz)
+#define	LOG_VCMT_MBF_LEAVE(ercd)
+#define	LOG_VPEK_MBF_ENTER(mbfid, p_msg)
+#define	LOG_VPEK_MBF_LEAVE(ercd, msg)
+#define	LOG_VFRE_MBF_ENTER(mbfid, msg)
+#define	LOG_VFRE_MBF_LEAVE(ercd)
+#define	LOG_VBSND_MBF_ENTER(mbfid, msg, msgsz, msgcnt)
+#define	LOG_VBSND_MBF_LEAVE(ercd)
+#define	LOG_VBRCV_MBF_ENTER(mbfid, msg, msgsz, msgcnt)
+#define	LOG_VBRCV_MBF_LEAVE(ercd)
 #define	LOG_GET_MPF_ENTER(mpfid, p_blk)
 #define	LOG_GET_MPF_LEAVE(ercd, blk)
 #define	LOG_PGET_MPF_ENTER(mpfid, p_blk)
@@ -206,6 +238,16 @@ call_atexit()
 #define	LOG_TGET_MPF_LEAVE(ercd, blk)
 #define	LOG_REL_MPF_ENTER(mpfid, blk)
 #define	LOG_REL_MPF_LEAVE(ercd)
+#define	LOG_GET_MPL_ENTER(mplid, blksz, p_blk)
+#define	LOG_GET_MPL_LEAVE(ercd, blk)
+#define	LOG_PGET_MPL_ENTER(mplid, blksz, p_blk)
+#define	LOG_PGET_MPL_LEAVE(ercd, blk)
+#define	LOG_TGET_MPL_ENTER(mplid, blksz, p_blk, tmout)
+#define	LOG_TGET_MPL_LEAVE(ercd, blk)
+#define	LOG_REL_MPL_ENTER(mplid, blk)
+#define	LOG_REL_MPL_LEAVE(ercd)
+#define	LOG_VREF_MPL_ENTER(mplid, pk_rmpl)
+#define	LOG_VREF_MPL_LEAVE(ercd)
 #define	LOG_SET_TIM_ENTER(p_systim)
 #define	LOG_SET_TIM_LEAVE(ercd)
 #define	LOG_GET_TIM_ENTER(p_systim)
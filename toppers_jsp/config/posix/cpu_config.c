@@ -0,0 +1,323 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Processor dependent module (POSIX host simulation)
+ *
+ *  The structure follows cpu_support.S of the ARMv4 port: a task gives
+ *  up the CPU by switching to the dispatcher, which runs on its own
+ *  system context together with the idle loop, and an interrupt that
+ *  makes another task ready ends with a dispatch (ret_int).
+ *
+ *  Interrupts are emulated with a software CPU lock (cpu_insn.h) and a
+ *  pending bit per interrupt handler number.  The system layer raises
+ *  them either from the idle loop (virtual time) or from a SIGALRM
+ *  handler (real time).
+ */
+
+#include "jsp_kernel.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+/*
+ *  Host context of a task
+ */
+typedef struct host_context {
+	ucontext_t	uc;
+	UB		stk[CPU_TASK_STKSZ];
+} HOSTCTX;
+
+/*
+ *  Interrupt nesting count
+ */
+UW	interrupt_count;
+
+/*
+ *  CPU lock and interrupt state
+ *
+ *  The CPU is locked until the first task is started.  Interrupts do
+ *  not nest: all of them have the same level, like the single level the
+ *  AIC is used with on the AT91SAM7S.
+ */
+volatile BOOL	int_lock_flag = TRUE;
+volatile UW	int_pend;
+static BOOL	int_active;
+
+/*
+ *  System context (dispatcher and idle loop)
+ */
+static ucontext_t	dispatcher_uc;
+static UB		system_stack[CPU_SYSTEM_STKSZ];
+
+static HOSTCTX	*task_context(TCB *tcb);
+static void	dispatcher(void);
+static void	interrupt(INHNO inhno);
+
+/*
+ *  CPU exception handler setting
+ */
+void
+define_exc(EXCNO excno, FP exchdr)
+{
+}
+
+/*
+ *  Processor dependent initialization
+ */
+void
+cpu_initialize(void)
+{
+	interrupt_count = 1;
+
+	getcontext(&dispatcher_uc);
+	dispatcher_uc.uc_stack.ss_sp = system_stack;
+	dispatcher_uc.uc_stack.ss_size = sizeof(system_stack);
+	dispatcher_uc.uc_link = NULL;
+	makecontext(&dispatcher_uc, dispatcher, 0);
+}
+
+/*
+ *  Processor dependent termination
+ *
+ *  The host contexts are left to the exit of the process, since
+ *  kernel_exit may be running on one of them.
+ */
+void
+cpu_terminate(void)
+{
+}
+
+/*
+ *  Task start routine
+ *
+ *  Entered through makecontext() when a task is dispatched for the
+ *  first time after its activation.
+ */
+void
+activate_r(void)
+{
+	unlock_cpu();
+	(*((void (*)(VP_INT))(runtsk->tinib->task)))(runtsk->tinib->exinf);
+	ext_tsk();
+}
+
+/*
+ *  Give up the CPU from a task (or from ret_int)
+ *
+ *  Called with the CPU locked.  Returns when the task is dispatched
+ *  again, after running its task exception routine (dispatch_r).
+ */
+void
+dispatch(void)
+{
+	HOSTCTX	*ctx = (HOSTCTX *)(runtsk->tskctxb.ctx);
+
+	LOG_DSP_ENTER(runtsk);
+	swapcontext(&(ctx->uc), &dispatcher_uc);
+	LOG_DSP_LEAVE(runtsk);
+	calltex();
+}
+
+/*
+ *  Leave the running task or the initialization for good
+ */
+void
+exit_and_dispatch(void)
+{
+	interrupt_count = 0;
+	setcontext(&dispatcher_uc);
+}
+
+/*
+ *  Host context of a task to be dispatched
+ *
+ *  Allocates the context on the first dispatch of the task and builds
+ *  a fresh one after an activation (activate_context).
+ */
+static HOSTCTX *
+task_context(TCB *tcb)
+{
+	HOSTCTX	*ctx = (HOSTCTX *)(tcb->tskctxb.ctx);
+
+	if (ctx == NULL) {
+		ctx = (HOSTCTX *) malloc(sizeof(HOSTCTX));
+		if (ctx == NULL) {
+			fprintf(stderr, "no memory for task %d\n",
+					(int)(TSKID(tcb)));
+			abort();
+		}
+		tcb->tskctxb.ctx = (VP) ctx;
+	}
+	if (tcb->tskctxb.pc != NULL) {
+		tcb->tskctxb.pc = NULL;
+		getcontext(&(ctx->uc));
+		ctx->uc.uc_stack.ss_sp = ctx->stk;
+		ctx->uc.uc_stack.ss_size = sizeof(ctx->stk);
+		ctx->uc.uc_link = NULL;
+		makecontext(&(ctx->uc), activate_r, 0);
+	}
+	return(ctx);
+}
+
+/*
+ *  Dispatcher (dispatcher_1 and dispatcher_2 of cpu_support.S)
+ *
+ *  Runs on the system context.  Every switch between two tasks goes
+ *  through here, so that a task never builds its new context on the
+ *  stack it is still running on.  Without a task to run, it waits for
+ *  an interrupt with interrupt_count at 1.
+ */
+static void
+dispatcher(void)
+{
+	HOSTCTX	*ctx;
+
+	for (;;) {
+		runtsk = schedtsk;
+		if (runtsk == NULL) {
+			interrupt_count = 1;
+			sys_wait_interrupt();
+			enaint();
+			disint();
+			interrupt_count = 0;
+			continue;
+		}
+		ctx = task_context(runtsk);
+		swapcontext(&dispatcher_uc, &(ctx->uc));
+	}
+}
+
+/*
+ *  Raise an interrupt
+ */
+void
+cpu_raise_interrupt(INHNO inhno)
+{
+	__sync_fetch_and_or(&int_pend, 1u << inhno);
+	if (!int_lock_flag) {
+		cpu_deliver_interrupt();
+	}
+}
+
+/*
+ *  Deliver the pending interrupts
+ *
+ *  Called with the CPU unlocked, from enaint() or from a signal
+ *  handler.  The lock flag is taken before the pending bit is cleared,
+ *  so that an interrupt is never run twice when a signal arrives in
+ *  between.  The lowest handler number is served first.
+ */
+void
+cpu_deliver_interrupt(void)
+{
+	UW	pend;
+	INHNO	inhno;
+
+	while (int_pend != 0u && !int_active) {
+		if (int_lock_flag) {
+			break;
+		}
+		disint();
+		pend = int_pend;
+		if (pend == 0u) {
+			enaint();
+			break;
+		}
+		inhno = (INHNO) __builtin_ctz(pend);
+		__sync_fetch_and_and(&int_pend, ~(1u << inhno));
+		interrupt(inhno);
+		Asm("" : : : "memory");
+		int_lock_flag = FALSE;
+	}
+}
+
+/*
+ *  Interrupt handler entry and exit (IRQ_Handler of irq.S and ret_int)
+ *
+ *  Called with the CPU locked; returns with the CPU locked.  The
+ *  handler runs with the CPU unlocked.  When the nesting count returns
+ *  to 0 with reqflg set, the running task is switched or its task
+ *  exception routine is called.
+ */
+static void
+interrupt(INHNO inhno)
+{
+	FP	inthdr = int_table[inhno];
+
+	LOG_INH_ENTER(inhno);
+	int_active = TRUE;
+	interrupt_count++;
+	enaint();
+	if (inthdr != NULL) {
+		(*inthdr)();
+	}
+	else {
+		syslog_1(LOG_EMERG, "Unregistered interrupt %d occurs.",
+							(SIZE) inhno);
+	}
+	disint();
+	interrupt_count--;
+	int_active = FALSE;
+	LOG_INH_LEAVE(inhno);
+
+	/* ret_int */
+	if (interrupt_count == 0 && reqflg) {
+		reqflg = FALSE;
+		if (enadsp && schedtsk != runtsk) {
+			dispatch();
+		}
+		else {
+			calltex();
+		}
+	}
+}
+
+/*
+ *  Short delay (the same loop as sil_dly_nse of cpu_support.S)
+ */
+void
+sil_dly_nse(UINT dlytim)
+{
+	volatile INT	t = (INT) dlytim - SIL_DLY_TIM1;
+
+	while (t > 0) {
+		t -= SIL_DLY_TIM2;
+	}
+}
@@ -0,0 +1,190 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Processor dependent module (POSIX host simulation)
+ *
+ *  Tasks run as ucontext coroutines of a single host thread.  The
+ *  dispatcher and the idle loop run on a separate system context, as
+ *  dispatcher_1 of the ARMv4 port (cpu_support.S) runs on the non-task
+ *  stack.
+ *
+ *  Included only from t_config.h.
+ */
+
+#ifndef _CPU_CONFIG_H_
+#define _CPU_CONFIG_H_
+
+/*
+ *  Renaming of the kernel internal identifiers
+ */
+#include "cpu_rename.h"
+
+#ifndef _MACRO_ONLY
+#include <cpu_insn.h>
+#endif /* _MACRO_ONLY */
+
+/*
+ *  Bit widths of the TCB fields (the same as on the ARMv4)
+ */
+#define	TBIT_TCB_TSTAT		8	/* tstat */
+#define	TBIT_TCB_PRIORITY	8	/* priority */
+
+/*
+ *  Host stack size of a task and of the system context
+ *
+ *  The stack given to CRE_TSK is sized for the ARM target and is far
+ *  too small for host code calling the C library, so each task gets
+ *  its own host stack of this size instead.
+ */
+#ifndef CPU_TASK_STKSZ
+#define CPU_TASK_STKSZ		(64u * 1024u)
+#endif /* CPU_TASK_STKSZ */
+#ifndef CPU_SYSTEM_STKSZ
+#define CPU_SYSTEM_STKSZ	(64u * 1024u)
+#endif /* CPU_SYSTEM_STKSZ */
+
+#ifndef _MACRO_ONLY
+/*
+ *  Task context block
+ *
+ *  ctx points to the host context (ucontext and stack) of the task,
+ *  allocated on its first dispatch.  pc is activate_r while the task
+ *  has to be started from its entry point, and NULL when it resumes
+ *  from its saved context.
+ */
+typedef struct task_context_block {
+	VP	ctx;		/* host context */
+	FP	pc;		/* start address */
+} CTXB;
+
+/*
+ *  Interrupt nesting count
+ *
+ *  As on the ARMv4, it is 1 while the kernel initializes and while the
+ *  dispatcher idles, so that both run as non-task contexts.
+ */
+extern UW	interrupt_count;
+
+/*
+ *  Context and CPU lock state
+ */
+Inline BOOL
+sense_context(void)
+{
+	return(interrupt_count > 0);
+}
+
+Inline BOOL
+sense_lock(void)
+{
+	return(int_lock_flag);
+}
+
+#define t_sense_lock	sense_lock
+#define i_sense_lock	sense_lock
+
+/*
+ *  CPU lock and unlock
+ */
+#define t_lock_cpu	lock_cpu
+#define i_lock_cpu	lock_cpu
+#define t_unlock_cpu	unlock_cpu
+#define i_unlock_cpu	unlock_cpu
+
+Inline void
+lock_cpu(void)
+{
+	disint();
+}
+
+Inline void
+unlock_cpu(void)
+{
+	enaint();
+}
+
+/*
+ *  Task dispatcher (cpu_config.c)
+ *
+ *  dispatch is called from a task with the CPU locked and returns when
+ *  the task runs again.  exit_and_dispatch leaves the running task (or
+ *  the initialization) for good.
+ */
+extern void	dispatch(void);
+extern void	exit_and_dispatch(void);
+
+/*
+ *  CPU exception handlers
+ *
+ *  The host simulation raises no CPU exception.  The entry macros are
+ *  provided so that a configuration with DEF_EXC still builds.
+ */
+extern void	define_exc(EXCNO excno, FP exchdr);
+
+#define EXCHDR_ENTRY(exchdr)	extern void exchdr(VP p_excinf)
+
+#define EXC_ENTRY(exchdr)	exchdr
+
+Inline BOOL
+exc_sense_context(VP p_excinf)
+{
+	return(interrupt_count > 1);
+}
+
+Inline BOOL
+exc_sense_lock(VP p_excinf)
+{
+	return(int_lock_flag);
+}
+
+/*
+ *  Processor dependent initialization and termination
+ */
+extern void	cpu_initialize(void);
+extern void	cpu_terminate(void);
+
+/*
+ *  Raise an interrupt (cpu_config.c)
+ *
+ *  Marks the interrupt handler inhno as pending and runs it right away
+ *  if the CPU is not locked.  May be called from a signal handler.
+ */
+extern void	cpu_raise_interrupt(INHNO inhno);
+
+#endif /* _MACRO_ONLY */
+#endif /* _CPU_CONFIG_H_ */
@@ -0,0 +1,71 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Task context (POSIX host simulation)
+ */
+
+#ifndef _CPU_CONTEXT_H_
+#define _CPU_CONTEXT_H_
+
+#include "task.h"
+
+/*
+ *  Task context initialization
+ *
+ *  The host context is allocated on the first dispatch of the task.
+ */
+Inline void
+create_context(TCB *tcb)
+{
+}
+
+/*
+ *  Task activation
+ *
+ *  The host context is built again from activate_r when the task is
+ *  next dispatched (cpu_config.c).
+ */
+extern void	activate_r(void);
+
+Inline void
+activate_context(TCB *tcb)
+{
+	tcb->tskctxb.pc = activate_r;
+}
+
+#endif /* _CPU_CONTEXT_H_ */
@@ -0,0 +1,54 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Processor dependent definitions (POSIX host simulation)
+ *
+ *  Included from kernel.h and sil.h, after t_stddef.h and itron.h.
+ */
+
+#ifndef _CPU_DEFS_H_
+#define _CPU_DEFS_H_
+
+#define POSIX
+
+#ifndef _MACRO_ONLY
+
+typedef	UINT		EXCNO;		/* CPU exception handler number */
+
+#endif /* _MACRO_ONLY */
+#endif /* _CPU_DEFS_H_ */
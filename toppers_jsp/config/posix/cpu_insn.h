@@ -0,0 +1,78 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Low level processor operations (POSIX host simulation)
+ *
+ *  The CPU lock is a software flag.  An interrupt raised while the
+ *  flag is set (or while an interrupt handler runs) is kept pending in
+ *  int_pend and is delivered by enaint().  The compiler barriers keep
+ *  kernel data accesses inside the locked region.
+ */
+
+#ifndef _CPU_INSN_H_
+#define _CPU_INSN_H_
+
+extern volatile BOOL	int_lock_flag;	/* CPU lock flag */
+extern volatile UW		int_pend;		/* pending interrupts, one bit per INHNO */
+
+extern void	cpu_deliver_interrupt(void);
+
+/*
+ *  Lock the CPU
+ */
+Inline void
+disint(void)
+{
+	int_lock_flag = TRUE;
+	Asm("" : : : "memory");
+}
+
+/*
+ *  Unlock the CPU and take the pending interrupts
+ */
+Inline void
+enaint(void)
+{
+	Asm("" : : : "memory");
+	int_lock_flag = FALSE;
+	if (int_pend != 0u) {
+		cpu_deliver_interrupt();
+	}
+}
+
+#endif /* _CPU_INSN_H_ */
@@ -0,0 +1,26 @@
+/* This file is generated from cpu_rename.def by genrename. */
+
+#ifndef _CPU_RENAME_H_
+#define _CPU_RENAME_H_
+
+#ifndef OMIT_RENAME
+
+#define activate_r		_kernel_activate_r
+#define interrupt_count		_kernel_interrupt_count
+#define int_lock_flag		_kernel_int_lock_flag
+#define int_pend		_kernel_int_pend
+#define cpu_deliver_interrupt	_kernel_cpu_deliver_interrupt
+#define cpu_raise_interrupt	_kernel_cpu_raise_interrupt
+
+#ifdef LABEL_ASM
+
+#define _activate_r		__kernel_activate_r
+#define _interrupt_count	__kernel_interrupt_count
+#define _int_lock_flag		__kernel_int_lock_flag
+#define _int_pend		__kernel_int_pend
+#define _cpu_deliver_interrupt	__kernel_cpu_deliver_interrupt
+#define _cpu_raise_interrupt	__kernel_cpu_raise_interrupt
+
+#endif /* LABEL_ASM */
+#endif /* OMIT_RENAME */
+#endif /* _CPU_RENAME_H_ */
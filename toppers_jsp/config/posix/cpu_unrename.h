@@ -0,0 +1,26 @@
+/* This file is generated from cpu_rename.def by genrename. */
+
+#ifdef _CPU_UNRENAME_H_
+#undef _CPU_UNRENAME_H_
+
+#ifndef OMIT_RENAME
+
+#undef activate_r
+#undef interrupt_count
+#undef int_lock_flag
+#undef int_pend
+#undef cpu_deliver_interrupt
+#undef cpu_raise_interrupt
+
+#ifdef LABEL_ASM
+
+#undef _activate_r
+#undef _interrupt_count
+#undef _int_lock_flag
+#undef _int_pend
+#undef _cpu_deliver_interrupt
+#undef _cpu_raise_interrupt
+
+#endif /* LABEL_ASM */
+#endif /* OMIT_RENAME */
+#endif /* _CPU_UNRENAME_H_ */
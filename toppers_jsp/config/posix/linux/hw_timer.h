@@ -0,0 +1,93 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Timer module (Linux host simulation)
+ *
+ *  The tick comes from sys_config.c, either in virtual time or
+ *  from SIGALRM.
+ */
+
+#ifndef _HW_TIMER_H_
+#define _HW_TIMER_H_
+
+/*
+ *  Interrupt handler number of the timer
+ */
+#define INHNO_TIMER	0
+
+#ifndef _MACRO_ONLY
+
+/*
+ *  Timer of the system layer (sys_config.c)
+ */
+extern void	sys_timer_initialize(void);
+extern void	sys_timer_tick(void);
+extern void	sys_timer_terminate(void);
+
+/*
+ *  Start the timer
+ */
+Inline void
+hw_timer_initialize(void)
+{
+	sys_timer_initialize();
+}
+
+/*
+ *  Clear the timer interrupt request
+ *
+ *  The tick is counted here, so that sys_config.c can end the run
+ *  after a given number of ticks.
+ */
+Inline void
+hw_timer_int_clear(void)
+{
+	sys_timer_tick();
+}
+
+/*
+ *  Stop the timer
+ */
+Inline void
+hw_timer_terminate(void)
+{
+	sys_timer_terminate();
+}
+
+#endif /* _MACRO_ONLY */
+#endif /* _HW_TIMER_H_ */
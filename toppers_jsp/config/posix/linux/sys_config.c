@@ -0,0 +1,219 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Target system dependent module (Linux host simulation)
+ *
+ *  The timer (hw_timer.h) is the only interrupt source.  By default it
+ *  runs in virtual time: the next tick is raised as soon as the
+ *  CPU goes idle, so a run is deterministic and proceeds at full host
+ *  speed.  A task that busy-waits is never preempted by the tick in
+ *  this mode.
+ *
+ *  Environment variables:
+ *    JSP_SIM_REALTIME=1  drive the tick from a SIGALRM instead;
+ *                        tasks are then preempted asynchronously
+ *    JSP_SIM_TICKS=n     call kernel_exit() after n ticks
+ */
+
+#include "jsp_kernel.h"
+#include <hw_timer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/time.h>
+
+/*
+ *  Interrupt handler table
+ */
+FP	int_table[MAX_INT_NUM];
+
+static BOOL	sys_realtime;
+static BOOL	sys_timer_started;
+static UW	sys_tick_limit;
+static UW	sys_tick_count;
+
+/*
+ *  SIGALRM handler (real time mode)
+ */
+static void
+sys_timer_handler(int sig)
+{
+	(void) sig;
+	cpu_raise_interrupt(INHNO_TIMER);
+}
+
+/*
+ *  Set the interval timer (0 stops it)
+ */
+static void
+sys_set_itimer(long usec)
+{
+	struct itimerval	itv;
+
+	itv.it_interval.tv_sec = 0;
+	itv.it_interval.tv_usec = usec;
+	itv.it_value = itv.it_interval;
+	setitimer(ITIMER_REAL, &itv, NULL);
+}
+
+/*
+ *  Target system dependent initialization
+ */
+void
+sys_initialize(void)
+{
+	const char	*env;
+
+	env = getenv("JSP_SIM_TICKS");
+	sys_tick_limit = (env != NULL) ? (UW) strtoul(env, NULL, 0) : 0u;
+	sys_tick_count = 0u;
+
+	env = getenv("JSP_SIM_REALTIME");
+	sys_realtime = ((env != NULL) && (atoi(env) != 0)) ? TRUE : FALSE;
+}
+
+/*
+ *  Start the timer
+ */
+void
+sys_timer_initialize(void)
+{
+	struct sigaction	sa;
+
+	sys_timer_started = TRUE;
+	if (sys_realtime) {
+		sa.sa_handler = sys_timer_handler;
+		sigemptyset(&sa.sa_mask);
+		sa.sa_flags = SA_RESTART;
+		sigaction(SIGALRM, &sa, NULL);
+		sys_set_itimer(TIC_NUME * 1000L / TIC_DENO);
+	}
+}
+
+/*
+ *  Count a tick (from the timer handler)
+ */
+void
+sys_timer_tick(void)
+{
+	if ((sys_tick_limit != 0u) && (sys_tick_count >= sys_tick_limit)) {
+		kernel_exit();
+	}
+	sys_tick_count++;
+}
+
+/*
+ *  Number of ticks supplied so far
+ */
+UW
+sys_get_ticks(void)
+{
+	return(sys_tick_count);
+}
+
+/*
+ *  Stop the timer
+ */
+void
+sys_timer_terminate(void)
+{
+	if (sys_realtime) {
+		sys_set_itimer(0);
+	}
+	sys_timer_started = FALSE;
+}
+
+/*
+ *  Wait for an interrupt from the idle loop
+ */
+void
+sys_wait_interrupt(void)
+{
+	sigset_t	set, oset, wset;
+
+	if (!sys_realtime) {
+		if (!sys_timer_started) {
+			fprintf(stderr, "idle without a timer\n");
+			abort();
+		}
+
+		/* virtual time: the next tick is due right now */
+		cpu_raise_interrupt(INHNO_TIMER);
+		return;
+	}
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &set, &oset);
+	if (int_pend == 0u) {
+		wset = oset;
+		sigdelset(&wset, SIGALRM);
+		sigsuspend(&wset);
+	}
+	sigprocmask(SIG_SETMASK, &oset, NULL);
+}
+
+/*
+ *  Target system termination
+ */
+void
+sys_exit(void)
+{
+	printf("%lu ticks simulated\n", (unsigned long) sys_tick_count);
+	exit(0);
+}
+
+/*
+ *  Character output of the target system
+ */
+void
+sys_putc(char c)
+{
+	putchar(c);
+}
+
+/*
+ *  Interrupt handler setting
+ */
+void
+define_inh(INHNO inhno, FP inthdr)
+{
+	assert(inhno < MAX_INT_NUM);
+	int_table[inhno] = inthdr;
+}
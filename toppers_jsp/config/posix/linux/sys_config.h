@@ -0,0 +1,107 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Target system dependent module (Linux host simulation)
+ *
+ *  Included only from t_config.h.
+ */
+
+#ifndef _SYS_CONFIG_H_
+#define _SYS_CONFIG_H_
+
+/*
+ *  Renaming of the kernel internal identifiers
+ */
+#include <sys_rename.h>
+
+/*
+ *  Number of interrupt handler numbers
+ */
+#define MAX_INT_NUM	32
+
+#ifndef _MACRO_ONLY
+
+/*
+ *  Target system dependent initialization
+ */
+extern void	sys_initialize(void);
+
+/*
+ *  Target system termination
+ *
+ *  Reports the number of simulated ticks and exits the process.
+ */
+extern void	sys_exit(void);
+
+/*
+ *  Character output of the target system (standard output)
+ */
+extern void	sys_putc(char c);
+
+/*
+ *  Wait for an interrupt from the idle loop (called with the CPU locked)
+ */
+extern void	sys_wait_interrupt(void);
+
+/*
+ *  Interrupt handler table
+ */
+extern FP	int_table[MAX_INT_NUM];
+
+/*
+ *  Interrupt handler entry
+ *
+ *  Handlers are plain C functions called from cpu_config.c.
+ */
+#define INTHDR_ENTRY(inthdr)	extern void inthdr(void)
+
+#define INT_ENTRY(inthdr)	inthdr
+
+/*
+ *  Interrupt handler setting
+ */
+extern void	define_inh(INHNO inhno, FP inthdr);
+
+#endif /* _MACRO_ONLY */
+
+/*
+ *  Kernel functions to build (the same set as for the NXT)
+ */
+#include "../../windows/api.h"
+
+#endif /* _SYS_CONFIG_H_ */
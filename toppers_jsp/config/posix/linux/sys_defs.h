@@ -0,0 +1,109 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+
+/*
+ *  Target system dependent definitions (Linux host simulation)
+ *
+ *  Included from kernel.h and sil.h, after t_stddef.h and itron.h.
+ */
+
+#ifndef _SYS_DEFS_H_
+#define _SYS_DEFS_H_
+
+/*
+ *  Target system name in the start-up message
+ */
+#define TARGET_NAME	"POSIX - Linux host simulation"
+
+#ifndef _MACRO_ONLY
+
+/*
+ *  Interrupt and interrupt handler numbers
+ */
+typedef	UINT		INTNO;		/* interrupt number */
+typedef	UINT		INHNO;		/* interrupt handler number */
+
+/*
+ *  Number of ticks supplied so far (sys_config.c)
+ *
+ *  Within a time event handler, it is the number of the tick being
+ *  processed.  Tests use it to time handlers, which cannot call
+ *  get_tim.
+ */
+extern UW	sys_get_ticks(void) throw();
+
+#endif /* _MACRO_ONLY */
+
+/*
+ *  Time tick (1 ms, as on the AT91SAM7S)
+ *
+ *  A longer tick may be given on the command line, so that tests can
+ *  run time events with cycles shorter than a tick.
+ */
+#ifndef TIC_NUME
+#define	TIC_NUME	1		/* numerator of the tick period */
+#endif /* TIC_NUME */
+#ifndef TIC_DENO
+#define	TIC_DENO	1		/* denominator of the tick period */
+#endif /* TIC_DENO */
+
+/*
+ *  Short delay loop
+ */
+#define	SIL_DLY_TIM1	20
+#define	SIL_DLY_TIM2	10
+
+/*
+ *  Byte order of the host
+ */
+#define	SIL_ENDIAN	SIL_ENDIAN_LITTLE
+
+#ifndef _MACRO_ONLY
+
+#include <stdlib.h>
+
+/*
+ *  Abort of the system
+ */
+Inline void
+kernel_abort(void)
+{
+	abort();
+}
+
+#endif /* _MACRO_ONLY */
+#endif /* _SYS_DEFS_H_ */
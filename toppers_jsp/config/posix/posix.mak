@@ -0,0 +1,141 @@
+# Common Makefile for building a TOPPERS/JSP application as a Linux host
+# simulation (config/posix)
+#
+# The application Makefile defines TARGET, TARGET_SOURCES and
+# TOPPERS_JSP_CFG_SOURCE like for ecrobot.mak and includes this file.
+# NXT device drivers are not available. kernel_cfg.c and kernel_id.h
+# are generated into O_PATH by the configurator, which is built from
+# cfg/ into O_PATH as well unless CFG names one already built.
+#
+# Run time options (environment):
+#   JSP_SIM_TICKS=n     call kernel_exit() after n ticks (1 ms each by default)
+#   JSP_SIM_REALTIME=1  drive the tick from SIGALRM instead of virtual time
+
+ifndef TOPPERS_ROOT
+TOPPERS_ROOT := $(dir $(lastword $(MAKEFILE_LIST)))../..
+endif
+
+CC = gcc
+CXX = g++
+O_PATH ?= build
+CFG ?= $(O_PATH)/cfg
+
+TOPPERS_INC_PATH = \
+	$(TOPPERS_ROOT)/kernel \
+	$(TOPPERS_ROOT)/include \
+	$(TOPPERS_ROOT)/config/posix \
+	$(TOPPERS_ROOT)/config/posix/linux \
+	$(TOPPERS_ROOT)/systask \
+	$(ECROBOT_C_ROOT)
+
+TOPPERS_KERNEL_SOURCES = $(addprefix $(TOPPERS_ROOT)/kernel/, \
+	banner.c \
+	cyclic.c \
+	dataqueue.c \
+	eventflag.c \
+	exception.c \
+	interrupt.c \
+	mailbox.c \
+	mempfix.c \
+	mempvar.c \
+	messagebuf.c \
+	mutex.c \
+	semaphore.c \
+	startup.c \
+	sys_manage.c \
+	syslog.c \
+	task.c \
+	task_except.c \
+	task_manage.c \
+	task_sync.c \
+	time_event.c \
+	time_manage.c \
+	wait.c )
+
+TOPPERS_CONFIG_SOURCES = $(addprefix $(TOPPERS_ROOT)/config/posix/, \
+	cpu_config.c \
+	start.c )
+
+TOPPERS_CONFIG_SYS_SOURCES = $(addprefix $(TOPPERS_ROOT)/config/posix/linux/, \
+	sys_config.c )
+
+TOPPERS_SYSLIB_SOURCES = $(addprefix $(TOPPERS_ROOT)/library/, \
+	log_output.c \
+	strerror.c \
+	t_perror.c \
+	vasyslog.c )
+
+TOPPERS_SYSTASK_SOURCES = $(addprefix $(TOPPERS_ROOT)/systask/, \
+	timer.c )
+
+# TLSF allocator of the variable-size memory pools (mempvar.c)
+ECROBOT_C_ROOT = $(TOPPERS_ROOT)/../ecrobot/c
+ECROBOT_SOURCES = $(ECROBOT_C_ROOT)/tlsf.c
+
+TOPPERS_CFG_SOURCE = $(O_PATH)/kernel_cfg.c
+TOPPERS_CFG_HEADER = $(O_PATH)/kernel_id.h
+
+C_SOURCES = \
+	$(TOPPERS_KERNEL_SOURCES) \
+	$(TOPPERS_CONFIG_SOURCES) \
+	$(TOPPERS_CONFIG_SYS_SOURCES) \
+	$(TOPPERS_SYSLIB_SOURCES) \
+	$(TOPPERS_SYSTASK_SOURCES) \
+	$(ECROBOT_SOURCES) \
+	$(TARGET_SOURCES)
+
+C_OBJECTS = $(addprefix $(O_PATH)/,$(notdir $(C_SOURCES:.c=.o))) \
+	$(O_PATH)/kernel_cfg.o
+
+vpath %.c $(sort $(dir $(C_SOURCES)))
+
+INC_FLAGS = -I$(O_PATH) -I. $(addprefix -I,$(TOPPERS_INC_PATH)) \
+	$(addprefix -I,$(USER_INC_PATH))
+
+# VP_INT is a pointer on the host, and the system log library casts
+# integers to it
+CFLAGS = -O2 -g -Wall -Wno-int-to-pointer-cast -finput-charset=euc-jp \
+	$(INC_FLAGS) $(addprefix -D,$(USER_DEF)) $(USER_COPT)
+
+# Configurator (the same objects as cfg/Makefile)
+CFG_ROOT = $(TOPPERS_ROOT)/cfg
+CFG_SOURCES = $(addprefix $(CFG_ROOT)/base/, \
+	parser.cpp mpstrstream.cpp manager.cpp directorymap.cpp \
+	message.cpp garbage.cpp component.cpp singleton.cpp except.cpp \
+	event.cpp collection.cpp option.cpp) \
+	$(addprefix $(CFG_ROOT)/jsp/, \
+	jsp_checkscript.cpp jsp_parser.cpp jsp_staticapi.cpp jsp_common.cpp)
+CFG_CXXFLAGS = -O2 -std=gnu++98 -w -DFILECONTAINER_BINUTILS -I$(CFG_ROOT)
+
+.PHONY: all
+all: $(TARGET)
+
+$(TARGET): $(C_OBJECTS)
+	$(CC) -o $@ $(C_OBJECTS) $(USER_LIB)
+
+$(O_PATH)/%.o: %.c $(TOPPERS_CFG_HEADER)
+	$(CC) -c $(CFLAGS) -o $@ $<
+
+$(O_PATH)/kernel_cfg.o: $(TOPPERS_CFG_SOURCE)
+	$(CC) -c $(CFLAGS) -o $@ $<
+
+# The configurator writes both files into the current directory
+$(TOPPERS_CFG_HEADER): $(TOPPERS_JSP_CFG_SOURCE) $(CFG)
+	@mkdir -p $(O_PATH)
+	$(CC) -E -x c-header $(TOPPERS_JSP_CFG_SOURCE) $(INC_FLAGS) \
+		$(addprefix -D,$(USER_DEF)) > $(O_PATH)/tmpfile1
+	cd $(O_PATH) && $(abspath $(CFG)) -s tmpfile1
+
+$(TOPPERS_CFG_SOURCE): $(TOPPERS_CFG_HEADER)
+
+ifeq ($(CFG),$(O_PATH)/cfg)
+$(CFG): $(CFG_SOURCES)
+	@mkdir -p $(O_PATH)
+	$(CXX) $(CFG_CXXFLAGS) -o $@ $(CFG_SOURCES)
+endif
+
+.PHONY: clean
+clean:
+	@echo "Removing kernel config files and objects"
+	@rm -rf $(O_PATH)
+	@rm -f $(TARGET)
@@ -0,0 +1,220 @@
+/* mbfbench.c for the POSIX host simulation of TOPPERS/JSP
+ *
+ * Throughput of the message buffer against the data queue. For each
+ * message size, SENDER_TASK passes MSG_COUNT messages to
+ * RECEIVER_TASK, at the same priority, in four ways:
+ *   dtq    snd_dtq / rcv_dtq, one call per VP_INT of the message
+ *   mbf    snd_mbf / rcv_mbf
+ *   batch  vbsnd_mbf / vbrcv_mbf, BATCH messages per call
+ *   zcopy  vrsv_mbf and vcmt_mbf / vpek_mbf and vfre_mbf, the sender
+ *          writing the message into the ring
+ * The sender blocks, or yields with rot_rdq for the polling calls,
+ * when the queue is full, and the receiver when it is empty. The first
+ * word of every message is its sequence number, which the receiver
+ * checks.
+ *
+ * It prints the time per message in TSC cycles (nanoseconds where
+ * there is no TSC), from the wake-up of both tasks by MAIN_TASK to the
+ * last message received.
+ */
+#include <stdio.h>
+#include <time.h>
+#include <t_services.h>
+#include "kernel_id.h"
+#include "mbfbench.h"
+
+#define BATCH		16
+
+enum { MODE_DTQ, MODE_MBF, MODE_BATCH, MODE_ZCOPY, TNUM_MODE };
+
+static const UINT msgsz_table[] = { 8, 32, MAX_MSGSZ };
+
+#define TNUM_MSGSZ	(sizeof(msgsz_table) / sizeof(msgsz_table[0]))
+
+static UINT mode;
+static UINT msgsz;
+static UINT errors;
+
+static UW send_buf[BATCH * MAX_MSGSZ / sizeof(UW)];
+static UW receive_buf[BATCH * MAX_MSGSZ / sizeof(UW)];
+
+static unsigned long long timestamp(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return (unsigned long long) __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ull
+		+ (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+/* Message i of a batch in send_buf or receive_buf */
+#define MSG(buf, i)	((UW *)((VB *)(buf) + (i) * msgsz))
+
+static void check(UW *msg, UINT seq)
+{
+	if (msg[0] != (UW) seq) errors++;
+}
+
+void sender_task(VP_INT exinf)
+{
+	UINT	nwords, seq, i, n, w;
+	ER_UINT	ercd;
+	VP	p;
+
+	for (;;)
+	{
+		slp_tsk();
+		nwords = (msgsz + sizeof(VP_INT) - 1) / sizeof(VP_INT);
+		switch (mode)
+		{
+		case MODE_DTQ:
+			for (seq = 0; seq < MSG_COUNT; seq++)
+			{
+				snd_dtq(DTQ, (VP_INT)(SIZE) seq);
+				for (w = 1; w < nwords; w++)
+				{
+					snd_dtq(DTQ, (VP_INT)(SIZE) w);
+				}
+			}
+			break;
+		case MODE_MBF:
+			for (seq = 0; seq < MSG_COUNT; seq++)
+			{
+				send_buf[0] = (UW) seq;
+				snd_mbf(MBF, send_buf, msgsz);
+			}
+			break;
+		case MODE_BATCH:
+			for (seq = 0; seq < MSG_COUNT; seq += n)
+			{
+				n = MSG_COUNT - seq < BATCH ? MSG_COUNT - seq : BATCH;
+				for (i = 0; i < n; i++)
+				{
+					MSG(send_buf, i)[0] = (UW)(seq + i);
+				}
+				for (i = 0; i < n; i += (UINT) ercd)
+				{
+					while ((ercd = vbsnd_mbf(MBF, MSG(send_buf, i),
+								msgsz, n - i)) < 0)
+					{
+						rot_rdq(TPRI_SELF);
+					}
+				}
+			}
+			break;
+		case MODE_ZCOPY:
+			for (seq = 0; seq < MSG_COUNT; seq++)
+			{
+				while (vrsv_mbf(MBF, &p, msgsz) != E_OK)
+				{
+					rot_rdq(TPRI_SELF);
+				}
+				((UW *) p)[0] = (UW) seq;
+				for (w = 1; w < msgsz / sizeof(UW); w++)
+				{
+					((UW *) p)[w] = (UW) w;
+				}
+				vcmt_mbf(MBF, msgsz);
+			}
+			break;
+		}
+	}
+}
+
+void receiver_task(VP_INT exinf)
+{
+	UINT	nwords, seq, i, w;
+	ER_UINT	ercd;
+	VP_INT	data;
+	VP	p;
+
+	for (;;)
+	{
+		slp_tsk();
+		nwords = (msgsz + sizeof(VP_INT) - 1) / sizeof(VP_INT);
+		switch (mode)
+		{
+		case MODE_DTQ:
+			for (seq = 0; seq < MSG_COUNT; seq++)
+			{
+				rcv_dtq(DTQ, &data);
+				if ((UINT)(SIZE) data != seq) errors++;
+				for (w = 1; w < nwords; w++)
+				{
+					rcv_dtq(DTQ, &data);
+				}
+			}
+			break;
+		case MODE_MBF:
+			for (seq = 0; seq < MSG_COUNT; seq++)
+			{
+				if (rcv_mbf(MBF, receive_buf) != (ER_UINT) msgsz) errors++;
+				check(receive_buf, seq);
+			}
+			break;
+		case MODE_BATCH:
+			for (seq = 0; seq < MSG_COUNT; seq += (UINT) ercd)
+			{
+				while ((ercd = vbrcv_mbf(MBF, receive_buf, msgsz,
+							BATCH)) < 0)
+				{
+					rot_rdq(TPRI_SELF);
+				}
+				for (i = 0; i < (UINT) ercd; i++)
+				{
+					check(MSG(receive_buf, i), seq + i);
+				}
+			}
+			break;
+		case MODE_ZCOPY:
+			for (seq = 0; seq < MSG_COUNT; seq++)
+			{
+				while ((ercd = vpek_mbf(MBF, &p)) < 0)
+				{
+					rot_rdq(TPRI_SELF);
+				}
+				if (ercd != (ER_UINT) msgsz) errors++;
+				check((UW *) p, seq);
+				vfre_mbf(MBF, p);
+			}
+			break;
+		}
+		wup_tsk(MAIN_TASK);
+	}
+}
+
+void main_task(VP_INT exinf)
+{
+	static const char *mode_name[TNUM_MODE] = { "dtq", "mbf", "batch", "zcopy" };
+	unsigned long long t0, t;
+	UINT	s;
+
+	printf("%-10s %4s", "mbfbench", "size");
+	for (mode = 0; mode < TNUM_MODE; mode++)
+	{
+		printf(" %10s", mode_name[mode]);
+	}
+	printf("\n");
+
+	for (s = 0; s < TNUM_MSGSZ; s++)
+	{
+		msgsz = msgsz_table[s];
+		printf("%-10s %4u", "", msgsz);
+		for (mode = 0; mode < TNUM_MODE; mode++)
+		{
+			t0 = timestamp();
+			wup_tsk(SENDER_TASK);
+			wup_tsk(RECEIVER_TASK);
+			slp_tsk();
+			t = timestamp() - t0;
+			printf(" %10llu", t / MSG_COUNT);
+		}
+		printf("\n");
+	}
+	if (errors > 0) printf("%u messages received wrong\n", errors);
+	kernel_exit();
+}
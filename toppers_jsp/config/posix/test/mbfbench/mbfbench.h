@@ -0,0 +1,22 @@
+/* mbfbench.h for the POSIX host simulation of TOPPERS/JSP */
+
+#ifndef _MBFBENCH_H_
+#define _MBFBENCH_H_
+
+#define MSG_COUNT	100000	/* messages moved per measurement */
+#define MAX_MSGSZ	128	/* largest message size measured */
+#define MBF_SIZE	4096	/* ring size of the message buffer */
+#define DTQ_COUNT	512	/* number of data queue entries */
+
+#define MAIN_PRIORITY	1
+#define TASK_PRIORITY	5
+#define STACK_SIZE	4096
+
+#ifndef _MACRO_ONLY
+
+extern void	main_task(VP_INT exinf);
+extern void	sender_task(VP_INT exinf);
+extern void	receiver_task(VP_INT exinf);
+
+#endif /* _MACRO_ONLY */
+#endif /* _MBFBENCH_H_ */
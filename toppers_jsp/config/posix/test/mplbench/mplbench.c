@@ -0,0 +1,185 @@
+/* mplbench.c for the POSIX host simulation of TOPPERS/JSP
+ *
+ * Timing and fragmentation of the TLSF variable-size memory pool. A
+ * random sequence of STEPS operations works on SLOTS blocks: an empty
+ * slot gets a block of 16 to 2047 bytes, smaller sizes being more
+ * likely, with pget_mpl, and a full one gives its block back with
+ * rel_mpl. The pool is about twice as large as the blocks in use on
+ * average.
+ *
+ * It prints the time of pget_mpl and rel_mpl in TSC cycles
+ * (nanoseconds where there is no TSC), and that of malloc and free of
+ * the host C library on the same sequence, for comparison. The maxima
+ * also take in the times the host preempts the simulation. The
+ * fragmentation ratio of vref_mpl is sampled every SAMPLE steps.
+ * Failed allocations are counted, and those that failed although the
+ * free space was enough are counted apart: only fragmentation made
+ * them fail.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <t_services.h>
+#include "kernel_id.h"
+#include "mplbench.h"
+
+#define STEPS		200000
+#define SLOTS		128
+#define SAMPLE		100
+
+typedef struct
+{
+	const char *name;
+	UINT count;
+	unsigned long long total;
+	unsigned long long min;
+	unsigned long long max;
+} TIMING;
+
+static TIMING stat_get = { "pget_mpl", 0, 0, ~0ull, 0 };
+static TIMING stat_rel = { "rel_mpl", 0, 0, ~0ull, 0 };
+static TIMING stat_malloc = { "malloc", 0, 0, ~0ull, 0 };
+static TIMING stat_free = { "free", 0, 0, ~0ull, 0 };
+
+static VP blocks[SLOTS];
+
+static unsigned long long timestamp(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return (unsigned long long) __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ull
+		+ (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void add(TIMING *stat, unsigned long long t)
+{
+	stat->count++;
+	stat->total += t;
+	if (t < stat->min) stat->min = t;
+	if (t > stat->max) stat->max = t;
+}
+
+static void print(TIMING *stat)
+{
+	printf("%-10s %10u %10llu %10llu %10llu\n", stat->name, stat->count,
+		stat->min, stat->count > 0 ? stat->total / stat->count : 0ull,
+		stat->max);
+}
+
+static UW rnd(UW *seed, UW n)
+{
+	*seed = *seed * 1103515245u + 12345u;
+	return ((*seed >> 16) & 0x7fff) % n;
+}
+
+/* Block size: 16 << 0..6, plus up to as much again */
+static UINT block_size(UW *seed)
+{
+	UINT size = 16u << rnd(seed, 7);
+
+	return size + rnd(seed, size);
+}
+
+void main_task(VP_INT exinf)
+{
+	T_VRMPL	rmpl;
+	UW	seed;
+	UINT	step, slot, size;
+	UINT	failed = 0, frag_failed = 0, samples = 0, frag_total = 0;
+	UINT	frag_max = 0;
+	unsigned long long t0, t;
+	ER	ercd;
+
+	/* the kernel pool */
+	seed = 1;
+	for (step = 0; step < STEPS; step++)
+	{
+		slot = rnd(&seed, SLOTS);
+		if (blocks[slot] == NULL)
+		{
+			size = block_size(&seed);
+			t0 = timestamp();
+			ercd = pget_mpl(MPL, size, &blocks[slot]);
+			t = timestamp() - t0;
+			if (ercd == E_OK)
+			{
+				add(&stat_get, t);
+			}
+			else
+			{
+				blocks[slot] = NULL;
+				failed++;
+				vref_mpl(MPL, &rmpl);
+				if (rmpl.fmplsz >= size) frag_failed++;
+			}
+		}
+		else
+		{
+			t0 = timestamp();
+			rel_mpl(MPL, blocks[slot]);
+			t = timestamp() - t0;
+			add(&stat_rel, t);
+			blocks[slot] = NULL;
+		}
+		if (step % SAMPLE == 0)
+		{
+			vref_mpl(MPL, &rmpl);
+			samples++;
+			frag_total += rmpl.fragrt;
+			if (rmpl.fragrt > frag_max) frag_max = rmpl.fragrt;
+		}
+	}
+	vref_mpl(MPL, &rmpl);
+	for (slot = 0; slot < SLOTS; slot++)
+	{
+		if (blocks[slot] != NULL)
+		{
+			rel_mpl(MPL, blocks[slot]);
+			blocks[slot] = NULL;
+		}
+	}
+
+	/* the same sequence with the C library, which never runs out */
+	seed = 1;
+	for (step = 0; step < STEPS; step++)
+	{
+		slot = rnd(&seed, SLOTS);
+		if (blocks[slot] == NULL)
+		{
+			size = block_size(&seed);
+			t0 = timestamp();
+			blocks[slot] = malloc(size);
+			t = timestamp() - t0;
+			add(&stat_malloc, t);
+		}
+		else
+		{
+			t0 = timestamp();
+			free(blocks[slot]);
+			t = timestamp() - t0;
+			add(&stat_free, t);
+			blocks[slot] = NULL;
+		}
+	}
+	for (slot = 0; slot < SLOTS; slot++)
+	{
+		free(blocks[slot]);
+	}
+
+	printf("%-10s %10s %10s %10s %10s\n", "mplbench", "count", "min", "avg", "max");
+	print(&stat_get);
+	print(&stat_rel);
+	print(&stat_malloc);
+	print(&stat_free);
+	printf("fragmentation avg %u%%, max %u%%; high-water mark %lu of %u bytes\n",
+		frag_total / samples, frag_max, (unsigned long) rmpl.mmplsz,
+		MPL_SIZE);
+	printf("failed allocations %u, %u of them with enough free space\n",
+		failed, frag_failed);
+	kernel_exit();
+}
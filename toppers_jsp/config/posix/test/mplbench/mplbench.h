@@ -0,0 +1,16 @@
+/* mplbench.h for the POSIX host simulation of TOPPERS/JSP */
+
+#ifndef _MPLBENCH_H_
+#define _MPLBENCH_H_
+
+#define MPL_SIZE	65536	/* size of the memory pool */
+
+#define MAIN_PRIORITY	1
+#define STACK_SIZE	4096
+
+#ifndef _MACRO_ONLY
+
+extern void	main_task(VP_INT exinf);
+
+#endif /* _MACRO_ONLY */
+#endif /* _MPLBENCH_H_ */
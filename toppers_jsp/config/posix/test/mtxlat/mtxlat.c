@@ -0,0 +1,133 @@
+/* mtxlat.c for the POSIX host simulation of TOPPERS/JSP
+ *
+ * Blocking time of a high priority task on a lock held by a low
+ * priority task, while a middle priority task becomes ready.
+ *
+ * Every tick wakes LOW_TASK, which takes LOCK, wakes HIGH_TASK and
+ * MID_TASK, and works for CS_WORK in its critical section. HIGH_TASK
+ * then waits for LOCK, and MID_TASK works for MID_WORK times
+ * MTXLAT_LOAD. The blocking time runs from the wake-up of HIGH_TASK to
+ * the moment it holds LOCK.
+ *
+ * With a semaphore, MID_TASK preempts LOW_TASK in its critical section
+ * (an inversion), so the blocking time grows with MTXLAT_LOAD. With
+ * priority inheritance or a priority ceiling, MID_TASK only runs after
+ * HIGH_TASK, and the blocking time stays at the critical section.
+ *
+ * At the end it prints the blocking times, in TSC cycles (nanoseconds
+ * where there is no TSC), and the number of rounds in which MID_TASK
+ * ran before HIGH_TASK got LOCK. The maximum also takes in the times
+ * the host preempts the simulation, so compare the averages.
+ */
+#include <stdio.h>
+#include <time.h>
+#include <t_services.h>
+#include "kernel_id.h"
+#include "mtxlat.h"
+
+#ifndef MTXLAT_LOAD
+#define MTXLAT_LOAD	1
+#endif
+
+#define CS_WORK		2000
+#define MID_WORK	20000
+
+#if defined(MTXLAT_SEM)
+#define LOCK_NAME	"semaphore"
+#define lock()		wai_sem(LOCK)
+#define unlock()	sig_sem(LOCK)
+#elif defined(MTXLAT_CEILING)
+#define LOCK_NAME	"ceiling"
+#define lock()		loc_mtx(LOCK)
+#define unlock()	unl_mtx(LOCK)
+#else
+#define LOCK_NAME	"inherit"
+#define lock()		loc_mtx(LOCK)
+#define unlock()	unl_mtx(LOCK)
+#endif
+
+static unsigned long long t_wakeup;
+static BOOL mid_done;
+
+static UINT count;
+static UINT inversions;
+static unsigned long long total;
+static unsigned long long min = ~0ull;
+static unsigned long long max;
+
+static unsigned long long timestamp(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return (unsigned long long) __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ull
+		+ (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void work(UINT n)
+{
+	volatile UINT i;
+
+	for (i = 0; i < n; i++);
+}
+
+void tick_handler(VP_INT exinf)
+{
+	iwup_tsk(LOW_TASK);
+}
+
+void high_task(VP_INT exinf)
+{
+	unsigned long long t;
+
+	for (;;)
+	{
+		slp_tsk();
+		lock();
+		t = timestamp() - t_wakeup;
+		count++;
+		total += t;
+		if (t < min) min = t;
+		if (t > max) max = t;
+		if (mid_done) inversions++;
+		unlock();
+	}
+}
+
+void mid_task(VP_INT exinf)
+{
+	for (;;)
+	{
+		slp_tsk();
+		work(MID_WORK * MTXLAT_LOAD);
+		mid_done = TRUE;
+	}
+}
+
+void low_task(VP_INT exinf)
+{
+	UINT round;
+
+	for (round = 0; round < ROUNDS; round++)
+	{
+		slp_tsk();
+		lock();
+		mid_done = FALSE;
+		t_wakeup = timestamp();
+		wup_tsk(HIGH_TASK);
+		wup_tsk(MID_TASK);
+		work(CS_WORK);
+		unlock();
+	}
+
+	printf("%-10s %4s %10s %10s %10s %10s %10s\n", "mtxlat", "load",
+		"count", "min", "avg", "max", "inversions");
+	printf("%-10s %4u %10u %10llu %10llu %10llu %10u\n", LOCK_NAME,
+		(unsigned int) MTXLAT_LOAD, (unsigned int) count, min,
+		count > 0 ? total / count : 0ull, max, (unsigned int) inversions);
+	kernel_exit();
+}
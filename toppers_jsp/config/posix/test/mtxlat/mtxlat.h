@@ -0,0 +1,21 @@
+/* mtxlat.h for the POSIX host simulation of TOPPERS/JSP */
+
+#ifndef _MTXLAT_H_
+#define _MTXLAT_H_
+
+#define ROUNDS		1000	/* number of ticks measured */
+
+#define HIGH_PRIORITY	2
+#define MID_PRIORITY	5
+#define LOW_PRIORITY	10
+#define STACK_SIZE	1024
+
+#ifndef _MACRO_ONLY
+
+extern void	high_task(VP_INT exinf);
+extern void	mid_task(VP_INT exinf);
+extern void	low_task(VP_INT exinf);
+extern void	tick_handler(VP_INT exinf);
+
+#endif /* _MACRO_ONLY */
+#endif /* _MTXLAT_H_ */
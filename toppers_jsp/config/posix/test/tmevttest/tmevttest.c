@@ -0,0 +1,103 @@
+/* tmevttest.c for the POSIX host simulation of TOPPERS/JSP
+ *
+ * Cyclic handlers that re-arm themselves, some from initialization,
+ * and tasks sleeping with dly_tsk record the tick they run in. At the
+ * end of the run main_task prints, for each tick, the handlers and
+ * tasks that ran in it. Handlers due in the same tick run in an order
+ * that depends on the time event queue, so each tick is printed
+ * sorted. The timing wheel and the heaps must give the same timeline
+ * (see ../Makefile).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <t_services.h>
+#include "kernel_id.h"
+#include "tmevttest.h"
+
+#define LOG_SIZE	8192
+
+static struct {
+	UW	tick;
+	char	id;
+} event_log[LOG_SIZE];
+static UINT	event_count;
+
+static UW rnd(UW *seed, UW n)
+{
+	*seed = *seed * 1103515245u + 12345u;
+	return ((*seed >> 16) & 0x7fff) % n;
+}
+
+static void record(char id)
+{
+	BOOL locked = sns_loc();
+
+	if (!locked)
+	{
+		if (sns_ctx()) iloc_cpu(); else loc_cpu();
+	}
+	if (event_count < LOG_SIZE)
+	{
+		event_log[event_count].tick = sys_get_ticks();
+		event_log[event_count].id = id;
+		event_count++;
+	}
+	if (!locked)
+	{
+		if (sns_ctx()) iunl_cpu(); else unl_cpu();
+	}
+}
+
+void cyclic_handler(VP_INT exinf)
+{
+	record((char)(SIZE) exinf);
+}
+
+void delay_task(VP_INT exinf)
+{
+	RELTIM d = (RELTIM)(SIZE) exinf;
+	UW seed = (UW) d;	/* one sequence per task: tasks woken in the
+				   same tick may run in any order */
+	ID tskid;
+
+	get_tid(&tskid);
+	for (;;)
+	{
+		dly_tsk(d);
+		record((char)('0' + tskid));
+		if (d > 1) d = 1 + rnd(&seed, 130);
+	}
+}
+
+static int by_id(const void *a, const void *b)
+{
+	return *(const char *) a - *(const char *) b;
+}
+
+void main_task(VP_INT exinf)
+{
+	char line[64];
+	UINT i, j, n;
+
+	dly_tsk(100);
+	sta_cyc(CYC_E);
+	dly_tsk(200);
+	stp_cyc(CYC_E);
+	dly_tsk(RUN_TICKS - 300);
+
+	loc_cpu();
+	for (i = 0; i < event_count; i = j)
+	{
+		n = 0;
+		for (j = i; j < event_count && event_log[j].tick == event_log[i].tick; j++)
+		{
+			if (n < sizeof(line) - 1) line[n++] = event_log[j].id;
+		}
+		qsort(line, n, 1, by_id);
+		line[n] = '\0';
+		printf("%lu %s\n", (unsigned long) event_log[i].tick, line);
+	}
+	if (event_count >= LOG_SIZE) printf("log overflow\n");
+	unl_cpu();
+	kernel_exit();
+}
@@ -0,0 +1,19 @@
+/* tmevttest.h for the POSIX host simulation of TOPPERS/JSP */
+
+#ifndef _TMEVTTEST_H_
+#define _TMEVTTEST_H_
+
+#define RUN_TICKS	1000	/* length of the run */
+
+#define MAIN_PRIORITY	1
+#define TASK_PRIORITY	5
+#define STACK_SIZE	1024
+
+#ifndef _MACRO_ONLY
+
+extern void	main_task(VP_INT exinf);
+extern void	delay_task(VP_INT exinf);
+extern void	cyclic_handler(VP_INT exinf);
+
+#endif /* _MACRO_ONLY */
+#endif /* _TMEVTTEST_H_ */
@@ -0,0 +1,74 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	ȯĶ˰¸
+ *
+ *  Υ󥯥롼ɥեϡt_stddef.h  itron.h Ƭǥ󥯥롼
+ *  ɤ롥¾Υե뤫ľܥ󥯥롼ɤ뤳ȤϤʤ¾Υ
+ *  󥯥롼ɥեΩäƽ뤿ᡤ¾Υ󥯥롼ɥե
+ *  ˰¸ƤϤʤʤ
+ */
+
+#ifndef _TOOL_DEFS_H_
+#define _TOOL_DEFS_H_
+
+/*
+ *  ѥ¸Υǡ
+ */
+#define	_int8_		char		/* 8ӥåȤ */
+#define	_int16_		short		/* 16ӥåȤ */
+#define	_int32_		int		/* 32ӥåȤ */
+#define _int64_		long long	/* 64ӥåȤ */
+
+/*
+ *  ѥγĥǽΤΥޥ
+ */
+#ifndef __cplusplus			/* C++ ˤ inline  */
+#if __STDC_VERSION__ < 199901L		/* C99 ˤ inline  */
+#define	inline		__inline__
+#endif /* __STDC_VERSION__ < 199901L */
+#endif /* __cplusplus */
+
+#define	Inline		static inline
+
+#ifndef __cplusplus			/* C++ ˤ asm  */
+#define	asm		__asm__
+#endif /* __cplusplus */
+
+#define	Asm		__asm__ volatile
+
+#endif /* _TOOL_DEFS_H_ */
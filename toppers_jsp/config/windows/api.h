@@ -79,18 +79,56 @@
 #define __rcv_mbx
 #define __prcv_mbx
 #define __trcv_mbx
+#define __mbfini
+#define __mbfrsv
+#define __mbfcmt
+#define __mbfenq
+#define __mbffst
+#define __mbfdeq
+#define __mbfsnd
+#define __mbfrcv
+#define __mbfsig
+#define __snd_mbf
+#define __psnd_mbf
+#define __tsnd_mbf
+#define __rcv_mbf
+#define __prcv_mbf
+#define __trcv_mbf
+#define __vrsv_mbf
+#define __vcmt_mbf
+#define __vpek_mbf
+#define __vfre_mbf
+#define __vbsnd_mbf
+#define __vbrcv_mbf
 #define __mpfini
 #define __mpfget
 #define __get_mpf
 #define __pget_mpf
 #define __tget_mpf
 #define __rel_mpf
+#define __mplini
+#define __mplsig
+#define __get_mpl
+#define __pget_mpl
+#define __tget_mpl
+#define __rel_mpl
+#define __vref_mpl
 #define __semini
 #define __sig_sem
 #define __isig_sem
 #define __wai_sem
 #define __pol_sem
 #define __twai_sem
+#define __mtxini
+#define __mtxcalc
+#define __mtxpri
+#define __mtxchk
+#define __mtxupd
+#define __mtxrel
+#define __loc_mtx
+#define __ploc_mtx
+#define __tloc_mtx
+#define __unl_mtx
 #define __rot_rdq
 #define __irot_rdq
 #define __get_tid
@@ -110,6 +110,15 @@ typedef	struct t_msg_pri {		/* ͥ
 	PRI		msgpri;		/* åͥ */
 } T_MSG_PRI;
 
+typedef	struct t_vrmpl {		/* Ĺסξ */
+	ID		wtskid;		/* ԤƬΥID */
+	SIZE		fmplsz;		/* ΰιץ */
+	UINT		fblksz;		/* ζ֥åΥ */
+	SIZE		umplsz;		/* ΰιץ */
+	SIZE		mmplsz;		/* ΰκ */
+	UINT		fragrt;		/* ҲΨ%*/
+} T_VRMPL;
+
 #endif /* _MACRO_ONLY */
 
 /*
@@ -186,6 +195,21 @@ extern ER	rcv_mbx(ID mbxid, T_MSG **ppk_msg) throw();
 extern ER	prcv_mbx(ID mbxid, T_MSG **ppk_msg) throw();
 extern ER	trcv_mbx(ID mbxid, T_MSG **ppk_msg, TMO tmout) throw();
 
+/*
+ *  ĥƱ̿ǽ
+ */
+extern ER	loc_mtx(ID mtxid) throw();
+extern ER	ploc_mtx(ID mtxid) throw();
+extern ER	tloc_mtx(ID mtxid, TMO tmout) throw();
+extern ER	unl_mtx(ID mtxid) throw();
+
+extern ER	snd_mbf(ID mbfid, VP msg, UINT msgsz) throw();
+extern ER	psnd_mbf(ID mbfid, VP msg, UINT msgsz) throw();
+extern ER	tsnd_mbf(ID mbfid, VP msg, UINT msgsz, TMO tmout) throw();
+extern ER_UINT	rcv_mbf(ID mbfid, VP msg) throw();
+extern ER_UINT	prcv_mbf(ID mbfid, VP msg) throw();
+extern ER_UINT	trcv_mbf(ID mbfid, VP msg, TMO tmout) throw();
+
 /*
  *  סǽ
  */
@@ -194,6 +218,11 @@ extern ER	pget_mpf(ID mpfid, VP *p_blk) throw();
 extern ER	tget_mpf(ID mpfid, VP *p_blk, TMO tmout) throw();
 extern ER	rel_mpf(ID mpfid, VP blk) throw();
 
+extern ER	get_mpl(ID mplid, UINT blksz, VP *p_blk) throw();
+extern ER	pget_mpl(ID mplid, UINT blksz, VP *p_blk) throw();
+extern ER	tget_mpl(ID mplid, UINT blksz, VP *p_blk, TMO tmout) throw();
+extern ER	rel_mpl(ID mplid, VP blk) throw();
+
 /*
  *  ִǽ
  */
@@ -232,6 +261,15 @@ extern BOOL	vxsns_dpn(VP p_excinf) throw();
 extern BOOL	vxsns_tex(VP p_excinf) throw();
 extern BOOL	vsns_ini(void) throw();
 
+extern ER	vrsv_mbf(ID mbfid, VP *p_msg, UINT msgsz) throw();
+extern ER	vcmt_mbf(ID mbfid, UINT msgsz) throw();
+extern ER_UINT	vpek_mbf(ID mbfid, VP *p_msg) throw();
+extern ER	vfre_mbf(ID mbfid, VP msg) throw();
+extern ER_UINT	vbsnd_mbf(ID mbfid, VP msg, UINT msgsz, UINT msgcnt) throw();
+extern ER_UINT	vbrcv_mbf(ID mbfid, VP msg, UINT msgsz, UINT msgcnt) throw();
+
+extern ER	vref_mpl(ID mplid, T_VRMPL *pk_rmpl) throw();
+
 #endif /* _MACRO_ONLY */
 
 /*
@@ -242,6 +280,8 @@ extern BOOL	vsns_ini(void) throw();
 
 #define TA_TFIFO	0x00u		/* ԤFIFO */
 #define TA_TPRI		0x01u		/* Ԥͥٽ */
+#define TA_INHERIT	0x02u		/* ͥٷѾץȥ */
+#define TA_CEILING	0x03u		/* ͥپ¥ץȥ */
 
 #define TA_MFIFO	0x00u		/* å塼FIFO */
 #define TA_MPRI		0x02u		/* å塼ͥٽ */
@@ -302,6 +342,12 @@ extern BOOL	vsns_ini(void) throw();
 #define	TBIT_FLGPTN	(sizeof(FLGPTN) * CHAR_BIT)
 					/* ٥ȥե饰Υӥåȿ */
 
+/*
+ *  ΰݤΤΥޥ
+ */
+#define	TSZ_MBF(msgcnt, msgsz)	((msgcnt) * (sizeof(VP) + TROUND_VP(msgsz)))
+					/* åХåեΰΥ */
+
 #ifdef __cplusplus
 }
 #endif
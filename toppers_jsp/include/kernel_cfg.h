@@ -53,10 +53,13 @@
  */
 #include <../kernel/task.h>
 #include <../kernel/semaphore.h>
+#include <../kernel/mutex.h>
 #include <../kernel/eventflag.h>
 #include <../kernel/dataqueue.h>
 #include <../kernel/mailbox.h>
+#include <../kernel/messagebuf.h>
 #include <../kernel/mempfix.h>
+#include <../kernel/mempvar.h>
 #include <../kernel/cyclic.h>
 #include <../kernel/interrupt.h>
 #include <../kernel/exception.h>
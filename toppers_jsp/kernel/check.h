@@ -102,6 +102,9 @@
 #define VALID_SEMID(semid) \
 	(TMIN_SEMID <= (semid) && (semid) <= tmax_semid)
 
+#define VALID_MTXID(mtxid) \
+	(TMIN_MTXID <= (mtxid) && (mtxid) <= tmax_mtxid)
+
 #define VALID_FLGID(flgid) \
 	(TMIN_FLGID <= (flgid) && (flgid) <= tmax_flgid)
 
@@ -111,9 +114,15 @@
 #define VALID_MBXID(mbxid) \
 	(TMIN_MBXID <= (mbxid) && (mbxid) <= tmax_mbxid)
 
+#define VALID_MBFID(mbfid) \
+	(TMIN_MBFID <= (mbfid) && (mbfid) <= tmax_mbfid)
+
 #define VALID_MPFID(mpfid) \
 	(TMIN_MPFID <= (mpfid) && (mpfid) <= tmax_mpfid)
 
+#define VALID_MPLID(mplid) \
+	(TMIN_MPLID <= (mplid) && (mplid) <= tmax_mplid)
+
 #define VALID_CYCID(cycid) \
 	(TMIN_CYCID <= (cycid) && (cycid) <= tmax_cycid)
 
@@ -141,6 +150,13 @@
 	}							\
 }
 
+#define CHECK_MTXID(mtxid) {					\
+	if (!VALID_MTXID(mtxid)) {				\
+		ercd = E_ID;					\
+		goto exit;					\
+	}							\
+}
+
 #define CHECK_FLGID(flgid) {					\
 	if (!VALID_FLGID(flgid)) {				\
 		ercd = E_ID;					\
@@ -162,6 +178,13 @@
 	}							\
 }
 
+#define CHECK_MBFID(mbfid) {					\
+	if (!VALID_MBFID(mbfid)) {				\
+		ercd = E_ID;					\
+		goto exit;					\
+	}							\
+}
+
 #define CHECK_MPFID(mpfid) {					\
 	if (!VALID_MPFID(mpfid)) {				\
 		ercd = E_ID;					\
@@ -169,6 +192,13 @@
 	}							\
 }
 
+#define CHECK_MPLID(mplid) {					\
+	if (!VALID_MPLID(mplid)) {				\
+		ercd = E_ID;					\
+		goto exit;					\
+	}							\
+}
+
 #define CHECK_CYCID(cycid) {					\
 	if (!VALID_CYCID(cycid)) {				\
 		ercd = E_ID;					\
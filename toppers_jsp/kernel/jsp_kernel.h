@@ -70,10 +70,13 @@
  */
 #define	TMIN_TSKID	1	/* IDκǾ */
 #define	TMIN_SEMID	1	/* ޥեIDκǾ */
+#define	TMIN_MTXID	1	/* ߥ塼ƥåIDκǾ */
 #define	TMIN_FLGID	1	/* ե饰IDκǾ */
 #define	TMIN_DTQID	1	/* ǡ塼IDκǾ */
 #define	TMIN_MBXID	1	/* ᡼ܥåIDκǾ */
+#define	TMIN_MBFID	1	/* åХåեIDκǾ */
 #define	TMIN_MPFID	1	/* ĹסIDκǾ */
+#define	TMIN_MPLID	1	/* ĹסIDκǾ */
 #define	TMIN_CYCID	1	/* ϥɥIDκǾ */
 
 /*
@@ -71,6 +71,10 @@
 #define tmevt_down		_kernel_tmevt_down
 #define tmevtb_insert		_kernel_tmevtb_insert
 #define tmevtb_delete		_kernel_tmevtb_delete
+#define tmevt_wheel_first	_kernel_tmevt_wheel_first
+#define tmevt_wheel_last	_kernel_tmevt_wheel_last
+#define tmevt_wheel_next	_kernel_tmevt_wheel_next
+#define tmevt_wheel_time	_kernel_tmevt_wheel_time
 
 /*
  *  syslog.c
@@ -90,6 +94,16 @@
  */
 #define semaphore_initialize	_kernel_semaphore_initialize
 
+/*
+ *  mutex.c
+ */
+#define mutex_initialize	_kernel_mutex_initialize
+#define mutex_calc_priority	_kernel_mutex_calc_priority
+#define mutex_change_priority	_kernel_mutex_change_priority
+#define mutex_check_ceilpri	_kernel_mutex_check_ceilpri
+#define mutex_update_owner	_kernel_mutex_update_owner
+#define mutex_release_all	_kernel_mutex_release_all
+
 /*
  *  eventflag.c
  */
@@ -111,12 +125,31 @@
  */
 #define mailbox_initialize	_kernel_mailbox_initialize
 
+/*
+ *  messagebuf.c
+ */
+#define messagebuf_initialize	_kernel_messagebuf_initialize
+#define reserve_message		_kernel_reserve_message
+#define commit_message		_kernel_commit_message
+#define enqueue_message		_kernel_enqueue_message
+#define first_message		_kernel_first_message
+#define dequeue_message		_kernel_dequeue_message
+#define send_message_rwait	_kernel_send_message_rwait
+#define receive_message_swait	_kernel_receive_message_swait
+#define messagebuf_signal	_kernel_messagebuf_signal
+
 /*
  *  mempfix.c
  */
 #define mempfix_initialize	_kernel_mempfix_initialize
 #define mempfix_get_block	_kernel_mempfix_get_block
 
+/*
+ *  mempvar.c
+ */
+#define mempvar_initialize	_kernel_mempvar_initialize
+#define mempvar_signal		_kernel_mempvar_signal
+
 /*
  *  cyclic.c
  */
@@ -147,6 +180,9 @@
 #define tmax_semid		_kernel_tmax_semid
 #define seminib_table		_kernel_seminib_table
 #define semcb_table		_kernel_semcb_table
+#define tmax_mtxid		_kernel_tmax_mtxid
+#define mtxinib_table		_kernel_mtxinib_table
+#define mtxcb_table		_kernel_mtxcb_table
 #define tmax_flgid		_kernel_tmax_flgid
 #define flginib_table		_kernel_flginib_table
 #define flgcb_table		_kernel_flgcb_table
@@ -156,9 +192,15 @@
 #define tmax_mbxid		_kernel_tmax_mbxid
 #define mbxcb_table		_kernel_mbxcb_table
 #define mbxinib_table		_kernel_mbxinib_table
+#define tmax_mbfid		_kernel_tmax_mbfid
+#define mbfcb_table		_kernel_mbfcb_table
+#define mbfinib_table		_kernel_mbfinib_table
 #define tmax_mpfid		_kernel_tmax_mpfid
 #define mpfinib_table		_kernel_mpfinib_table
 #define mpfcb_table		_kernel_mpfcb_table
+#define tmax_mplid		_kernel_tmax_mplid
+#define mplinib_table		_kernel_mplinib_table
+#define mplcb_table		_kernel_mplcb_table
 #define tmax_cycid		_kernel_tmax_cycid
 #define cycinib_table		_kernel_cycinib_table
 #define cyccb_table		_kernel_cyccb_table
@@ -238,6 +280,10 @@
 #define _tmevt_down		__kernel_tmevt_down
 #define _tmevtb_insert		__kernel_tmevtb_insert
 #define _tmevtb_delete		__kernel_tmevtb_delete
+#define _tmevt_wheel_first	__kernel_tmevt_wheel_first
+#define _tmevt_wheel_last	__kernel_tmevt_wheel_last
+#define _tmevt_wheel_next	__kernel_tmevt_wheel_next
+#define _tmevt_wheel_time	__kernel_tmevt_wheel_time
 
 /*
  *  syslog.c
@@ -257,6 +303,16 @@
  */
 #define _semaphore_initialize	__kernel_semaphore_initialize
 
+/*
+ *  mutex.c
+ */
+#define _mutex_initialize	__kernel_mutex_initialize
+#define _mutex_calc_priority	__kernel_mutex_calc_priority
+#define _mutex_change_priority	__kernel_mutex_change_priority
+#define _mutex_check_ceilpri	__kernel_mutex_check_ceilpri
+#define _mutex_update_owner	__kernel_mutex_update_owner
+#define _mutex_release_all	__kernel_mutex_release_all
+
 /*
  *  eventflag.c
  */
@@ -278,12 +334,31 @@
  */
 #define _mailbox_initialize	__kernel_mailbox_initialize
 
+/*
+ *  messagebuf.c
+ */
+#define _messagebuf_initialize	__kernel_messagebuf_initialize
+#define _reserve_message	__kernel_reserve_message
+#define _commit_message		__kernel_commit_message
+#define _enqueue_message	__kernel_enqueue_message
+#define _first_message		__kernel_first_message
+#define _dequeue_message	__kernel_dequeue_message
+#define _send_message_rwait	__kernel_send_message_rwait
+#define _receive_message_swait	__kernel_receive_message_swait
+#define _messagebuf_signal	__kernel_messagebuf_signal
+
 /*
  *  mempfix.c
  */
 #define _mempfix_initialize	__kernel_mempfix_initialize
 #define _mempfix_get_block	__kernel_mempfix_get_block
 
+/*
+ *  mempvar.c
+ */
+#define _mempvar_initialize	__kernel_mempvar_initialize
+#define _mempvar_signal		__kernel_mempvar_signal
+
 /*
  *  cyclic.c
  */
@@ -314,6 +389,9 @@
 #define _tmax_semid		__kernel_tmax_semid
 #define _seminib_table		__kernel_seminib_table
 #define _semcb_table		__kernel_semcb_table
+#define _tmax_mtxid		__kernel_tmax_mtxid
+#define _mtxinib_table		__kernel_mtxinib_table
+#define _mtxcb_table		__kernel_mtxcb_table
 #define _tmax_flgid		__kernel_tmax_flgid
 #define _flginib_table		__kernel_flginib_table
 #define _flgcb_table		__kernel_flgcb_table
@@ -323,9 +401,15 @@
 #define _tmax_mbxid		__kernel_tmax_mbxid
 #define _mbxcb_table		__kernel_mbxcb_table
 #define _mbxinib_table		__kernel_mbxinib_table
+#define _tmax_mbfid		__kernel_tmax_mbfid
+#define _mbfcb_table		__kernel_mbfcb_table
+#define _mbfinib_table		__kernel_mbfinib_table
 #define _tmax_mpfid		__kernel_tmax_mpfid
 #define _mpfinib_table		__kernel_mpfinib_table
 #define _mpfcb_table		__kernel_mpfcb_table
+#define _tmax_mplid		__kernel_tmax_mplid
+#define _mplinib_table		__kernel_mplinib_table
+#define _mplcb_table		__kernel_mplcb_table
 #define _tmax_cycid		__kernel_tmax_cycid
 #define _cycinib_table		__kernel_cycinib_table
 #define _cyccb_table		__kernel_cyccb_table
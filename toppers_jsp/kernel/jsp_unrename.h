@@ -71,6 +71,10 @@
 #undef tmevt_down
 #undef tmevtb_insert
 #undef tmevtb_delete
+#undef tmevt_wheel_first
+#undef tmevt_wheel_last
+#undef tmevt_wheel_next
+#undef tmevt_wheel_time
 
 /*
  *  syslog.c
@@ -90,6 +94,16 @@
  */
 #undef semaphore_initialize
 
+/*
+ *  mutex.c
+ */
+#undef mutex_initialize
+#undef mutex_calc_priority
+#undef mutex_change_priority
+#undef mutex_check_ceilpri
+#undef mutex_update_owner
+#undef mutex_release_all
+
 /*
  *  eventflag.c
  */
@@ -111,12 +125,31 @@
  */
 #undef mailbox_initialize
 
+/*
+ *  messagebuf.c
+ */
+#undef messagebuf_initialize
+#undef reserve_message
+#undef commit_message
+#undef enqueue_message
+#undef first_message
+#undef dequeue_message
+#undef send_message_rwait
+#undef receive_message_swait
+#undef messagebuf_signal
+
 /*
  *  mempfix.c
  */
 #undef mempfix_initialize
 #undef mempfix_get_block
 
+/*
+ *  mempvar.c
+ */
+#undef mempvar_initialize
+#undef mempvar_signal
+
 /*
  *  cyclic.c
  */
@@ -147,6 +180,9 @@
 #undef tmax_semid
 #undef seminib_table
 #undef semcb_table
+#undef tmax_mtxid
+#undef mtxinib_table
+#undef mtxcb_table
 #undef tmax_flgid
 #undef flginib_table
 #undef flgcb_table
@@ -156,9 +192,15 @@
 #undef tmax_mbxid
 #undef mbxcb_table
 #undef mbxinib_table
+#undef tmax_mbfid
+#undef mbfcb_table
+#undef mbfinib_table
 #undef tmax_mpfid
 #undef mpfinib_table
 #undef mpfcb_table
+#undef tmax_mplid
+#undef mplinib_table
+#undef mplcb_table
 #undef tmax_cycid
 #undef cycinib_table
 #undef cyccb_table
@@ -238,6 +280,10 @@
 #undef _tmevt_down
 #undef _tmevtb_insert
 #undef _tmevtb_delete
+#undef _tmevt_wheel_first
+#undef _tmevt_wheel_last
+#undef _tmevt_wheel_next
+#undef _tmevt_wheel_time
 
 /*
  *  syslog.c
@@ -257,6 +303,16 @@
  */
 #undef _semaphore_initialize
 
+/*
+ *  mutex.c
+ */
+#undef _mutex_initialize
+#undef _mutex_calc_priority
+#undef _mutex_change_priority
+#undef _mutex_check_ceilpri
+#undef _mutex_update_owner
+#undef _mutex_release_all
+
 /*
  *  eventflag.c
  */
@@ -278,12 +334,31 @@
  */
 #undef _mailbox_initialize
 
+/*
+ *  messagebuf.c
+ */
+#undef _messagebuf_initialize
+#undef _reserve_message
+#undef _commit_message
+#undef _enqueue_message
+#undef _first_message
+#undef _dequeue_message
+#undef _send_message_rwait
+#undef _receive_message_swait
+#undef _messagebuf_signal
+
 /*
  *  mempfix.c
  */
 #undef _mempfix_initialize
 #undef _mempfix_get_block
 
+/*
+ *  mempvar.c
+ */
+#undef _mempvar_initialize
+#undef _mempvar_signal
+
 /*
  *  cyclic.c
  */
@@ -314,6 +389,9 @@
 #undef _tmax_semid
 #undef _seminib_table
 #undef _semcb_table
+#undef _tmax_mtxid
+#undef _mtxinib_table
+#undef _mtxcb_table
 #undef _tmax_flgid
 #undef _flginib_table
 #undef _flgcb_table
@@ -323,9 +401,15 @@
 #undef _tmax_mbxid
 #undef _mbxcb_table
 #undef _mbxinib_table
+#undef _tmax_mbfid
+#undef _mbfcb_table
+#undef _mbfinib_table
 #undef _tmax_mpfid
 #undef _mpfinib_table
 #undef _mpfcb_table
+#undef _tmax_mplid
+#undef _mplinib_table
+#undef _mplcb_table
 #undef _tmax_cycid
 #undef _cycinib_table
 #undef _cyccb_table
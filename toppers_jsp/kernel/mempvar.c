@@ -0,0 +1,353 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	Variable-size memory pools
+ *
+ *  The area of mplsz bytes given to CRE_MPL is managed by the TLSF
+ *  allocator (tlsf.c): get_mpl and rel_mpl take a bounded time whatever
+ *  the number and sizes of the blocks in the pool.  Each block costs
+ *  TLSF_OVERHEAD bytes of header and is rounded up to TLSF_ALIGN bytes.
+ *
+ *  Tasks waiting for a block are queued in the order given by the
+ *  attribute (TA_TFIFO or TA_TPRI) and are served strictly in queue
+ *  order: a block is not given to a task while another task is waiting
+ *  before it, even if it would fit.  When the first task stops waiting
+ *  because of a timeout or rel_wai, the tasks behind it are served when
+ *  it runs again; after ter_tsk or chg_pri they are served at the next
+ *  rel_mpl.
+ *
+ *  vref_mpl is an implementation specific service call returning the
+ *  usage and the fragmentation of a pool.
+ */
+
+#include "jsp_kernel.h"
+#include "check.h"
+#include "task.h"
+#include "wait.h"
+#include "mempvar.h"
+
+/*
+ *  Maximum variable-size memory pool ID (kernel_cfg.c)
+ */
+extern const ID	tmax_mplid;
+
+/*
+ *  Variable-size memory pool initialization blocks (kernel_cfg.c)
+ */
+extern const MPLINIB	mplinib_table[];
+
+/*
+ *  Variable-size memory pool control blocks (kernel_cfg.c)
+ */
+extern MPLCB	mplcb_table[];
+
+/*
+ *  Number of variable-size memory pools
+ */
+#define TNUM_MPL	((UINT)(tmax_mplid - TMIN_MPLID + 1))
+
+/*
+ *  Variable-size memory pool control block from a memory pool ID
+ */
+#define INDEX_MPL(mplid)	((UINT)((mplid) - TMIN_MPLID))
+#define get_mplcb(mplid)	(&(mplcb_table[INDEX_MPL(mplid)]))
+
+/*
+ *  Waiting information block
+ */
+typedef struct variable_memorypool_waiting_information {
+	WINFO	winfo;		/* standard waiting information */
+	WOBJCB	*wobjcb;	/* control block of the waited object */
+	UINT	blksz;		/* requested block size */
+	VP	blk;		/* allocated block */
+} WINFO_MPL;
+
+/*
+ *  Initialization
+ */
+#ifdef __mplini
+
+void
+mempvar_initialize(void)
+{
+	UINT	i;
+	MPLCB	*mplcb;
+
+	for (mplcb = mplcb_table, i = 0; i < TNUM_MPL; mplcb++, i++) {
+		queue_initialize(&(mplcb->wait_queue));
+		mplcb->mplinib = &(mplinib_table[i]);
+		tlsf_init(&(mplcb->tlsf));
+		tlsf_add_area(&(mplcb->tlsf), mplcb->mplinib->mpl,
+						mplcb->mplinib->mplsz);
+	}
+}
+
+#endif /* __mplini */
+
+/*
+ *  Give blocks to the tasks waiting for one
+ */
+#ifdef __mplsig
+
+BOOL
+mempvar_signal(MPLCB *mplcb)
+{
+	TCB	*tcb;
+	WINFO_MPL *winfo;
+	VP	blk;
+	BOOL	dspreq = FALSE;
+
+	while (!(queue_empty(&(mplcb->wait_queue)))) {
+		tcb = (TCB *)(mplcb->wait_queue.next);
+		winfo = (WINFO_MPL *)(tcb->winfo);
+		if ((blk = tlsf_malloc(&(mplcb->tlsf), winfo->blksz)) == NULL) {
+			break;
+		}
+		queue_delete(&(tcb->task_queue));
+		winfo->blk = blk;
+		if (wait_complete(tcb)) {
+			dspreq = TRUE;
+		}
+	}
+	return(dspreq);
+}
+
+#endif /* __mplsig */
+
+/*
+ *  Get a block
+ */
+#ifdef __get_mpl
+
+SYSCALL ER
+get_mpl(ID mplid, UINT blksz, VP *p_blk)
+{
+	MPLCB	*mplcb;
+	WINFO_MPL winfo;
+	ER	ercd;
+
+	LOG_GET_MPL_ENTER(mplid, blksz, p_blk);
+	CHECK_DISPATCH();
+	CHECK_MPLID(mplid);
+	mplcb = get_mplcb(mplid);
+	CHECK_PAR(0 < blksz && blksz <= mplcb->mplinib->mplsz);
+
+	t_lock_cpu();
+	if (queue_empty(&(mplcb->wait_queue))
+		&& (*p_blk = tlsf_malloc(&(mplcb->tlsf), blksz)) != NULL) {
+		ercd = E_OK;
+	}
+	else {
+		winfo.blksz = blksz;
+		wobj_make_wait((WOBJCB *) mplcb, (WINFO_WOBJ *) &winfo);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+		if (ercd == E_OK) {
+			*p_blk = winfo.blk;
+		}
+		else if (mempvar_signal(mplcb)) {
+			dispatch();
+		}
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_GET_MPL_LEAVE(ercd, *p_blk);
+	return(ercd);
+}
+
+#endif /* __get_mpl */
+
+/*
+ *  Get a block (polling)
+ */
+#ifdef __pget_mpl
+
+SYSCALL ER
+pget_mpl(ID mplid, UINT blksz, VP *p_blk)
+{
+	MPLCB	*mplcb;
+	ER	ercd;
+
+	LOG_PGET_MPL_ENTER(mplid, blksz, p_blk);
+	CHECK_TSKCTX_UNL();
+	CHECK_MPLID(mplid);
+	mplcb = get_mplcb(mplid);
+	CHECK_PAR(0 < blksz && blksz <= mplcb->mplinib->mplsz);
+
+	t_lock_cpu();
+	if (queue_empty(&(mplcb->wait_queue))
+		&& (*p_blk = tlsf_malloc(&(mplcb->tlsf), blksz)) != NULL) {
+		ercd = E_OK;
+	}
+	else {
+		ercd = E_TMOUT;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_PGET_MPL_LEAVE(ercd, *p_blk);
+	return(ercd);
+}
+
+#endif /* __pget_mpl */
+
+/*
+ *  Get a block (with timeout)
+ */
+#ifdef __tget_mpl
+
+SYSCALL ER
+tget_mpl(ID mplid, UINT blksz, VP *p_blk, TMO tmout)
+{
+	MPLCB	*mplcb;
+	WINFO_MPL winfo;
+	TMEVTB	tmevtb;
+	ER	ercd;
+
+	LOG_TGET_MPL_ENTER(mplid, blksz, p_blk, tmout);
+	CHECK_DISPATCH();
+	CHECK_MPLID(mplid);
+	CHECK_TMOUT(tmout);
+	mplcb = get_mplcb(mplid);
+	CHECK_PAR(0 < blksz && blksz <= mplcb->mplinib->mplsz);
+
+	t_lock_cpu();
+	if (queue_empty(&(mplcb->wait_queue))
+		&& (*p_blk = tlsf_malloc(&(mplcb->tlsf), blksz)) != NULL) {
+		ercd = E_OK;
+	}
+	else if (tmout == TMO_POL) {
+		ercd = E_TMOUT;
+	}
+	else {
+		winfo.blksz = blksz;
+		wobj_make_wait_tmout((WOBJCB *) mplcb, (WINFO_WOBJ *) &winfo,
+						&tmevtb, tmout);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+		if (ercd == E_OK) {
+			*p_blk = winfo.blk;
+		}
+		else if (mempvar_signal(mplcb)) {
+			dispatch();
+		}
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_TGET_MPL_LEAVE(ercd, *p_blk);
+	return(ercd);
+}
+
+#endif /* __tget_mpl */
+
+/*
+ *  Release a block
+ */
+#ifdef __rel_mpl
+
+SYSCALL ER
+rel_mpl(ID mplid, VP blk)
+{
+	MPLCB	*mplcb;
+	ER	ercd;
+
+	LOG_REL_MPL_ENTER(mplid, blk);
+	CHECK_TSKCTX_UNL();
+	CHECK_MPLID(mplid);
+	mplcb = get_mplcb(mplid);
+	CHECK_PAR(mplcb->mplinib->mpl < blk
+		&& (VB *) blk < (VB *)(mplcb->mplinib->mpl)
+						+ mplcb->mplinib->mplsz
+		&& ((SIZE) blk & (TLSF_ALIGN - 1)) == 0);
+
+	t_lock_cpu();
+	if (tlsf_free(&(mplcb->tlsf), blk) < 0) {
+		ercd = E_PAR;
+	}
+	else {
+		if (mempvar_signal(mplcb)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_REL_MPL_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __rel_mpl */
+
+/*
+ *  Usage of a pool
+ */
+#ifdef __vref_mpl
+
+SYSCALL ER
+vref_mpl(ID mplid, T_VRMPL *pk_rmpl)
+{
+	MPLCB	*mplcb;
+	TLSF_STAT stat;
+	ER	ercd;
+
+	LOG_VREF_MPL_ENTER(mplid, pk_rmpl);
+	CHECK_TSKCTX_UNL();
+	CHECK_MPLID(mplid);
+	mplcb = get_mplcb(mplid);
+
+	t_lock_cpu();
+	tlsf_stat(&(mplcb->tlsf), &stat);
+	pk_rmpl->wtskid = queue_empty(&(mplcb->wait_queue)) ? TSK_NONE
+				: TSKID((TCB *)(mplcb->wait_queue.next));
+	t_unlock_cpu();
+
+	pk_rmpl->fmplsz = stat.free;
+	pk_rmpl->fblksz = stat.largest;
+	pk_rmpl->umplsz = stat.used;
+	pk_rmpl->mmplsz = stat.max_used;
+	pk_rmpl->fragrt = stat.frag;
+	ercd = E_OK;
+
+    exit:
+	LOG_VREF_MPL_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __vref_mpl */
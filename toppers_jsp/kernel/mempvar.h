@@ -0,0 +1,79 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	Variable-size memory pools
+ */
+
+#ifndef _MEMPVAR_H_
+#define _MEMPVAR_H_
+
+#include "queue.h"
+#include "tlsf.h"
+
+/*
+ *  Variable-size memory pool initialization block
+ */
+typedef struct variable_memorypool_initialization_block {
+	ATR	mplatr;		/* memory pool attribute */
+	SIZE	mplsz;		/* size of the pool area */
+	VP	mpl;		/* start address of the pool area */
+} MPLINIB;
+
+/*
+ *  Variable-size memory pool control block
+ */
+typedef struct variable_memorypool_control_block {
+	QUEUE	wait_queue;	/* tasks waiting for a block */
+	const MPLINIB *mplinib;	/* initialization block */
+	TLSF_POOL tlsf;		/* free blocks of the pool */
+} MPLCB;
+
+/*
+ *  Initialization
+ */
+extern void	mempvar_initialize(void);
+
+/*
+ *  Give blocks to the tasks waiting for one
+ *
+ *  The tasks are served in queue order until the block requested by the
+ *  first one cannot be allocated.  Returns TRUE when a dispatch is
+ *  needed.
+ */
+extern BOOL	mempvar_signal(MPLCB *mplcb);
+
+#endif /* _MEMPVAR_H_ */
@@ -0,0 +1,934 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	Message buffers
+ *
+ *  Variable length messages of up to maxmsz bytes are copied into a
+ *  ring of mbfsz bytes given to CRE_MBF.  Tasks waiting to send are
+ *  queued in the order given by the attribute (TA_TFIFO or TA_TPRI) and
+ *  are served strictly in queue order: a message is not put into the
+ *  ring while another task is still waiting to send, even if it would
+ *  fit.  Tasks waiting to receive are queued in FIFO order.  When mbfsz
+ *  is 0, messages are passed directly from the sending to the receiving
+ *  task.
+ *
+ *  Besides the copying service calls there are implementation specific
+ *  ones for zero-copy use and for batches of fixed size messages.  They
+ *  only poll and may be called from task context only.
+ *
+ *  vrsv_mbf reserves room for a message in the ring and returns its
+ *  address; the message is written there and appended with vcmt_mbf.
+ *  While a message is reserved, other messages are not put into the
+ *  ring.  vpek_mbf returns the address and size of the first message
+ *  without removing it, and vfre_mbf removes it after use.  Both pairs
+ *  assume a single producer and a single consumer respectively.
+ *
+ *  vbsnd_mbf sends messages of msgsz bytes from an array, and
+ *  vbrcv_mbf receives messages into an array of msgsz byte slots, under
+ *  a single lock.  They return the number of messages moved.
+ */
+
+#include "jsp_kernel.h"
+#include "check.h"
+#include "task.h"
+#include "wait.h"
+#include "messagebuf.h"
+
+/*
+ *  Maximum message buffer ID (kernel_cfg.c)
+ */
+extern const ID	tmax_mbfid;
+
+/*
+ *  Message buffer initialization blocks (kernel_cfg.c)
+ */
+extern const MBFINIB	mbfinib_table[];
+
+/*
+ *  Number of message buffers
+ */
+#define TNUM_MBF	((UINT)(tmax_mbfid - TMIN_MBFID + 1))
+
+/*
+ *  Message buffer control blocks (kernel_cfg.c)
+ */
+extern MBFCB	mbfcb_table[];
+
+/*
+ *  Message buffer control block from a message buffer ID
+ */
+#define INDEX_MBF(mbfid)	((UINT)((mbfid) - TMIN_MBFID))
+#define get_mbfcb(mbfid)	(&(mbfcb_table[INDEX_MBF(mbfid)]))
+
+/*
+ *  Waiting information block
+ *
+ *  Used both to wait to send and to wait to receive.
+ */
+typedef struct messagebuf_waiting_information {
+	WINFO	winfo;		/* standard waiting information */
+	WOBJCB	*wobjcb;	/* control block of the waited object */
+	VP	msg;		/* message */
+	UINT	msgsz;		/* size of the message */
+} WINFO_MBF;
+
+/*
+ *  Size of the message of the first task waiting to send
+ */
+#define SWAIT_MSGSZ(mbfcb) \
+	(((WINFO_MBF *)(((TCB *)((mbfcb)->swait_queue.next))->winfo))->msgsz)
+
+/*
+ *  Initialization
+ */
+#ifdef __mbfini
+
+void
+messagebuf_initialize(void)
+{
+	UINT	i;
+	MBFCB	*mbfcb;
+
+	for (mbfcb = mbfcb_table, i = 0; i < TNUM_MBF; mbfcb++, i++) {
+		queue_initialize(&(mbfcb->swait_queue));
+		mbfcb->mbfinib = &(mbfinib_table[i]);
+		queue_initialize(&(mbfcb->rwait_queue));
+		mbfcb->head = 0;
+		mbfcb->tail = 0;
+		mbfcb->smsgcnt = 0;
+		mbfcb->rsvpos = 0;
+		mbfcb->rsvsz = 0;
+	}
+}
+
+#endif /* __mbfini */
+
+/*
+ *  Find room for a message
+ *
+ *  The free room is either [tail, head), or [tail, mbfsz) followed by
+ *  [0, head) when the messages do not wrap around.  Only one of the
+ *  parts is used, so that the message stays contiguous.  Not called
+ *  while a message is reserved, so head and tail are 0 when the ring is
+ *  empty.
+ */
+#ifdef __mbfrsv
+
+INT
+reserve_message(MBFCB *mbfcb, UINT msgsz)
+{
+	UINT	size = MBF_MSGSZ(msgsz);
+	UINT	head = mbfcb->head;
+	UINT	tail = mbfcb->tail;
+
+	if (mbfcb->smsgcnt == 0) {
+		return((size <= mbfcb->mbfinib->mbfsz) ? 0 : -1);
+	}
+	if (tail > head) {
+		if (mbfcb->mbfinib->mbfsz - tail >= size) {
+			return((INT) tail);
+		}
+		if (head >= size) {
+			return(0);
+		}
+	}
+	else if (head - tail >= size) {
+		return((INT) tail);
+	}
+	return(-1);
+}
+
+#endif /* __mbfrsv */
+
+/*
+ *  Append a message
+ */
+#ifdef __mbfcmt
+
+void
+commit_message(MBFCB *mbfcb, UINT pos, UINT msgsz)
+{
+	if (pos != mbfcb->tail && mbfcb->tail < mbfcb->mbfinib->mbfsz) {
+		MBF_HEADER(mbfcb, mbfcb->tail) = MBF_WRAP;
+	}
+	MBF_HEADER(mbfcb, pos) = msgsz;
+	mbfcb->tail = pos + MBF_MSGSZ(msgsz);
+	if (mbfcb->smsgcnt == 0) {
+		mbfcb->head = pos;
+	}
+	mbfcb->smsgcnt++;
+}
+
+#endif /* __mbfcmt */
+
+/*
+ *  Store a message into the ring
+ */
+#ifdef __mbfenq
+
+BOOL
+enqueue_message(MBFCB *mbfcb, VP msg, UINT msgsz)
+{
+	INT	pos;
+
+	if (mbfcb->rsvsz == 0
+			&& (pos = reserve_message(mbfcb, msgsz)) >= 0) {
+		messagebuf_copy(MBF_BODY(mbfcb, pos), msg, msgsz);
+		commit_message(mbfcb, (UINT) pos, msgsz);
+		return(TRUE);
+	}
+	return(FALSE);
+}
+
+#endif /* __mbfenq */
+
+/*
+ *  First message in the ring
+ */
+#ifdef __mbffst
+
+UINT
+first_message(MBFCB *mbfcb, UINT *p_msgsz)
+{
+	UINT	pos = mbfcb->head;
+
+	if (pos == mbfcb->mbfinib->mbfsz
+			|| MBF_HEADER(mbfcb, pos) == MBF_WRAP) {
+		pos = mbfcb->head = 0;
+	}
+	*p_msgsz = MBF_HEADER(mbfcb, pos);
+	return(pos);
+}
+
+#endif /* __mbffst */
+
+/*
+ *  Remove the first message from the ring
+ */
+#ifdef __mbfdeq
+
+UINT
+dequeue_message(MBFCB *mbfcb, VP msg)
+{
+	UINT	pos, msgsz;
+
+	if (mbfcb->smsgcnt == 0) {
+		return(0);
+	}
+	pos = first_message(mbfcb, &msgsz);
+	if (msg != NULL) {
+		messagebuf_copy(msg, MBF_BODY(mbfcb, pos), msgsz);
+	}
+	mbfcb->smsgcnt--;
+	if (mbfcb->smsgcnt == 0 && mbfcb->rsvsz == 0) {
+		mbfcb->head = 0;
+		mbfcb->tail = 0;
+	}
+	else {
+		mbfcb->head = pos + MBF_MSGSZ(msgsz);
+	}
+	return(msgsz);
+}
+
+#endif /* __mbfdeq */
+
+/*
+ *  Send a message to the first task waiting to receive
+ */
+#ifdef __mbfsnd
+
+TCB *
+send_message_rwait(MBFCB *mbfcb, VP msg, UINT msgsz)
+{
+	TCB	*tcb;
+
+	if (!(queue_empty(&(mbfcb->rwait_queue)))) {
+		tcb = (TCB *) queue_delete_next(&(mbfcb->rwait_queue));
+		messagebuf_copy(((WINFO_MBF *)(tcb->winfo))->msg, msg, msgsz);
+		((WINFO_MBF *)(tcb->winfo))->msgsz = msgsz;
+		return(tcb);
+	}
+	return(NULL);
+}
+
+#endif /* __mbfsnd */
+
+/*
+ *  Receive a message from the first task waiting to send
+ */
+#ifdef __mbfrcv
+
+TCB *
+receive_message_swait(MBFCB *mbfcb, VP msg, UINT *p_msgsz)
+{
+	TCB	*tcb;
+
+	if (!(queue_empty(&(mbfcb->swait_queue)))) {
+		tcb = (TCB *) queue_delete_next(&(mbfcb->swait_queue));
+		*p_msgsz = ((WINFO_MBF *)(tcb->winfo))->msgsz;
+		messagebuf_copy(msg, ((WINFO_MBF *)(tcb->winfo))->msg, *p_msgsz);
+		return(tcb);
+	}
+	return(NULL);
+}
+
+#endif /* __mbfrcv */
+
+/*
+ *  Move the messages of the tasks waiting to send into the ring
+ */
+#ifdef __mbfsig
+
+BOOL
+messagebuf_signal(MBFCB *mbfcb)
+{
+	TCB	*tcb;
+	WINFO_MBF *winfo;
+	BOOL	dspreq = FALSE;
+
+	while (!(queue_empty(&(mbfcb->swait_queue)))) {
+		tcb = (TCB *)(mbfcb->swait_queue.next);
+		winfo = (WINFO_MBF *)(tcb->winfo);
+		if (!enqueue_message(mbfcb, winfo->msg, winfo->msgsz)) {
+			break;
+		}
+		queue_delete(&(tcb->task_queue));
+		if (wait_complete(tcb)) {
+			dspreq = TRUE;
+		}
+	}
+	return(dspreq);
+}
+
+#endif /* __mbfsig */
+
+/*
+ *  Wait to send
+ *
+ *  The running task may have been queued in front of the tasks already
+ *  waiting; its message is then tried at once.
+ */
+Inline void
+messagebuf_make_wait(MBFCB *mbfcb, WINFO_MBF *winfo, VP msg, UINT msgsz)
+{
+	winfo->msg = msg;
+	winfo->msgsz = msgsz;
+	runtsk->tstat |= TS_WAIT_SMBF;
+	if (mbfcb->swait_queue.next == &(runtsk->task_queue)) {
+		(void) messagebuf_signal(mbfcb);
+	}
+}
+
+/*
+ *  Send to a message buffer
+ */
+#ifdef __snd_mbf
+
+SYSCALL ER
+snd_mbf(ID mbfid, VP msg, UINT msgsz)
+{
+	MBFCB	*mbfcb;
+	WINFO_MBF winfo;
+	TCB	*tcb;
+	ER	ercd;
+
+	LOG_SND_MBF_ENTER(mbfid, msg, msgsz);
+	CHECK_DISPATCH();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+	CHECK_PAR(0 < msgsz && msgsz <= mbfcb->mbfinib->maxmsz);
+
+	t_lock_cpu();
+	if ((tcb = send_message_rwait(mbfcb, msg, msgsz)) != NULL) {
+		if (wait_complete(tcb)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	else if (queue_empty(&(mbfcb->swait_queue))
+			&& enqueue_message(mbfcb, msg, msgsz)) {
+		ercd = E_OK;
+	}
+	else {
+		wobj_make_wait((WOBJCB *) mbfcb, (WINFO_WOBJ *) &winfo);
+		messagebuf_make_wait(mbfcb, &winfo, msg, msgsz);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_SND_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __snd_mbf */
+
+/*
+ *  Send to a message buffer (polling)
+ */
+#ifdef __psnd_mbf
+
+SYSCALL ER
+psnd_mbf(ID mbfid, VP msg, UINT msgsz)
+{
+	MBFCB	*mbfcb;
+	TCB	*tcb;
+	ER	ercd;
+
+	LOG_PSND_MBF_ENTER(mbfid, msg, msgsz);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+	CHECK_PAR(0 < msgsz && msgsz <= mbfcb->mbfinib->maxmsz);
+
+	t_lock_cpu();
+	if ((tcb = send_message_rwait(mbfcb, msg, msgsz)) != NULL) {
+		if (wait_complete(tcb)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	else if (queue_empty(&(mbfcb->swait_queue))
+			&& enqueue_message(mbfcb, msg, msgsz)) {
+		ercd = E_OK;
+	}
+	else {
+		ercd = E_TMOUT;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_PSND_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __psnd_mbf */
+
+/*
+ *  Send to a message buffer (with timeout)
+ */
+#ifdef __tsnd_mbf
+
+SYSCALL ER
+tsnd_mbf(ID mbfid, VP msg, UINT msgsz, TMO tmout)
+{
+	MBFCB	*mbfcb;
+	WINFO_MBF winfo;
+	TMEVTB	tmevtb;
+	TCB	*tcb;
+	ER	ercd;
+
+	LOG_TSND_MBF_ENTER(mbfid, msg, msgsz, tmout);
+	CHECK_DISPATCH();
+	CHECK_MBFID(mbfid);
+	CHECK_TMOUT(tmout);
+	mbfcb = get_mbfcb(mbfid);
+	CHECK_PAR(0 < msgsz && msgsz <= mbfcb->mbfinib->maxmsz);
+
+	t_lock_cpu();
+	if ((tcb = send_message_rwait(mbfcb, msg, msgsz)) != NULL) {
+		if (wait_complete(tcb)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	else if (queue_empty(&(mbfcb->swait_queue))
+			&& enqueue_message(mbfcb, msg, msgsz)) {
+		ercd = E_OK;
+	}
+	else if (tmout == TMO_POL) {
+		ercd = E_TMOUT;
+	}
+	else {
+		wobj_make_wait_tmout((WOBJCB *) mbfcb, (WINFO_WOBJ *) &winfo,
+						&tmevtb, tmout);
+		messagebuf_make_wait(mbfcb, &winfo, msg, msgsz);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_TSND_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __tsnd_mbf */
+
+/*
+ *  Receive from a message buffer
+ */
+#ifdef __rcv_mbf
+
+SYSCALL ER_UINT
+rcv_mbf(ID mbfid, VP msg)
+{
+	MBFCB	*mbfcb;
+	WINFO_MBF winfo;
+	TCB	*tcb;
+	UINT	msgsz;
+	ER_UINT	ercd;
+
+	LOG_RCV_MBF_ENTER(mbfid, msg);
+	CHECK_DISPATCH();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+
+	t_lock_cpu();
+	if ((msgsz = dequeue_message(mbfcb, msg)) > 0) {
+		if (messagebuf_signal(mbfcb)) {
+			dispatch();
+		}
+		ercd = (ER_UINT) msgsz;
+	}
+	else if ((tcb = receive_message_swait(mbfcb, msg, &msgsz)) != NULL) {
+		if (wait_complete(tcb)) {
+			dispatch();
+		}
+		ercd = (ER_UINT) msgsz;
+	}
+	else {
+		runtsk->tstat = (TS_WAITING | TS_WAIT_WOBJ);
+		make_wait(&(winfo.winfo));
+		queue_insert_prev(&(mbfcb->rwait_queue),
+					&(runtsk->task_queue));
+		winfo.wobjcb = (WOBJCB *) mbfcb;
+		winfo.msg = msg;
+		LOG_TSKSTAT(runtsk);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+		if (ercd == E_OK) {
+			ercd = (ER_UINT)(winfo.msgsz);
+		}
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_RCV_MBF_LEAVE(ercd, msg);
+	return(ercd);
+}
+
+#endif /* __rcv_mbf */
+
+/*
+ *  Receive from a message buffer (polling)
+ */
+#ifdef __prcv_mbf
+
+SYSCALL ER_UINT
+prcv_mbf(ID mbfid, VP msg)
+{
+	MBFCB	*mbfcb;
+	TCB	*tcb;
+	UINT	msgsz;
+	ER_UINT	ercd;
+
+	LOG_PRCV_MBF_ENTER(mbfid, msg);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+
+	t_lock_cpu();
+	if ((msgsz = dequeue_message(mbfcb, msg)) > 0) {
+		if (messagebuf_signal(mbfcb)) {
+			dispatch();
+		}
+		ercd = (ER_UINT) msgsz;
+	}
+	else if ((tcb = receive_message_swait(mbfcb, msg, &msgsz)) != NULL) {
+		if (wait_complete(tcb)) {
+			dispatch();
+		}
+		ercd = (ER_UINT) msgsz;
+	}
+	else {
+		ercd = E_TMOUT;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_PRCV_MBF_LEAVE(ercd, msg);
+	return(ercd);
+}
+
+#endif /* __prcv_mbf */
+
+/*
+ *  Receive from a message buffer (with timeout)
+ */
+#ifdef __trcv_mbf
+
+SYSCALL ER_UINT
+trcv_mbf(ID mbfid, VP msg, TMO tmout)
+{
+	MBFCB	*mbfcb;
+	WINFO_MBF winfo;
+	TMEVTB	tmevtb;
+	TCB	*tcb;
+	UINT	msgsz;
+	ER_UINT	ercd;
+
+	LOG_TRCV_MBF_ENTER(mbfid, msg, tmout);
+	CHECK_DISPATCH();
+	CHECK_MBFID(mbfid);
+	CHECK_TMOUT(tmout);
+	mbfcb = get_mbfcb(mbfid);
+
+	t_lock_cpu();
+	if ((msgsz = dequeue_message(mbfcb, msg)) > 0) {
+		if (messagebuf_signal(mbfcb)) {
+			dispatch();
+		}
+		ercd = (ER_UINT) msgsz;
+	}
+	else if ((tcb = receive_message_swait(mbfcb, msg, &msgsz)) != NULL) {
+		if (wait_complete(tcb)) {
+			dispatch();
+		}
+		ercd = (ER_UINT) msgsz;
+	}
+	else if (tmout == TMO_POL) {
+		ercd = E_TMOUT;
+	}
+	else {
+		runtsk->tstat = (TS_WAITING | TS_WAIT_WOBJ);
+		make_wait_tmout(&(winfo.winfo), &tmevtb, tmout);
+		queue_insert_prev(&(mbfcb->rwait_queue),
+					&(runtsk->task_queue));
+		winfo.wobjcb = (WOBJCB *) mbfcb;
+		winfo.msg = msg;
+		LOG_TSKSTAT(runtsk);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+		if (ercd == E_OK) {
+			ercd = (ER_UINT)(winfo.msgsz);
+		}
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_TRCV_MBF_LEAVE(ercd, msg);
+	return(ercd);
+}
+
+#endif /* __trcv_mbf */
+
+/*
+ *  Reserve room for a message in a message buffer
+ */
+#ifdef __vrsv_mbf
+
+SYSCALL ER
+vrsv_mbf(ID mbfid, VP *p_msg, UINT msgsz)
+{
+	MBFCB	*mbfcb;
+	INT	pos;
+	ER	ercd;
+
+	LOG_VRSV_MBF_ENTER(mbfid, p_msg, msgsz);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+	CHECK_PAR(0 < msgsz && msgsz <= mbfcb->mbfinib->maxmsz);
+
+	t_lock_cpu();
+	if (mbfcb->rsvsz != 0) {
+		ercd = E_OBJ;
+	}
+	else if (!(queue_empty(&(mbfcb->swait_queue)))
+			|| (pos = reserve_message(mbfcb, msgsz)) < 0) {
+		ercd = E_TMOUT;
+	}
+	else {
+		mbfcb->rsvpos = (UINT) pos;
+		mbfcb->rsvsz = msgsz;
+		*p_msg = MBF_BODY(mbfcb, pos);
+		ercd = E_OK;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_VRSV_MBF_LEAVE(ercd, *p_msg);
+	return(ercd);
+}
+
+#endif /* __vrsv_mbf */
+
+/*
+ *  Send the reserved message
+ *
+ *  msgsz may be smaller than the size given to vrsv_mbf.  When it is 0
+ *  the reservation is cancelled.
+ */
+#ifdef __vcmt_mbf
+
+SYSCALL ER
+vcmt_mbf(ID mbfid, UINT msgsz)
+{
+	MBFCB	*mbfcb;
+	TCB	*tcb;
+	WINFO_MBF *winfo;
+	BOOL	dspreq = FALSE;
+	ER	ercd;
+
+	LOG_VCMT_MBF_ENTER(mbfid, msgsz);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+
+	t_lock_cpu();
+	if (mbfcb->rsvsz == 0) {
+		ercd = E_OBJ;
+	}
+	else if (msgsz > mbfcb->rsvsz) {
+		ercd = E_PAR;
+	}
+	else {
+		if (msgsz > 0) {
+			commit_message(mbfcb, mbfcb->rsvpos, msgsz);
+		}
+		mbfcb->rsvsz = 0;
+		if (mbfcb->smsgcnt == 0) {
+			mbfcb->head = 0;
+			mbfcb->tail = 0;
+		}
+		else if (!(queue_empty(&(mbfcb->rwait_queue)))) {
+			tcb = (TCB *) queue_delete_next(&(mbfcb->rwait_queue));
+			winfo = (WINFO_MBF *)(tcb->winfo);
+			winfo->msgsz = dequeue_message(mbfcb, winfo->msg);
+			dspreq = wait_complete(tcb);
+		}
+		if (messagebuf_signal(mbfcb)) {
+			dspreq = TRUE;
+		}
+		if (dspreq) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_VCMT_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __vcmt_mbf */
+
+/*
+ *  Refer to the first message in a message buffer
+ */
+#ifdef __vpek_mbf
+
+SYSCALL ER_UINT
+vpek_mbf(ID mbfid, VP *p_msg)
+{
+	MBFCB	*mbfcb;
+	UINT	pos, msgsz;
+	ER_UINT	ercd;
+
+	LOG_VPEK_MBF_ENTER(mbfid, p_msg);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+
+	t_lock_cpu();
+	if (mbfcb->smsgcnt == 0) {
+		ercd = E_TMOUT;
+	}
+	else {
+		pos = first_message(mbfcb, &msgsz);
+		*p_msg = MBF_BODY(mbfcb, pos);
+		ercd = (ER_UINT) msgsz;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_VPEK_MBF_LEAVE(ercd, *p_msg);
+	return(ercd);
+}
+
+#endif /* __vpek_mbf */
+
+/*
+ *  Remove the first message from a message buffer
+ *
+ *  msg must be the address returned by vpek_mbf.
+ */
+#ifdef __vfre_mbf
+
+SYSCALL ER
+vfre_mbf(ID mbfid, VP msg)
+{
+	MBFCB	*mbfcb;
+	UINT	msgsz;
+	ER	ercd;
+
+	LOG_VFRE_MBF_ENTER(mbfid, msg);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+
+	t_lock_cpu();
+	if (mbfcb->smsgcnt == 0
+		|| MBF_BODY(mbfcb, first_message(mbfcb, &msgsz)) != msg) {
+		ercd = E_PAR;
+	}
+	else {
+		(void) dequeue_message(mbfcb, NULL);
+		if (messagebuf_signal(mbfcb)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_VFRE_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __vfre_mbf */
+
+/*
+ *  Send a batch of messages to a message buffer
+ *
+ *  Sends the msgcnt messages of msgsz bytes stored one after the other
+ *  from msg, as far as they fit.
+ */
+#ifdef __vbsnd_mbf
+
+SYSCALL ER_UINT
+vbsnd_mbf(ID mbfid, VP msg, UINT msgsz, UINT msgcnt)
+{
+	MBFCB	*mbfcb;
+	TCB	*tcb;
+	BOOL	dspreq = FALSE;
+	UINT	i;
+	ER_UINT	ercd;
+
+	LOG_VBSND_MBF_ENTER(mbfid, msg, msgsz, msgcnt);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+	CHECK_PAR(0 < msgsz && msgsz <= mbfcb->mbfinib->maxmsz);
+
+	t_lock_cpu();
+	for (i = 0; i < msgcnt; i++, msg = (VP)((VB *) msg + msgsz)) {
+		if ((tcb = send_message_rwait(mbfcb, msg, msgsz)) != NULL) {
+			if (wait_complete(tcb)) {
+				dspreq = TRUE;
+			}
+		}
+		else if (!(queue_empty(&(mbfcb->swait_queue)))
+				|| !enqueue_message(mbfcb, msg, msgsz)) {
+			break;
+		}
+	}
+	if (dspreq) {
+		dispatch();
+	}
+	ercd = (i > 0) ? (ER_UINT) i : E_TMOUT;
+	t_unlock_cpu();
+
+    exit:
+	LOG_VBSND_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __vbsnd_mbf */
+
+/*
+ *  Receive a batch of messages from a message buffer
+ *
+ *  Receives up to msgcnt messages into slots of msgsz bytes from msg
+ *  on.  The sizes of the messages are not returned; it is meant for
+ *  messages of a fixed size.  Stops at a message larger than msgsz.
+ */
+#ifdef __vbrcv_mbf
+
+SYSCALL ER_UINT
+vbrcv_mbf(ID mbfid, VP msg, UINT msgsz, UINT msgcnt)
+{
+	MBFCB	*mbfcb;
+	TCB	*tcb;
+	BOOL	dspreq = FALSE;
+	UINT	i, size;
+	ER_UINT	ercd;
+
+	LOG_VBRCV_MBF_ENTER(mbfid, msg, msgsz, msgcnt);
+	CHECK_TSKCTX_UNL();
+	CHECK_MBFID(mbfid);
+	mbfcb = get_mbfcb(mbfid);
+	CHECK_PAR(0 < msgsz);
+
+	t_lock_cpu();
+	for (i = 0; i < msgcnt; i++, msg = (VP)((VB *) msg + msgsz)) {
+		if (mbfcb->smsgcnt > 0) {
+			(void) first_message(mbfcb, &size);
+			if (size > msgsz) {
+				break;
+			}
+			(void) dequeue_message(mbfcb, msg);
+			if (messagebuf_signal(mbfcb)) {
+				dspreq = TRUE;
+			}
+		}
+		else if (!(queue_empty(&(mbfcb->swait_queue)))
+				&& SWAIT_MSGSZ(mbfcb) <= msgsz) {
+			tcb = receive_message_swait(mbfcb, msg, &size);
+			if (wait_complete(tcb)) {
+				dspreq = TRUE;
+			}
+		}
+		else {
+			break;
+		}
+	}
+	if (dspreq) {
+		dispatch();
+	}
+	ercd = (i > 0) ? (ER_UINT) i : E_TMOUT;
+	t_unlock_cpu();
+
+    exit:
+	LOG_VBRCV_MBF_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __vbrcv_mbf */
@@ -0,0 +1,182 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	Message buffers
+ */
+
+#ifndef _MESSAGEBUF_H_
+#define _MESSAGEBUF_H_
+
+#include "queue.h"
+#include "task.h"
+#include "wait.h"
+
+/*
+ *  Message buffer initialization block
+ */
+typedef struct message_buffer_initialization_block {
+	ATR	mbfatr;		/* message buffer attribute */
+	UINT	maxmsz;		/* maximum message size in bytes */
+	SIZE	mbfsz;		/* size of the ring (multiple of sizeof(VP)) */
+	VP	mbf;		/* start address of the ring */
+} MBFINIB;
+
+/*
+ *  Message buffer control block
+ *
+ *  The messages are kept in the ring one after the other, each one
+ *  behind a header of sizeof(VP) bytes holding its size and padded to a
+ *  multiple of sizeof(VP).  A message is never split at the end of the
+ *  ring: when it does not fit there, MBF_WRAP is written into the
+ *  header position and the message is stored at the start.  Messages
+ *  can therefore be read and written in place (rsv_mbf, pek_mbf).
+ *
+ *  head and tail are byte offsets into the ring.  When the buffer is
+ *  empty and nothing is reserved both are 0.
+ */
+typedef struct message_buffer_control_block {
+	QUEUE	swait_queue;	/* tasks waiting to send */
+	const MBFINIB *mbfinib;	/* initialization block */
+	QUEUE	rwait_queue;	/* tasks waiting to receive */
+	UINT	head;		/* header of the first message */
+	UINT	tail;		/* just past the last message */
+	UINT	smsgcnt;	/* number of messages in the ring */
+	UINT	rsvpos;		/* header of the message reserved by rsv_mbf */
+	UINT	rsvsz;		/* size reserved by rsv_mbf (0: none) */
+} MBFCB;
+
+/*
+ *  Header of a message and size it takes in the ring
+ */
+#define	MBF_WRAP		(~0u)
+#define	MBF_HEADER(mbfcb, pos) \
+		(*((UINT *)((VB *)((mbfcb)->mbfinib->mbf) + (pos))))
+#define	MBF_BODY(mbfcb, pos) \
+		((VP)((VB *)((mbfcb)->mbfinib->mbf) + (pos) + sizeof(VP)))
+#define	MBF_MSGSZ(msgsz)	(sizeof(VP) + TROUND_VP(msgsz))
+
+/*
+ *  Message buffer a task waits to send to (only when TS_WAIT_SMBF is
+ *  set)
+ */
+#define	WAIT_MBFCB(tcb)	((MBFCB *)(((WINFO_WOBJ *)((tcb)->winfo))->wobjcb))
+
+/*
+ *  Copy a message
+ *
+ *  The ring is word aligned; messages in word aligned user buffers are
+ *  copied a word at a time.
+ */
+Inline void
+messagebuf_copy(VP dst, VP src, UINT msgsz)
+{
+	UINT	i;
+
+	if ((((SIZE) dst | (SIZE) src) & (sizeof(UW) - 1)) == 0) {
+		for (i = 0; i < msgsz / sizeof(UW); i++) {
+			((UW *) dst)[i] = ((UW *) src)[i];
+		}
+		i *= sizeof(UW);
+	}
+	else {
+		i = 0;
+	}
+	for (; i < msgsz; i++) {
+		((VB *) dst)[i] = ((VB *) src)[i];
+	}
+}
+
+/*
+ *  Initialization
+ */
+extern void	messagebuf_initialize(void);
+
+/*
+ *  Find room for a message of msgsz bytes
+ *
+ *  Returns the offset of the header, or -1 when the message does not
+ *  fit.  The ring is not changed.
+ */
+extern INT	reserve_message(MBFCB *mbfcb, UINT msgsz);
+
+/*
+ *  Append a message whose body has been written at pos
+ */
+extern void	commit_message(MBFCB *mbfcb, UINT pos, UINT msgsz);
+
+/*
+ *  Store a message into the ring
+ *
+ *  Fails while a message is reserved by rsv_mbf.
+ */
+extern BOOL	enqueue_message(MBFCB *mbfcb, VP msg, UINT msgsz);
+
+/*
+ *  First message in the ring
+ *
+ *  Returns the offset of its header and sets *p_msgsz; the ring must
+ *  not be empty.
+ */
+extern UINT	first_message(MBFCB *mbfcb, UINT *p_msgsz);
+
+/*
+ *  Remove the first message from the ring
+ *
+ *  Copies it to msg unless msg is NULL and returns its size, or 0 when
+ *  the ring is empty.
+ */
+extern UINT	dequeue_message(MBFCB *mbfcb, VP msg);
+
+/*
+ *  Send a message to the first task waiting to receive
+ */
+extern TCB	*send_message_rwait(MBFCB *mbfcb, VP msg, UINT msgsz);
+
+/*
+ *  Receive a message from the first task waiting to send
+ */
+extern TCB	*receive_message_swait(MBFCB *mbfcb, VP msg, UINT *p_msgsz);
+
+/*
+ *  Move the messages of the tasks waiting to send into the ring
+ *
+ *  Called whenever room is made or the first waiting task changes.
+ *  Returns TRUE when a dispatch is needed.
+ */
+extern BOOL	messagebuf_signal(MBFCB *mbfcb);
+
+#endif /* _MESSAGEBUF_H_ */
@@ -0,0 +1,490 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	Mutexes
+ *
+ *  A TA_INHERIT mutex raises the priority of the task that has locked
+ *  it to that of the highest priority task waiting for it (priority
+ *  inheritance).  A TA_CEILING mutex raises it to the ceiling priority
+ *  given to CRE_MTX as long as the mutex is locked (priority ceiling);
+ *  a task whose base priority is higher than the ceiling may not lock
+ *  it.  TA_TFIFO and TA_TPRI mutexes leave the priorities alone.
+ *
+ *  The priority set by chg_pri is kept in bpriority of the TCB, and
+ *  priority is recomputed from it and the locked mutexes whenever one
+ *  of them changes.  Mutexes may be unlocked in any order; those still
+ *  locked when a task terminates are unlocked by the kernel.
+ */
+
+#include "jsp_kernel.h"
+#include "check.h"
+#include "task.h"
+#include "wait.h"
+#include "mutex.h"
+
+/*
+ *  Maximum mutex ID (kernel_cfg.c)
+ */
+extern const ID	tmax_mtxid;
+
+/*
+ *  Mutex initialization blocks (kernel_cfg.c)
+ */
+extern const MTXINIB	mtxinib_table[];
+
+/*
+ *  Mutex control blocks (kernel_cfg.c)
+ */
+extern MTXCB	mtxcb_table[];
+
+/*
+ *  Number of mutexes
+ */
+#define TNUM_MTX	((UINT)(tmax_mtxid - TMIN_MTXID + 1))
+
+/*
+ *  Mutex control block from a mutex ID
+ */
+#define INDEX_MTX(mtxid)	((UINT)((mtxid) - TMIN_MTXID))
+#define get_mtxcb(mtxid)	(&(mtxcb_table[INDEX_MTX(mtxid)]))
+
+/*
+ *  Locking protocol
+ */
+#define MTX_INHERIT(mtxcb)	((mtxcb)->mtxinib->mtxatr == TA_INHERIT)
+#define MTX_CEILING(mtxcb)	((mtxcb)->mtxinib->mtxatr == TA_CEILING)
+
+/*
+ *  Initialization
+ */
+#ifdef __mtxini
+
+void
+mutex_initialize()
+{
+	UINT	i;
+	MTXCB	*mtxcb;
+
+	for (mtxcb = mtxcb_table, i = 0; i < TNUM_MTX; mtxcb++, i++) {
+		queue_initialize(&(mtxcb->wait_queue));
+		mtxcb->mtxinib = &(mtxinib_table[i]);
+		mtxcb->mtxtsk = NULL;
+		mtxcb->prevmtx = NULL;
+	}
+}
+
+#endif /* __mtxini */
+
+/*
+ *  Current priority of a task
+ *
+ *  The wait queue of a TA_INHERIT mutex is in priority order, so only
+ *  its first task has to be looked at.
+ */
+#ifdef __mtxcalc
+
+UINT
+mutex_calc_priority(TCB *tcb)
+{
+	UINT	priority = tcb->bpriority;
+	MTXCB	*mtxcb;
+	TCB	*waitcb;
+
+	for (mtxcb = tcb->lastmtx; mtxcb != NULL; mtxcb = mtxcb->prevmtx) {
+		if (MTX_CEILING(mtxcb)) {
+			if (mtxcb->mtxinib->ceilpri < priority) {
+				priority = mtxcb->mtxinib->ceilpri;
+			}
+		}
+		else if (MTX_INHERIT(mtxcb)
+				&& !queue_empty(&(mtxcb->wait_queue))) {
+			waitcb = (TCB *)(mtxcb->wait_queue.next);
+			if (waitcb->priority < priority) {
+				priority = waitcb->priority;
+			}
+		}
+	}
+	return(priority);
+}
+
+#endif /* __mtxcalc */
+
+/*
+ *  Update the current priority of a task
+ *
+ *  The chain ends at a task that is runnable, that does not wait for a
+ *  TA_INHERIT mutex, or whose priority does not change.  It always ends
+ *  because priorities only move towards the highest one in the chain,
+ *  even if the tasks are deadlocked.
+ */
+#ifdef __mtxpri
+
+BOOL
+mutex_change_priority(TCB *tcb)
+{
+	UINT	newpri;
+	MTXCB	*mtxcb;
+
+	while ((newpri = mutex_calc_priority(tcb)) != tcb->priority) {
+		if (TSTAT_RUNNABLE(tcb->tstat)) {
+			return(change_priority(tcb, newpri));
+		}
+		tcb->priority = newpri;
+		if ((tcb->tstat & TS_WAIT_WOBJCB) != 0) {
+			wobj_change_priority(((WINFO_WOBJ *)(tcb->winfo))
+							->wobjcb, tcb);
+		}
+		if ((tcb->tstat & TS_WAIT_MTX) == 0) {
+			break;
+		}
+		mtxcb = WAIT_MTXCB(tcb);
+		if (!MTX_INHERIT(mtxcb)) {
+			break;
+		}
+		tcb = mtxcb->mtxtsk;
+	}
+	return(FALSE);
+}
+
+#endif /* __mtxpri */
+
+/*
+ *  Check a base priority against the ceilings
+ */
+#ifdef __mtxchk
+
+BOOL
+mutex_check_ceilpri(TCB *tcb, UINT bpriority)
+{
+	MTXCB	*mtxcb;
+
+	for (mtxcb = tcb->lastmtx; mtxcb != NULL; mtxcb = mtxcb->prevmtx) {
+		if (MTX_CEILING(mtxcb) && bpriority < mtxcb->mtxinib->ceilpri) {
+			return(FALSE);
+		}
+	}
+	if ((tcb->tstat & TS_WAIT_MTX) != 0) {
+		mtxcb = WAIT_MTXCB(tcb);
+		if (MTX_CEILING(mtxcb) && bpriority < mtxcb->mtxinib->ceilpri) {
+			return(FALSE);
+		}
+	}
+	return(TRUE);
+}
+
+#endif /* __mtxchk */
+
+/*
+ *  A waiting task left the queue or changed its priority
+ */
+#ifdef __mtxupd
+
+BOOL
+mutex_update_owner(MTXCB *mtxcb)
+{
+	if (MTX_INHERIT(mtxcb)) {
+		return(mutex_change_priority(mtxcb->mtxtsk));
+	}
+	return(FALSE);
+}
+
+#endif /* __mtxupd */
+
+/*
+ *  Lock a mutex for a task
+ */
+Inline void
+mutex_lock(MTXCB *mtxcb, TCB *tcb)
+{
+	mtxcb->mtxtsk = tcb;
+	mtxcb->prevmtx = tcb->lastmtx;
+	tcb->lastmtx = mtxcb;
+}
+
+/*
+ *  Wait for a mutex
+ *
+ *  Called after the running task has been put into the wait queue.  A
+ *  TA_INHERIT mutex passes the priority of the task on to the owner.
+ */
+Inline void
+mutex_make_wait(MTXCB *mtxcb)
+{
+	runtsk->tstat |= TS_WAIT_MTX;
+	if (MTX_INHERIT(mtxcb)) {
+		(void) mutex_change_priority(mtxcb->mtxtsk);
+	}
+}
+
+/*
+ *  Unlock a mutex
+ *
+ *  Removes mtxcb from the mutexes locked by its owner and passes it on
+ *  to the first waiting task, if any, whose priority is updated.  The
+ *  priority of the former owner is not.  Returns TRUE when a dispatch
+ *  is needed.
+ */
+Inline BOOL
+mutex_unlock(MTXCB *mtxcb)
+{
+	TCB	*tcb = mtxcb->mtxtsk;
+	MTXCB	**p_mtxcb;
+	BOOL	dspreq = FALSE;
+
+	p_mtxcb = &(tcb->lastmtx);
+	while (*p_mtxcb != mtxcb) {
+		p_mtxcb = &((*p_mtxcb)->prevmtx);
+	}
+	*p_mtxcb = mtxcb->prevmtx;
+
+	if (queue_empty(&(mtxcb->wait_queue))) {
+		mtxcb->mtxtsk = NULL;
+	}
+	else {
+		tcb = (TCB *) queue_delete_next(&(mtxcb->wait_queue));
+		mutex_lock(mtxcb, tcb);
+		if (wait_complete(tcb)) {
+			dspreq = TRUE;
+		}
+		if (mutex_change_priority(tcb)) {
+			dspreq = TRUE;
+		}
+	}
+	return(dspreq);
+}
+
+/*
+ *  Unlock all mutexes locked by a task
+ */
+#ifdef __mtxrel
+
+BOOL
+mutex_release_all(TCB *tcb)
+{
+	BOOL	dspreq = FALSE;
+
+	while (tcb->lastmtx != NULL) {
+		if (mutex_unlock(tcb->lastmtx)) {
+			dspreq = TRUE;
+		}
+	}
+	return(dspreq);
+}
+
+#endif /* __mtxrel */
+
+/*
+ *  Lock a mutex
+ */
+#ifdef __loc_mtx
+
+SYSCALL ER
+loc_mtx(ID mtxid)
+{
+	MTXCB	*mtxcb;
+	WINFO_WOBJ winfo;
+	ER	ercd;
+
+	LOG_LOC_MTX_ENTER(mtxid);
+	CHECK_DISPATCH();
+	CHECK_MTXID(mtxid);
+	mtxcb = get_mtxcb(mtxid);
+
+	t_lock_cpu();
+	if (MTX_CEILING(mtxcb)
+			&& runtsk->bpriority < mtxcb->mtxinib->ceilpri) {
+		ercd = E_ILUSE;
+	}
+	else if (mtxcb->mtxtsk == NULL) {
+		mutex_lock(mtxcb, runtsk);
+		if (mutex_change_priority(runtsk)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	else if (mtxcb->mtxtsk == runtsk) {
+		ercd = E_ILUSE;
+	}
+	else {
+		wobj_make_wait((WOBJCB *) mtxcb, &winfo);
+		mutex_make_wait(mtxcb);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_LOC_MTX_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __loc_mtx */
+
+/*
+ *  Lock a mutex (polling)
+ */
+#ifdef __ploc_mtx
+
+SYSCALL ER
+ploc_mtx(ID mtxid)
+{
+	MTXCB	*mtxcb;
+	ER	ercd;
+
+	LOG_PLOC_MTX_ENTER(mtxid);
+	CHECK_TSKCTX_UNL();
+	CHECK_MTXID(mtxid);
+	mtxcb = get_mtxcb(mtxid);
+
+	t_lock_cpu();
+	if (MTX_CEILING(mtxcb)
+			&& runtsk->bpriority < mtxcb->mtxinib->ceilpri) {
+		ercd = E_ILUSE;
+	}
+	else if (mtxcb->mtxtsk == NULL) {
+		mutex_lock(mtxcb, runtsk);
+		if (mutex_change_priority(runtsk)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	else if (mtxcb->mtxtsk == runtsk) {
+		ercd = E_ILUSE;
+	}
+	else {
+		ercd = E_TMOUT;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_PLOC_MTX_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __ploc_mtx */
+
+/*
+ *  Lock a mutex (with timeout)
+ */
+#ifdef __tloc_mtx
+
+SYSCALL ER
+tloc_mtx(ID mtxid, TMO tmout)
+{
+	MTXCB	*mtxcb;
+	WINFO_WOBJ winfo;
+	TMEVTB	tmevtb;
+	ER	ercd;
+
+	LOG_TLOC_MTX_ENTER(mtxid, tmout);
+	CHECK_DISPATCH();
+	CHECK_MTXID(mtxid);
+	CHECK_TMOUT(tmout);
+	mtxcb = get_mtxcb(mtxid);
+
+	t_lock_cpu();
+	if (MTX_CEILING(mtxcb)
+			&& runtsk->bpriority < mtxcb->mtxinib->ceilpri) {
+		ercd = E_ILUSE;
+	}
+	else if (mtxcb->mtxtsk == NULL) {
+		mutex_lock(mtxcb, runtsk);
+		if (mutex_change_priority(runtsk)) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	else if (mtxcb->mtxtsk == runtsk) {
+		ercd = E_ILUSE;
+	}
+	else if (tmout == TMO_POL) {
+		ercd = E_TMOUT;
+	}
+	else {
+		wobj_make_wait_tmout((WOBJCB *) mtxcb, &winfo, &tmevtb, tmout);
+		mutex_make_wait(mtxcb);
+		dispatch();
+		ercd = winfo.winfo.wercd;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_TLOC_MTX_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __tloc_mtx */
+
+/*
+ *  Unlock a mutex
+ */
+#ifdef __unl_mtx
+
+SYSCALL ER
+unl_mtx(ID mtxid)
+{
+	MTXCB	*mtxcb;
+	BOOL	dspreq;
+	ER	ercd;
+
+	LOG_UNL_MTX_ENTER(mtxid);
+	CHECK_TSKCTX_UNL();
+	CHECK_MTXID(mtxid);
+	mtxcb = get_mtxcb(mtxid);
+
+	t_lock_cpu();
+	if (mtxcb->mtxtsk != runtsk) {
+		ercd = E_ILUSE;
+	}
+	else {
+		dspreq = mutex_unlock(mtxcb);
+		if (mutex_change_priority(runtsk)) {
+			dspreq = TRUE;
+		}
+		if (dspreq) {
+			dispatch();
+		}
+		ercd = E_OK;
+	}
+	t_unlock_cpu();
+
+    exit:
+	LOG_UNL_MTX_LEAVE(ercd);
+	return(ercd);
+}
+
+#endif /* __unl_mtx */
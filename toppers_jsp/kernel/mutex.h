@@ -0,0 +1,134 @@
+/*
+ *  TOPPERS/JSP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Just Standard Profile Kernel
+ * 
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ * 
+ *  嵭Ԥϡʲ (1)(4) ξ狼Free Software Foundation 
+ *  ˤäƸɽƤ GNU General Public License  Version 2 ˵
+ *  ҤƤ˸¤ꡤܥեȥܥեȥ
+ *  ѤΤޤࡥʲƱˤѡʣѡۡʰʲ
+ *  ѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
+ *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
+ *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
+ *      ˴ޤޤƤ뤳ȡ
+ *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
+ *      ѤǤǺۤˤϡۤȼɥȡ
+ *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
+ *      ̵ݾڵǺܤ뤳ȡ
+ *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
+ *      ѤǤʤǺۤˤϡΤ줫ξ
+ *      ȡ
+ *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
+ *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
+ *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
+ *        𤹤뤳ȡ
+ *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
+ *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
+ * 
+ *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
+ *  TOPPERSץȤϡܥեȥ˴ؤơŬѲǽ
+ *  ޤơʤݾڤԤʤޤܥեȥѤˤľ
+ *  ŪޤϴŪʤ»˴ؤƤ⡤Ǥʤ
+ */
+
+/*
+ *	Mutexes
+ */
+
+#ifndef _MUTEX_H_
+#define _MUTEX_H_
+
+#include "queue.h"
+#include "task.h"
+#include "wait.h"
+
+/*
+ *  Wait queue order of a mutex
+ *
+ *  The common waiting routines of wait.c queue a task by priority when
+ *  TA_TPRI is set in the first attribute of the initialization block.
+ *  Tasks waiting for a TA_INHERIT or TA_CEILING mutex are always queued
+ *  by priority, so the initialization block keeps the queue order in
+ *  wobjatr and the attribute given to CRE_MTX in mtxatr.
+ */
+#define	MTX_WOBJATR(mtxatr)	(((mtxatr) == TA_TFIFO) ? TA_TFIFO : TA_TPRI)
+
+/*
+ *  Mutex initialization block
+ */
+typedef struct mutex_initialization_block {
+	ATR	wobjatr;	/* wait queue order (TA_TFIFO or TA_TPRI) */
+	ATR	mtxatr;		/* mutex attribute */
+	UINT	ceilpri;	/* ceiling priority (internal) */
+} MTXINIB;
+
+/*
+ *  Mutex control block
+ *
+ *  The mutexes locked by a task are linked from lastmtx in its TCB
+ *  through prevmtx, the last locked one first.
+ */
+typedef struct mutex_control_block {
+	QUEUE	wait_queue;	/* tasks waiting to lock the mutex */
+	const MTXINIB *mtxinib;	/* initialization block */
+	TCB	*mtxtsk;	/* task that has locked the mutex, or NULL */
+	struct mutex_control_block *prevmtx;
+				/* mutex locked by mtxtsk before this one */
+} MTXCB;
+
+/*
+ *  Mutex a task waits for (only when TS_WAIT_MTX is set)
+ */
+#define	WAIT_MTXCB(tcb)	((MTXCB *)(((WINFO_WOBJ *)((tcb)->winfo))->wobjcb))
+
+/*
+ *  Initialization
+ */
+extern void	mutex_initialize(void);
+
+/*
+ *  Current priority of a task
+ *
+ *  Returns the highest of the base priority of tcb, the ceilings of
+ *  the TA_CEILING mutexes it has locked and the priorities of the tasks
+ *  waiting for the TA_INHERIT mutexes it has locked.
+ */
+extern UINT	mutex_calc_priority(TCB *tcb);
+
+/*
+ *  Update the current priority of a task
+ *
+ *  Sets the priority of tcb to mutex_calc_priority(tcb).  If tcb waits
+ *  for a TA_INHERIT mutex, the priority of its owner is updated in turn,
+ *  and so on along the chain.  Returns TRUE when a dispatch is needed.
+ */
+extern BOOL	mutex_change_priority(TCB *tcb);
+
+/*
+ *  Check a base priority against the ceilings
+ *
+ *  Returns FALSE when bpriority is higher than the ceiling of a
+ *  TA_CEILING mutex that tcb has locked or waits for.
+ */
+extern BOOL	mutex_check_ceilpri(TCB *tcb, UINT bpriority);
+
+/*
+ *  A waiting task left the queue of mtxcb or changed its priority
+ *
+ *  Updates the priority of the owner of a TA_INHERIT mutex.  Returns
+ *  TRUE when a dispatch is needed.
+ */
+extern BOOL	mutex_update_owner(MTXCB *mtxcb);
+
+/*
+ *  Unlock all mutexes locked by a task (on termination)
+ *
+ *  Each mutex is passed on to its first waiting task.  The priority of
+ *  tcb itself is left as it is.  Returns TRUE when a dispatch is needed.
+ */
+extern BOOL	mutex_release_all(TCB *tcb);
+
+#endif /* _MUTEX_H_ */
@@ -44,6 +44,7 @@
 
 #include "jsp_kernel.h"
 #include "task.h"
+#include "mutex.h"
 #include <cpu_context.h>
 
 #ifdef __tskini
@@ -245,6 +246,8 @@ void
 make_dormant(TCB *tcb)
 {
 	tcb->priority = tcb->tinib->ipriority;
+	tcb->bpriority = tcb->tinib->ipriority;
+	tcb->lastmtx = NULL;
 	tcb->tstat = TS_DORMANT;
 	tcb->wupcnt = FALSE;
 	tcb->enatex = FALSE;
@@ -277,6 +280,7 @@ make_active(TCB *tcb)
 void
 exit_task()
 {
+	(void) mutex_release_all(runtsk);
 	make_non_runnable(runtsk);
 	make_dormant(runtsk);
 	if (runtsk->actcnt) {
@@ -71,6 +71,8 @@
 #define	TS_WAIT_SLEEP	0x08u	/* Ԥ */
 #define	TS_WAIT_WOBJ	0x10u	/* Ʊ֥̿ȤФԤ */
 #define	TS_WAIT_WOBJCB	0x20u	/* ʬԤ塼ˤĤʤäƤ */
+#define	TS_WAIT_MTX	0x40u	/* ߥ塼ƥåΥåԤ */
+#define	TS_WAIT_SMBF	0x80u	/* åХåեؤԤ */
 
 /*
  *  Ƚ̥ޥ
@@ -164,7 +166,7 @@ typedef struct task_initialization_block {
  *  åȰ¸˥եɤΥӥåѹ뤳ȤƤ롥
  */
 #ifndef TBIT_TCB_TSTAT
-#define	TBIT_TCB_TSTAT		6	/* tstat եɤΥӥå */
+#define	TBIT_TCB_TSTAT		8	/* tstat եɤΥӥå */
 #endif /* TBIT_TCB_TSTAT */
 
 #ifndef TBIT_TCB_PRIORITY
@@ -190,10 +192,14 @@ typedef struct task_control_block {
 	unsigned int	actcnt : 1;		/* ư׵ᥭ塼 */
 	unsigned int	wupcnt : 1;		/* ׵ᥭ塼 */
 	unsigned int	enatex : 1;		/* 㳰ľ */
+	unsigned int	bpriority : TBIT_TCB_PRIORITY;
+					/* ١ͥ١ɽ*/
 
 	TEXPTN	texptn;		/* α㳰װ */
 	WINFO	*winfo;		/* Ԥ֥åؤΥݥ */
 	CTXB	tskctxb;	/* ƥȥ֥å */
+	struct mutex_control_block *lastmtx;
+				/* Ǹ˥åߥ塼ƥå */
 } TCB;
 
 /*
@@ -365,6 +371,8 @@ extern void	exit_task(void);
  *  ѹ롥ޤɬפʾˤϺǹ̤ͥΥ򹹿ǥ
  *  ѥåľ֤Ǥ TRUE ֤Ǥʤ FALSE 
  *  
+ *  The priorities raised and restored by mutexes are changed through
+ *  this function as well (mutex_change_priority in mutex.c).
  */
 extern BOOL	change_priority(TCB *tcb, UINT newpri);
 
@@ -44,6 +44,8 @@
 #include "check.h"
 #include "task.h"
 #include "wait.h"
+#include "mutex.h"
+#include "messagebuf.h"
 
 /*
  *  εư
@@ -219,6 +221,7 @@ ter_tsk(ID tskid)
 {
 	TCB	*tcb;
 	UINT	tstat;
+	BOOL	dspreq;
 	ER	ercd;
 
 	LOG_TER_TSK_ENTER(tskid);
@@ -232,19 +235,25 @@ ter_tsk(ID tskid)
 		ercd = E_OBJ;
 	}
 	else {
+		dspreq = mutex_release_all(tcb);
 		if (TSTAT_RUNNABLE(tstat)) {
 			make_non_runnable(tcb);
 		}
 		else if (TSTAT_WAITING(tstat)) {
-			wait_cancel(tcb);
+			if (wait_cancel(tcb)) {
+				dspreq = TRUE;
+			}
 		}
 		make_dormant(tcb);
 		if (tcb->actcnt) {
 			tcb->actcnt = FALSE;
 			if (make_active(tcb)) {
-				dispatch();
+				dspreq = TRUE;
 			}
 		}
+		if (dspreq) {
+			dispatch();
+		}
 		ercd = E_OK;
 	}
 	t_unlock_cpu();
@@ -281,17 +290,30 @@ chg_pri(ID tskid, PRI tskpri)
 	if (TSTAT_DORMANT(tstat = tcb->tstat)) {
 		ercd = E_OBJ;
 	}
+	else if (!mutex_check_ceilpri(tcb, newpri)) {
+		ercd = E_ILUSE;
+	}
 	else if (TSTAT_RUNNABLE(tstat)) {
-		if (change_priority(tcb, newpri)) {
+		tcb->bpriority = newpri;
+		if (change_priority(tcb, mutex_calc_priority(tcb))) {
 			dispatch();
 		}
 		ercd = E_OK;
 	}
 	else {
-		tcb->priority = newpri;
+		tcb->bpriority = newpri;
+		tcb->priority = mutex_calc_priority(tcb);
 		if ((tstat & TS_WAIT_WOBJCB) != 0) {
 			wobj_change_priority(((WINFO_WOBJ *)(tcb->winfo))
 							->wobjcb, tcb);
+			if ((tstat & TS_WAIT_MTX) != 0
+					&& mutex_update_owner(WAIT_MTXCB(tcb))) {
+				dispatch();
+			}
+			if ((tstat & TS_WAIT_SMBF) != 0
+					&& messagebuf_signal(WAIT_MBFCB(tcb))) {
+				dispatch();
+			}
 		}
 		ercd = E_OK;
 	}
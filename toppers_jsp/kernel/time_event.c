@@ -49,8 +49,13 @@
 /*
  *  ।٥ȥҡޥ
  */
+#ifndef TMEVT_HEAP4
 #define	PARENT(index)	((index) >> 1)		/* ƥΡɤ */
 #define	LCHILD(index)	((index) << 1)		/* λҥΡɤ */
+#else /* TMEVT_HEAP4 */
+#define	PARENT(index)	(((index) + 2) >> 2)	/* parent node */
+#define	LCHILD(index)	(((index) << 2) - 2)	/* first of the 4 children */
+#endif /* TMEVT_HEAP4 */
 #define	TMEVT_NODE(index)	(tmevt_heap[(index) - 1])
 
 /*
@@ -94,6 +99,16 @@ UINT	next_subtime;
  */
 UINT	last_index;
 
+#ifdef TMEVT_WHEEL
+/*
+ *  Timing wheel
+ */
+TMEVTB	*tmevt_wheel_first[TNUM_TMEVT_SLOT];
+TMEVTB	*tmevt_wheel_last[TNUM_TMEVT_SLOT];
+TMEVTB	*tmevt_wheel_next;
+EVTTIM	tmevt_wheel_time;
+#endif /* TMEVT_WHEEL */
+
 /*
  *  ޥ⥸塼ν
  */
@@ -110,10 +125,24 @@ tmevt_initialize(void)
 	next_subtime %= TIC_DENO;
 #endif /* TIC_DENO == 1 */
 	last_index = 0;
+#ifdef TMEVT_WHEEL
+	{
+		UINT	slot;
+
+		for (slot = 0; slot < TNUM_TMEVT_SLOT; slot++) {
+			tmevt_wheel_first[slot] = NULL;
+			tmevt_wheel_last[slot] = NULL;
+		}
+		tmevt_wheel_next = NULL;
+		tmevt_wheel_time = current_time;
+	}
+#endif /* TMEVT_WHEEL */
 }
 
 #endif /* __tmeini */
 
+#ifndef TMEVT_WHEEL
+
 /*
  *  ।٥Ȥ֤õ
  *
@@ -167,8 +196,12 @@ UINT
 tmevt_down(UINT index, EVTTIM time)
 {
 	UINT	child;
+#ifdef TMEVT_HEAP4
+	UINT	i, last;
+#endif /* TMEVT_HEAP4 */
 
 	while ((child = LCHILD(index)) <= last_index) {
+#ifndef TMEVT_HEAP4
 		/*
 		 *  λҥΡɤΥ٥ȯӤᤤ
 		 *  ҥΡɤΰ֤ child ꤹ롥ʲλҥΡ
@@ -179,6 +212,20 @@ tmevt_down(UINT index, EVTTIM time)
 				  TMEVT_NODE(child).time)) {
 			child = child + 1;
 		}
+#else /* TMEVT_HEAP4 */
+		/*
+		 *  Select the earliest of the (up to 4) children.
+		 */
+		last = child + 3;
+		if (last > last_index) {
+			last = last_index;
+		}
+		for (i = child + 1; i <= last; i++) {
+			if (EVTTIM_LT(TMEVT_NODE(i).time, TMEVT_NODE(child).time)) {
+				child = i;
+			}
+		}
+#endif /* TMEVT_HEAP4 */
 
 		/*
 		 *  ҥΡɤΥ٥ȯ٤ʤޤƱ
@@ -323,6 +370,128 @@ tmevtb_delete_top(void)
 	TMEVT_NODE(index).tmevtb->index = index;
 }
 
+#else /* TMEVT_WHEEL */
+
+/*
+ *  Insertion into the timing wheel
+ *
+ *  The event is appended to the slot of its time.  An event whose slot
+ *  has already been scanned is due at once, as with the heap:
+ *
+ *  - Outside isig_tim (tmevt_wheel_time == current_time), e.g. a cyclic
+ *    handler with phase 0 at initialization, it goes to the slot that
+ *    the next tick scans first.
+ *  - Within tmevt_wheel_expire, e.g. a cyclic handler started at phase
+ *    0 that re-arms itself for a time the scan has passed, it goes to
+ *    the slot being scanned.  If no event is left to look at there, it
+ *    becomes tmevt_wheel_next, so that it is called in the same call.
+ */
+#ifdef __tmeins
+
+void
+tmevtb_insert(TMEVTB *tmevtb, EVTTIM time)
+{
+	UINT	slot;
+	TMEVTB	*last;
+
+	if (!EVTTIM_LE(time, tmevt_wheel_time)) {
+		slot = TMEVT_SLOT(time);
+	}
+	else if (tmevt_wheel_time == current_time) {
+		slot = TMEVT_SLOT(tmevt_wheel_time + 1);
+	}
+	else {
+		slot = TMEVT_SLOT(tmevt_wheel_time);
+		if (tmevt_wheel_next == NULL) {
+			tmevt_wheel_next = tmevtb;
+		}
+	}
+	last = tmevt_wheel_last[slot];
+
+	tmevtb->index = slot;
+	tmevtb->time = time;
+	tmevtb->next = NULL;
+	tmevtb->prev = last;
+	if (last != NULL) {
+		last->next = tmevtb;
+	}
+	else {
+		tmevt_wheel_first[slot] = tmevtb;
+	}
+	tmevt_wheel_last[slot] = tmevtb;
+	last_index++;
+}
+
+#endif /* __tmeins */
+
+/*
+ *  Removal from the timing wheel
+ */
+#ifdef __tmedel
+
+void
+tmevtb_delete(TMEVTB *tmevtb)
+{
+	UINT	slot = tmevtb->index;
+	TMEVTB	*next = tmevtb->next;
+	TMEVTB	*prev = tmevtb->prev;
+
+	if (tmevtb == tmevt_wheel_next) {
+		tmevt_wheel_next = next;
+	}
+	if (prev != NULL) {
+		prev->next = next;
+	}
+	else {
+		tmevt_wheel_first[slot] = next;
+	}
+	if (next != NULL) {
+		next->prev = prev;
+	}
+	else {
+		tmevt_wheel_last[slot] = prev;
+	}
+	last_index--;
+}
+
+#endif /* __tmedel */
+
+/*
+ *  Expiry of the time events up to next_time
+ *
+ *  The slots of the times in (current_time, next_time] are scanned in
+ *  time order.  A slot also holds the events of later rounds of the
+ *  wheel, which are skipped.  The callbacks may delete any event,
+ *  including the next one to look at (tmevt_wheel_next).
+ */
+Inline void
+tmevt_wheel_expire(void)
+{
+	TMEVTB	*tmevtb;
+
+	while (tmevt_wheel_time != next_time) {
+		tmevt_wheel_time++;
+		tmevtb = tmevt_wheel_first[TMEVT_SLOT(tmevt_wheel_time)];
+		while (tmevtb != NULL) {
+			tmevt_wheel_next = tmevtb->next;
+			if (EVTTIM_LE(tmevtb->time, next_time)) {
+				tmevtb_delete(tmevtb);
+				(*(tmevtb->callback))(tmevtb->arg);
+
+				/*
+				 *  ͥ٤ι⤤ߤդ롥
+				 */
+				i_unlock_cpu();
+				i_lock_cpu();
+			}
+			tmevtb = tmevt_wheel_next;
+		}
+	}
+	tmevt_wheel_next = NULL;
+}
+
+#endif /* TMEVT_WHEEL */
+
 /*
  *  ƥåζ
  *
@@ -334,7 +503,9 @@ tmevtb_delete_top(void)
 SYSCALL ER
 isig_tim(void)
 {
+#ifndef TMEVT_WHEEL
 	TMEVTB	*tmevtb;
+#endif /* TMEVT_WHEEL */
 	ER	ercd;
 
 	LOG_ISIG_TIM_ENTER();
@@ -346,6 +517,7 @@ isig_tim(void)
 	 *  ٥Ȥ򡤥।٥ȥҡפХåؿ
 	 *  ƤӽФ
 	 */
+#ifndef TMEVT_WHEEL
 	while (last_index > 0 && EVTTIM_LE(TMEVT_NODE(1).time, next_time)) {
 		tmevtb = TMEVT_NODE(1).tmevtb;
 		tmevtb_delete_top();
@@ -357,6 +529,9 @@ isig_tim(void)
 		i_unlock_cpu();
 		i_lock_cpu();
 	}
+#else /* TMEVT_WHEEL */
+	tmevt_wheel_expire();
+#endif /* TMEVT_WHEEL */
 
 	/*
 	 *  current_time 򹹿롥
@@ -58,6 +58,35 @@ typedef UW	EVTTIM;
  */
 #define	TMAX_RELTIM	((((EVTTIM) 1) << (sizeof(EVTTIM) * CHAR_BIT - 1)) - 1)
 
+/*
+ *  Time event queue
+ *
+ *  The time events are kept in one of the following queues, selected
+ *  when the kernel is compiled:
+ *
+ *    (default)		binary heap in tmevt_heap
+ *    TMEVT_HEAP4	4-ary heap in tmevt_heap.  It has half as many levels,
+ *			so fewer nodes (and the index of their TMEVTB) are
+ *			moved on insertion and deletion, and the children
+ *			of a node are adjacent in memory.
+ *    TMEVT_WHEEL	timing wheel of TNUM_TMEVT_SLOT slots.  Insertion
+ *			and deletion take constant time; isig_tim looks at
+ *			the slots of the elapsed ticks only.  tmevt_heap
+ *			is not used.
+ *
+ *  The rest of the kernel uses the queue only through tmevtb_enqueue,
+ *  tmevtb_enqueue_evttim, tmevtb_dequeue and isig_tim.
+ */
+#ifdef TMEVT_WHEEL
+
+#ifndef TNUM_TMEVT_SLOT
+#define	TNUM_TMEVT_SLOT	64u		/* must be a power of 2 */
+#endif /* TNUM_TMEVT_SLOT */
+
+#define	TMEVT_SLOT(time)	((UINT)((time) & (TNUM_TMEVT_SLOT - 1u)))
+
+#endif /* TMEVT_WHEEL */
+
 /* 
  *  ।٥ȥ֥åΥǡ
  */
@@ -67,6 +96,11 @@ typedef struct time_event_block {
 	UINT	index;		/* ।٥ȥҡǤΰ */
 	CBACK	callback;	/* Хåؿ */
 	VP	arg;		/* ХåؿϤ */
+#ifdef TMEVT_WHEEL
+	struct time_event_block	*next;	/* next event in the slot */
+	struct time_event_block	*prev;	/* previous event in the slot */
+	EVTTIM	time;		/* event time (index holds the slot) */
+#endif /* TMEVT_WHEEL */
 } TMEVTB;
 
 /*
@@ -82,6 +116,21 @@ typedef struct time_event_node {
  */
 extern TMEVTN	tmevt_heap[];
 
+#ifdef TMEVT_WHEEL
+/*
+ *  Timing wheel
+ *
+ *  tmevt_wheel_first/tmevt_wheel_last hold the first and the last
+ *  event of each slot.  tmevt_wheel_time is the time whose slot isig_tim
+ *  is scanning (current_time outside isig_tim), and tmevt_wheel_next
+ *  the next event it looks at in that slot.
+ */
+extern TMEVTB	*tmevt_wheel_first[];
+extern TMEVTB	*tmevt_wheel_last[];
+extern TMEVTB	*tmevt_wheel_next;
+extern EVTTIM	tmevt_wheel_time;
+#endif /* TMEVT_WHEEL */
+
 /*
  *  ƥΥեå
  */
@@ -126,6 +175,7 @@ extern UINT	next_subtime;
  *  ।٥ȥҡפκǸλΰΥǥå
  *
  *  ।٥ȥҡפϿƤ륿।٥Ȥο˰פ롥
+ *  With TMEVT_WHEEL, the number of time events in the wheel.
  */
 extern UINT	last_index;
 
@@ -137,8 +187,10 @@ extern void	tmevt_initialize(void);
 /*
  *  ।٥Ȥ֤õ
  */
+#ifndef TMEVT_WHEEL
 extern UINT	tmevt_up(UINT index, EVTTIM time);
 extern UINT	tmevt_down(UINT index, EVTTIM time);
+#endif /* TMEVT_WHEEL */
 
 /*
  *  ।٥ȥҡפؤϿȺ
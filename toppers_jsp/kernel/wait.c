@@ -42,6 +42,8 @@
 
 #include "jsp_kernel.h"
 #include "wait.h"
+#include "mutex.h"
+#include "messagebuf.h"
 
 /*
  *  Ԥ֤ؤΰܹԡʥॢȻ
@@ -122,6 +124,14 @@ wait_tmout(TCB *tcb)
 {
 	if ((tcb->tstat & TS_WAIT_WOBJ) != 0) {
 		queue_delete(&(tcb->task_queue));
+		if ((tcb->tstat & TS_WAIT_MTX) != 0
+				&& mutex_update_owner(WAIT_MTXCB(tcb))) {
+			reqflg = TRUE;
+		}
+		if ((tcb->tstat & TS_WAIT_SMBF) != 0
+				&& messagebuf_signal(WAIT_MBFCB(tcb))) {
+			reqflg = TRUE;
+		}
 	}
 	tcb->winfo->wercd = E_TMOUT;
 	if (make_non_wait(tcb)) {
@@ -148,7 +158,7 @@ wait_tmout_ok(TCB *tcb)
  */
 #ifdef __waican
 
-void
+BOOL
 wait_cancel(TCB *tcb)
 {
 	if (tcb->winfo->tmevtb != NULL) {
@@ -156,7 +166,14 @@ wait_cancel(TCB *tcb)
 	}
 	if ((tcb->tstat & TS_WAIT_WOBJ) != 0) {
 		queue_delete(&(tcb->task_queue));
+		if ((tcb->tstat & TS_WAIT_MTX) != 0) {
+			return(mutex_update_owner(WAIT_MTXCB(tcb)));
+		}
+		if ((tcb->tstat & TS_WAIT_SMBF) != 0) {
+			return(messagebuf_signal(WAIT_MBFCB(tcb)));
+		}
 	}
+	return(FALSE);
 }
 
 #endif /* __waican */
@@ -165,9 +182,14 @@ wait_cancel(TCB *tcb)
 BOOL
 wait_release(TCB *tcb)
 {
-	wait_cancel(tcb);
+	BOOL	dspreq;
+
+	dspreq = wait_cancel(tcb);
 	tcb->winfo->wercd = E_RLWAI;
-	return(make_non_wait(tcb));
+	if (make_non_wait(tcb)) {
+		dspreq = TRUE;
+	}
+	return(dspreq);
 }
 
 #endif /* __wairel */
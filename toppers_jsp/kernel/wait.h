@@ -107,8 +107,11 @@ extern void	wait_tmout_ok(TCB *tcb);
  *  wait_release ϡξ֤򹹿Ԥ
  *  ͤ E_RLWAI Ȥ롥ޤԤؤΥǥѥåɬ
  *  פʾˤ TRUE ֤
+ *  When the task waited for a TA_INHERIT mutex, the priority of the
+ *  owner is lowered again; both functions return TRUE if this needs a
+ *  dispatch.
  */
-extern void	wait_cancel(TCB *tcb);
+extern BOOL	wait_cancel(TCB *tcb);
 extern BOOL	wait_release(TCB *tcb);
 
 /*
@@ -51,4 +51,27 @@ extern void disable_int(void);
 extern void enable_int(void);
 extern void nop(void);
 
+/*
+ *  Interrupt disable with save/restore (cpu_support.S)
+ */
+extern UINT32 save_disable_int(void);
+extern void restore_int(UINT32 flags);
+
+/*
+ *  Bit search with the CLZ instruction
+ *
+ *  CLZ exists from ARMv5 on.  The ARM7TDMI core of the AT91SAM7S
+ *  (ARMv4T) does not have it, so the NXT uses the table search of
+ *  task.c on purpose; a CLZ built from shifts would take more steps.
+ */
+#ifdef __ARM_FEATURE_CLZ
+#define CPU_BITMAP_SEARCH
+
+Inline Priority
+bitmap_search(UINT32 bitmap)
+{
+	return((Priority)(31 - __builtin_clz(bitmap)));
+}
+#endif /* __ARM_FEATURE_CLZ */
+
 #endif /* _CPU_INSN_H_ */
@@ -196,6 +196,12 @@ uart_isr_entry_1:
 @	irq_wrapper_nested uart_isr_C_1
 	irq_wrapper_type2 uart_isr_C_1 8
 
+	.extern bt_isr_C
+	.global bt_isr_entry
+bt_isr_entry:
+@	irq_wrapper_nested bt_isr_C
+	irq_wrapper_type2 bt_isr_C 8
+
 	.extern nxt_motor_isr_C
 	.global nxt_motor_isr_entry
 nxt_motor_isr_entry:
@@ -50,19 +50,28 @@
 #define _TOOL_CONFIG_H_
 
 /*
- *  Jˑ͎̏gpȂ
+ *  g[XR[_(OSEK_TRACE, kernel/trace.h)
  */
-#define tool_initialize()
+#include "trace.h"
+
+/*
+ *  Jˑ̏
+ */
+#define tool_initialize()	trace_initialize()
 
 /*
  *  g[XO̐ݒ
  */
 
-#define LOG_ACTTSK_ENTER(tskid)
+#define LOG_TSKDSP(tskid)		TRACE_TSKDSP_LOG(tskid)
+#define LOG_TSKSWT(tskid)		TRACE_TSKSWT_LOG(tskid)
+#define LOG_TSKEXT(tskid)		TRACE_TSKEXT_LOG(tskid)
+
+#define LOG_ACTTSK_ENTER(tskid)	TRACE_ACTTSK_LOG(tskid)
 #define LOG_ACTTSK_LEAVE(ercd)
 #define LOG_TERTSK_ENTER()
 #define LOG_TERTSK_LEAVE(ercd)
-#define LOG_CHNTSK_ENTER(tskid)
+#define LOG_CHNTSK_ENTER(tskid)	TRACE_ACTTSK_LOG(tskid)
 #define LOG_CHNTSK_LEAVE(ercd)
 #define LOG_SCHED_ENTER()
 #define LOG_SCHED_LEAVE(ercd)
@@ -82,17 +91,17 @@
 #define LOG_SUSOSI_LEAVE()
 #define LOG_RSMOSI_ENTER()
 #define LOG_RSMOSI_LEAVE()
-#define LOG_GETRES_ENTER(resid)
+#define LOG_GETRES_ENTER(resid)	TRACE_GETRES_LOG(resid)
 #define LOG_GETRES_LEAVE(ercd)
-#define LOG_RELRES_ENTER(resid)
+#define LOG_RELRES_ENTER(resid)	TRACE_RELRES_LOG(resid)
 #define LOG_RELRES_LEAVE(ercd)
-#define LOG_SETEVT_ENTER(tskid, mask)
+#define LOG_SETEVT_ENTER(tskid, mask)	TRACE_SETEVT_LOG(tskid, mask)
 #define LOG_SETEVT_LEAVE(ercd)
 #define LOG_CLREVT_ENTER(mask)
 #define LOG_CLREVT_LEAVE(ercd)
 #define LOG_GETEVT_ENTER(tskid, p_mask)
 #define LOG_GETEVT_LEAVE(ercd, mask)
-#define LOG_WAIEVT_ENTER(mask)
+#define LOG_WAIEVT_ENTER(mask)	TRACE_WAIEVT_LOG(mask)
 #define LOG_WAIEVT_LEAVE(ercd)
 #define LOG_GETALB_ENTER(almid, info)
 #define LOG_GETALB_LEAVE(ercd)
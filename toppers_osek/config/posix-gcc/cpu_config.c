@@ -0,0 +1,348 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *  Processor dependent module (POSIX host simulation)
+ *
+ *  The structure follows cpu_support.S of the AT91SAM7S port: a task
+ *  gives up the CPU by switching to the dispatcher, which runs on its
+ *  own system context together with the idle loop, and an interrupt
+ *  that makes another task ready ends with a dispatch (ret_int).
+ *
+ *  Interrupts are emulated with a software CPU lock (cpu_insn.h) and a
+ *  pending flag.  The system layer raises them either from the idle
+ *  loop (virtual time) or from a SIGALRM handler (real time).
+ */
+
+
+#include	"osek_kernel.h"
+#include	"task.h"
+#include	"interrupt.h"
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<ucontext.h>
+
+/*
+ *  Host context of a task
+ */
+typedef struct cpu_context_block {
+	ucontext_t	uc;
+	UINT8		stk[CPU_TASK_STKSZ];
+} CTXB;
+
+/*
+ *  CPU lock and interrupt state
+ *
+ *  The CPU is locked until start_dispatch() enters the first task.
+ */
+volatile UINT8	int_lock_flag = TRUE;
+volatile UINT8	int_pend_flag = FALSE;
+UINT8			int_nest = 0;
+UINT8			cpu_ipl = IPL_ENA_ALL;
+
+static volatile FP		int_pend_isr;
+static volatile IsrType	int_pend_isrid;
+
+/*
+ *  System context (dispatcher and idle loop)
+ */
+static ucontext_t	dispatcher_uc;
+static UINT8		system_stack[CPU_SYSTEM_STKSZ];
+
+static CTXB	*task_context(TaskType tskid);
+static void	dispatcher(void);
+static void	idle_loop(void);
+static void	interrupt(IsrType isrid, FP isr);
+
+/*
+ *  Processor dependent initialization
+ */
+void
+cpu_initialize(void)
+{
+	TaskType	tskid;
+
+	for (tskid = 0; tskid < tnum_task; tskid++) {
+		tcxb_pc[tskid] = NULL;
+		tcxb_sp[tskid] = NULL;
+	}
+}
+
+/*
+ *  Processor dependent termination
+ */
+void
+cpu_terminate(void)
+{
+	TaskType	tskid;
+
+	for (tskid = 0; tskid < tnum_task; tskid++) {
+		free(tcxb_sp[tskid]);
+		tcxb_sp[tskid] = NULL;
+	}
+}
+
+/*
+ *  Task start routine
+ *
+ *  Entered through makecontext() when a task is dispatched for the
+ *  first time after its activation.
+ */
+void
+activate_r(void)
+{
+	tcb_curpri[runtsk] = tinib_exepri[runtsk];
+	LOG_TSK_START(runtsk);
+	enable_int();
+	(*tinib_task[runtsk])();
+
+	/*
+	 *  A task must end with TerminateTask or ChainTask; returning from
+	 *  the task body is a fatal application error.
+	 */
+	fprintf(stderr, "task %u returned without TerminateTask\n",
+			(unsigned int) runtsk);
+	abort();
+}
+
+/*
+ *  Give up the CPU from a task (or from ret_int)
+ *
+ *  Called with the CPU locked.  Returns when the task is dispatched
+ *  again.
+ */
+void
+dispatch(void)
+{
+	CTXB	*ctxb = (CTXB *) tcxb_sp[runtsk];
+
+	LOG_DSP_ENTER();
+	swapcontext(&(ctxb->uc), &dispatcher_uc);
+	LOG_DSP_LEAVE();
+}
+
+/*
+ *  Leave the running task for good (TerminateTask, ChainTask)
+ */
+void
+exit_and_dispatch(void)
+{
+	setcontext(&dispatcher_uc);
+}
+
+/*
+ *  Start the first dispatch (called once from StartOS)
+ */
+void
+start_dispatch(void)
+{
+	getcontext(&dispatcher_uc);
+	dispatcher_uc.uc_stack.ss_sp = system_stack;
+	dispatcher_uc.uc_stack.ss_size = sizeof(system_stack);
+	dispatcher_uc.uc_link = NULL;
+	makecontext(&dispatcher_uc, dispatcher, 0);
+	setcontext(&dispatcher_uc);
+}
+
+/*
+ *  Host context of a task to be dispatched
+ *
+ *  Allocates the context on the first dispatch of the task and builds
+ *  a fresh one after an activation (activate_context).  ctxb is
+ *  volatile because it is live across getcontext(), which may return
+ *  twice.
+ */
+static CTXB *
+task_context(TaskType tskid)
+{
+	CTXB	*volatile ctxb = (CTXB *) tcxb_sp[tskid];
+
+	if (ctxb == NULL) {
+		ctxb = (CTXB *) malloc(sizeof(CTXB));
+		if (ctxb == NULL) {
+			fprintf(stderr, "no memory for task %u\n", (unsigned int) tskid);
+			abort();
+		}
+		tcxb_sp[tskid] = (VP) ctxb;
+	}
+	if (tcxb_pc[tskid] != NULL) {
+		tcxb_pc[tskid] = NULL;
+		getcontext(&(ctxb->uc));
+		ctxb->uc.uc_stack.ss_sp = ctxb->stk;
+		ctxb->uc.uc_stack.ss_size = sizeof(ctxb->stk);
+		ctxb->uc.uc_link = NULL;
+		makecontext(&(ctxb->uc), activate_r, 0);
+	}
+	return(ctxb);
+}
+
+/*
+ *  Dispatcher
+ *
+ *  Runs on the system context.  Every switch between two tasks goes
+ *  through here, so that a task never builds its new context on the
+ *  stack it is still running on.
+ */
+static void
+dispatcher(void)
+{
+	volatile FP	hook_adr;
+	CTXB		*ctxb;
+
+	for (;;) {
+		/* start_dispatch */
+		runtsk = schedtsk;
+		if (runtsk == INVALID_TASK) {
+			idle_loop();
+			continue;
+		}
+
+		hook_adr = (FP)PreTaskHook;
+		if (hook_adr != NULL) {
+			call_pretaskhook();
+		}
+
+		ctxb = task_context(runtsk);
+		swapcontext(&dispatcher_uc, &(ctxb->uc));
+
+		/* back from dispatch or exit_and_dispatch */
+		hook_adr = (FP)PostTaskHook;
+		if (hook_adr != NULL) {
+			call_posttaskhook();
+		}
+	}
+}
+
+/*
+ *  Idle loop
+ *
+ *  Waits for an interrupt to make a task ready.  As on the AT91SAM7S,
+ *  callevel is TCL_ISR2 while idling.
+ */
+static void
+idle_loop(void)
+{
+	callevel = TCL_ISR2;
+	while (schedtsk == INVALID_TASK) {
+		sys_wait_interrupt();
+		enable_int();
+		disable_int();
+	}
+	callevel = TCL_TASK;
+}
+
+/*
+ *  Raise an interrupt
+ */
+void
+cpu_raise_interrupt(IsrType isrid, FP isr)
+{
+	int_pend_isr = isr;
+	int_pend_isrid = isrid;
+	int_pend_flag = TRUE;
+	if (!int_lock_flag) {
+		cpu_deliver_interrupt();
+	}
+}
+
+/*
+ *  Deliver a pending interrupt
+ *
+ *  Called with the CPU unlocked, from enable_int() or from a signal
+ *  handler.  The lock flag is taken before the pending flag is cleared,
+ *  so that an interrupt is never run twice when a signal arrives in
+ *  between.
+ */
+void
+cpu_deliver_interrupt(void)
+{
+	FP		isr;
+	IsrType	isrid;
+
+	while (int_pend_flag && (int_nest == 0) && (cpu_ipl == IPL_ENA_ALL)) {
+		if (int_lock_flag) {
+			break;
+		}
+		disable_int();
+		if (!int_pend_flag) {
+			enable_int();
+			break;
+		}
+		int_pend_flag = FALSE;
+		isr = int_pend_isr;
+		isrid = int_pend_isrid;
+		interrupt(isrid, isr);
+		Asm("" : : : "memory");
+		int_lock_flag = FALSE;
+	}
+}
+
+/*
+ *  Category 2 interrupt entry
+ *
+ *  Corresponds to irq_wrapper_type2 and _interrupt/int_from_int of the
+ *  AT91SAM7S port.  Called with the CPU locked; returns with the CPU
+ *  locked.
+ */
+static void
+interrupt(IsrType isrid, FP isr)
+{
+	UINT8	saved_callevel = callevel;
+	IsrType	saved_runisr = runisr;
+
+	LOG_INH_ENTER();
+	runisr = isrid;
+	int_nest++;
+	callevel = TCL_ISR2;
+	enable_int();
+	TRACE_ISRENT_LOG(isrid);
+	(*isr)();
+	TRACE_ISREXT_LOG(isrid);
+	disable_int();
+	int_nest--;
+	callevel = saved_callevel;
+	runisr = saved_runisr;
+	LOG_INH_LEAVE();
+
+	/* ret_int */
+	if ((saved_callevel == TCL_TASK) && (schedtsk != runtsk)) {
+		dispatch();
+	}
+}
@@ -0,0 +1,150 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *  Processor dependent module (POSIX host simulation)
+ *
+ *  Tasks run as ucontext coroutines of a single host thread.  The
+ *  dispatcher and the idle loop run on a separate system context, in
+ *  the same way as the AT91SAM7S port switches to __system_stack__.
+ */
+
+
+#ifndef	_CPU_CONFIG_H_
+#define	_CPU_CONFIG_H_
+
+#define MAX_IPM  0xf
+
+/*
+ *  Host stack size of a task and of the system context
+ *
+ *  The STACKSIZE given in the OIL file is sized for the ARM target and
+ *  is far too small for host code calling the C library, so each task
+ *  gets its own host stack of this size instead of tinib_stk[].
+ */
+#ifndef CPU_TASK_STKSZ
+#define CPU_TASK_STKSZ		(64u * 1024u)
+#endif
+#ifndef CPU_SYSTEM_STKSZ
+#define CPU_SYSTEM_STKSZ	(64u * 1024u)
+#endif
+
+
+#ifndef _MACRO_ONLY
+#include "cpu_insn.h"
+#endif /* _MACRO_ONLY */
+
+
+#ifndef _MACRO_ONLY
+/* Inline function prototypes */
+Inline void set_ipl(UINT8 ipl);
+Inline UINT8 current_ipl(void);
+
+/*
+ *  Current interrupt priority level
+ *
+ *  The virtual timer interrupt is blocked while cpu_ipl is above
+ *  IPL_ENA_ALL (i.e. within SuspendOSInterrupts and the hooks).
+ */
+extern UINT8	cpu_ipl;
+
+/*
+ *  Set the interrupt priority level
+ */
+Inline void set_ipl(UINT8 ipl)
+{
+	cpu_ipl = ipl;
+}
+
+
+/*
+ *  Get the interrupt priority level
+ */
+Inline UINT8 current_ipl(void)
+{
+	return cpu_ipl;
+}
+
+
+/*
+ *  Processor dependent initialization (cpu_config.c)
+ */
+extern void	cpu_initialize(void);
+
+/*
+ *  Processor dependent termination (cpu_config.c)
+ */
+extern void	cpu_terminate(void);
+
+/*
+ *  Raise an interrupt (cpu_config.c)
+ *
+ *  Marks the category 2 ISR isr, whose ID is isrid, as pending and
+ *  runs it right away if the CPU is not locked.  May be called from a
+ *  signal handler.
+ */
+extern void	cpu_raise_interrupt(IsrType isrid, FP isr);
+
+/*
+ *  Interrupt nesting level (cpu_config.c), non-zero while an ISR runs
+ */
+extern UINT8	int_nest;
+
+/*
+ *  Task context blocks
+ *
+ *  tcxb_pc[] is activate_r while the task has to be started from its
+ *  entry point, and NULL when it resumes from its saved context.
+ *  tcxb_sp[] points to the host context (ucontext and stack) of the
+ *  task, allocated on its first dispatch.
+ */
+#define DEFINE_CTXB(tnum) \
+FP tcxb_pc[tnum]; \
+VP tcxb_sp[tnum];
+
+extern FP tcxb_pc[];
+extern VP tcxb_sp[];
+
+/* Dispatcher entry points (cpu_config.c) */
+extern void  dispatch(void);
+extern void  exit_and_dispatch(void);
+extern void  start_dispatch(void);
+
+#endif /* _MACRO_ONLY */
+#endif	/* _CPU_CONFIG_H_	*/
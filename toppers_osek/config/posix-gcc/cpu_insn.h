@@ -0,0 +1,119 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *  Low level processor operations (POSIX host simulation)
+ *
+ *  The CPU lock is a software flag.  An interrupt raised while the
+ *  flag is set (or while an ISR is running) is kept pending and is
+ *  delivered by enable_int().  The compiler barriers keep kernel data
+ *  accesses inside the locked region.
+ */
+
+
+#ifndef	_CPU_INSN_H_
+#define	_CPU_INSN_H_
+
+extern volatile UINT8	int_lock_flag;	/* CPU lock flag */
+extern volatile UINT8	int_pend_flag;	/* an interrupt is pending */
+
+extern void cpu_deliver_interrupt(void);
+
+Inline void
+disable_int(void)
+{
+	int_lock_flag = TRUE;
+	Asm("" : : : "memory");
+}
+
+Inline void
+enable_int(void)
+{
+	Asm("" : : : "memory");
+	int_lock_flag = FALSE;
+	if (int_pend_flag) {
+		cpu_deliver_interrupt();
+	}
+}
+
+/*
+ *  Interrupt disable with save/restore
+ *
+ *  For code that may or may not run with the CPU locked.
+ */
+Inline UINT32
+save_disable_int(void)
+{
+	UINT32	flags = int_lock_flag;
+
+	disable_int();
+	return(flags);
+}
+
+Inline void
+restore_int(UINT32 flags)
+{
+	if (!flags) {
+		enable_int();
+	}
+}
+
+Inline void
+nop(void)
+{
+}
+
+/*
+ *  Bit search with count leading zeros
+ *
+ *  Returns the number of the highest set bit (task.c).  bitmap must
+ *  not be 0.  With OMIT_BITMAP_SEARCH the table search of task.c is
+ *  used instead, as on the AT91SAM7S (test/schedbench compares them).
+ */
+#ifndef OMIT_BITMAP_SEARCH
+#define CPU_BITMAP_SEARCH
+
+Inline Priority
+bitmap_search(UINT32 bitmap)
+{
+	return((Priority)(31 - __builtin_clz(bitmap)));
+}
+#endif /* OMIT_BITMAP_SEARCH */
+
+#endif /* _CPU_INSN_H_ */
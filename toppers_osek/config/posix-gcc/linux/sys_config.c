@@ -0,0 +1,165 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *  Target system dependent module (Linux host simulation)
+ *
+ *  The system timer is the only interrupt source.  By default it runs
+ *  in virtual time: the next 1 ms tick is raised as soon as the CPU
+ *  goes idle, so a run is deterministic and proceeds at full host
+ *  speed.  A task that busy-waits is never preempted by the tick in
+ *  this mode.
+ *
+ *  Environment variables:
+ *    OSEK_SIM_REALTIME=1  drive the tick from a 1 ms SIGALRM instead;
+ *                         tasks are then preempted asynchronously
+ *    OSEK_SIM_TICKS=n     call ShutdownOS(E_OK) after n ticks
+ */
+
+#include	"osek_kernel.h"
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<signal.h>
+#include	<sys/time.h>
+
+/*
+ *  System timer ISR of the target (hw_sys_timer.c)
+ */
+extern void	hw_sys_timer_isr(void);
+
+static BOOL		sys_realtime;
+static UINT32	sys_tick_limit;
+static UINT32	sys_tick_count;
+
+/*
+ *  Category 2 ISR of the system timer
+ */
+static void
+sys_timer_isr(void)
+{
+	if ((sys_tick_limit != 0u) && (sys_tick_count >= sys_tick_limit)) {
+		ShutdownOS(E_OK);
+	}
+	sys_tick_count++;
+	hw_sys_timer_isr();
+}
+
+/*
+ *  SIGALRM handler (real time mode)
+ */
+static void
+sys_timer_handler(int sig)
+{
+	(void) sig;
+	cpu_raise_interrupt(SYS_TIMER_ISRID, sys_timer_isr);
+}
+
+/*
+ *  Target system dependent initialization
+ */
+void
+sys_initialize(void)
+{
+	const char			*env;
+	struct sigaction	sa;
+	struct itimerval	itv;
+
+	env = getenv("OSEK_SIM_TICKS");
+	sys_tick_limit = (env != NULL) ? (UINT32) strtoul(env, NULL, 0) : 0u;
+	sys_tick_count = 0u;
+
+	env = getenv("OSEK_SIM_REALTIME");
+	sys_realtime = ((env != NULL) && (atoi(env) != 0)) ? TRUE : FALSE;
+	if (sys_realtime) {
+		sa.sa_handler = sys_timer_handler;
+		sigemptyset(&sa.sa_mask);
+		sa.sa_flags = SA_RESTART;
+		sigaction(SIGALRM, &sa, NULL);
+
+		itv.it_interval.tv_sec = 0;
+		itv.it_interval.tv_usec = 1000;
+		itv.it_value = itv.it_interval;
+		setitimer(ITIMER_REAL, &itv, NULL);
+	}
+}
+
+/*
+ *  Wait for an interrupt from the idle loop
+ */
+void
+sys_wait_interrupt(void)
+{
+	sigset_t	set, oset, wset;
+
+	if (!sys_realtime) {
+		/* virtual time: the next tick is due right now */
+		cpu_raise_interrupt(SYS_TIMER_ISRID, sys_timer_isr);
+		return;
+	}
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &set, &oset);
+	if (!int_pend_flag) {
+		wset = oset;
+		sigdelset(&wset, SIGALRM);
+		sigsuspend(&wset);
+	}
+	sigprocmask(SIG_SETMASK, &oset, NULL);
+}
+
+/*
+ *  Target system termination
+ */
+void
+sys_exit(void)
+{
+	struct itimerval	itv;
+
+	if (sys_realtime) {
+		itv.it_interval.tv_sec = 0;
+		itv.it_interval.tv_usec = 0;
+		itv.it_value = itv.it_interval;
+		setitimer(ITIMER_REAL, &itv, NULL);
+	}
+	printf("%lu ticks simulated\n", (unsigned long) sys_tick_count);
+	log_report();
+	exit(0);
+}
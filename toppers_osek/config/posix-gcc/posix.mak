@@ -0,0 +1,101 @@
+# Common Makefile for building a TOPPERS/OSEK application as a Linux host
+# simulation (config/posix-gcc)
+#
+# The application Makefile defines TARGET, TARGET_SOURCES and
+# TOPPERS_OSEK_OIL_SOURCE like for ecrobot.mak, plus a main() that calls
+# StartOS(), and includes this file. NXT device drivers are not available.
+# With TOPPERS_OSEK_OIL_SOURCE empty, kernel_cfg.c and kernel_id.h are
+# the application's own (the tests in test/ are built like that).
+#
+# Run time options (environment):
+#   OSEK_SIM_TICKS=n     shut the OS down after n ticks of 1 ms
+#   OSEK_SIM_REALTIME=1  drive the tick from SIGALRM instead of virtual time
+
+ifndef TOPPERS_ROOT
+TOPPERS_ROOT := $(dir $(lastword $(MAKEFILE_LIST)))../..
+endif
+
+ifndef TOPPERS_OSEK_ROOT_SG
+TOPPERS_OSEK_ROOT_SG = $(TOPPERS_ROOT)
+endif
+
+CC = gcc
+O_PATH ?= build
+
+TOPPERS_INC_PATH = \
+	$(TOPPERS_ROOT)/kernel \
+	$(TOPPERS_ROOT)/include \
+	$(TOPPERS_ROOT)/config/posix-gcc \
+	$(TOPPERS_ROOT)/config/posix-gcc/linux \
+	$(TOPPERS_ROOT)/sg \
+	$(TOPPERS_ROOT)/syslib/posix-gcc/linux
+
+TOPPERS_KERNEL_SOURCES = $(addprefix $(TOPPERS_ROOT)/kernel/, \
+	alarm.c \
+	event.c	\
+	interrupt.c \
+	osctl.c	\
+	resource.c \
+	stack.c \
+	task.c \
+	task_manage.c \
+	trace.c )
+
+TOPPERS_CONFIG_SOURCES = $(addprefix $(TOPPERS_ROOT)/config/posix-gcc/, \
+	cpu_config.c \
+	tool_config.c )
+
+TOPPERS_CONFIG_SYS_SOURCES = $(addprefix $(TOPPERS_ROOT)/config/posix-gcc/linux/, \
+	sys_config.c )
+
+TOPPERS_SYSLIB_SOURCES = $(addprefix $(TOPPERS_ROOT)/syslib/posix-gcc/linux/, \
+	hw_sys_timer.c )
+
+TOPPERS_CFG_SOURCE = ./kernel_cfg.c
+TOPPERS_CFG_HEADER = ./kernel_id.h
+
+C_SOURCES = \
+	$(TOPPERS_KERNEL_SOURCES) \
+	$(TOPPERS_CONFIG_SOURCES) \
+	$(TOPPERS_CONFIG_SYS_SOURCES) \
+	$(TOPPERS_SYSLIB_SOURCES) \
+	$(TOPPERS_CFG_SOURCE) \
+	$(TARGET_SOURCES)
+
+C_OBJECTS = $(addprefix $(O_PATH)/,$(notdir $(C_SOURCES:.c=.o)))
+
+vpath %.c $(sort $(dir $(C_SOURCES)))
+
+CFLAGS = -O2 -g -Wall -finput-charset=cp932 \
+	$(addprefix -I,$(TOPPERS_INC_PATH)) -I. $(addprefix -I,$(USER_INC_PATH)) \
+	$(addprefix -D,$(USER_DEF)) $(USER_COPT)
+
+.PHONY: all
+all: $(TARGET)
+
+$(TARGET): $(C_OBJECTS)
+	$(CC) -o $@ $(C_OBJECTS) $(USER_LIB)
+
+$(O_PATH)/%.o: %.c $(TOPPERS_CFG_HEADER)
+	@mkdir -p $(O_PATH)
+	$(CC) -c $(CFLAGS) -o $@ $<
+
+ifneq ($(TOPPERS_OSEK_OIL_SOURCE),)
+$(TOPPERS_CFG_SOURCE) $(TOPPERS_CFG_HEADER) implementation.oil : $(TOPPERS_OSEK_OIL_SOURCE)
+	@echo "Generating OSEK kernel config files from $(TOPPERS_OSEK_OIL_SOURCE)"
+	wineconsole $(TOPPERS_OSEK_ROOT_SG)/sg/sg $(TOPPERS_OSEK_OIL_SOURCE) \
+	-os=ECC2 -I$(TOPPERS_OSEK_ROOT_SG)/sg/impl_oil -template=$(TOPPERS_OSEK_ROOT_SG)/sg/lego_nxt.sgt
+endif
+
+.PHONY: clean
+clean:
+ifneq ($(TOPPERS_OSEK_OIL_SOURCE),)
+	@echo "Removing kernel config files and objects"
+	@rm -f $(TOPPERS_CFG_SOURCE)
+	@rm -f $(TOPPERS_CFG_HEADER)
+	@rm -f implementation.oil
+else
+	@echo "Removing objects"
+endif
+	@rm -rf $(O_PATH)
+	@rm -f $(TARGET)
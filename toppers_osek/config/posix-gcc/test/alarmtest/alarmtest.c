@@ -0,0 +1,98 @@
+/* alarmtest.c for the POSIX host simulation of TOPPERS/OSEK
+ *
+ * Twelve alarms on two counters, driven by the 1 ms system tick. Each
+ * alarm callback prints the tick and then makes three random alarm
+ * service calls (SetRelAlarm, SetAbsAlarm, CancelAlarm or GetAlarm),
+ * printing their results. The output is the timeline of the run; the
+ * same seed gives the same calls, so two kernel configurations that
+ * must behave alike can be compared by their output (see ../Makefile).
+ */
+#include <stdio.h>
+#include "kernel.h"
+#include "kernel_id.h"
+
+extern UINT32 systick_get_ms(void);
+
+#define NUM_ALARMS 12
+
+static UINT32 seed = 12345;
+
+static UINT32 rnd(UINT32 n)
+{
+	seed = seed * 1103515245u + 12345u;
+	return ((seed >> 16) & 0x7fff) % n;
+}
+
+static TickType rnd_cycle(void)
+{
+	return rnd(2) ? 1 + rnd(300) : 0;
+}
+
+static void expired(int almid)
+{
+	int i;
+	AlarmType a;
+	TickType t;
+	StatusType e;
+
+	printf("%lu exp %d\n", (unsigned long) systick_get_ms(), almid);
+	for (i = 0; i < 3; i++)
+	{
+		a = rnd(NUM_ALARMS);
+		switch (rnd(5))
+		{
+		case 0:
+			e = SetRelAlarm(a, 1 + rnd(MAXVAL), rnd_cycle());
+			printf("  rel %d %d\n", a, e);
+			break;
+		case 1:
+			e = SetAbsAlarm(a, rnd(MAXVAL + 1), rnd_cycle());
+			printf("  abs %d %d\n", a, e);
+			break;
+		case 2:
+			e = CancelAlarm(a);
+			printf("  can %d %d\n", a, e);
+			break;
+		default:
+			e = GetAlarm(a, &t);
+			printf("  get %d %d %lu\n", a, e, (unsigned long) (e == E_OK ? t : 0));
+			break;
+		}
+	}
+}
+
+ALARMCALLBACK(cb0) { expired(0); }
+ALARMCALLBACK(cb1) { expired(1); }
+ALARMCALLBACK(cb2) { expired(2); }
+ALARMCALLBACK(cb3) { expired(3); }
+ALARMCALLBACK(cb4) { expired(4); }
+ALARMCALLBACK(cb5) { expired(5); }
+ALARMCALLBACK(cb6) { expired(6); }
+ALARMCALLBACK(cb7) { expired(7); }
+ALARMCALLBACK(cb8) { expired(8); }
+ALARMCALLBACK(cb9) { expired(9); }
+ALARMCALLBACK(cb10) { expired(10); }
+ALARMCALLBACK(cb11) { expired(11); }
+
+void user_1ms_isr_type2(void)
+{
+	(void) SignalCounter(C_0);
+	(void) SignalCounter(C_1);
+}
+
+TASK(T_IDLE)
+{
+	TerminateTask();
+}
+
+void StartupHook(void) {}
+void ShutdownHook(StatusType ercd) {}
+void PreTaskHook(void) {}
+void PostTaskHook(void) {}
+void ErrorHook(StatusType ercd) {}
+
+int main(void)
+{
+	StartOS(OSDEFAULTAPPMODE);
+	return 0;
+}
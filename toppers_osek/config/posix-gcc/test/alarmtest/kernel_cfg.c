@@ -0,0 +1,88 @@
+/* kernel_cfg.c for alarmtest.c, written by hand as sg does from an OIL file
+ *
+ * TICKBASE (default 1) sets the TICKSPERBASE of both counters.
+ */
+#include "osek_kernel.h"
+#include "kernel_id.h"
+#include "alarm.h"
+#include "interrupt.h"
+#include "resource.h"
+#include "task.h"
+
+#ifndef TICKBASE
+#define TICKBASE 1
+#endif
+
+#define __STK_UNIT VP
+#define __TCOUNT_STK_UNIT(sz) (((sz) + sizeof(__STK_UNIT) - 1) / sizeof(__STK_UNIT))
+
+#define TNUM_TASK 1
+#define TNUM_EXTTASK 0
+const UINT8 tnum_task = TNUM_TASK;
+const UINT8 tnum_exttask = TNUM_EXTTASK;
+void TaskMainT_IDLE(void);
+static __STK_UNIT _stack_T_IDLE[__TCOUNT_STK_UNIT(512)];
+const Priority tinib_inipri[TNUM_TASK] = {1};
+const Priority tinib_exepri[TNUM_TASK] = {1};
+const UINT8 tinib_maxact[TNUM_TASK] = {0};
+const AppModeType tinib_autoact[TNUM_TASK] = {0x1};
+const FP tinib_task[TNUM_TASK] = {TaskMainT_IDLE};
+const __STK_UNIT tinib_stk[TNUM_TASK] = {(__STK_UNIT)_stack_T_IDLE};
+const UINT16 tinib_stksz[TNUM_TASK] = {512};
+TaskType tcb_next[TNUM_TASK];
+UINT8 tcb_tstat[TNUM_TASK];
+Priority tcb_curpri[TNUM_TASK];
+UINT8 tcb_actcnt[TNUM_TASK];
+EventMaskType tcb_curevt[TNUM_EXTTASK+1];
+EventMaskType tcb_waievt[TNUM_EXTTASK+1];
+ResourceType tcb_lastres[TNUM_TASK];
+DEFINE_CTXB(TNUM_TASK);
+
+#define TNUM_COUNTER 2
+const UINT8 tnum_counter = TNUM_COUNTER;
+const TickType cntinib_maxval[TNUM_COUNTER] = {MAXVAL, MAXVAL};
+const TickType cntinib_maxval2[TNUM_COUNTER] = {2 * MAXVAL + 1, 2 * MAXVAL + 1};
+const TickType cntinib_tickbase[TNUM_COUNTER] = {TICKBASE, TICKBASE};
+const TickType cntinib_mincyc[TNUM_COUNTER] = {1, 1};
+AlarmType cntcb_almque[TNUM_COUNTER];
+TickType cntcb_curval[TNUM_COUNTER];
+
+#define TNUM_ALARM 12
+const UINT8 tnum_alarm = TNUM_ALARM;
+void AlarmMaincb0(void); void AlarmMaincb1(void); void AlarmMaincb2(void);
+void AlarmMaincb3(void); void AlarmMaincb4(void); void AlarmMaincb5(void);
+void AlarmMaincb6(void); void AlarmMaincb7(void); void AlarmMaincb8(void);
+void AlarmMaincb9(void); void AlarmMaincb10(void); void AlarmMaincb11(void);
+const CounterType alminib_cntid[TNUM_ALARM] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1};
+const FP alminib_cback[TNUM_ALARM] = {
+	AlarmMaincb0, AlarmMaincb1, AlarmMaincb2, AlarmMaincb3,
+	AlarmMaincb4, AlarmMaincb5, AlarmMaincb6, AlarmMaincb7,
+	AlarmMaincb8, AlarmMaincb9, AlarmMaincb10, AlarmMaincb11};
+const AppModeType alminib_autosta[TNUM_ALARM] = {0x1, 0x1, 0, 0, 0, 0, 0, 0, 0x1, 0, 0, 0};
+const TickType alminib_almval[TNUM_ALARM] = {5, 7, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0};
+const TickType alminib_cycle[TNUM_ALARM] = {5, 13, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0};
+AlarmType almcb_next[TNUM_ALARM];
+AlarmType almcb_prev[TNUM_ALARM];
+TickType almcb_almval[TNUM_ALARM];
+TickType almcb_cycle[TNUM_ALARM];
+
+#define TNUM_RESOURCE 0
+const UINT8 tnum_resource = TNUM_RESOURCE;
+const Priority resinib_ceilpri[TNUM_RESOURCE+1];
+Priority rescb_prevpri[TNUM_RESOURCE+1];
+ResourceType rescb_prevres[TNUM_RESOURCE+1];
+
+#define TNUM_ISR2 0
+#define IPL_MAXISR2 1
+const UINT8 tnum_isr2 = TNUM_ISR2;
+const Priority isrinib_intpri[TNUM_ISR2+1];
+ResourceType isrcb_lastres[TNUM_ISR2+1];
+const IPL ipl_maxisr2 = IPL_MAXISR2;
+
+void object_initialize(void)
+{
+	task_initialize();
+	alarm_initialize();
+	resource_initialize();
+	interrupt_initialize();
+}
@@ -0,0 +1,19 @@
+/* kernel_id.h for alarmtest.c, written by hand as sg does from an OIL file */
+#define T_IDLE	0
+#define C_0	0
+#define C_1	1
+#define A_0	0
+#define A_1	1
+#define A_2	2
+#define A_3	3
+#define A_4	4
+#define A_5	5
+#define A_6	6
+#define A_7	7
+#define A_8	8
+#define A_9	9
+#define A_10	10
+#define A_11	11
+
+/* MAXALLOWEDVALUE of both counters */
+#define MAXVAL	1000
@@ -0,0 +1,55 @@
+/* almbench.c for the POSIX host simulation of TOPPERS/OSEK
+ *
+ * NUM_ALARMS cyclic alarms on one counter, with cycles of 100 to 499
+ * ticks. Each expiry cancels a random alarm and sets it again with a
+ * random offset and cycle, so that the queue keeps its length while
+ * alarms are inserted and removed all over it. The service latency
+ * table printed at shutdown gives the cost of SignalCounter,
+ * SetRelAlarm and CancelAlarm (see ../Makefile).
+ */
+#include "kernel.h"
+#include "kernel_id.h"
+
+static UINT32 seed = 12345;
+
+static UINT32 rnd(UINT32 n)
+{
+	seed = seed * 1103515245u + 12345u;
+	return ((seed >> 16) & 0x7fff) % n;
+}
+
+ALARMCALLBACK(expired)
+{
+	AlarmType a = rnd(NUM_ALARMS);
+
+	(void) CancelAlarm(a);
+	(void) SetRelAlarm(a, 1 + rnd(500), 100 + rnd(400));
+}
+
+void user_1ms_isr_type2(void)
+{
+	(void) SignalCounter(C_0);
+}
+
+TASK(T_INIT)
+{
+	AlarmType a;
+
+	for (a = 0; a < NUM_ALARMS; a++)
+	{
+		(void) SetRelAlarm(a, 1 + rnd(500), 100 + rnd(400));
+	}
+	TerminateTask();
+}
+
+void StartupHook(void) {}
+void ShutdownHook(StatusType ercd) {}
+void PreTaskHook(void) {}
+void PostTaskHook(void) {}
+void ErrorHook(StatusType ercd) {}
+
+int main(void)
+{
+	StartOS(OSDEFAULTAPPMODE);
+	return 0;
+}
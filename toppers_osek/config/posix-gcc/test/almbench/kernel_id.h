@@ -0,0 +1,8 @@
+/* kernel_id.h for almbench.c, written by hand as sg does from an OIL file */
+#define T_INIT	0
+#define C_0	0
+
+/* Number of alarms, all on C_0 (IDs 0 to NUM_ALARMS - 1) */
+#ifndef NUM_ALARMS
+#define NUM_ALARMS	64
+#endif
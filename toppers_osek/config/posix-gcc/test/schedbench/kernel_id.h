@@ -0,0 +1,6 @@
+/* kernel_id.h for schedbench.c, written by hand as sg does from an OIL file */
+#define T_KICK	0
+
+/* Worker tasks W_0 to W_14 have the IDs 1 to NUM_WORKERS */
+#define NUM_WORKERS	15
+#define W_0	1
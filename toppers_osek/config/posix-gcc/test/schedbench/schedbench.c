@@ -0,0 +1,126 @@
+/* schedbench.c for the POSIX host simulation of TOPPERS/OSEK
+ *
+ * Every tick activates T_KICK, a non-preemptive task at the lowest
+ * priority. T_KICK activates the NUM_WORKERS worker tasks, which are
+ * spread over all the priorities (see kernel_cfg.c), and calls
+ * Schedule. The workers then run from the highest priority down, each
+ * one ending with TerminateTask, and T_KICK resumes last.
+ *
+ * At shutdown, ahead of the service latency table, it prints in the
+ * same unit:
+ *   dispatch  from the Schedule call of T_KICK to the first worker
+ *   switch    from TerminateTask of a worker to the start of the next
+ *             task (the next worker, or T_KICK)
+ * Both include the host context switch. Schedule in the service
+ * latency table is the kernel's part of dispatch: preempt, with its
+ * bitmap search, without the time T_KICK spends switched out.
+ */
+#include <stdio.h>
+#include <time.h>
+#include "kernel.h"
+#include "kernel_id.h"
+
+typedef struct
+{
+	const char *name;
+	UINT32 count;
+	UINT64 total;
+	UINT64 min;
+	UINT64 max;
+} STAT;
+
+static STAT stat_dispatch = { "dispatch", 0, 0, ~(UINT64) 0, 0 };
+static STAT stat_switch = { "switch", 0, 0, ~(UINT64) 0, 0 };
+
+/* Time stamp of the last Schedule or TerminateTask call, and its kind */
+static UINT64 t_last;
+static STAT *t_last_stat;
+
+/* Same time stamp as the service latency table (tool_config.c) */
+static UINT64 timestamp(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return (UINT64) __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (UINT64) ts.tv_sec * 1000000000ull + (UINT64) ts.tv_nsec;
+#endif
+}
+
+static void started(void)
+{
+	UINT64 lat = timestamp() - t_last;
+	STAT *stat = t_last_stat;
+
+	stat->count++;
+	stat->total += lat;
+	if (lat < stat->min)
+	{
+		stat->min = lat;
+	}
+	if (lat > stat->max)
+	{
+		stat->max = lat;
+	}
+}
+
+void user_1ms_isr_type2(void)
+{
+	(void) ActivateTask(T_KICK);
+}
+
+TASK(T_KICK)
+{
+	TaskType w;
+
+	for (w = W_0; w < W_0 + NUM_WORKERS; w++)
+	{
+		(void) ActivateTask(w);
+	}
+	t_last_stat = &stat_dispatch;
+	t_last = timestamp();
+	(void) Schedule();
+	started();
+	TerminateTask();
+}
+
+TASK(W)
+{
+	started();
+	t_last_stat = &stat_switch;
+	t_last = timestamp();
+	TerminateTask();
+}
+
+void StartupHook(void) {}
+void PreTaskHook(void) {}
+void PostTaskHook(void) {}
+void ErrorHook(StatusType ercd) {}
+
+void ShutdownHook(StatusType ercd)
+{
+	STAT *stats[2] = { &stat_dispatch, &stat_switch };
+	int i;
+
+	printf("%-26s %10s %10s %10s %10s\n", "schedbench", "count", "min", "avg", "max");
+	for (i = 0; i < 2; i++)
+	{
+		if (stats[i]->count == 0)
+		{
+			continue;
+		}
+		printf("%-26s %10u %10llu %10llu %10llu\n", stats[i]->name,
+			(unsigned int) stats[i]->count,
+			(unsigned long long) stats[i]->min,
+			(unsigned long long) (stats[i]->total / stats[i]->count),
+			(unsigned long long) stats[i]->max);
+	}
+}
+
+int main(void)
+{
+	StartOS(OSDEFAULTAPPMODE);
+	return 0;
+}
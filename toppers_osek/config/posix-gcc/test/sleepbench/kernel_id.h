@@ -0,0 +1,5 @@
+/* kernel_id.h for sleepbench.c, written by hand as sg does from an OIL file */
+
+/* Sleeping tasks S_0 to S_5 have the IDs 0 to NUM_SLEEPERS - 1 */
+#define NUM_SLEEPERS	6
+#define S_0	0
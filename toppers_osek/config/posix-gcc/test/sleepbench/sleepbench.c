@@ -0,0 +1,165 @@
+/* sleepbench.c for the POSIX host simulation of TOPPERS/OSEK
+ *
+ * The sleepers S_0 to S_5 call Sleep of ecrobot/c/rtoscalls.c in a
+ * loop, to wake up on absolute deadlines every 2, 3, 7, 10, 25 and
+ * 100 ms, the shortest period at the highest priority. The tick calls
+ * SleeperMonitor, as the 1 ms ISR hook of ecrobot does.
+ *
+ * At shutdown, ahead of the service latency table, it prints:
+ *   late [ticks]  from a deadline to the tick the sleeper woke up on
+ *   wakeup        from the SleeperMonitor call to the sleeper running
+ *                 again; its spread is the wake-up jitter
+ *   monitor idle  SleeperMonitor on a tick where no sleeper is due
+ *   monitor wake  SleeperMonitor on a tick where some are
+ * The last three are in the unit of the service latency table.
+ *
+ * Built with SLEEP_STRAY_EVENTS, the tick also sets EventSleep of one
+ * of the sleepers, as any task or ISR may, and each sleeper counts the
+ * wake ups before its deadline; the run exits with 1 if there are any
+ * (make check).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "rtoscalls.h"
+#include "kernel_id.h"
+
+DeclareEvent(EventSleep);
+
+typedef struct
+{
+	const char *name;
+	UINT32 count;
+	UINT64 total;
+	UINT64 min;
+	UINT64 max;
+} STAT;
+
+static STAT stat_late = { "late [ticks]", 0, 0, ~(UINT64) 0, 0 };
+static STAT stat_wakeup = { "wakeup", 0, 0, ~(UINT64) 0, 0 };
+static STAT stat_idle = { "monitor idle", 0, 0, ~(UINT64) 0, 0 };
+static STAT stat_wake = { "monitor wake", 0, 0, ~(UINT64) 0, 0 };
+
+static const UINT32 period[NUM_SLEEPERS] = { 2, 3, 7, 10, 25, 100 };
+
+/* Wake ups before the deadline */
+static UINT32 early;
+
+/* Time stamp of the last SleeperMonitor call */
+static UINT64 t_tick;
+
+/* Same time stamp as the service latency table (tool_config.c) */
+static UINT64 timestamp(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return (UINT64) __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (UINT64) ts.tv_sec * 1000000000ull + (UINT64) ts.tv_nsec;
+#endif
+}
+
+static void add(STAT *stat, UINT64 value)
+{
+	stat->count++;
+	stat->total += value;
+	if (value < stat->min)
+	{
+		stat->min = value;
+	}
+	if (value > stat->max)
+	{
+		stat->max = value;
+	}
+}
+
+/* The I2C driver is not simulated: no port is ever busy */
+int i2c_busy(int port)
+{
+	return 0;
+}
+
+void i2c_set_idle_callback(void (*callback)(int port)) {}
+
+void user_1ms_isr_type2(void)
+{
+	UINT32 now = systick_get_ms();
+	STAT *stat = &stat_idle;
+	int i;
+
+	/* The sleepers started at 0, so their deadlines are multiples of
+	 * their periods */
+	for (i = 0; i < NUM_SLEEPERS; i++)
+	{
+		if (now % period[i] == 0)
+		{
+			stat = &stat_wake;
+		}
+	}
+	t_tick = timestamp();
+	SleeperMonitor();
+	add(stat, timestamp() - t_tick);
+#ifdef SLEEP_STRAY_EVENTS
+	(void) SetEvent(S_0 + now % NUM_SLEEPERS, EventSleep);
+#endif
+}
+
+TASK(S)
+{
+	TaskType id;
+	UINT32 deadline;
+
+	(void) GetTaskID(&id);
+	deadline = systick_get_ms();
+	for (;;)
+	{
+		deadline += period[id - S_0];
+		Sleep(deadline - systick_get_ms());
+		if ((INT32) (systick_get_ms() - deadline) < 0)
+		{
+			early++;
+		}
+		add(&stat_wakeup, timestamp() - t_tick);
+		add(&stat_late, systick_get_ms() - deadline);
+	}
+}
+
+void StartupHook(void) {}
+void PreTaskHook(void) {}
+void PostTaskHook(void) {}
+void ErrorHook(StatusType ercd) {}
+
+void ShutdownHook(StatusType ercd)
+{
+	STAT *stats[4] = { &stat_late, &stat_wakeup, &stat_idle, &stat_wake };
+	int i;
+
+	printf("%-26s %10s %10s %10s %10s\n", "sleepbench", "count", "min", "avg", "max");
+	for (i = 0; i < 4; i++)
+	{
+		if (stats[i]->count == 0)
+		{
+			continue;
+		}
+		printf("%-26s %10u %10llu %10llu %10llu\n", stats[i]->name,
+			(unsigned int) stats[i]->count,
+			(unsigned long long) stats[i]->min,
+			(unsigned long long) (stats[i]->total / stats[i]->count),
+			(unsigned long long) stats[i]->max);
+	}
+#ifdef SLEEP_STRAY_EVENTS
+	printf("sleepbench: %u wake ups before the deadline\n", (unsigned int) early);
+	if (early != 0)
+	{
+		exit(1);
+	}
+#endif
+}
+
+int main(void)
+{
+	StartOS(OSDEFAULTAPPMODE);
+	return 0;
+}
@@ -0,0 +1,84 @@
+/* kernel_cfg.c for stacktest.c, written by hand as sg does from
+ * stacktest.oil: the task entries are TASKNAME( name ), which
+ * osek_stksz.py maps back to the TASK names of the OIL file. */
+#include "osek_kernel.h"
+#include "kernel_id.h"
+#include "alarm.h"
+#include "interrupt.h"
+#include "resource.h"
+#include "task.h"
+
+#define __STK_UNIT VP
+#define __TCOUNT_STK_UNIT(sz) (((sz) + sizeof(__STK_UNIT) - 1) / sizeof(__STK_UNIT))
+
+ /****** Object TASK ******/
+
+#define TNUM_TASK 4
+#define TNUM_EXTTASK 0
+const UINT8 tnum_task = TNUM_TASK;
+const UINT8 tnum_exttask = TNUM_EXTTASK;
+extern void TASKNAME( T_A )( void );
+extern void TASKNAME( T_B )( void );
+extern void TASKNAME( T_C )( void );
+extern void TASKNAME( T_D )( void );
+static __STK_UNIT _stack_T_A[__TCOUNT_STK_UNIT(512)];
+static __STK_UNIT _stack_T_B[__TCOUNT_STK_UNIT(1024)];
+static __STK_UNIT _stack_T_C[__TCOUNT_STK_UNIT(256)];
+static __STK_UNIT _stack_T_D[__TCOUNT_STK_UNIT(256)];
+const Priority tinib_inipri[TNUM_TASK] = { TPRI_MINTASK + 4, TPRI_MINTASK + 3, TPRI_MINTASK + 2, TPRI_MINTASK + 1, };
+const Priority tinib_exepri[TNUM_TASK] = { TPRI_MINTASK + 4, TPRI_MINTASK + 3, TPRI_MINTASK + 2, TPRI_MINTASK + 1, };
+const UINT8 tinib_maxact[TNUM_TASK] = { (1) - 1, (1) - 1, (1) - 1, (1) - 1, };
+const AppModeType tinib_autoact[TNUM_TASK] = { 0x00000001, 0x00000001, 0x00000000, 0x00000001, };
+const FP tinib_task[TNUM_TASK] = { TASKNAME( T_A ), TASKNAME( T_B ), TASKNAME( T_C ), TASKNAME( T_D ), };
+const __STK_UNIT tinib_stk[TNUM_TASK] = { (__STK_UNIT)_stack_T_A, (__STK_UNIT)_stack_T_B, (__STK_UNIT)_stack_T_C, (__STK_UNIT)_stack_T_D, };
+const UINT16 tinib_stksz[TNUM_TASK] = { 512, 1024, 256, 256, };
+TaskType tcb_next[TNUM_TASK];
+UINT8 tcb_tstat[TNUM_TASK];
+Priority tcb_curpri[TNUM_TASK];
+UINT8 tcb_actcnt[TNUM_TASK];
+EventMaskType tcb_curevt[TNUM_EXTTASK+1];
+EventMaskType tcb_waievt[TNUM_EXTTASK+1];
+ResourceType tcb_lastres[TNUM_TASK];
+DEFINE_CTXB(TNUM_TASK);
+
+#define TNUM_COUNTER 0
+const UINT8 tnum_counter = TNUM_COUNTER;
+const TickType cntinib_maxval[TNUM_COUNTER+1];
+const TickType cntinib_maxval2[TNUM_COUNTER+1];
+const TickType cntinib_tickbase[TNUM_COUNTER+1];
+const TickType cntinib_mincyc[TNUM_COUNTER+1];
+AlarmType cntcb_almque[TNUM_COUNTER+1];
+TickType cntcb_curval[TNUM_COUNTER+1];
+
+#define TNUM_ALARM 0
+const UINT8 tnum_alarm = TNUM_ALARM;
+const CounterType alminib_cntid[TNUM_ALARM+1];
+const FP alminib_cback[TNUM_ALARM+1];
+const AppModeType alminib_autosta[TNUM_ALARM+1];
+const TickType alminib_almval[TNUM_ALARM+1];
+const TickType alminib_cycle[TNUM_ALARM+1];
+AlarmType almcb_next[TNUM_ALARM+1];
+AlarmType almcb_prev[TNUM_ALARM+1];
+TickType almcb_almval[TNUM_ALARM+1];
+TickType almcb_cycle[TNUM_ALARM+1];
+
+#define TNUM_RESOURCE 0
+const UINT8 tnum_resource = TNUM_RESOURCE;
+const Priority resinib_ceilpri[TNUM_RESOURCE+1];
+Priority rescb_prevpri[TNUM_RESOURCE+1];
+ResourceType rescb_prevres[TNUM_RESOURCE+1];
+
+#define TNUM_ISR2 0
+#define IPL_MAXISR2 1
+const UINT8 tnum_isr2 = TNUM_ISR2;
+const Priority isrinib_intpri[TNUM_ISR2+1];
+ResourceType isrcb_lastres[TNUM_ISR2+1];
+const IPL ipl_maxisr2 = IPL_MAXISR2;
+
+void object_initialize(void)
+{
+	task_initialize();
+	alarm_initialize();
+	resource_initialize();
+	interrupt_initialize();
+}
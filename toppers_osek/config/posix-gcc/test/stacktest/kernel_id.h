@@ -0,0 +1,5 @@
+/* kernel_id.h for stacktest.c, written by hand as sg does from stacktest.oil */
+#define T_A	0
+#define T_B	1
+#define T_C	2
+#define T_D	3
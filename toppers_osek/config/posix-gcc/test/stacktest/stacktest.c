@@ -0,0 +1,130 @@
+/* stacktest.c for the POSIX host simulation of TOPPERS/OSEK, built with
+ * OSEK_STACK_MONITOR
+ *
+ * The tasks of the simulation run on host stacks, so each task writes
+ * the top depth[] bytes of its own stack area (tinib_stk[]) itself, as
+ * a task that used that much of it on the NXT would, and checks the
+ * high-water mark that stack_get_usage() reads from the paint. T_C
+ * never runs and T_D fills its whole area.
+ *
+ * At shutdown the usage of all tasks is checked again and stack_dump()
+ * writes the report to the file named on the command line, for
+ * utils/osek_stksz.py (see ../Makefile). A failed check exits with 1.
+ */
+#include "osek_kernel.h"
+#include "kernel_id.h"
+#include "task.h"
+#include "stack.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const UINT16 depth[] = { 100, 600, 0, 256 };
+
+static FILE *report_file;
+static int errors;
+
+static void check(TaskType tskid)
+{
+	STACK_INFO info;
+
+	if (!stack_get_usage(tskid, &info))
+	{
+		printf("stacktest: no usage of task %d\n", tskid);
+		errors++;
+	}
+	else if (info.size != tinib_stksz[tskid] || info.used != depth[tskid])
+	{
+		printf("stacktest: task %d used %u of %u bytes, not %u of %u\n",
+			tskid, info.used, info.size, depth[tskid], tinib_stksz[tskid]);
+		errors++;
+	}
+}
+
+/* The stacks grow down from the end of the area */
+static void use_stack(void)
+{
+	TaskType tskid;
+	UINT32 *top;
+	UINT32 i;
+
+	(void) GetTaskID(&tskid);
+	top = (UINT32 *) ((UINT8 *) tinib_stk[tskid] + tinib_stksz[tskid]);
+	for (i = 1; i <= depth[tskid] / sizeof(UINT32); i++)
+	{
+		top[-(INT32) i] = i;
+	}
+	check(tskid);
+}
+
+TASK(T_A)
+{
+	use_stack();
+	TerminateTask();
+}
+
+TASK(T_B)
+{
+	use_stack();
+	TerminateTask();
+}
+
+TASK(T_C)
+{
+	use_stack();
+	TerminateTask();
+}
+
+TASK(T_D)
+{
+	use_stack();
+	TerminateTask();
+}
+
+void user_1ms_isr_type2(void) {}
+
+static UINT32 send(UINT8 *buf, UINT32 len)
+{
+	return (UINT32) fwrite(buf, 1, len, report_file);
+}
+
+void StartupHook(void) {}
+void PreTaskHook(void) {}
+void PostTaskHook(void) {}
+void ErrorHook(StatusType ercd) {}
+
+void ShutdownHook(StatusType ercd)
+{
+	STACK_INFO info;
+	TaskType tskid;
+
+	for (tskid = 0; tskid < tnum_task; tskid++)
+	{
+		check(tskid);
+	}
+	if (stack_get_usage(tnum_task, &info))
+	{
+		printf("stacktest: usage of a task that does not exist\n");
+		errors++;
+	}
+	if (stack_dump(send) != tnum_task)
+	{
+		printf("stacktest: report not written\n");
+		errors++;
+	}
+	fclose(report_file);
+	if (errors)
+	{
+		exit(1);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 2 || (report_file = fopen(argv[1], "wb")) == NULL)
+	{
+		fprintf(stderr, "usage: stacktest REPORT.bin\n");
+		return 2;
+	}
+	StartOS(OSDEFAULTAPPMODE);
+	return 0;
+}
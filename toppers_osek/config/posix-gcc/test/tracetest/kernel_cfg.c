@@ -0,0 +1,78 @@
+/* kernel_cfg.c for tracetest.c, written by hand as sg does from an OIL file */
+#include "osek_kernel.h"
+#include "kernel_id.h"
+#include "alarm.h"
+#include "interrupt.h"
+#include "resource.h"
+#include "task.h"
+
+#define __STK_UNIT VP
+#define __TCOUNT_STK_UNIT(sz) (((sz) + sizeof(__STK_UNIT) - 1) / sizeof(__STK_UNIT))
+
+/* Two basic tasks, T_HI above T_LO, activated from the tick and the
+ * device ISR */
+#define TNUM_TASK 2
+#define TNUM_EXTTASK 0
+const UINT8 tnum_task = TNUM_TASK;
+const UINT8 tnum_exttask = TNUM_EXTTASK;
+void TaskMainT_LO(void);
+void TaskMainT_HI(void);
+static __STK_UNIT _stack_T_LO[__TCOUNT_STK_UNIT(512)];
+static __STK_UNIT _stack_T_HI[__TCOUNT_STK_UNIT(512)];
+const Priority tinib_inipri[TNUM_TASK] = {1, 2};
+const Priority tinib_exepri[TNUM_TASK] = {1, 2};
+const UINT8 tinib_maxact[TNUM_TASK] = {0};
+const AppModeType tinib_autoact[TNUM_TASK] = {0};
+const FP tinib_task[TNUM_TASK] = {TaskMainT_LO, TaskMainT_HI};
+const __STK_UNIT tinib_stk[TNUM_TASK] = {(__STK_UNIT)_stack_T_LO, (__STK_UNIT)_stack_T_HI};
+const UINT16 tinib_stksz[TNUM_TASK] = {512, 512};
+TaskType tcb_next[TNUM_TASK];
+UINT8 tcb_tstat[TNUM_TASK];
+Priority tcb_curpri[TNUM_TASK];
+UINT8 tcb_actcnt[TNUM_TASK];
+EventMaskType tcb_curevt[TNUM_EXTTASK+1];
+EventMaskType tcb_waievt[TNUM_EXTTASK+1];
+ResourceType tcb_lastres[TNUM_TASK];
+DEFINE_CTXB(TNUM_TASK);
+
+#define TNUM_COUNTER 0
+const UINT8 tnum_counter = TNUM_COUNTER;
+const TickType cntinib_maxval[TNUM_COUNTER+1];
+const TickType cntinib_maxval2[TNUM_COUNTER+1];
+const TickType cntinib_tickbase[TNUM_COUNTER+1];
+const TickType cntinib_mincyc[TNUM_COUNTER+1];
+AlarmType cntcb_almque[TNUM_COUNTER+1];
+TickType cntcb_curval[TNUM_COUNTER+1];
+
+#define TNUM_ALARM 0
+const UINT8 tnum_alarm = TNUM_ALARM;
+const CounterType alminib_cntid[TNUM_ALARM+1];
+const FP alminib_cback[TNUM_ALARM+1];
+const AppModeType alminib_autosta[TNUM_ALARM+1];
+const TickType alminib_almval[TNUM_ALARM+1];
+const TickType alminib_cycle[TNUM_ALARM+1];
+AlarmType almcb_next[TNUM_ALARM+1];
+AlarmType almcb_prev[TNUM_ALARM+1];
+TickType almcb_almval[TNUM_ALARM+1];
+TickType almcb_cycle[TNUM_ALARM+1];
+
+#define TNUM_RESOURCE 0
+const UINT8 tnum_resource = TNUM_RESOURCE;
+const Priority resinib_ceilpri[TNUM_RESOURCE+1];
+Priority rescb_prevpri[TNUM_RESOURCE+1];
+ResourceType rescb_prevres[TNUM_RESOURCE+1];
+
+#define TNUM_ISR2 0
+#define IPL_MAXISR2 1
+const UINT8 tnum_isr2 = TNUM_ISR2;
+const Priority isrinib_intpri[TNUM_ISR2+1];
+ResourceType isrcb_lastres[TNUM_ISR2+1];
+const IPL ipl_maxisr2 = IPL_MAXISR2;
+
+void object_initialize(void)
+{
+	task_initialize();
+	alarm_initialize();
+	resource_initialize();
+	interrupt_initialize();
+}
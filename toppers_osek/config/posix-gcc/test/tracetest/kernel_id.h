@@ -0,0 +1,6 @@
+/* kernel_id.h for tracetest.c, written by hand as sg does from an OIL file */
+#define T_LO	0
+#define T_HI	1
+
+/* Interrupt number of the simulated device ISR */
+#define DEV_ISRID	3
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# tracecheck.py - checks the trace written by tracetest.c
+#
+# usage: tracecheck.py TRACE.bin JOBS
+#
+# Decodes the trace with utils/osek_trace.py and checks that
+#   - ISRENT and ISREXT nest, and no task starts or stops inside an ISR
+#   - TSKDSP only follows a TSKSWT, and TSKSWT and TSKEXT are those of
+#     the running task
+#   - each of the JOBS jobs of T_LO is preempted by T_HI once, after
+#     the device ISR
+#   - the exec_max of the statistics is the longest job recomputed from
+#     the trace, without the time spent in ISRs, which must be non-zero
+#     for some job of T_LO
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "..", "..", "utils"))
+sys.dont_write_bytecode = True
+import osek_trace as ot
+
+T_LO = 0
+T_HI = 1
+DEV_ISRID = 3
+READY = 2
+
+errors = []
+
+
+def error(msg):
+    if len(errors) < 10:
+        print("tracecheck: " + msg)
+    errors.append(msg)
+
+
+def check_order(logs):
+    """Checks the nesting of ISRs and tasks; returns the number of times
+    T_LO was preempted by T_HI after the device ISR."""
+    running = None
+    isrs = []
+    dev_isr = False
+    preempted = 0
+    for time, typ, obj, arg in logs:
+        if typ == ot.TRACE_ISRENT:
+            isrs.append(obj)
+            if obj == DEV_ISRID:
+                dev_isr = running == T_LO
+        elif typ == ot.TRACE_ISREXT:
+            if not isrs or isrs.pop() != obj:
+                error("ISREXT %d at %d without its ISRENT" % (obj, time))
+        elif typ in (ot.TRACE_TSKDSP, ot.TRACE_TSKSWT, ot.TRACE_TSKEXT):
+            if isrs:
+                error("task %d switched at %d inside ISR %d" %
+                      (obj, time, isrs[-1]))
+            if typ == ot.TRACE_TSKDSP:
+                if running is not None:
+                    error("task %d dispatched at %d while task %d runs" %
+                          (obj, time, running))
+                running = obj
+            elif running != obj:
+                error("task %d switched out at %d while not running" %
+                      (obj, time))
+            elif typ == ot.TRACE_TSKSWT:
+                running = None
+                if obj == T_LO and arg == READY:
+                    if not dev_isr:
+                        error("T_LO preempted at %d without the ISR" % time)
+                    preempted += 1
+                    dev_isr = False
+    return preempted
+
+
+def job_exec(logs, count_isr):
+    """Execution times of the jobs of each task, as kernel/trace.c
+    counts them; with count_isr, ISR time is not subtracted. The tasks
+    are never activated while active."""
+    isr_time = 0
+    isr_start = 0
+    nest = 0
+    dsp = {}
+    acc = {}
+    pending = {}
+    jobs = {}
+    for time, typ, obj, arg in logs:
+        if typ == ot.TRACE_ISRENT:
+            if nest == 0:
+                isr_start = time
+            nest += 1
+        elif typ == ot.TRACE_ISREXT and nest > 0:
+            nest -= 1
+            if nest == 0 and not count_isr:
+                isr_time += time - isr_start
+        elif typ == ot.TRACE_ACTTSK:
+            if not pending.get(obj):
+                pending[obj] = True
+                acc[obj] = 0
+        elif typ == ot.TRACE_TSKDSP:
+            dsp[obj] = (time, isr_time)
+        elif typ in (ot.TRACE_TSKSWT, ot.TRACE_TSKEXT) and obj in dsp:
+            elapsed = (time - dsp[obj][0]) - (isr_time - dsp[obj][1])
+            if typ == ot.TRACE_TSKSWT:
+                acc[obj] = acc.get(obj, 0) + elapsed
+            else:
+                jobs.setdefault(obj, []).append(acc.get(obj, 0) + elapsed)
+                pending[obj] = False
+                acc[obj] = 0
+                dsp[obj] = (time, isr_time)
+    return jobs
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: tracecheck.py TRACE.bin JOBS")
+        return 2
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    njobs = int(sys.argv[2])
+
+    logs, stats = ot.parse(data)
+    logs = ot.unwrap(logs)
+    if any(typ == ot.TRACE_LOST for time, typ, obj, arg in logs):
+        error("entries lost")
+
+    preempted = check_order(logs)
+    if preempted != njobs:
+        error("T_LO preempted %d times, not %d" % (preempted, njobs))
+
+    jobs = job_exec(logs, False)
+    jobs_isr = job_exec(logs, True)
+    stat = {s["task"]: s for s in stats}
+    for tskid, name in ((T_LO, "T_LO"), (T_HI, "T_HI")):
+        if tskid not in stat:
+            error("no statistics for " + name)
+            continue
+        s = stat[tskid]
+        if s["count"] != njobs or len(jobs.get(tskid, [])) != njobs:
+            error("%s: %d jobs in the statistics, %d in the trace, not %d" %
+                  (name, s["count"], len(jobs.get(tskid, [])), njobs))
+            continue
+        if s["exec_max"] != max(jobs[tskid]):
+            error("%s: exec_max %d, %d in the trace" %
+                  (name, s["exec_max"], max(jobs[tskid])))
+        if s["exec_total"] != sum(jobs[tskid]):
+            error("%s: exec_total %d, %d in the trace" %
+                  (name, s["exec_total"], sum(jobs[tskid])))
+    if jobs.get(T_LO) == jobs_isr.get(T_LO):
+        error("T_LO: no ISR time in its jobs")
+
+    chrome = ot.to_chrome(logs, ["T_LO", "T_HI"])
+    runs = [e for e in chrome["traceEvents"] if e["ph"] == "X"]
+    tasks = len([e for e in runs if e["pid"] == 0])
+    isrs = len([e for e in runs if e["pid"] == 1 and e["tid"] == DEV_ISRID])
+    if tasks != 3 * njobs or isrs != njobs:
+        error("%d task runs and %d device ISRs in the Chrome trace" %
+              (tasks, isrs))
+
+    if errors:
+        print("tracetest: failed")
+        return 1
+    print("tracetest: %d entries, T_LO exec max %d us, %d us with ISRs" %
+          (len(logs), stat[T_LO]["exec_max"], max(jobs_isr[T_LO])))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
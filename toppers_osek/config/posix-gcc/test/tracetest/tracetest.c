@@ -0,0 +1,98 @@
+/* tracetest.c for the POSIX host simulation of TOPPERS/OSEK, built with
+ * OSEK_TRACE
+ *
+ * Every PERIOD ticks the tick activates T_LO. T_LO runs for a while,
+ * then raises the device ISR, which runs for a while and activates
+ * T_HI; T_HI preempts T_LO when the ISR returns, and T_LO finishes
+ * its job after T_HI has ended. The busy waits are in host time, all
+ * within one tick, which the trace time stamps resolve in us.
+ *
+ * At shutdown the trace (trace_dump) and the task statistics
+ * (trace_dump_stat) are written to the file named on the command
+ * line, for tracecheck.py.
+ */
+#include <stdio.h>
+#include <time.h>
+#include "kernel.h"
+#include "kernel_id.h"
+#include "trace.h"
+
+extern UINT32 systick_get_ms(void);
+
+/* Raise a category 2 ISR (cpu_config.h) */
+extern void cpu_raise_interrupt(IsrType isrid, void (*isr)(void));
+
+#define PERIOD 5
+
+static FILE *trace_file;
+
+/* Busy wait in host time */
+static void spin(long us)
+{
+	struct timespec t0, t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	do
+	{
+		clock_gettime(CLOCK_MONOTONIC, &t);
+	} while ((t.tv_sec - t0.tv_sec) * 1000000L
+			+ (t.tv_nsec - t0.tv_nsec) / 1000L < us);
+}
+
+static void dev_isr(void)
+{
+	spin(200);
+	(void) ActivateTask(T_HI);
+}
+
+void user_1ms_isr_type2(void)
+{
+	if (systick_get_ms() % PERIOD == 0)
+	{
+		(void) ActivateTask(T_LO);
+	}
+}
+
+TASK(T_LO)
+{
+	spin(100);
+	cpu_raise_interrupt(DEV_ISRID, dev_isr);
+	spin(100);
+	TerminateTask();
+}
+
+TASK(T_HI)
+{
+	spin(100);
+	TerminateTask();
+}
+
+static UINT32 send(UINT8 *buf, UINT32 len)
+{
+	return (UINT32) fwrite(buf, 1, len, trace_file);
+}
+
+void StartupHook(void) {}
+void PreTaskHook(void) {}
+void PostTaskHook(void) {}
+void ErrorHook(StatusType ercd) {}
+
+void ShutdownHook(StatusType ercd)
+{
+	while (trace_dump(send) > 0)
+	{
+	}
+	(void) trace_dump_stat(send);
+	fclose(trace_file);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 2 || (trace_file = fopen(argv[1], "wb")) == NULL)
+	{
+		fprintf(stderr, "usage: tracetest TRACE.bin\n");
+		return 2;
+	}
+	StartOS(OSDEFAULTAPPMODE);
+	return 0;
+}
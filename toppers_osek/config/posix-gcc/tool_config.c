@@ -0,0 +1,285 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	Development environment dependent module (host gcc, POSIX)
+ *
+ *  Per-service latency statistics.  Each execution context (task, idle
+ *  loop, ISR) keeps a small stack of open service calls; the time the
+ *  context spends switched out between log_suspend() and log_resume()
+ *  is subtracted from every call open in it.  On x86 hosts the unit is
+ *  the time stamp counter, elsewhere nanoseconds of CLOCK_MONOTONIC.
+ */
+
+
+#include	"osek_kernel.h"
+#include	"task.h"
+
+#include	<stdio.h>
+#include	<time.h>
+
+/*
+ *  Number of service IDs (OSServiceId_SignalCounter is the last one)
+ */
+#define TNUM_SVCID		((UINT32)OSServiceId_SignalCounter + 1u)
+
+/*
+ *  Context IDs: task IDs, the idle loop (INVALID_TASK) and the ISR
+ */
+#define LOG_CTX_ISR		((UINT32)INVALID_TASK + 1u)
+#define TNUM_LOG_CTX	(LOG_CTX_ISR + 1u)
+
+/*
+ *  Nesting depth of service calls within one context
+ *  (e.g. ErrorHook calling GetTaskID)
+ */
+#define LOG_NEST_MAX	4u
+
+typedef struct log_frame {
+	OSServiceIdType	svcid;
+	UINT64			start;		/* time stamp at entry */
+	UINT64			excl;		/* switched-out time at entry */
+} LOGFRAME;
+
+typedef struct log_context {
+	UINT32			depth;
+	UINT64			excl;		/* total switched-out time */
+	UINT64			susp;		/* time stamp of log_suspend */
+	LOGFRAME		frame[LOG_NEST_MAX];
+} LOGCTX;
+
+typedef struct log_stat {
+	UINT32			count;
+	UINT64			total;
+	UINT64			min;
+	UINT64			max;
+} LOGSTAT;
+
+static LOGCTX	log_ctx[TNUM_LOG_CTX];
+static LOGSTAT	log_stat[TNUM_SVCID];
+
+static const char * const log_svcname[TNUM_SVCID] = {
+	"ActivateTask",
+	"TerminateTask",
+	"ChainTask",
+	"Schedule",
+	"GetTaskID",
+	"GetTaskState",
+	"EnableAllInterrupts",
+	"DisableAllInterrupts",
+	"ResumeAllInterrupts",
+	"SuspendAllInterrupts",
+	"ResumeOSInterrupts",
+	"SuspendOSInterrupts",
+	"GetResource",
+	"ReleaseResource",
+	"SetEvent",
+	"ClearEvent",
+	"GetEvent",
+	"WaitEvent",
+	"GetAlarmBase",
+	"GetAlarm",
+	"SetRelAlarm",
+	"SetAbsAlarm",
+	"CancelAlarm",
+	"GetActiveApplicationMode",
+	"StartOS",
+	"ShutdownOS",
+	"SignalCounter"
+};
+
+/*
+ *  Read the time stamp
+ */
+Inline UINT64
+log_timestamp(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return((UINT64) __builtin_ia32_rdtsc());
+#else
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((UINT64) ts.tv_sec * 1000000000ull + (UINT64) ts.tv_nsec);
+#endif
+}
+
+/*
+ *  Current context
+ */
+Inline LOGCTX *
+log_current(void)
+{
+	if (int_nest > 0) {
+		return(&log_ctx[LOG_CTX_ISR]);
+	}
+	return(&log_ctx[runtsk]);
+}
+
+/*
+ *  Initialization (tool_initialize)
+ */
+void
+log_initialize(void)
+{
+	UINT32	i;
+
+	for (i = 0; i < TNUM_LOG_CTX; i++) {
+		log_ctx[i].depth = 0;
+		log_ctx[i].excl = 0;
+	}
+	for (i = 0; i < TNUM_SVCID; i++) {
+		log_stat[i].count = 0;
+		log_stat[i].total = 0;
+		log_stat[i].min = ~(UINT64) 0;
+		log_stat[i].max = 0;
+	}
+}
+
+/*
+ *  Service call entry
+ */
+void
+log_api_enter(OSServiceIdType svcid)
+{
+	LOGCTX		*ctx = log_current();
+	LOGFRAME	*frame;
+
+	if (ctx->depth >= LOG_NEST_MAX) {
+		return;
+	}
+	frame = &(ctx->frame[ctx->depth++]);
+	frame->svcid = svcid;
+	frame->excl = ctx->excl;
+	frame->start = log_timestamp();
+}
+
+/*
+ *  Service call exit
+ *
+ *  Frames above the matching one belong to calls that never returned
+ *  and are dropped.
+ */
+void
+log_api_leave(OSServiceIdType svcid)
+{
+	UINT64		now = log_timestamp();
+	LOGCTX		*ctx = log_current();
+	LOGFRAME	*frame;
+	LOGSTAT		*stat;
+	UINT64		lat;
+
+	while (ctx->depth > 0) {
+		frame = &(ctx->frame[--ctx->depth]);
+		if (frame->svcid == svcid) {
+			lat = (now - frame->start) - (ctx->excl - frame->excl);
+			stat = &log_stat[svcid];
+			stat->count++;
+			stat->total += lat;
+			if (lat < stat->min) {
+				stat->min = lat;
+			}
+			if (lat > stat->max) {
+				stat->max = lat;
+			}
+			break;
+		}
+	}
+}
+
+/*
+ *  A task starts from its entry point
+ *
+ *  Calls left open by the previous run (TerminateTask, ChainTask) are
+ *  discarded.
+ */
+void
+log_task_start(TaskType tskid)
+{
+	log_ctx[tskid].depth = 0;
+}
+
+/*
+ *  The current context is switched out
+ */
+void
+log_suspend(void)
+{
+	log_current()->susp = log_timestamp();
+}
+
+/*
+ *  The current context is switched in again
+ */
+void
+log_resume(void)
+{
+	LOGCTX	*ctx = log_current();
+
+	ctx->excl += log_timestamp() - ctx->susp;
+}
+
+/*
+ *  Print the latency report
+ */
+void
+log_report(void)
+{
+	UINT32	i;
+	LOGSTAT	*stat;
+
+#if defined(__i386__) || defined(__x86_64__)
+	printf("OSEK service latency [TSC cycles]\n");
+#else
+	printf("OSEK service latency [ns]\n");
+#endif
+	printf("%-26s %10s %10s %10s %10s\n", "service", "calls", "min", "avg", "max");
+	for (i = 0; i < TNUM_SVCID; i++) {
+		stat = &log_stat[i];
+		if (stat->count == 0) {
+			continue;
+		}
+		printf("%-26s %10u %10llu %10llu %10llu\n", log_svcname[i],
+				(unsigned int) stat->count,
+				(unsigned long long) stat->min,
+				(unsigned long long) (stat->total / stat->count),
+				(unsigned long long) stat->max);
+	}
+	fflush(stdout);
+}
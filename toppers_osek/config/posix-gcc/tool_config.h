@@ -0,0 +1,175 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	Development environment dependent module (host gcc, POSIX)
+ *
+ *  This file is included only from t_config.h.
+ *
+ *  The trace log macros feed the per-service latency statistics of
+ *  tool_config.c, which are printed when the OS shuts down, and the
+ *  trace recorder of kernel/trace.c when OSEK_TRACE is defined.
+ */
+
+
+#ifndef _TOOL_CONFIG_H_
+#define _TOOL_CONFIG_H_
+
+#ifndef _MACRO_ONLY
+
+/*
+ *  Latency statistics (tool_config.c)
+ */
+extern void	log_initialize(void);
+extern void	log_api_enter(OSServiceIdType svcid);
+extern void	log_api_leave(OSServiceIdType svcid);
+extern void	log_task_start(TaskType tskid);
+extern void	log_suspend(void);
+extern void	log_resume(void);
+extern void	log_report(void);
+
+#endif /* _MACRO_ONLY */
+
+/*
+ *  Trace recorder (OSEK_TRACE, kernel/trace.h)
+ */
+#include "trace.h"
+
+/*
+ *  Development environment dependent initialization
+ */
+#define tool_initialize()	do {		\
+	log_initialize();					\
+	trace_initialize();					\
+} while (0)
+
+/*
+ *  Dispatch and interrupt entry/exit
+ *
+ *  The time a context spends switched out is not charged to the
+ *  service call it was executing.
+ */
+#define LOG_DSP_ENTER()			log_suspend()
+#define LOG_DSP_LEAVE()			log_resume()
+#define LOG_INH_ENTER()			log_suspend()
+#define LOG_INH_LEAVE()			log_resume()
+#define LOG_TSK_START(tskid)	log_task_start(tskid)
+
+#define LOG_TSKDSP(tskid)		TRACE_TSKDSP_LOG(tskid)
+#define LOG_TSKSWT(tskid)		TRACE_TSKSWT_LOG(tskid)
+#define LOG_TSKEXT(tskid)		TRACE_TSKEXT_LOG(tskid)
+
+/*
+ *  Trace log settings
+ */
+
+#define LOG_ACTTSK_ENTER(tskid)	do {				\
+	TRACE_ACTTSK_LOG(tskid);						\
+	log_api_enter(OSServiceId_ActivateTask);		\
+} while (0)
+#define LOG_ACTTSK_LEAVE(ercd)	log_api_leave(OSServiceId_ActivateTask)
+#define LOG_TERTSK_ENTER()	log_api_enter(OSServiceId_TerminateTask)
+#define LOG_TERTSK_LEAVE(ercd)	log_api_leave(OSServiceId_TerminateTask)
+#define LOG_CHNTSK_ENTER(tskid)	do {				\
+	TRACE_ACTTSK_LOG(tskid);						\
+	log_api_enter(OSServiceId_ChainTask);			\
+} while (0)
+#define LOG_CHNTSK_LEAVE(ercd)	log_api_leave(OSServiceId_ChainTask)
+#define LOG_SCHED_ENTER()	log_api_enter(OSServiceId_Schedule)
+#define LOG_SCHED_LEAVE(ercd)	log_api_leave(OSServiceId_Schedule)
+#define LOG_GETTID_ENTER(p_tskid)	log_api_enter(OSServiceId_GetTaskID)
+#define LOG_GETTID_LEAVE(ercd, tskid)	log_api_leave(OSServiceId_GetTaskID)
+#define LOG_GETTST_ENTER(tskid, p_state)	log_api_enter(OSServiceId_GetTaskState)
+#define LOG_GETTST_LEAVE(ercd, state)	log_api_leave(OSServiceId_GetTaskState)
+#define LOG_DISINT_ENTER()	log_api_enter(OSServiceId_DisableAllInterrupts)
+#define LOG_DISINT_LEAVE()	log_api_leave(OSServiceId_DisableAllInterrupts)
+#define LOG_ENAINT_ENTER()	log_api_enter(OSServiceId_EnableAllInterrupts)
+#define LOG_ENAINT_LEAVE()	log_api_leave(OSServiceId_EnableAllInterrupts)
+#define LOG_SUSALL_ENTER()	log_api_enter(OSServiceId_SuspendAllInterrupts)
+#define LOG_SUSALL_LEAVE()	log_api_leave(OSServiceId_SuspendAllInterrupts)
+#define LOG_RSMALL_ENTER()	log_api_enter(OSServiceId_ResumeAllInterrupts)
+#define LOG_RSMALL_LEAVE()	log_api_leave(OSServiceId_ResumeAllInterrupts)
+#define LOG_SUSOSI_ENTER()	log_api_enter(OSServiceId_SuspendOSInterrupts)
+#define LOG_SUSOSI_LEAVE()	log_api_leave(OSServiceId_SuspendOSInterrupts)
+#define LOG_RSMOSI_ENTER()	log_api_enter(OSServiceId_ResumeOSInterrupts)
+#define LOG_RSMOSI_LEAVE()	log_api_leave(OSServiceId_ResumeOSInterrupts)
+#define LOG_GETRES_ENTER(resid)	do {				\
+	TRACE_GETRES_LOG(resid);						\
+	log_api_enter(OSServiceId_GetResource);			\
+} while (0)
+#define LOG_GETRES_LEAVE(ercd)	log_api_leave(OSServiceId_GetResource)
+#define LOG_RELRES_ENTER(resid)	do {				\
+	TRACE_RELRES_LOG(resid);						\
+	log_api_enter(OSServiceId_ReleaseResource);		\
+} while (0)
+#define LOG_RELRES_LEAVE(ercd)	log_api_leave(OSServiceId_ReleaseResource)
+#define LOG_SETEVT_ENTER(tskid, mask)	do {		\
+	TRACE_SETEVT_LOG(tskid, mask);					\
+	log_api_enter(OSServiceId_SetEvent);			\
+} while (0)
+#define LOG_SETEVT_LEAVE(ercd)	log_api_leave(OSServiceId_SetEvent)
+#define LOG_CLREVT_ENTER(mask)	log_api_enter(OSServiceId_ClearEvent)
+#define LOG_CLREVT_LEAVE(ercd)	log_api_leave(OSServiceId_ClearEvent)
+#define LOG_GETEVT_ENTER(tskid, p_mask)	log_api_enter(OSServiceId_GetEvent)
+#define LOG_GETEVT_LEAVE(ercd, mask)	log_api_leave(OSServiceId_GetEvent)
+#define LOG_WAIEVT_ENTER(mask)	do {				\
+	TRACE_WAIEVT_LOG(mask);							\
+	log_api_enter(OSServiceId_WaitEvent);			\
+} while (0)
+#define LOG_WAIEVT_LEAVE(ercd)	log_api_leave(OSServiceId_WaitEvent)
+#define LOG_GETALB_ENTER(almid, info)	log_api_enter(OSServiceId_GetAlarmBase)
+#define LOG_GETALB_LEAVE(ercd)	log_api_leave(OSServiceId_GetAlarmBase)
+#define LOG_GETALM_ENTER(almid, p_tick)	log_api_enter(OSServiceId_GetAlarm)
+#define LOG_GETALM_LEAVE(ercd)	log_api_leave(OSServiceId_GetAlarm)
+#define LOG_SETREL_ENTER(almid, incr, cycle)	log_api_enter(OSServiceId_SetRelAlarm)
+#define LOG_SETREL_LEAVE(ercd)	log_api_leave(OSServiceId_SetRelAlarm)
+#define LOG_SETABS_ENTER(almid, start, cycle)	log_api_enter(OSServiceId_SetAbsAlarm)
+#define LOG_SETABS_LEAVE(ercd)	log_api_leave(OSServiceId_SetAbsAlarm)
+#define LOG_CANALM_ENTER(almid)	log_api_enter(OSServiceId_CancelAlarm)
+#define LOG_CANALM_LEAVE(ercd)	log_api_leave(OSServiceId_CancelAlarm)
+#define LOG_SIGCNT_ENTER(cntid)	log_api_enter(OSServiceId_SignalCounter)
+#define LOG_SIGCNT_LEAVE(ercd)	log_api_leave(OSServiceId_SignalCounter)
+#define LOG_GETAAM_ENTER()	log_api_enter(OSServiceId_GetActiveApplicationMode)
+#define LOG_GETAAM_LEAVE(mode)	log_api_leave(OSServiceId_GetActiveApplicationMode)
+#define LOG_STAOS_ENTER(mode)	log_api_enter(OSServiceId_StartOS)
+#define LOG_STAOS_LEAVE()	log_api_leave(OSServiceId_StartOS)
+#define LOG_STUTOS_ENTER(ercd)	log_api_enter(OSServiceId_ShutdownOS)
+#define LOG_STUTOS_LEAVE()	log_api_leave(OSServiceId_ShutdownOS)
+
+#endif /* _TOOL_CONFIG_H_ */
@@ -53,6 +53,20 @@ Inline TickType	add_tick(TickType almval, TickType incr, TickType maxval2);
 Inline TickType	diff_tick(TickType val1, TickType val2, TickType maxval2);
 static void	enqueue_alarm(AlarmType almid, CounterType cntid);
 static void	dequeue_alarm(AlarmType almid, CounterType cntid);
+Inline AlarmType	expire_first(CounterType cntid, TickType newval);
+#ifdef ALMWHEEL_CNTMAP
+static void	almwheel_expinsert(AlarmType almid, CounterType cntid);
+static void	almwheel_enqueue(AlarmType almid, CounterType cntid);
+static void	almwheel_dequeue(AlarmType almid, CounterType cntid);
+static void	almwheel_expire(CounterType cntid, TickType oldval);
+#endif /* ALMWHEEL_CNTMAP */
+#ifdef OSEK_TICKLESS
+static void	tickless_catchup(CounterType cntid);
+static void	tickless_update(CounterType cntid);
+#else /* OSEK_TICKLESS */
+#define tickless_catchup(cntid)
+#define tickless_update(cntid)
+#endif /* OSEK_TICKLESS */
 
 /*
  *  eBbNl̉Z
@@ -116,6 +130,13 @@ enqueue_alarm(AlarmType almid, CounterType cntid)
 	TickType	enqval, curval;
 	AlarmType	next, prev;
 
+#ifdef ALMWHEEL_CNTMAP
+	if (ALMWHEEL_USED(cntid)) {
+		almwheel_enqueue(almid, cntid);
+		return;
+	}
+#endif /* ALMWHEEL_CNTMAP */
+
 	enqval = almcb_almval[almid];
 	curval = cntcb_curval[cntid];
 
@@ -177,6 +198,13 @@ dequeue_alarm(AlarmType almid, CounterType cntid)
 {
 	AlarmType	next, prev;
 
+#ifdef ALMWHEEL_CNTMAP
+	if (ALMWHEEL_USED(cntid)) {
+		almwheel_dequeue(almid, cntid);
+		return;
+	}
+#endif /* ALMWHEEL_CNTMAP */
+
 	next = almcb_next[almid];
 	prev = almcb_prev[almid];
 	if (prev != ALMID_NULL) {
@@ -191,6 +219,310 @@ dequeue_alarm(AlarmType almid, CounterType cntid)
 	almcb_next[almid] = almid;
 }
 
+#ifdef ALMWHEEL_CNTMAP
+
+/*
+ *  Timing wheels
+ *
+ *  almwheel_index maps a counter ID to the index of its wheel.
+ *  almwheel_first/almwheel_last hold the first and the last alarm of
+ *  each slot (ALMID_NULL when the slot is empty). Within a slot the
+ *  alarms are kept in the order they were inserted, not sorted.
+ *
+ *  The alarms that expire in one SignalCounter call are first moved to
+ *  almwheel_expque, sorted by their expiry tick, and their callbacks
+ *  are called from there one by one. The alarms in almwheel_expque are
+ *  still queued, so a callback may cancel any of them.
+ */
+static const UINT8 almwheel_index[ALMWHEEL_MAXCNT] = {
+	0u,
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x01u),
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x03u),
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x07u),
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x0fu),
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x1fu),
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x3fu),
+	ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP) & 0x7fu)
+};
+
+static AlarmType	almwheel_first[TNUM_ALMWHEEL][TNUM_ALMWHEEL_SLOT];
+static AlarmType	almwheel_last[TNUM_ALMWHEEL][TNUM_ALMWHEEL_SLOT];
+static AlarmType	almwheel_expque[TNUM_ALMWHEEL];
+static AlarmType	almwheel_explast[TNUM_ALMWHEEL];
+
+/*
+ *  Insertion into the expired queue of a timing wheel
+ *
+ *  The expired queue is ordered by expiry tick, the oldest first; an
+ *  alarm is inserted after the alarms that expired at the same tick.
+ *  The place is searched from the tail, as the alarms are mostly
+ *  collected in expiry order.
+ */
+static void
+almwheel_expinsert(AlarmType almid, CounterType cntid)
+{
+	UINT8		whl;
+	TickType	curval, maxval2, age;
+	AlarmType	next, prev;
+
+	whl = almwheel_index[cntid];
+	curval = cntcb_curval[cntid];
+	maxval2 = cntinib_maxval2[cntid];
+	age = diff_tick(curval, almcb_almval[almid], maxval2);
+
+	prev = almwheel_explast[whl];
+	while ((prev != ALMID_NULL)
+			&& (diff_tick(curval, almcb_almval[prev], maxval2) < age)) {
+		prev = almcb_prev[prev];
+	}
+	if (prev != ALMID_NULL) {
+		next = almcb_next[prev];
+		almcb_next[prev] = almid;
+	}
+	else {
+		next = almwheel_expque[whl];
+		almwheel_expque[whl] = almid;
+	}
+	almcb_next[almid] = next;
+	almcb_prev[almid] = prev;
+	if (next != ALMID_NULL) {
+		almcb_prev[next] = almid;
+	}
+	else {
+		almwheel_explast[whl] = almid;
+	}
+}
+
+/*
+ *  Insertion into a timing wheel
+ *
+ *  The alarm is appended to the slot of its expiry tick. A cyclic
+ *  alarm whose cycle is shorter than the ticks per SignalCounter call
+ *  may be re-inserted with an expiry tick that has already passed; it
+ *  goes directly to the expired queue, as it would expire again in the
+ *  same call with the sorted list.
+ */
+static void
+almwheel_enqueue(AlarmType almid, CounterType cntid)
+{
+	UINT8		whl;
+	UINT16		slot;
+	AlarmType	last;
+
+	if (diff_tick(cntcb_curval[cntid], almcb_almval[almid],
+					cntinib_maxval2[cntid]) <= cntinib_maxval[cntid]) {
+		almwheel_expinsert(almid, cntid);
+		return;
+	}
+
+	whl = almwheel_index[cntid];
+	slot = ALMWHEEL_SLOT(almcb_almval[almid]);
+	last = almwheel_last[whl][slot];
+
+	almcb_next[almid] = ALMID_NULL;
+	almcb_prev[almid] = last;
+	if (last != ALMID_NULL) {
+		almcb_next[last] = almid;
+	}
+	else {
+		almwheel_first[whl][slot] = almid;
+	}
+	almwheel_last[whl][slot] = almid;
+}
+
+/*
+ *  Removal from a timing wheel
+ *
+ *  The alarm is either in the slot of its expiry tick or in the
+ *  expired queue of the wheel.
+ */
+static void
+almwheel_dequeue(AlarmType almid, CounterType cntid)
+{
+	UINT8		whl;
+	UINT16		slot;
+	AlarmType	next, prev;
+
+	whl = almwheel_index[cntid];
+	slot = ALMWHEEL_SLOT(almcb_almval[almid]);
+	next = almcb_next[almid];
+	prev = almcb_prev[almid];
+
+	if (prev != ALMID_NULL) {
+		almcb_next[prev] = next;
+	}
+	else if (almwheel_expque[whl] == almid) {
+		almwheel_expque[whl] = next;
+	}
+	else {
+		almwheel_first[whl][slot] = next;
+	}
+	if (next != ALMID_NULL) {
+		almcb_prev[next] = prev;
+	}
+	else if (almwheel_explast[whl] == almid) {
+		almwheel_explast[whl] = prev;
+	}
+	else {
+		almwheel_last[whl][slot] = prev;
+	}
+	almcb_next[almid] = almid;
+}
+
+/*
+ *  Collection of the expired alarms of a timing wheel
+ *
+ *  Only the slots of the ticks in (oldval, cntcb_curval[cntid]] are
+ *  looked at; all of them when the counter advanced by
+ *  TNUM_ALMWHEEL_SLOT ticks or more. An alarm in one of these slots has
+ *  expired when its expiry tick lies in that range; it is moved to the
+ *  expired queue. When the counter advances by one tick, all of them
+ *  come from the same slot and are simply appended.
+ */
+static void
+almwheel_expire(CounterType cntid, TickType oldval)
+{
+	UINT8		whl;
+	UINT16		slot;
+	TickType	maxval2, ticks, i;
+	AlarmType	almid, next;
+
+	whl = almwheel_index[cntid];
+	maxval2 = cntinib_maxval2[cntid];
+	ticks = cntinib_tickbase[cntid];
+
+	for (i = 1u; (i <= ticks) && (i <= TNUM_ALMWHEEL_SLOT); i++) {
+		slot = ALMWHEEL_SLOT(add_tick(oldval, i, maxval2));
+		almid = almwheel_first[whl][slot];
+		while (almid != ALMID_NULL) {
+			next = almcb_next[almid];
+			if (diff_tick(almcb_almval[almid], oldval, maxval2) <= ticks) {
+				almwheel_dequeue(almid, cntid);
+				almwheel_expinsert(almid, cntid);
+			}
+			almid = next;
+		}
+	}
+}
+
+#endif /* ALMWHEEL_CNTMAP */
+
+#ifdef OSEK_TICKLESS
+
+/*
+ *  Tick-less counters
+ *
+ *  tickless_pending holds the SignalCounter calls not yet applied to
+ *  cntcb_curval, tickless_compare the number of calls, counted from
+ *  cntcb_curval, after which the first alarm of the queue expires.
+ */
+static TickType	tickless_pending[TICKLESS_MAXCNT];
+static TickType	tickless_compare[TICKLESS_MAXCNT];
+
+/*
+ *  Catching up the pending ticks
+ *
+ *  Called with the CPU locked before the counter value is read. No
+ *  alarm expires in the pending ticks.
+ */
+static void
+tickless_catchup(CounterType cntid)
+{
+	TickType	pending;
+
+	if (TICKLESS_USED(cntid)) {
+		pending = tickless_pending[cntid];
+		if (pending > 0u) {
+			cntcb_curval[cntid] = add_tick(cntcb_curval[cntid],
+						pending * cntinib_tickbase[cntid], cntinib_maxval2[cntid]);
+			tickless_compare[cntid] -= pending;
+			tickless_pending[cntid] = 0u;
+		}
+	}
+}
+
+/*
+ *  Update of the compare value
+ *
+ *  Called with the CPU locked and no ticks pending, after the head of
+ *  the alarm queue may have changed. Without alarms the counter is
+ *  still advanced once per maxallowedvalue ticks.
+ *
+ *  Only the head of the queue is checked for expiry, so an alarm
+ *  queued behind one that is not due yet can be overdue by the time
+ *  it becomes the head (when the alarm before it expires or is
+ *  cancelled). expire_first() takes it at the next call, so then the
+ *  compare value is 1, not the ticks up to its next turn.
+ */
+static void
+tickless_update(CounterType cntid)
+{
+	AlarmType	almid;
+	TickType	ticks, tickbase, curval, maxval2;
+
+	if (TICKLESS_USED(cntid)) {
+		almid = cntcb_almque[cntid];
+		curval = cntcb_curval[cntid];
+		maxval2 = cntinib_maxval2[cntid];
+		tickbase = cntinib_tickbase[cntid];
+		if (almid == ALMID_NULL) {
+			ticks = cntinib_maxval[cntid];
+		}
+		else if (diff_tick(add_tick(curval, tickbase, maxval2),
+					almcb_almval[almid], maxval2) <= cntinib_maxval[cntid]) {
+			ticks = 0u;
+		}
+		else {
+			ticks = diff_tick(almcb_almval[almid], curval, maxval2);
+		}
+		ticks = (ticks + tickbase - 1u) / tickbase;
+		tickless_compare[cntid] = (ticks > 0u) ? ticks : 1u;
+	}
+}
+
+#endif /* OSEK_TICKLESS */
+
+/*
+ *  Removal of the first expired alarm
+ *
+ *  Returns the first alarm of the counter that has expired at tick
+ *  newval after taking it off the alarm queue, or ALMID_NULL when
+ *  there is none.
+ */
+Inline AlarmType
+expire_first(CounterType cntid, TickType newval)
+{
+	AlarmType	almid, next;
+
+#ifdef ALMWHEEL_CNTMAP
+	if (ALMWHEEL_USED(cntid)) {
+		almid = almwheel_expque[almwheel_index[cntid]];
+		if (almid != ALMID_NULL) {
+			almwheel_dequeue(almid, cntid);
+		}
+		return(almid);
+	}
+#endif /* ALMWHEEL_CNTMAP */
+
+	almid = cntcb_almque[cntid];
+	if ((almid == ALMID_NULL)
+			|| (diff_tick(newval, almcb_almval[almid], cntinib_maxval2[cntid])
+												> cntinib_maxval[cntid])) {
+		return(ALMID_NULL);
+	}
+
+	/*
+	 *  A[L[̐擪̃A[CL[OD
+	 */
+	next = almcb_next[almid];
+	cntcb_almque[cntid] = next;
+	if (next != ALMID_NULL) {
+		almcb_prev[next] = ALMID_NULL;
+	}
+	almcb_next[almid] = almid;
+	return(almid);
+}
+
 /*
  *  A[@\̏
  */
@@ -199,11 +531,25 @@ alarm_initialize(void)
 {
 	CounterType	cntid;
 	AlarmType	almid;
+#ifdef ALMWHEEL_CNTMAP
+	UINT8		whl;
+	UINT16		slot;
+#endif /* ALMWHEEL_CNTMAP */
 
 	for (cntid = 0; cntid < tnum_counter; cntid++) {
 		cntcb_curval[cntid] = 0u;
 		cntcb_almque[cntid] = ALMID_NULL;
 	}
+#ifdef ALMWHEEL_CNTMAP
+	for (whl = 0; whl < TNUM_ALMWHEEL; whl++) {
+		for (slot = 0; slot < TNUM_ALMWHEEL_SLOT; slot++) {
+			almwheel_first[whl][slot] = ALMID_NULL;
+			almwheel_last[whl][slot] = ALMID_NULL;
+		}
+		almwheel_expque[whl] = ALMID_NULL;
+		almwheel_explast[whl] = ALMID_NULL;
+	}
+#endif /* ALMWHEEL_CNTMAP */
 	for (almid = 0; almid < tnum_alarm; almid++) {
 		almcb_next[almid] = almid;
 		if ((alminib_autosta[almid] & appmode) != APPMODE_NONE) {
@@ -212,6 +558,14 @@ alarm_initialize(void)
 			enqueue_alarm(almid, alminib_cntid[almid]);
 		}
 	}
+#ifdef OSEK_TICKLESS
+	for (cntid = 0; cntid < tnum_counter; cntid++) {
+		if (TICKLESS_USED(cntid)) {
+			tickless_pending[cntid] = 0u;
+			tickless_update(cntid);
+		}
+	}
+#endif /* OSEK_TICKLESS */
 }
 
 /*
@@ -264,6 +618,7 @@ GetAlarm(AlarmType almid, TickRefType p_tick)
 		goto d_error_exit;
 	}
 	cntid = alminib_cntid[almid];
+	tickless_catchup(cntid);
 	curval = cntcb_curval[cntid];
 	if (curval < almcb_almval[almid]) {
 		*p_tick = almcb_almval[almid] - curval;
@@ -311,10 +666,12 @@ SetRelAlarm(AlarmType almid, TickType incr, TickType cycle)
 		ercd = E_OS_STATE;
 		goto d_error_exit;
 	}
+	tickless_catchup(cntid);
 	almcb_almval[almid] = add_tick(cntcb_curval[cntid], incr,
 										cntinib_maxval2[cntid]);
 	almcb_cycle[almid] = cycle;
 	enqueue_alarm(almid, cntid);
+	tickless_update(cntid);
   exit:
 	unlock_cpu();
 	LOG_SETREL_LEAVE(ercd);
@@ -356,6 +713,7 @@ SetAbsAlarm(AlarmType almid, TickType start, TickType cycle)
 		goto d_error_exit;
 	}
 
+	tickless_catchup(cntid);
 	start2 = start + maxval + 1;
 	if (cntcb_curval[cntid] <= maxval) {
 		if (start <= cntcb_curval[cntid]) {
@@ -375,6 +733,7 @@ SetAbsAlarm(AlarmType almid, TickType start, TickType cycle)
 	}
 	almcb_cycle[almid] = cycle;
 	enqueue_alarm(almid, cntid);
+	tickless_update(cntid);
   exit:
 	unlock_cpu();
 	LOG_SETABS_LEAVE(ercd);
@@ -408,7 +767,9 @@ CancelAlarm(AlarmType almid)
 		ercd = E_OS_NOFUNC;
 		goto d_error_exit;
 	}
+	tickless_catchup(alminib_cntid[almid]);
 	dequeue_alarm(almid, alminib_cntid[almid]);
+	tickless_update(alminib_cntid[almid]);
 
 	/*
 	 *  A[R[obN̒CA[ SetRelAlarm/
@@ -438,42 +799,56 @@ StatusType
 SignalCounter(CounterType cntid)
 {
 	StatusType	ercd = E_OK;
-	TickType	newval;
-	AlarmType	almid, next;
+	TickType	newval, ticks;
+	AlarmType	almid;
+#ifdef ALMWHEEL_CNTMAP
+	TickType	oldval;
+#endif /* ALMWHEEL_CNTMAP */
 
 	LOG_SIGCNT_ENTER(cntid);
 	CHECK_CALLEVEL(TCL_ISR2);
 	CHECK_CNTID(cntid);
 
 	lock_cpu();
+	ticks = cntinib_tickbase[cntid];
+
+#ifdef OSEK_TICKLESS
+	/*
+	 *  Until the compare value is reached, the tick is only counted.
+	 */
+	if (TICKLESS_USED(cntid)) {
+		tickless_pending[cntid] += 1u;
+		if (tickless_pending[cntid] < tickless_compare[cntid]) {
+			goto exit;
+		}
+		ticks *= tickless_pending[cntid];
+		tickless_pending[cntid] = 0u;
+	}
+#endif /* OSEK_TICKLESS */
 
 	/*
 	 *  XṼJE^l߂
 	 */
-	newval = add_tick(cntcb_curval[cntid], cntinib_tickbase[cntid],
-												cntinib_maxval2[cntid]);
+#ifdef ALMWHEEL_CNTMAP
+	oldval = cntcb_curval[cntid];
+#endif /* ALMWHEEL_CNTMAP */
+	newval = add_tick(cntcb_curval[cntid], ticks, cntinib_maxval2[cntid]);
 
 	/*
 	 *  JE^̌ݒl̍XV
 	 */
 	cntcb_curval[cntid] = newval;
 
+#ifdef ALMWHEEL_CNTMAP
+	if (ALMWHEEL_USED(cntid)) {
+		almwheel_expire(cntid, oldval);
+	}
+#endif /* ALMWHEEL_CNTMAP */
+
 	/*
 	 *  A[ expire 
 	 */
-	while (((almid = cntcb_almque[cntid]) != ALMID_NULL)
-			&& diff_tick(newval, almcb_almval[almid], cntinib_maxval2[cntid])
-												<= cntinib_maxval[cntid]) {
-		/*
-		 *  A[L[̐擪̃A[CL[OD
-		 */
-		next = almcb_next[almid];
-		cntcb_almque[cntid] = next;
-		if (next != ALMID_NULL) {
-			almcb_prev[next] = ALMID_NULL;
-		}
-		almcb_next[almid] = almid;
-
+	while ((almid = expire_first(cntid, newval)) != ALMID_NULL) {
 		/*
 		 *  A[R[obŇĂяo
 		 */
@@ -496,6 +871,7 @@ SignalCounter(CounterType cntid)
 			enqueue_alarm(almid, cntid);
 		}
 	}
+	tickless_update(cntid);
   exit:
 	unlock_cpu();
 	LOG_SIGCNT_LEAVE(ercd);
@@ -90,6 +90,69 @@ extern AlarmType		almcb_prev[];		/* 
 extern TickType			almcb_almval[];		/* expire eBbNl */
 extern TickType			almcb_cycle[];		/* A[̎ */
 
+/*
+ *  Timing wheel alarm queue
+ *
+ *  When ALMWHEEL_CNTMAP is defined, the alarms of every counter whose
+ *  bit is set in ALMWHEEL_CNTMAP (bit 0 is counter ID 0) are kept in a
+ *  hashed timing wheel of TNUM_ALMWHEEL_SLOT slots instead of the
+ *  sorted list cntcb_almque. An alarm is linked into the slot selected
+ *  by the low bits of almcb_almval, so SetRelAlarm/SetAbsAlarm/
+ *  CancelAlarm take constant time, and SignalCounter only looks at the
+ *  slots of the ticks that have just elapsed. Alarms whose period is
+ *  longer than TNUM_ALMWHEEL_SLOT ticks stay in their slot and are
+ *  skipped once per round.
+ *
+ *  The counter IDs follow the order in which the counters are defined
+ *  in the OIL file; only the first ALMWHEEL_MAXCNT counters can use the
+ *  wheel. For example, USER_DEF = ALMWHEEL_CNTMAP=0x01 in the
+ *  application Makefile puts the first counter (usually SysTimerCnt)
+ *  on a wheel.
+ */
+#ifdef ALMWHEEL_CNTMAP
+
+#ifndef TNUM_ALMWHEEL_SLOT
+#define TNUM_ALMWHEEL_SLOT	64u		/* must be a power of 2 */
+#endif /* TNUM_ALMWHEEL_SLOT */
+
+#define ALMWHEEL_MAXCNT		8u
+#define ALMWHEEL_SLOT(almval)	((almval) & (TNUM_ALMWHEEL_SLOT - 1u))
+#define ALMWHEEL_USED(cntid)	(((cntid) < ALMWHEEL_MAXCNT)	\
+		&& ((((UINT8)(ALMWHEEL_CNTMAP)) & (1u << (cntid))) != 0u))
+
+#define ALMWHEEL_BITCNT(map)	\
+		(((map) & 1u) + (((map) >> 1) & 1u) + (((map) >> 2) & 1u)	\
+		+ (((map) >> 3) & 1u) + (((map) >> 4) & 1u) + (((map) >> 5) & 1u)	\
+		+ (((map) >> 6) & 1u) + (((map) >> 7) & 1u))
+#define TNUM_ALMWHEEL		ALMWHEEL_BITCNT((UINT8)(ALMWHEEL_CNTMAP))
+
+#endif /* ALMWHEEL_CNTMAP */
+
+/*
+ *  Tick-less counters
+ *
+ *  When OSEK_TICKLESS is defined, SignalCounter does not process every
+ *  tick of the first TICKLESS_MAXCNT counters. It only counts them
+ *  until the tick at which the first alarm of cntcb_almque expires
+ *  (the software compare value, updated whenever the queue changes),
+ *  and then advances the counter by all the pending ticks at once.
+ *  No alarm can expire in between, so the alarms expire at the same
+ *  ticks as before; the services that read the counter value catch up
+ *  the pending ticks first. Counters on a timing wheel are processed
+ *  on every tick.
+ */
+#ifdef OSEK_TICKLESS
+
+#define TICKLESS_MAXCNT		8u
+#ifdef ALMWHEEL_CNTMAP
+#define TICKLESS_USED(cntid)	(((cntid) < TICKLESS_MAXCNT)	\
+									&& !ALMWHEEL_USED(cntid))
+#else /* ALMWHEEL_CNTMAP */
+#define TICKLESS_USED(cntid)	((cntid) < TICKLESS_MAXCNT)
+#endif /* ALMWHEEL_CNTMAP */
+
+#endif /* OSEK_TICKLESS */
+
 /*
  *  A[@\̏
  */
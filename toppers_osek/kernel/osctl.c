@@ -44,6 +44,7 @@
 
 #include "osek_kernel.h"
 #include "check.h"
+#include "task.h"
 #include "interrupt.h"
 
 /*
@@ -109,6 +110,7 @@ call_errorhook(StatusType ercd, OSServiceIdType svcid)
 void
 call_posttaskhook(void)
 {
+	LOG_TSKSWT(runtsk);
 	callevel = TCL_PREPOST;
 	set_ipl(ipl_maxisr2);
 	unlock_cpu();
@@ -124,6 +126,7 @@ call_posttaskhook(void)
 void
 call_pretaskhook(void)
 {
+	LOG_TSKDSP(runtsk);
 	callevel = TCL_PREPOST;
 	set_ipl(ipl_maxisr2);
 	unlock_cpu();
@@ -69,8 +69,17 @@ typedef	UINT8		IPL;			/* 
 
 /*
  *  Dx̒iK̒`
- */
-#define TNUM_PRIORITY	((Priority) 16)
+ *
+ *  ready_primap is 32 bits wide, so up to 32 task priorities can be
+ *  used.  The ECC impl_oil files accept PRIORITY 1..32 accordingly;
+ *  define TNUM_PRIORITY (e.g. in USER_DEF) to save RAM when fewer
+ *  levels are needed.  sg.exe itself is a Windows binary and has not
+ *  been run on an OIL file with priorities above 16; check its
+ *  kernel_cfg.c output before relying on them.
+ */
+#ifndef TNUM_PRIORITY
+#define TNUM_PRIORITY	((Priority) 32)
+#endif /* TNUM_PRIORITY */
 
 /*
  *  ʓIȒ萔̒`
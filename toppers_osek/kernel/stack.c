@@ -0,0 +1,135 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	Task stack monitor
+ *
+ *  The stacks grow downwards from tinib_stk[] + tinib_stksz[], so the
+ *  words at the bottom of the area that still hold STACK_PAINT have
+ *  never been used.
+ *
+ *  The stacks are painted once in task_initialize(), before any task
+ *  runs, rather than on every activation: tasks of the same priority
+ *  may share a stack area, and repainting it when one of them is
+ *  activated would destroy the frame of the one that is running.
+ */
+
+#include "osek_kernel.h"
+#include "task.h"
+#include "stack.h"
+
+#ifdef OSEK_STACK_MONITOR
+
+/*
+ *  Number of whole words in the stack area of a task
+ */
+#define STACK_WORDS(tskid)	((UINT32) tinib_stksz[tskid] / sizeof(UINT32))
+
+/*
+ *  Initialization (task_initialize)
+ */
+void
+stack_initialize(void)
+{
+	TaskType	tskid;
+	UINT32		*p_stk;
+	UINT32		i, n;
+
+	for (tskid = 0; tskid < tnum_task; tskid++) {
+		p_stk = (UINT32 *) tinib_stk[tskid];
+		n = STACK_WORDS(tskid);
+		for (i = 0u; i < n; i++) {
+			p_stk[i] = STACK_PAINT;
+		}
+	}
+}
+
+/*
+ *  Read the high-water mark of a task
+ *
+ *  Can be called from any task or ISR; the unused part of the stack
+ *  only ever shrinks, so no lock is needed.
+ */
+BOOL
+stack_get_usage(TaskType tskid, STACK_INFO *p_info)
+{
+	const UINT32	*p_stk;
+	UINT32			i, n;
+
+	if (tskid >= tnum_task) {
+		return(FALSE);
+	}
+	p_stk = (const UINT32 *) tinib_stk[tskid];
+	n = STACK_WORDS(tskid);
+	for (i = 0u; i < n && p_stk[i] == STACK_PAINT; i++) {
+	}
+	p_info->size = tinib_stksz[tskid];
+	p_info->used = (UINT16)(tinib_stksz[tskid] - i * sizeof(UINT32));
+	return(TRUE);
+}
+
+/*
+ *  Send the high-water marks of all tasks
+ *
+ *  One STACK_RECORD_INFO per task.  Returns the number of records
+ *  sent.
+ */
+UINT32
+stack_dump(STACK_SEND send)
+{
+	STACK_RECORD_INFO	rec;
+	STACK_INFO			info;
+	TaskType			tskid;
+	UINT32				sent = 0u;
+
+	for (tskid = 0; stack_get_usage(tskid, &info); tskid++) {
+		rec.size = info.size;
+		rec.used = info.used;
+		rec.type = STACK_RECORD;
+		rec.id = tskid;
+		rec.reserved = 0u;
+		if (send((UINT8 *) &rec, sizeof(rec)) == 0u) {
+			break;
+		}
+		sent++;
+	}
+	return(sent);
+}
+
+#endif /* OSEK_STACK_MONITOR */
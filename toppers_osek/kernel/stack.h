@@ -0,0 +1,108 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	Task stack monitor
+ *
+ *  Enabled by defining OSEK_STACK_MONITOR (e.g. in USER_DEF).  The task
+ *  stacks are filled with STACK_PAINT when the OS starts, and the part
+ *  a task has written since then is its high-water mark.
+ *  stack_get_usage() reads it at run time and stack_dump() sends it
+ *  out through a function such as ecrobot_send_bt_packet();
+ *  utils/osek_stksz.py turns the report into new STACKSIZE values for
+ *  the OIL file.
+ *
+ *  Tasks that share a stack area report the usage of the whole area.
+ *  Only meaningful on ports that run the tasks on tinib_stk[] (not on
+ *  the POSIX simulator, whose tasks run on host stacks).
+ */
+
+#ifndef _STACK_H_
+#define _STACK_H_
+
+/*
+ *  Fill pattern
+ */
+#define STACK_PAINT		0xa5c3a5c3u
+
+/*
+ *  Record type on the wire, next to the TRACE_* types of trace.h
+ */
+#define STACK_RECORD	0x81u
+
+#ifndef _MACRO_ONLY
+
+/*
+ *  Stack usage of a task [bytes]
+ */
+typedef struct stack_info {
+	UINT16	size;		/* size of the stack area (STACKSIZE) */
+	UINT16	used;		/* high-water mark */
+} STACK_INFO;
+
+/*
+ *  Report record (8 bytes), same layout as a trace log entry
+ */
+typedef struct stack_record {
+	UINT16	size;		/* size of the stack area */
+	UINT16	used;		/* high-water mark */
+	UINT8	type;		/* STACK_RECORD */
+	UINT8	id;			/* task ID */
+	UINT16	reserved;
+} STACK_RECORD_INFO;
+
+/*
+ *  Output function: sends len bytes, returns the number sent (0 when
+ *  the link is busy or down), like ecrobot_send_bt_packet()
+ */
+typedef UINT32 (*STACK_SEND)(UINT8 *buf, UINT32 len);
+
+#ifdef OSEK_STACK_MONITOR
+
+extern void		stack_initialize(void);
+extern BOOL		stack_get_usage(TaskType tskid, STACK_INFO *p_info);
+extern UINT32	stack_dump(STACK_SEND send);
+
+#else /* OSEK_STACK_MONITOR */
+
+#define stack_initialize()
+
+#endif /* OSEK_STACK_MONITOR */
+#endif /* _MACRO_ONLY */
+#endif /* _STACK_H_ */
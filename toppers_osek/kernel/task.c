@@ -47,6 +47,7 @@
 #include "task.h"
 #include "resource.h"
 #include "cpu_context.h"
+#include "stack.h"
 
 /*
  *  X^eBbN֐̃vg^Cv錾
@@ -54,7 +55,7 @@
 Inline void	ready_insert_first(Priority pri, TaskType tskid);
 Inline void	ready_insert_last(Priority pri, TaskType tskid);
 Inline TaskType	ready_delete_first(Priority pri);
-Inline Priority	bitmap_search(UINT16 bitmap);
+Inline Priority	bitmap_search(UINT32 bitmap);
 
 /*
  *  fBL[
@@ -124,8 +125,8 @@ ready_delete_first(Priority pri)
  *
  *  bitmap  1 ̃rbg̓CłLiĵ̂T[`C̃r
  *  bgԍԂDrbgԍ́Cŉʃrbg 0 ƂDbitmap  0
- *  w肵Ă͂ȂȂD̊֐ł́CDx16iKȉł邱Ƃ
- *  肵Cbitmap ̉16rbĝ݂T[`D
+ *  w肵Ă͂ȂȂD̊֐ł́CDx32iKȉł邱Ƃ
+ *  肷D
  *  rbgT[`߂vZbTł́CrbgT[`߂g悤
  *  ǂ낤D̂悤ȏꍇɂ́Ccpu_insn.h 
  *  rbgT[`߂g bitmap_search `CCPU_BITMAP_SEARCH 
@@ -134,8 +135,8 @@ ready_delete_first(Priority pri)
  *  }N`΂悢D
  *  ܂CWCu ffs ȂĈ悤ɒ`ĕWC
  *  ugǂ\D
- *	#define PRIMAP_BIT(pri)	(0x8000u >> (pri))
- *	#define	bitmap_search(bitmap) (16 - ffs(bitmap))
+ *	#define PRIMAP_BIT(pri)	(0x80000000u >> (pri))
+ *	#define	bitmap_search(bitmap) (32 - ffs(bitmap))
  *  ITRONdlƂ͗DẍӖt̂߁CT[`tɂȂ
  *  Dbitmap_search uꍇɂ́CӂKvłD
  */
@@ -146,22 +147,26 @@ ready_delete_first(Priority pri)
 #ifndef CPU_BITMAP_SEARCH
 
 Inline Priority
-bitmap_search(UINT16 bitmap)
+bitmap_search(UINT32 bitmap)
 {
 	static const UINT8 search_table[] = { 0, 1, 1, 2, 2, 2, 2,
 						3, 3, 3, 3, 3, 3, 3, 3 };
 	Priority	pri = 0;
 
-	assert((bitmap & ((UINT16) 0xffffu)) != 0);
-	if ((bitmap & ((UINT16) 0xff00u)) != 0) {
+	assert(bitmap != 0u);
+	if ((bitmap & 0xffff0000u) != 0u) {
+		bitmap >>= 16;
+		pri += 16;
+	}
+	if ((bitmap & 0xff00u) != 0u) {
 		bitmap >>= 8;
 		pri += 8;
 	}
-	if ((bitmap & ((UINT16) 0xf0)) != 0) {
+	if ((bitmap & 0xf0u) != 0u) {
 		bitmap >>= 4;
 		pri += 4;
 	}
-	return(pri + (search_table[(bitmap & ((UINT16) 0x0f)) - 1]));
+	return(pri + (search_table[(bitmap & 0x0fu) - 1]));
 }
 
 #endif /* CPU_BITMAP_SEARCH */
@@ -186,7 +191,7 @@ Priority	nextpri;
  *
  *  fBL[̎is\Ԃ̃^XNj 0 ɂD
  */
-static UINT16	ready_primap;
+static UINT32	ready_primap;
 
 /*
  *  ^XNǗW[̏
@@ -205,6 +210,11 @@ task_initialize(void)
 	nextpri = TPRI_MINTASK;
 	ready_primap = 0u;
 
+	/*
+	 *  X^bNgpʂ̌v̏iOSEK_STACK_MONITORj
+	 */
+	stack_initialize();
+
 	for (tskid = 0; tskid < tnum_task; tskid++) {
 		tcb_actcnt[tskid] = 0;
 		if ((tinib_autoact[tskid] & appmode) != APPMODE_NONE) {
@@ -278,14 +288,14 @@ make_runnable(TaskType tskid)
 void
 search_schedtsk(void)
 {
-	if (ready_primap == ((UINT16) 0)) {
+	if (ready_primap == 0u) {
 		schedtsk = TSKID_NULL;
 	}
 	else {
 		schedtsk = ready_delete_first(nextpri);
 		if (ready_queue_first[nextpri] == TSKID_NULL) {
 			ready_primap &= ~PRIMAP_BIT(nextpri);
-			nextpri = (ready_primap == ((UINT16) 0)) ?
+			nextpri = (ready_primap == 0u) ?
 						TPRI_MINTASK : bitmap_search(ready_primap);
 		}
 	}
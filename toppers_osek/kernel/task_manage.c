@@ -108,6 +108,7 @@ TerminateTask(void)
 		tcb_actcnt[runtsk] -= 1;
 		(void)make_active(runtsk);
 	}
+	LOG_TSKEXT(runtsk);
 	exit_and_dispatch();
 	/* ɂ͖߂ĂȂ */
 
@@ -165,6 +166,7 @@ ChainTask(TaskType tskid)
 			tcb_actcnt[tskid] += 1;
 		}
 	}
+	LOG_TSKEXT(runtsk);
 	exit_and_dispatch();
 	/* ɂ͖߂ĂȂ */
 
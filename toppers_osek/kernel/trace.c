@@ -0,0 +1,384 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	Trace recorder
+ *
+ *  The ring buffer keeps the newest TNUM_TRACE_LOG entries; older ones
+ *  are overwritten and counted in trace_lost.  A writer only claims
+ *  and fills one entry with interrupts masked (save_disable_int), so
+ *  the recorder can be called from any context, with or without the
+ *  CPU locked, and never waits.
+ */
+
+#include "osek_kernel.h"
+#include "task.h"
+
+#ifdef OSEK_TRACE
+
+#define TRACE_LOG_MASK	(TNUM_TRACE_LOG - 1u)
+
+/*
+ *  Ring buffer
+ *
+ *  trace_head is the index of the next entry to write and trace_tail
+ *  that of the oldest entry not yet dumped; both run freely.
+ */
+static TRACE_LOG	trace_buf[TNUM_TRACE_LOG];
+static UINT32		trace_head;
+static UINT32		trace_tail;
+static UINT32		trace_lost;
+
+/*
+ *  Job state of the traced tasks
+ */
+static UINT32		trace_act_time[TNUM_TRACE_TASK];	/* activation */
+static UINT32		trace_dsp_time[TNUM_TRACE_TASK];	/* last dispatch */
+static UINT32		trace_dsp_isr[TNUM_TRACE_TASK];		/* trace_isr_time then */
+static UINT32		trace_exec[TNUM_TRACE_TASK];		/* execution so far */
+static BOOL			trace_pending[TNUM_TRACE_TASK];		/* activated, not ended */
+static TRACE_STAT_INFO	trace_stat[TNUM_TRACE_TASK];
+
+/*
+ *  Time spent in ISRs, subtracted from the execution time of tasks
+ */
+static UINT32		trace_isr_time;
+static UINT32		trace_isr_start;
+static UINT8		trace_isr_nest;
+
+/*
+ *  Append an entry (called with interrupts masked)
+ */
+Inline void
+trace_put(UINT32 time, UINT8 type, UINT8 id, UINT16 arg)
+{
+	TRACE_LOG	*log = &trace_buf[trace_head & TRACE_LOG_MASK];
+
+	log->time = time;
+	log->type = type;
+	log->id = id;
+	log->arg = arg;
+	trace_head++;
+	if ((trace_head - trace_tail) > TNUM_TRACE_LOG) {
+		trace_tail++;
+		trace_lost++;
+	}
+}
+
+/*
+ *  Initialization (tool_initialize)
+ */
+void
+trace_initialize(void)
+{
+	TaskType	tskid;
+
+	trace_head = 0u;
+	trace_tail = 0u;
+	trace_lost = 0u;
+	trace_isr_time = 0u;
+	trace_isr_nest = 0u;
+	for (tskid = 0; tskid < TNUM_TRACE_TASK; tskid++) {
+		trace_pending[tskid] = FALSE;
+		trace_exec[tskid] = 0u;
+		trace_stat[tskid].count = 0u;
+		trace_stat[tskid].exec_max = 0u;
+		trace_stat[tskid].exec_total = 0u;
+		trace_stat[tskid].resp_min = ~0u;
+		trace_stat[tskid].resp_max = 0u;
+	}
+}
+
+/*
+ *  Record an event
+ */
+void
+trace_write(UINT8 type, UINT8 id, UINT16 arg)
+{
+	UINT32	flags = save_disable_int();
+
+	trace_put(trace_get_time(), type, id, arg);
+	restore_int(flags);
+}
+
+/*
+ *  Activation request
+ */
+void
+trace_tskact(TaskType tskid)
+{
+	UINT32	flags = save_disable_int();
+	UINT32	now = trace_get_time();
+
+	trace_put(now, TRACE_ACTTSK, tskid, 0u);
+	if ((tskid < TNUM_TRACE_TASK) && !trace_pending[tskid]) {
+		trace_pending[tskid] = TRUE;
+		trace_act_time[tskid] = now;
+		trace_exec[tskid] = 0u;
+	}
+	restore_int(flags);
+}
+
+/*
+ *  Task starts running (call_pretaskhook)
+ */
+void
+trace_tskdsp(TaskType tskid)
+{
+	UINT32	flags = save_disable_int();
+	UINT32	now = trace_get_time();
+
+	trace_put(now, TRACE_TSKDSP, tskid, 0u);
+	if (tskid < TNUM_TRACE_TASK) {
+		trace_dsp_time[tskid] = now;
+		trace_dsp_isr[tskid] = trace_isr_time;
+	}
+	restore_int(flags);
+}
+
+/*
+ *  Execution time since the last dispatch, without ISRs
+ */
+Inline UINT32
+trace_elapsed(TaskType tskid, UINT32 now)
+{
+	return((now - trace_dsp_time[tskid])
+				- (trace_isr_time - trace_dsp_isr[tskid]));
+}
+
+/*
+ *  Task stops running (call_posttaskhook)
+ *
+ *  The argument is the new task state: preempted (TS_RUNNABLE),
+ *  waiting or terminated.
+ */
+void
+trace_tskswt(TaskType tskid)
+{
+	UINT32	flags = save_disable_int();
+	UINT32	now = trace_get_time();
+
+	trace_put(now, TRACE_TSKSWT, tskid, tcb_tstat[tskid]);
+	if (tskid < TNUM_TRACE_TASK) {
+		trace_exec[tskid] += trace_elapsed(tskid, now);
+	}
+	restore_int(flags);
+}
+
+/*
+ *  End of a job (TerminateTask, ChainTask)
+ *
+ *  Called with the CPU locked, after a queued activation has been
+ *  made active again.
+ */
+void
+trace_tskext(TaskType tskid)
+{
+	UINT32			flags = save_disable_int();
+	UINT32			now = trace_get_time();
+	UINT32			exec, resp;
+	TRACE_STAT_INFO	*stat;
+
+	trace_put(now, TRACE_TSKEXT, tskid, 0u);
+	if (tskid < TNUM_TRACE_TASK) {
+		exec = trace_exec[tskid] + trace_elapsed(tskid, now);
+		stat = &trace_stat[tskid];
+		stat->count++;
+		stat->exec_total += exec;
+		if (exec > stat->exec_max) {
+			stat->exec_max = exec;
+		}
+		if (trace_pending[tskid]) {
+			resp = now - trace_act_time[tskid];
+			if (resp < stat->resp_min) {
+				stat->resp_min = resp;
+			}
+			if (resp > stat->resp_max) {
+				stat->resp_max = resp;
+			}
+		}
+
+		/*
+		 *  The rest of this run up to the dispatch is charged to the
+		 *  next job (if any).
+		 */
+		trace_pending[tskid] = (tcb_tstat[tskid] != TS_DORMANT);
+		trace_act_time[tskid] = now;
+		trace_exec[tskid] = 0u;
+		trace_dsp_time[tskid] = now;
+		trace_dsp_isr[tskid] = trace_isr_time;
+	}
+	restore_int(flags);
+}
+
+/*
+ *  ISR2 entry and exit
+ */
+void
+trace_isrent(UINT8 intno)
+{
+	UINT32	flags = save_disable_int();
+	UINT32	now = trace_get_time();
+
+	trace_put(now, TRACE_ISRENT, intno, 0u);
+	if (trace_isr_nest++ == 0u) {
+		trace_isr_start = now;
+	}
+	restore_int(flags);
+}
+
+void
+trace_isrext(UINT8 intno)
+{
+	UINT32	flags = save_disable_int();
+	UINT32	now = trace_get_time();
+
+	trace_put(now, TRACE_ISREXT, intno, 0u);
+	if ((trace_isr_nest > 0u) && (--trace_isr_nest == 0u)) {
+		trace_isr_time += now - trace_isr_start;
+	}
+	restore_int(flags);
+}
+
+/*
+ *  Read the statistics of a task
+ */
+BOOL
+trace_get_stat(TaskType tskid, TRACE_STAT_INFO *p_stat)
+{
+	UINT32	flags;
+
+	if (tskid >= TNUM_TRACE_TASK || tskid >= tnum_task) {
+		return(FALSE);
+	}
+	flags = save_disable_int();
+	*p_stat = trace_stat[tskid];
+	restore_int(flags);
+	return(TRUE);
+}
+
+/*
+ *  Number of entries sent per call of the output function
+ */
+#define TRACE_DUMP_NUM	8u
+
+/*
+ *  Send the buffered entries
+ *
+ *  Entries are removed once send() has accepted them; a TRACE_LOST
+ *  entry goes first if entries were overwritten.  Returns the number
+ *  of entries sent; call it again (e.g. from a background task) until
+ *  it returns 0.
+ */
+UINT32
+trace_dump(TRACE_SEND send)
+{
+	TRACE_LOG	buf[TRACE_DUMP_NUM];
+	UINT32		flags, tail, lost;
+	UINT32		num, n = 0u, sent = 0u;
+
+	do {
+		flags = save_disable_int();
+		tail = trace_tail;
+		lost = trace_lost;
+		num = 0u;
+		if (lost > 0u) {
+			buf[num].time = trace_get_time();
+			buf[num].type = TRACE_LOST;
+			buf[num].id = 0u;
+			buf[num].arg = (lost > 0xffffu) ? 0xffffu : (UINT16) lost;
+			num++;
+		}
+		while ((num < TRACE_DUMP_NUM) && (tail + n != trace_head)) {
+			buf[num++] = trace_buf[(tail + n) & TRACE_LOG_MASK];
+			n++;
+		}
+		restore_int(flags);
+
+		if (num == 0u || send((UINT8 *) buf, num * sizeof(TRACE_LOG)) == 0u) {
+			break;
+		}
+
+		/*
+		 *  Entries overwritten while sending have already moved
+		 *  trace_tail on (and were counted as lost).
+		 */
+		flags = save_disable_int();
+		if ((trace_tail - tail) < n) {
+			trace_tail = tail + n;
+		}
+		trace_lost -= lost;
+		restore_int(flags);
+		sent += num;
+		n = 0u;
+	} while (num == TRACE_DUMP_NUM);
+	return(sent);
+}
+
+/*
+ *  Send the statistics of all traced tasks
+ *
+ *  One 24 byte record per task: count, type TRACE_STAT, task ID, two
+ *  bytes padding, then exec_max, exec_total, resp_min and resp_max.
+ *  Returns the number of records sent.
+ */
+UINT32
+trace_dump_stat(TRACE_SEND send)
+{
+	UINT32			rec[6];
+	TRACE_STAT_INFO	stat;
+	TaskType		tskid;
+	UINT32			sent = 0u;
+
+	for (tskid = 0; trace_get_stat(tskid, &stat); tskid++) {
+		rec[0] = stat.count;
+		rec[1] = TRACE_STAT | ((UINT32) tskid << 8);
+		rec[2] = stat.exec_max;
+		rec[3] = stat.exec_total;
+		rec[4] = stat.resp_min;
+		rec[5] = stat.resp_max;
+		if (send((UINT8 *) rec, sizeof(rec)) == 0u) {
+			break;
+		}
+		sent++;
+	}
+	return(sent);
+}
+
+#endif /* OSEK_TRACE */
@@ -0,0 +1,166 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	Trace recorder
+ *
+ *  Enabled by defining OSEK_TRACE (e.g. in USER_DEF).  Task activation,
+ *  dispatch, preemption, WaitEvent, GetResource/ReleaseResource and
+ *  ISR2 entry/exit are time stamped into a ring buffer, and execution
+ *  and response times are accumulated per task.  trace_dump() and
+ *  trace_dump_stat() send both out through a function such as
+ *  ecrobot_send_bt_packet(); utils/osek_trace.py decodes the stream.
+ *
+ *  The target supplies trace_get_time(), a free running time in
+ *  microseconds (syslib hw_sys_timer.c).
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+/*
+ *  Number of log entries (must be a power of 2) and of tasks for which
+ *  statistics are kept (task IDs from 0)
+ */
+#ifndef TNUM_TRACE_LOG
+#define TNUM_TRACE_LOG		256u
+#endif /* TNUM_TRACE_LOG */
+
+#ifndef TNUM_TRACE_TASK
+#define TNUM_TRACE_TASK		16u
+#endif /* TNUM_TRACE_TASK */
+
+/*
+ *  Event types
+ *
+ *  id is a task ID unless noted otherwise.
+ */
+#define TRACE_ACTTSK	0x01u	/* activation request */
+#define TRACE_TSKDSP	0x02u	/* task starts running */
+#define TRACE_TSKSWT	0x03u	/* task stops running, arg: new state */
+#define TRACE_TSKEXT	0x04u	/* job ends (TerminateTask, ChainTask) */
+#define TRACE_WAIEVT	0x05u	/* WaitEvent, arg: mask (low 16 bits) */
+#define TRACE_SETEVT	0x06u	/* SetEvent, arg: mask (low 16 bits) */
+#define TRACE_GETRES	0x07u	/* GetResource, id: resource, arg: task */
+#define TRACE_RELRES	0x08u	/* ReleaseResource, id: resource, arg: task */
+#define TRACE_ISRENT	0x09u	/* ISR2 entry, id: interrupt number */
+#define TRACE_ISREXT	0x0au	/* ISR2 exit, id: interrupt number */
+#define TRACE_LOST		0x7fu	/* entries overwritten, arg: count */
+#define TRACE_STAT		0x80u	/* task statistics record (trace_dump_stat) */
+
+#ifndef _MACRO_ONLY
+
+/*
+ *  Log entry (8 bytes, also the format on the wire)
+ */
+typedef struct trace_log {
+	UINT32	time;		/* time stamp [us] */
+	UINT8	type;		/* event type */
+	UINT8	id;			/* object ID */
+	UINT16	arg;		/* argument */
+} TRACE_LOG;
+
+/*
+ *  Per-task statistics [us]
+ *
+ *  The execution time of a job excludes preemption and ISRs.  The
+ *  response time runs from the activation to the end of the job; for
+ *  an activation that was queued while the task was active it runs
+ *  from the end of the previous job.
+ */
+typedef struct trace_stat {
+	UINT32	count;		/* number of finished jobs */
+	UINT32	exec_max;	/* worst observed execution time */
+	UINT32	exec_total;	/* sum of execution times */
+	UINT32	resp_min;	/* shortest response time */
+	UINT32	resp_max;	/* longest response time */
+} TRACE_STAT_INFO;
+
+/*
+ *  Output function: sends len bytes, returns the number sent (0 when
+ *  the link is busy or down), like ecrobot_send_bt_packet()
+ */
+typedef UINT32 (*TRACE_SEND)(UINT8 *buf, UINT32 len);
+
+#ifdef OSEK_TRACE
+
+extern UINT32	trace_get_time(void);
+
+extern void		trace_initialize(void);
+extern void		trace_write(UINT8 type, UINT8 id, UINT16 arg);
+extern void		trace_tskact(TaskType tskid);
+extern void		trace_tskdsp(TaskType tskid);
+extern void		trace_tskswt(TaskType tskid);
+extern void		trace_tskext(TaskType tskid);
+extern void		trace_isrent(UINT8 intno);
+extern void		trace_isrext(UINT8 intno);
+
+extern BOOL		trace_get_stat(TaskType tskid, TRACE_STAT_INFO *p_stat);
+extern UINT32	trace_dump(TRACE_SEND send);
+extern UINT32	trace_dump_stat(TRACE_SEND send);
+
+#define TRACE_ACTTSK_LOG(tskid)		trace_tskact(tskid)
+#define TRACE_TSKDSP_LOG(tskid)		trace_tskdsp(tskid)
+#define TRACE_TSKSWT_LOG(tskid)		trace_tskswt(tskid)
+#define TRACE_TSKEXT_LOG(tskid)		trace_tskext(tskid)
+#define TRACE_WAIEVT_LOG(mask)		trace_write(TRACE_WAIEVT, runtsk, (UINT16)(mask))
+#define TRACE_SETEVT_LOG(tskid, mask) \
+							trace_write(TRACE_SETEVT, (tskid), (UINT16)(mask))
+#define TRACE_GETRES_LOG(resid)		trace_write(TRACE_GETRES, (resid), runtsk)
+#define TRACE_RELRES_LOG(resid)		trace_write(TRACE_RELRES, (resid), runtsk)
+#define TRACE_ISRENT_LOG(intno)		trace_isrent(intno)
+#define TRACE_ISREXT_LOG(intno)		trace_isrext(intno)
+
+#else /* OSEK_TRACE */
+
+#define trace_initialize()
+#define TRACE_ACTTSK_LOG(tskid)
+#define TRACE_TSKDSP_LOG(tskid)
+#define TRACE_TSKSWT_LOG(tskid)
+#define TRACE_TSKEXT_LOG(tskid)
+#define TRACE_WAIEVT_LOG(mask)
+#define TRACE_SETEVT_LOG(tskid, mask)
+#define TRACE_GETRES_LOG(resid)
+#define TRACE_RELRES_LOG(resid)
+#define TRACE_ISRENT_LOG(intno)
+#define TRACE_ISREXT_LOG(intno)
+
+#endif /* OSEK_TRACE */
+#endif /* _MACRO_ONLY */
+#endif /* _TRACE_H_ */
@@ -48,6 +48,8 @@
 #include "ecrobot_base.h"
 #include "ecrobot_interface.h"
 
+#include "trace.h"
+
 /* Originally, systick_low_priority_C is a LEJOS ISR. 
  * LEJOS-OSEK uses systick_isr_C1 category 2 ISR instead of systick_low_priority_C 
  * to implement a system timer module for OSEK alarm and 
@@ -71,6 +73,29 @@ void systick_isr_C1()
 	 * after EXIT button was pressed
 	 */
 	systick_low_priority_C();
+}
+
+#ifdef OSEK_TRACE
+/* Time stamp for the trace recorder [us]
+ * systick_ms is updated by the PIT ISR, the PIT counts at MCK/16 and
+ * PICNT holds the periods not yet acknowledged by the ISR.
+ */
+UINT32 trace_get_time(void)
+{
+	U32 ms;
+	U32 piir;
+	U32 piv;
+
+	do
+	{
+		ms = systick_get_ms();
+		piir = *AT91C_PITC_PIIR;
+	} while (ms != systick_get_ms());
+
+	piv = (*AT91C_PITC_PIMR & AT91C_SYSC_PIV) + 1;
+	ms += (piir & AT91C_SYSC_PICNT) >> 20;
 
+	return ms * 1000 + ((piir & AT91C_SYSC_CPIV) * 1000) / piv;
 }
+#endif
 
@@ -0,0 +1,104 @@
+/*
+ *  TOPPERS/OSEK Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      OSEK Kernel
+ *
+ *  Copyright (C) 2000-2003 by Embedded and Real-Time Systems Laboratory
+ *                              Toyohashi Univ. of Technology, JAPAN
+ *  Copyright (C) 2004 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2006 by Witz Corporation, JAPAN
+ *
+ *  L쌠҂́Cȉ (1)`(4) ̏CFree Software Foundation
+ *  ɂČ\Ă GNU General Public License  Version 2 ɋL
+ *  qĂ𖞂ꍇɌC{\tgEFAi{\tgEFA
+ *  ς̂܂ށDȉjgpEEρEĔzziȉC
+ *  pƌĂԁj邱Ƃ𖳏ŋD
+ *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
+ *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
+ *      XR[hɊ܂܂Ă邱ƁD
+ *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
+ *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
+ *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
+ *      ̖ۏ؋Kfڂ邱ƁD
+ *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
+ *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
+ *      ƁD
+ *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
+ *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
+ *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
+ *        񍐂邱ƁD
+ *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
+ *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
+ *
+ *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
+ *  TOPPERSvWFNǵC{\tgEFAɊւāC̓Kp\
+ *  ܂߂āCȂۏ؂sȂD܂C{\tgEFA̗pɂ蒼
+ *  ړI܂͊ԐړIɐȂ鑹QɊւĂC̐ӔC𕉂ȂD
+ */
+
+/*
+ *	System timer module for the samples (Linux host simulation)
+ *
+ *  Plays the part of systick_isr_C1 of the NXT: the application's
+ *  user_1ms_isr_type2() is called on every 1 ms tick of the simulated
+ *  system timer, and systick_get_ms() returns the simulated time.
+ */
+
+
+#include "kernel.h"
+#include "trace.h"
+#ifdef OSEK_TRACE
+#include <time.h>
+#endif /* OSEK_TRACE */
+
+extern void user_1ms_isr_type2(void);
+
+static volatile UINT32	systick_ms;
+
+#ifdef OSEK_TRACE
+static struct timespec	systick_ts;		/* host time of the last tick */
+
+static void
+systick_stamp(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &systick_ts);
+}
+
+/*
+ *  Time stamp for the trace recorder [us]
+ *
+ *  Simulated milliseconds plus the host time elapsed since the last
+ *  tick, clamped so that it never runs into the next tick.
+ */
+UINT32 trace_get_time(void)
+{
+	struct timespec	now;
+	long			us;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	us = (now.tv_sec - systick_ts.tv_sec) * 1000000L
+			+ (now.tv_nsec - systick_ts.tv_nsec) / 1000L;
+	if (us < 0) {
+		us = 0;
+	}
+	else if (us > 999) {
+		us = 999;
+	}
+	return(systick_ms * 1000u + (UINT32) us);
+}
+#else /* OSEK_TRACE */
+#define systick_stamp()
+#endif /* OSEK_TRACE */
+
+void hw_sys_timer_isr(void)
+{
+	systick_ms++;
+	systick_stamp();
+	user_1ms_isr_type2();
+}
+
+UINT32 systick_get_ms(void)
+{
+	return systick_ms;
+}
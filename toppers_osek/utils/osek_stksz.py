@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+#
+# osek_stksz.py - size the OSEK task stacks from measured usage
+#
+# Reads the report written by stack_dump() (kernel/stack.c, built with
+# OSEK_STACK_MONITOR) and sets the STACKSIZE of every measured TASK in
+# the OIL file to its high-water mark plus a margin.
+#
+# usage: osek_stksz.py [-b] [-m MARGIN] [-n] KERNEL_CFG.c APP.oil REPORT.bin
+#
+#   KERNEL_CFG.c  kernel_cfg.c generated for the measured build, used to
+#                 map task IDs to the TASK names of the OIL file
+#   -b            report was captured from Bluetooth: every packet starts
+#                 with the 2 byte length header of ecrobot_send_bt_packet()
+#   -m MARGIN     bytes added to the measured usage (default 64)
+#   -n            dry run, only print the table
+#
+# The report may be mixed with the output of trace_dump() and
+# trace_dump_stat(); those records are skipped.  Tasks that never ran
+# and tasks that used up their whole stack are left alone.  The OIL file
+# is rewritten in place, the original is kept as APP.oil.bak.
+
+import argparse
+import re
+import shutil
+import struct
+import sys
+
+TRACE_STAT = 0x80
+STACK_RECORD = 0x81
+ALIGN = 8           # AAPCS stack alignment
+
+
+def strip_bt_headers(data):
+    """Remove the 2 byte little endian length header of each BT packet."""
+    out = bytearray()
+    pos = 0
+    while pos + 2 <= len(data):
+        (length,) = struct.unpack_from("<H", data, pos)
+        pos += 2
+        out += data[pos:pos + length]
+        pos += length
+    return bytes(out)
+
+
+def parse_report(data):
+    """Return {task ID: (size, used)}; later records win."""
+    usage = {}
+    pos = 0
+    while pos + 8 <= len(data):
+        size, used, typ, tskid, _ = struct.unpack_from("<HHBBH", data, pos)
+        if typ == TRACE_STAT:
+            pos += 24
+            continue
+        if typ == STACK_RECORD:
+            usage[tskid] = (size, used)
+        pos += 8
+    return usage
+
+
+def task_names(cfg_text):
+    """Task names in ID order from tinib_task[] of kernel_cfg.c.
+
+    sg writes the entries as TASKNAME( name ) (kernel.h); the expanded
+    form TaskMainname is accepted too."""
+    m = re.search(r"tinib_task\s*\[[^\]]*\]\s*=\s*\{([^}]*)\}", cfg_text)
+    if m is None:
+        sys.exit("tinib_task[] not found in kernel_cfg.c")
+    names = []
+    for entry in m.group(1).split(","):
+        entry = entry.strip()
+        if not entry:
+            continue
+        n = re.match(r"TASKNAME\(\s*(\w+)\s*\)", entry) \
+            or re.match(r"TaskMain(\w+)", entry)
+        names.append(n.group(1) if n else entry)
+    return names
+
+
+def find_block_end(text, start):
+    """Index just past the '}' matching the '{' at start."""
+    depth = 0
+    for i in range(start, len(text)):
+        if text[i] == "{":
+            depth += 1
+        elif text[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return i + 1
+    return len(text)
+
+
+def set_stacksize(oil, name, size):
+    """Replace STACKSIZE in TASK name; returns (new text, old size)."""
+    m = re.search(r"\bTASK\s+%s\s*\{" % re.escape(name), oil)
+    if m is None:
+        return oil, None
+    start = m.end() - 1
+    end = find_block_end(oil, start)
+    block = oil[start:end]
+    s = re.search(r"(\bSTACKSIZE\s*=\s*)(\w+)", block)
+    if s is None:
+        return oil, None
+    old = int(s.group(2), 0)
+    block = block[:s.start(2)] + str(size) + block[s.end(2):]
+    return oil[:start] + block + oil[end:], old
+
+
+def main():
+    ap = argparse.ArgumentParser(description="rewrite STACKSIZE from "
+                                 "a stack_dump() report")
+    ap.add_argument("kernel_cfg")
+    ap.add_argument("oil")
+    ap.add_argument("report")
+    ap.add_argument("-b", "--bluetooth", action="store_true",
+                    help="strip the BT packet length headers")
+    ap.add_argument("-m", "--margin", type=int, default=64,
+                    help="bytes added to the measured usage")
+    ap.add_argument("-n", "--dry-run", action="store_true")
+    opt = ap.parse_args()
+
+    with open(opt.kernel_cfg, encoding="latin-1") as f:
+        names = task_names(f.read())
+    with open(opt.report, "rb") as f:
+        data = f.read()
+    if opt.bluetooth:
+        data = strip_bt_headers(data)
+    usage = parse_report(data)
+    with open(opt.oil, encoding="latin-1", newline="") as f:
+        oil = f.read()
+
+    saved = 0
+    print("%-16s %8s %8s %8s" % ("task", "size", "used", "new"))
+    for tskid in sorted(usage):
+        size, used = usage[tskid]
+        name = names[tskid] if tskid < len(names) else "task%d" % tskid
+        if used == 0:
+            print("%-16s %8d %8d %8s  never ran" % (name, size, used, "-"))
+            continue
+        if used + 4 > size:
+            print("%-16s %8d %8d %8s  stack full, check for overflow" %
+                  (name, size, used, "-"))
+            continue
+        new = (used + opt.margin + ALIGN - 1) // ALIGN * ALIGN
+        oil, old = set_stacksize(oil, name, new)
+        if old is None:
+            print("%-16s %8d %8d %8s  no STACKSIZE in %s" %
+                  (name, size, used, "-", opt.oil))
+            continue
+        saved += old - new
+        print("%-16s %8d %8d %8d" % (name, old, used, new))
+    print("%d bytes saved" % saved)
+
+    if not opt.dry_run:
+        shutil.copyfile(opt.oil, opt.oil + ".bak")
+        with open(opt.oil, "w", encoding="latin-1", newline="") as f:
+            f.write(oil)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
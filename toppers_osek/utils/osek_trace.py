@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+#
+# osek_trace.py - decoder for the TOPPERS/OSEK trace recorder (OSEK_TRACE)
+#
+# Reads the byte stream written by trace_dump()/trace_dump_stat()
+# (kernel/trace.c) and converts it into a Chrome trace JSON file that can
+# be opened with chrome://tracing or https://ui.perfetto.dev.
+#
+# usage: osek_trace.py [-b] [-n NAMES] [-o OUT.json] TRACE.bin
+#
+#   -b        input was captured from Bluetooth: every packet starts with
+#             the 2 byte length header of ecrobot_send_bt_packet()
+#   -n NAMES  task names, comma separated in task ID order
+#   -o OUT    output file (default: TRACE.json)
+#
+# The task statistics records are printed to stdout.
+
+import json
+import struct
+import sys
+import argparse
+
+TRACE_ACTTSK = 0x01
+TRACE_TSKDSP = 0x02
+TRACE_TSKSWT = 0x03
+TRACE_TSKEXT = 0x04
+TRACE_WAIEVT = 0x05
+TRACE_SETEVT = 0x06
+TRACE_GETRES = 0x07
+TRACE_RELRES = 0x08
+TRACE_ISRENT = 0x09
+TRACE_ISREXT = 0x0a
+TRACE_LOST = 0x7f
+TRACE_STAT = 0x80
+STACK_RECORD = 0x81       # kernel/stack.h, see osek_stksz.py
+
+INSTANT_NAMES = {
+    TRACE_ACTTSK: "ActivateTask",
+    TRACE_TSKEXT: "TerminateTask",
+    TRACE_WAIEVT: "WaitEvent",
+    TRACE_SETEVT: "SetEvent",
+    TRACE_GETRES: "GetResource",
+    TRACE_RELRES: "ReleaseResource",
+    TRACE_LOST: "lost",
+}
+
+
+def strip_bt_headers(data):
+    """Remove the 2 byte little endian length header of each BT packet."""
+    out = bytearray()
+    pos = 0
+    while pos + 2 <= len(data):
+        (length,) = struct.unpack_from("<H", data, pos)
+        pos += 2
+        out += data[pos:pos + length]
+        pos += length
+    return bytes(out)
+
+
+def parse(data):
+    """Split the stream into log entries and statistics records."""
+    logs = []
+    stats = []
+    pos = 0
+    while pos + 8 <= len(data):
+        time, typ, obj, arg = struct.unpack_from("<IBBH", data, pos)
+        if typ == TRACE_STAT:
+            if pos + 24 > len(data):
+                break
+            rec = struct.unpack_from("<6I", data, pos)
+            stats.append({"task": obj, "count": rec[0], "exec_max": rec[2],
+                          "exec_total": rec[3], "resp_min": rec[4],
+                          "resp_max": rec[5]})
+            pos += 24
+        elif typ == STACK_RECORD:
+            pos += 8
+        else:
+            logs.append((time, typ, obj, arg))
+            pos += 8
+    return logs, stats
+
+
+def unwrap(logs):
+    """Make the 32 bit microsecond time stamps monotonic."""
+    base = 0
+    last = None
+    out = []
+    for time, typ, obj, arg in logs:
+        if last is not None and time < last and last - time > 0x80000000:
+            base += 1 << 32
+        last = time
+        out.append((base + time, typ, obj, arg))
+    return out
+
+
+def to_chrome(logs, names):
+    def task_name(tskid):
+        if tskid < len(names):
+            return names[tskid]
+        return "task%d" % tskid
+
+    events = []
+    running = None          # (tskid, start)
+    isr_start = {}
+    for time, typ, obj, arg in logs:
+        if typ == TRACE_TSKDSP:
+            running = (obj, time)
+        elif typ == TRACE_TSKSWT:
+            if running is not None and running[0] == obj:
+                events.append({"name": task_name(obj), "ph": "X",
+                               "ts": running[1], "dur": time - running[1],
+                               "pid": 0, "tid": obj})
+            running = None
+        elif typ == TRACE_ISRENT:
+            isr_start[obj] = time
+        elif typ == TRACE_ISREXT:
+            if obj in isr_start:
+                start = isr_start.pop(obj)
+                events.append({"name": "ISR%d" % obj, "ph": "X",
+                               "ts": start, "dur": time - start,
+                               "pid": 1, "tid": obj})
+        elif typ in INSTANT_NAMES:
+            if typ in (TRACE_GETRES, TRACE_RELRES):
+                tid, args = arg, {"resource": obj}
+            elif typ == TRACE_LOST:
+                tid, args = 0, {"count": arg}
+            else:
+                tid, args = obj, {"arg": arg}
+            events.append({"name": INSTANT_NAMES[typ], "ph": "i", "s": "t",
+                           "ts": time, "pid": 0, "tid": tid, "args": args})
+
+    tids = sorted({e["tid"] for e in events if e["pid"] == 0})
+    for tid in tids:
+        events.append({"name": "thread_name", "ph": "M", "pid": 0,
+                       "tid": tid, "args": {"name": task_name(tid)}})
+    events.append({"name": "process_name", "ph": "M", "pid": 0,
+                   "args": {"name": "tasks"}})
+    events.append({"name": "process_name", "ph": "M", "pid": 1,
+                   "args": {"name": "ISR2"}})
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def print_stats(stats, names):
+    if not stats:
+        return
+    print("%-16s %8s %10s %10s %10s %10s %10s" %
+          ("task", "jobs", "exec avg", "exec max", "resp min", "resp max",
+           "jitter"))
+    for s in stats:
+        name = names[s["task"]] if s["task"] < len(names) \
+            else "task%d" % s["task"]
+        if s["count"] == 0:
+            print("%-16s %8d" % (name, 0))
+            continue
+        avg = s["exec_total"] / s["count"]
+        if s["resp_max"] >= s["resp_min"]:
+            resp_min, resp_max = s["resp_min"], s["resp_max"]
+            jitter = "%10d" % (resp_max - resp_min)
+            resp_min, resp_max = "%10d" % resp_min, "%10d" % resp_max
+        else:
+            resp_min = resp_max = jitter = "%10s" % "-"
+        print("%-16s %8d %10.1f %10d %s %s %s" %
+              (name, s["count"], avg, s["exec_max"], resp_min, resp_max,
+               jitter))
+    print("(times in us)")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="decode an OSEK_TRACE dump")
+    ap.add_argument("input")
+    ap.add_argument("-b", "--bluetooth", action="store_true",
+                    help="strip the BT packet length headers")
+    ap.add_argument("-n", "--names", default="",
+                    help="task names in task ID order, comma separated")
+    ap.add_argument("-o", "--output")
+    opt = ap.parse_args()
+
+    with open(opt.input, "rb") as f:
+        data = f.read()
+    if opt.bluetooth:
+        data = strip_bt_headers(data)
+    names = [n for n in opt.names.split(",") if n]
+
+    logs, stats = parse(data)
+    logs = unwrap(logs)
+    out = opt.output or opt.input.rsplit(".", 1)[0] + ".json"
+    with open(out, "w") as f:
+        json.dump(to_chrome(logs, names), f)
+    print("%d entries -> %s" % (len(logs), out))
+    print_stats(stats, names)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())